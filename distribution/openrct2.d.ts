@@ -35,6 +35,8 @@ declare global {
     var network: Network;
     /** APIs for the park and management of it. */
     var park: Park;
+    /** APIs for timing the game logic. */
+    var profiler: Profiler;
     /** APIs for the current scenario. */
     var scenario: Scenario;
     /** APIs for the climate and weather. */
@@ -1971,6 +1973,53 @@ declare global {
         showVehiclesFromOtherTrackTypes: boolean;
     }
 
+    /**
+     * Profiler APIs
+     * Times are per game tick, measured over the most recent ticks in which the function was entered.
+     */
+    interface Profiler {
+        /**
+         * Whether the profiler is currently collecting timings.
+         */
+        readonly enabled: boolean;
+
+        /**
+         * Gets the collected timings for every function that has been entered since the data was last reset.
+         */
+        getData(): ProfiledFunction[];
+
+        start(): void;
+        stop(): void;
+        reset(): void;
+    }
+
+    interface ProfiledFunction {
+        readonly name: string;
+
+        /**
+         * The name of the function this one is nested in, or null for the outermost functions.
+         */
+        readonly parent: string | null;
+
+        /**
+         * The total number of times the function was entered.
+         */
+        readonly calls: number;
+
+        /**
+         * The number of ticks the timings below are calculated from.
+         */
+        readonly ticks: number;
+
+        /**
+         * Times in milliseconds spent in the function per tick.
+         */
+        readonly mean: number;
+        readonly p50: number;
+        readonly p99: number;
+        readonly max: number;
+    }
+
     /**
      * User Interface APIs
      * These will only be available to servers and clients that are not running headless mode.
@@ -18,6 +18,7 @@
 #include <openrct2/drawing/LightFX.h>
 #include <openrct2/drawing/X8DrawingEngine.h>
 #include <openrct2/paint/Paint.h>
+#include <openrct2/profiling/Profiling.h>
 #include <openrct2/ui/UiContext.h>
 #include <vector>
 
@@ -180,6 +181,8 @@ public:
 
     void EndDraw() override
     {
+        TRACED_SCOPE("HardwareDisplayDrawingEngine::EndDraw");
+
         Display();
         if (gShowDirtyVisuals)
         {
@@ -17,6 +17,7 @@
 #include <openrct2/core/Guard.hpp>
 #include <openrct2/drawing/IDrawingEngine.h>
 #include <openrct2/drawing/X8DrawingEngine.h>
+#include <openrct2/profiling/Profiling.h>
 #include <openrct2/ui/UiContext.h>
 
 using namespace OpenRCT2;
@@ -96,6 +97,8 @@ public:
 
     void EndDraw() override
     {
+        TRACED_SCOPE("SoftwareDrawingEngine::EndDraw");
+
         Display();
     }
 
@@ -34,6 +34,7 @@
 #    include <openrct2/drawing/LightFX.h>
 #    include <openrct2/drawing/Weather.h>
 #    include <openrct2/interface/Screenshot.h>
+#    include <openrct2/profiling/Profiling.h>
 #    include <openrct2/ui/UiContext.h>
 #    include <openrct2/util/Util.h>
 #    include <openrct2/world/Climate.h>
@@ -298,6 +299,8 @@ public:
 
     void EndDraw() override
     {
+        TRACED_SCOPE("OpenGLDrawingEngine::EndDraw");
+
         _drawingContext->FlushCommandBuffers();
 
         glDisable(GL_DEPTH_TEST);
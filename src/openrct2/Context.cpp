@@ -41,6 +41,7 @@
 #include "drawing/IDrawingEngine.h"
 #include "drawing/Image.h"
 #include "drawing/LightFX.h"
+#include "drawing/SpriteCache.h"
 #include "entity/EntityRegistry.h"
 #include "entity/EntityTweener.h"
 #include "interface/Chat.h"
@@ -56,9 +57,11 @@
 #include "object/ObjectManager.h"
 #include "object/ObjectRepository.h"
 #include "paint/Painter.h"
+#include "park/ParkSaveWorker.h"
 #include "platform/Crash.h"
 #include "platform/Platform2.h"
 #include "platform/platform.h"
+#include "profiling/Profiling.h"
 #include "ride/TrackData.h"
 #include "ride/TrackDesignRepository.h"
 #include "scenario/Scenario.h"
@@ -175,6 +178,11 @@ namespace OpenRCT2
             //       If objects use GetContext() in their destructor things won't go well.
 
             GameActions::ClearQueue();
+            ParkSaveWorker::Flush();
+            if (Profiling::IsTracing() && !String::IsNullOrEmpty(gTraceOutputPath))
+            {
+                Profiling::StopTrace(gTraceOutputPath);
+            }
 #ifndef DISABLE_NETWORK
             _network.Close();
 #endif
@@ -802,6 +810,7 @@ namespace OpenRCT2
             gfx_load_g2();
             gfx_load_csg();
             font_sprite_initialise_characters();
+            sprite_cache_set_budget(static_cast<size_t>(std::max(gConfigGeneral.sprite_cache_size, 0)) * 1024 * 1024);
             return true;
         }
 
@@ -977,6 +986,7 @@ namespace OpenRCT2
         {
             log_verbose("begin openrct2 loop");
             _finished = false;
+            Profiling::SetThreadName("Main");
 
 #ifndef __EMSCRIPTEN__
             _variableFrame = ShouldRunVariableFrame();
@@ -997,6 +1007,8 @@ namespace OpenRCT2
 
         void RunFrame()
         {
+            TRACED_SCOPE("Context::RunFrame");
+
             const auto deltaTime = _timer.GetElapsedTimeAndRestart().count();
 
             // Make sure we catch the state change and reset it.
@@ -1137,6 +1149,7 @@ namespace OpenRCT2
             }
 #endif
 
+            ParkSaveWorker::Update();
             chat_update();
 #ifdef ENABLE_SCRIPTING
             _scriptEngine.Tick();
@@ -23,6 +23,7 @@
 #include "audio/audio.h"
 #include "config/Config.h"
 #include "core/Console.hpp"
+#include "core/File.h"
 #include "core/FileScanner.h"
 #include "core/Path.hpp"
 #include "entity/EntityRegistry.h"
@@ -39,6 +40,8 @@
 #include "network/network.h"
 #include "object/Object.h"
 #include "object/ObjectList.h"
+#include "park/ParkFile.h"
+#include "park/ParkSaveWorker.h"
 #include "platform/Platform2.h"
 #include "ride/Ride.h"
 #include "ride/RideRatings.h"
@@ -666,12 +669,10 @@ void game_autosave()
 {
     const char* subDirectory = "save";
     const char* fileExtension = ".park";
-    uint32_t saveFlags = 0x80000000;
     if (gScreenFlags & SCREEN_FLAGS_EDITOR)
     {
         subDirectory = "landscape";
         fileExtension = ".sc6";
-        saveFlags |= 2;
     }
 
     // Retrieve current time
@@ -684,7 +685,7 @@ void game_autosave()
         currentDate.day, currentTime.hour, currentTime.minute, currentTime.second, fileExtension);
 
     int32_t autosavesToKeep = gConfigGeneral.autosave_amount;
-    limit_autosave_count(autosavesToKeep - 1, (gScreenFlags & SCREEN_FLAGS_EDITOR));
+    bool isEditor = (gScreenFlags & SCREEN_FLAGS_EDITOR) != 0;
 
     utf8 path[MAX_PATH];
     utf8 backupPath[MAX_PATH];
@@ -697,13 +698,29 @@ void game_autosave()
     safe_strcat(backupPath, fileExtension, sizeof(backupPath));
     safe_strcat(backupPath, ".bak", sizeof(backupPath));
 
-    if (Platform::FileExists(path))
-    {
-        platform_file_copy(path, backupPath, true);
-    }
+    viewport_set_saved_view();
 
-    if (!scenario_save(path, saveFlags))
+    // Only the capture of the park happens here, the files are all handled by the save worker.
+    auto exporter = ParkFileExporter();
+    exporter.OmitTracklessRides = true;
+    auto writeFunc = [savePath = std::string(path), backupPath = std::string(backupPath), autosavesToKeep,
+                      isEditor](const std::vector<uint8_t>& data) {
+        limit_autosave_count(autosavesToKeep - 1, isEditor);
+        if (Platform::FileExists(savePath))
+        {
+            platform_file_copy(savePath.c_str(), backupPath.c_str(), true);
+        }
+        File::WriteAllBytes(savePath, data.data(), data.size());
+        return true;
+    };
+    auto onComplete = [](ParkSaveWorker::Result& result) {
+        if (!result.Success)
+            Console::Error::WriteLine("Could not autosave the scenario. Is the save folder writeable?");
+    };
+    if (!ParkSaveWorker::Start("Autosave", exporter, writeFunc, onComplete))
         Console::Error::WriteLine("Could not autosave the scenario. Is the save folder writeable?");
+
+    gfx_invalidate_screen();
 }
 
 static void game_load_or_quit_no_save_prompt_callback(int32_t result, const utf8* path)
@@ -27,12 +27,14 @@
 #include "management/NewsItem.h"
 #include "network/network.h"
 #include "platform/Platform2.h"
+#include "profiling/Profiling.h"
 #include "ride/Vehicle.h"
 #include "scenario/Scenario.h"
 #include "scripting/ScriptEngine.h"
 #include "title/TitleScreen.h"
 #include "title/TitleSequencePlayer.h"
 #include "ui/UiContext.h"
+#include "util/Util.h"
 #include "windows/Intent.h"
 #include "world/Climate.h"
 #include "world/MapAnimation.h"
@@ -239,15 +241,48 @@ void GameState::Tick()
     gInUpdateCode = false;
 }
 
+#ifdef ENABLE_SCRIPTING
+static constexpr LogicTimePart LastLogicTimePart = LogicTimePart::Scripts;
+#else
+static constexpr LogicTimePart LastLogicTimePart = LogicTimePart::NetworkFlush;
+#endif
+
+static Profiling::Function& GetProfiledLogicTimePart(LogicTimePart part)
+{
+    static std::vector<std::unique_ptr<Profiling::Function>> functions = []() {
+        std::vector<std::unique_ptr<Profiling::Function>> result;
+        for (size_t i = 0; i <= EnumValue(LogicTimePart::Scripts); i++)
+        {
+            result.push_back(std::make_unique<Profiling::Function>(GetLogicTimePartName(static_cast<LogicTimePart>(i))));
+        }
+        return result;
+    }();
+    return *functions[EnumValue(part)];
+}
+
 void GameState::UpdateLogic(LogicTimings* timings)
 {
     auto start_time = std::chrono::high_resolution_clock::now();
 
-    auto report_time = [timings, start_time](LogicTimePart part) {
+    static Profiling::Function profiledLogic("GameState::UpdateLogic");
+    Profiling::ScopedTimer logicTimer(profiledLogic);
+    Profiling::ScopedTimer partTimer(GetProfiledLogicTimePart(LogicTimePart::NetworkUpdate));
+
+    auto report_time = [timings, start_time, &partTimer](LogicTimePart part) {
         if (timings != nullptr)
         {
             timings->TimingInfo[part][timings->CurrentIdx] = std::chrono::high_resolution_clock::now() - start_time;
         }
+
+        // Parts are reported in order, the time until the next report belongs to the next part.
+        if (part != LastLogicTimePart)
+        {
+            partTimer.Switch(GetProfiledLogicTimePart(static_cast<LogicTimePart>(EnumValue(part) + 1)));
+        }
+        else
+        {
+            partTimer.Stop();
+        }
     };
 
     gScreenAge++;
@@ -367,6 +402,8 @@ void GameState::UpdateLogic(LogicTimings* timings)
     gCurrentTicks++;
     gSavedAge++;
 
+    GetContext()->GetReplayManager()->PostUpdate();
+
 #ifdef ENABLE_SCRIPTING
     auto& hookEngine = GetContext()->GetScriptEngine().GetHookEngine();
     hookEngine.Call(HOOK_TYPE::INTERVAL_TICK, true);
@@ -382,6 +419,9 @@ void GameState::UpdateLogic(LogicTimings* timings)
     {
         timings->CurrentIdx = (timings->CurrentIdx + 1) % LOGIC_UPDATE_MEASUREMENTS_COUNT;
     }
+
+    logicTimer.Stop();
+    Profiling::EndTick();
 }
 
 void GameState::CreateStateSnapshot()
@@ -392,3 +432,55 @@ void GameState::CreateStateSnapshot()
     snapshots->Capture(snapshot);
     snapshots->LinkSnapshot(snapshot, gCurrentTicks, scenario_rand_state().s0);
 }
+
+const char* OpenRCT2::GetLogicTimePartName(LogicTimePart part)
+{
+    switch (part)
+    {
+        case LogicTimePart::NetworkUpdate:
+            return "NetworkUpdate";
+        case LogicTimePart::Date:
+            return "Date";
+        case LogicTimePart::Scenario:
+            return "Scenario";
+        case LogicTimePart::Climate:
+            return "Climate";
+        case LogicTimePart::MapTiles:
+            return "MapTiles";
+        case LogicTimePart::MapStashProvisionalElements:
+            return "MapStashProvisionalElements";
+        case LogicTimePart::MapPathWideFlags:
+            return "MapPathWideFlags";
+        case LogicTimePart::Peep:
+            return "Peep";
+        case LogicTimePart::MapRestoreProvisionalElements:
+            return "MapRestoreProvisionalElements";
+        case LogicTimePart::Vehicle:
+            return "Vehicle";
+        case LogicTimePart::Misc:
+            return "Misc";
+        case LogicTimePart::Ride:
+            return "Ride";
+        case LogicTimePart::Park:
+            return "Park";
+        case LogicTimePart::Research:
+            return "Research";
+        case LogicTimePart::RideRatings:
+            return "RideRatings";
+        case LogicTimePart::RideMeasurments:
+            return "RideMeasurments";
+        case LogicTimePart::News:
+            return "News";
+        case LogicTimePart::MapAnimation:
+            return "MapAnimation";
+        case LogicTimePart::Sounds:
+            return "Sounds";
+        case LogicTimePart::GameActions:
+            return "GameActions";
+        case LogicTimePart::NetworkFlush:
+            return "NetworkFlush";
+        case LogicTimePart::Scripts:
+            return "Scripts";
+    }
+    return "Unknown";
+}
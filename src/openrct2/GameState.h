@@ -47,6 +47,8 @@ namespace OpenRCT2
         Scripts,
     };
 
+    const char* GetLogicTimePartName(LogicTimePart part);
+
     // ~6.5s at 40Hz
     constexpr size_t LOGIC_UPDATE_MEASUREMENTS_COUNT = 256;
 
@@ -20,11 +20,21 @@
 #include "entity/MoneyEffect.h"
 #include "entity/Particle.h"
 #include "entity/Staff.h"
+#include "ride/Ride.h"
 #include "ride/Vehicle.h"
+#include "util/Util.h"
+#include "world/Map.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
 
 static constexpr size_t MaximumGameStateSnapshots = 32;
 static constexpr uint32_t InvalidTick = 0xFFFFFFFF;
 
+// Every this many captures the full state is kept, the captures in between only keep what changed since.
+static constexpr size_t SnapshotKeyframeInterval = 8;
+
 #pragma pack(push, 1)
 union EntitySnapshot
 {
@@ -36,135 +46,494 @@ union EntitySnapshot
     }
 };
 assert_struct_size(EntitySnapshot, 0x200);
+
+// The fields of a ride that the simulation changes.
+struct RideSnapshot
+{
+    uint8_t type;
+    RideStatus status;
+    RideMode mode;
+    uint8_t num_vehicles;
+    uint8_t num_cars_per_train;
+    RatingTuple ratings;
+    uint16_t value;
+    money16 price[RCT2::ObjectLimits::MaxShopItemsPerRideEntry];
+    uint16_t cur_num_customers;
+    uint32_t total_customers;
+    money64 total_profit;
+    money64 income_per_hour;
+    money64 profit;
+    uint8_t popularity;
+    uint8_t satisfaction;
+    uint16_t reliability;
+    uint8_t breakdown_reason;
+    uint8_t mechanic_status;
+    uint16_t mechanic;
+    uint8_t downtime;
+};
 #pragma pack(pop)
 
-struct GameStateSnapshot_t
+enum class SnapshotSectionType : uint8_t
 {
-    GameStateSnapshot_t& operator=(GameStateSnapshot_t&& mv) noexcept
+    Entities,
+    Tiles,
+    Rides,
+    Count,
+};
+
+/*
+ * A part of the game state as records ordered by their id, which is the entity index, map row or ride index. In
+ * snapshots that are not keyframes a record can hold the changes to the keyframe's record with the same id instead.
+ */
+struct SnapshotSection
+{
+    struct Record
+    {
+        uint32_t Id;
+        uint32_t Offset;
+        uint32_t Size;
+        bool IsDelta;
+    };
+
+    std::vector<Record> Records;
+    std::vector<uint8_t> Data;
+
+    void Add(uint32_t id, const uint8_t* data, size_t size)
+    {
+        Records.push_back({ id, static_cast<uint32_t>(Data.size()), static_cast<uint32_t>(size), false });
+        Data.insert(Data.end(), data, data + size);
+    }
+
+    const Record* Find(uint32_t id) const
     {
-        tick = mv.tick;
-        storedSprites = std::move(mv.storedSprites);
-        return *this;
+        auto it = std::lower_bound(
+            Records.begin(), Records.end(), id, [](const Record& record, uint32_t value) { return record.Id < value; });
+        if (it == Records.end() || it->Id != id)
+            return nullptr;
+        return &*it;
     }
 
+    const uint8_t* GetData(const Record& record) const
+    {
+        return Data.data() + record.Offset;
+    }
+};
+
+using SnapshotState = std::array<SnapshotSection, EnumValue(SnapshotSectionType::Count)>;
+
+struct GameStateSnapshot_t
+{
     uint32_t tick = InvalidTick;
     uint32_t srand0 = 0;
 
-    OpenRCT2::MemoryStream storedSprites;
+    // The state of the keyframe the snapshot was captured against, its own state if it is the keyframe.
+    std::shared_ptr<const SnapshotState> keyframe;
+    bool isKeyframe = false;
+    // Every record of the captured state, mostly as changes to the keyframe.
+    SnapshotState delta;
+    // Snapshots from older versions only contain entities.
+    bool hasTilesAndRides = true;
+
     OpenRCT2::MemoryStream parkParameters;
+};
 
-    template<typename T> bool EntitySizeCheck(DataSerialiser& ds)
+template<typename T> static bool EntitySizeCheck(DataSerialiser& ds)
+{
+    uint32_t size = sizeof(T);
+    ds << size;
+    if (ds.IsLoading())
     {
-        uint32_t size = sizeof(T);
-        ds << size;
-        if (ds.IsLoading())
-        {
-            return size == sizeof(T);
-        }
-        return true;
+        return size == sizeof(T);
     }
-    template<typename... T> bool EntitiesSizeCheck(DataSerialiser& ds)
+    return true;
+}
+
+template<typename... T> static bool EntitiesSizeCheck(DataSerialiser& ds)
+{
+    return (EntitySizeCheck<T>(ds) && ...);
+}
+
+static void SerialiseEntity(DataSerialiser& ds, EntitySnapshot& sprite)
+{
+    switch (sprite.base.Type)
     {
-        return (EntitySizeCheck<T>(ds) && ...);
+        case EntityType::Vehicle:
+            reinterpret_cast<Vehicle&>(sprite).Serialise(ds);
+            break;
+        case EntityType::Guest:
+            reinterpret_cast<Guest&>(sprite).Serialise(ds);
+            break;
+        case EntityType::Staff:
+            reinterpret_cast<Staff&>(sprite).Serialise(ds);
+            break;
+        case EntityType::Litter:
+            reinterpret_cast<Litter&>(sprite).Serialise(ds);
+            break;
+        case EntityType::MoneyEffect:
+            reinterpret_cast<MoneyEffect&>(sprite).Serialise(ds);
+            break;
+        case EntityType::Balloon:
+            reinterpret_cast<Balloon&>(sprite).Serialise(ds);
+            break;
+        case EntityType::Duck:
+            reinterpret_cast<Duck&>(sprite).Serialise(ds);
+            break;
+        case EntityType::JumpingFountain:
+            reinterpret_cast<JumpingFountain&>(sprite).Serialise(ds);
+            break;
+        case EntityType::SteamParticle:
+            reinterpret_cast<SteamParticle&>(sprite).Serialise(ds);
+            break;
+        case EntityType::Null:
+            break;
+        default:
+            break;
     }
+}
 
-    // Must pass a function that can access the sprite.
-    void SerialiseSprites(std::function<EntitySnapshot*(const size_t)> getEntity, const size_t numSprites, bool saving)
-    {
-        const bool loading = !saving;
+// Each record is the entity index and type followed by the entity, the same layout as written by older versions.
+static SnapshotSection CaptureEntities()
+{
+    SnapshotSection section;
 
-        storedSprites.SetPosition(0);
-        DataSerialiser ds(saving, storedSprites);
+    OpenRCT2::MemoryStream stream;
+    DataSerialiser ds(true, stream);
+    for (uint32_t i = 0; i < MAX_ENTITIES; i++)
+    {
+        auto* entity = reinterpret_cast<EntitySnapshot*>(GetEntity(i));
+        if (entity == nullptr || entity->base.Type == EntityType::Null)
+            continue;
+
+        auto offset = static_cast<uint32_t>(stream.GetPosition());
+        uint32_t index = i;
+        ds << index;
+        ds << entity->base.Type;
+        SerialiseEntity(ds, *entity);
+        section.Records.push_back({ i, offset, static_cast<uint32_t>(stream.GetPosition()) - offset, false });
+    }
 
-        std::vector<uint32_t> indexTable;
-        indexTable.reserve(numSprites);
+    const auto* data = static_cast<const uint8_t*>(stream.GetData());
+    section.Data.assign(data, data + stream.GetLength());
+    return section;
+}
 
-        uint32_t numSavedSprites = 0;
+// Each record is a row of tiles, each tile its element count followed by the elements. Ghosts are local to each player
+// and left out, which also changes which element is the last one of its tile.
+static SnapshotSection CaptureTiles()
+{
+    SnapshotSection section;
 
-        if (saving)
+    std::vector<uint8_t> row;
+    for (int32_t y = 0; y < gMapSize; y++)
+    {
+        row.clear();
+        for (int32_t x = 0; x < gMapSize; x++)
         {
-            for (size_t i = 0; i < numSprites; i++)
+            auto countOffset = row.size();
+            row.resize(countOffset + sizeof(uint16_t));
+
+            uint16_t numElements = 0;
+            auto* tileElement = map_get_first_element_at(TileCoordsXY{ x, y });
+            if (tileElement != nullptr)
             {
-                auto entity = getEntity(i);
-                if (entity == nullptr || entity->base.Type == EntityType::Null)
-                    continue;
-                indexTable.push_back(static_cast<uint32_t>(i));
+                do
+                {
+                    if (tileElement->IsGhost())
+                        continue;
+
+                    auto element = *tileElement;
+                    element.Flags &= ~TILE_ELEMENT_FLAG_LAST_TILE;
+                    const auto* bytes = reinterpret_cast<const uint8_t*>(&element);
+                    row.insert(row.end(), bytes, bytes + sizeof(element));
+                    numElements++;
+                } while (!(tileElement++)->IsLastForTile());
             }
-            numSavedSprites = static_cast<uint32_t>(indexTable.size());
+            std::memcpy(row.data() + countOffset, &numElements, sizeof(numElements));
+        }
+        section.Add(static_cast<uint32_t>(y), row.data(), row.size());
+    }
+    return section;
+}
+
+static SnapshotSection CaptureRides()
+{
+    SnapshotSection section;
+
+    for (uint32_t i = 0; i < MAX_RIDES; i++)
+    {
+        auto* ride = get_ride(static_cast<ride_id_t>(i));
+        if (ride == nullptr)
+            continue;
+
+        RideSnapshot snapshot{};
+        snapshot.type = ride->type;
+        snapshot.status = ride->status;
+        snapshot.mode = ride->mode;
+        snapshot.num_vehicles = ride->num_vehicles;
+        snapshot.num_cars_per_train = ride->num_cars_per_train;
+        snapshot.ratings = ride->ratings;
+        snapshot.value = ride->value;
+        std::copy(std::begin(ride->price), std::end(ride->price), snapshot.price);
+        snapshot.cur_num_customers = ride->cur_num_customers;
+        snapshot.total_customers = ride->total_customers;
+        snapshot.total_profit = ride->total_profit;
+        snapshot.income_per_hour = ride->income_per_hour;
+        snapshot.profit = ride->profit;
+        snapshot.popularity = ride->popularity;
+        snapshot.satisfaction = ride->satisfaction;
+        snapshot.reliability = ride->reliability;
+        snapshot.breakdown_reason = ride->breakdown_reason;
+        snapshot.mechanic_status = ride->mechanic_status;
+        snapshot.mechanic = ride->mechanic;
+        snapshot.downtime = ride->downtime;
+        section.Add(i, reinterpret_cast<const uint8_t*>(&snapshot), sizeof(snapshot));
+    }
+    return section;
+}
+
+static void WriteRunLength(std::vector<uint8_t>& output, uint16_t length)
+{
+    const auto* bytes = reinterpret_cast<const uint8_t*>(&length);
+    output.insert(output.end(), bytes, bytes + sizeof(length));
+}
+
+/*
+ * Appends the bytes of current that differ from keyframe as runs, each the number of unchanged bytes to skip, the
+ * number of changed bytes and the changed bytes XORed with the keyframe. Unchanged trailing bytes are left out, so an
+ * unchanged record takes no space at all.
+ */
+static void EncodeRecordDelta(const uint8_t* keyframe, const uint8_t* current, size_t size, std::vector<uint8_t>& output)
+{
+    size_t pos = 0;
+    while (pos < size)
+    {
+        size_t numSkipped = 0;
+        while (pos < size && keyframe[pos] == current[pos])
+        {
+            pos++;
+            numSkipped++;
         }
+        if (pos == size)
+            break;
 
-        // Encodes and checks the size of each of the entity so that we
-        // can fail gracefully when fields added/removed
-        if (!EntitiesSizeCheck<Vehicle, Guest, Staff, Litter, MoneyEffect, Balloon, Duck, JumpingFountain, SteamParticle>(ds))
+        for (; numSkipped > UINT16_MAX; numSkipped -= UINT16_MAX)
         {
-            log_error("Entity index corrupted!");
-            return;
+            WriteRunLength(output, UINT16_MAX);
+            WriteRunLength(output, 0);
         }
-        ds << numSavedSprites;
 
-        if (loading)
+        uint16_t numChanged = 0;
+        auto changedStart = pos;
+        while (pos < size && numChanged < UINT16_MAX && keyframe[pos] != current[pos])
         {
-            indexTable.resize(numSavedSprites);
+            pos++;
+            numChanged++;
         }
 
-        for (uint32_t i = 0; i < numSavedSprites; i++)
+        WriteRunLength(output, static_cast<uint16_t>(numSkipped));
+        WriteRunLength(output, numChanged);
+        for (auto i = changedStart; i < pos; i++)
         {
-            ds << indexTable[i];
+            output.push_back(keyframe[i] ^ current[i]);
+        }
+    }
+}
+
+static void DecodeRecordDelta(
+    const uint8_t* keyframe, size_t size, const uint8_t* delta, size_t deltaSize, std::vector<uint8_t>& output)
+{
+    auto start = output.size();
+    output.insert(output.end(), keyframe, keyframe + size);
+    auto* data = output.data() + start;
+
+    size_t pos = 0;
+    size_t deltaPos = 0;
+    while (deltaPos + 2 * sizeof(uint16_t) <= deltaSize)
+    {
+        uint16_t numSkipped;
+        uint16_t numChanged;
+        std::memcpy(&numSkipped, delta + deltaPos, sizeof(numSkipped));
+        std::memcpy(&numChanged, delta + deltaPos + sizeof(numSkipped), sizeof(numChanged));
+        deltaPos += 2 * sizeof(uint16_t);
+
+        pos += numSkipped;
+        for (uint16_t i = 0; i < numChanged; i++)
+        {
+            data[pos++] ^= delta[deltaPos++];
+        }
+    }
+}
 
-            const uint32_t spriteIdx = indexTable[i];
-            EntitySnapshot* entity = getEntity(spriteIdx);
-            if (entity == nullptr)
+// Records that are missing from the keyframe or changed in size are kept whole.
+static SnapshotState EncodeStateDelta(const SnapshotState& keyframe, const SnapshotState& state)
+{
+    SnapshotState delta;
+    for (size_t i = 0; i < state.size(); i++)
+    {
+        const auto& keyframeSection = keyframe[i];
+        const auto& section = state[i];
+        auto& deltaSection = delta[i];
+        deltaSection.Records.reserve(section.Records.size());
+        for (const auto& record : section.Records)
+        {
+            const auto* keyframeRecord = keyframeSection.Find(record.Id);
+            if (keyframeRecord == nullptr || keyframeRecord->Size != record.Size)
             {
-                log_error("Entity index corrupted!");
-                return;
+                deltaSection.Add(record.Id, section.GetData(record), record.Size);
+                continue;
             }
-            auto& sprite = *entity;
 
-            ds << sprite.base.Type;
+            auto offset = static_cast<uint32_t>(deltaSection.Data.size());
+            EncodeRecordDelta(
+                keyframeSection.GetData(*keyframeRecord), section.GetData(record), record.Size, deltaSection.Data);
+            deltaSection.Records.push_back(
+                { record.Id, offset, static_cast<uint32_t>(deltaSection.Data.size()) - offset, true });
+        }
+    }
+    return delta;
+}
+
+// Restores the full state of a snapshot, which for keyframes is the one they already hold.
+static std::shared_ptr<const SnapshotState> Materialise(const GameStateSnapshot_t& snapshot)
+{
+    if (snapshot.keyframe == nullptr)
+        return std::make_shared<const SnapshotState>();
+    if (snapshot.isKeyframe)
+        return snapshot.keyframe;
 
-            switch (sprite.base.Type)
+    auto state = std::make_shared<SnapshotState>();
+    for (size_t i = 0; i < state->size(); i++)
+    {
+        const auto& keyframeSection = (*snapshot.keyframe)[i];
+        const auto& deltaSection = snapshot.delta[i];
+        auto& section = (*state)[i];
+        section.Records.reserve(deltaSection.Records.size());
+        for (const auto& record : deltaSection.Records)
+        {
+            if (!record.IsDelta)
             {
-                case EntityType::Vehicle:
-                    reinterpret_cast<Vehicle&>(sprite).Serialise(ds);
-                    break;
-                case EntityType::Guest:
-                    reinterpret_cast<Guest&>(sprite).Serialise(ds);
-                    break;
-                case EntityType::Staff:
-                    reinterpret_cast<Staff&>(sprite).Serialise(ds);
-                    break;
-                case EntityType::Litter:
-                    reinterpret_cast<Litter&>(sprite).Serialise(ds);
-                    break;
-                case EntityType::MoneyEffect:
-                    reinterpret_cast<MoneyEffect&>(sprite).Serialise(ds);
-                    break;
-                case EntityType::Balloon:
-                    reinterpret_cast<Balloon&>(sprite).Serialise(ds);
-                    break;
-                case EntityType::Duck:
-                    reinterpret_cast<Duck&>(sprite).Serialise(ds);
-                    break;
-                case EntityType::JumpingFountain:
-                    reinterpret_cast<JumpingFountain&>(sprite).Serialise(ds);
-                    break;
-                case EntityType::SteamParticle:
-                    reinterpret_cast<SteamParticle&>(sprite).Serialise(ds);
-                    break;
-                case EntityType::Null:
-                    break;
-                default:
-                    break;
+                section.Add(record.Id, deltaSection.GetData(record), record.Size);
+                continue;
             }
+
+            const auto* keyframeRecord = keyframeSection.Find(record.Id);
+            auto offset = static_cast<uint32_t>(section.Data.size());
+            DecodeRecordDelta(
+                keyframeSection.GetData(*keyframeRecord), keyframeRecord->Size, deltaSection.GetData(record), record.Size,
+                section.Data);
+            section.Records.push_back({ record.Id, offset, keyframeRecord->Size, false });
         }
     }
-};
+    return state;
+}
+
+static void WriteSection(OpenRCT2::MemoryStream& stream, const SnapshotSection& section)
+{
+    DataSerialiser ds(true, stream);
+    uint32_t numRecords = static_cast<uint32_t>(section.Records.size());
+    ds << numRecords;
+    for (const auto& record : section.Records)
+    {
+        uint32_t id = record.Id;
+        uint32_t size = record.Size;
+        ds << id;
+        ds << size;
+        stream.Write(section.GetData(record), size);
+    }
+}
+
+static void ReadSection(OpenRCT2::MemoryStream& stream, SnapshotSection& section)
+{
+    DataSerialiser ds(false, stream);
+    uint32_t numRecords = 0;
+    ds << numRecords;
+    for (uint32_t i = 0; i < numRecords; i++)
+    {
+        uint32_t id = 0;
+        uint32_t size = 0;
+        ds << id;
+        ds << size;
+        if (size > stream.GetLength() - stream.GetPosition())
+            throw std::runtime_error("Snapshot section corrupted");
+
+        section.Add(id, static_cast<const uint8_t*>(stream.GetData()) + stream.GetPosition(), size);
+        stream.SetPosition(stream.GetPosition() + size);
+    }
+}
+
+/*
+ * Writes the state in the format of older versions, the entities preceded by their count and sizes. The tiles and rides
+ * follow the entities, older versions stop reading before them.
+ */
+static void WriteState(OpenRCT2::MemoryStream& stream, const SnapshotState& state, bool hasTilesAndRides)
+{
+    const auto& entities = state[EnumValue(SnapshotSectionType::Entities)];
+
+    DataSerialiser ds(true, stream);
+    EntitiesSizeCheck<Vehicle, Guest, Staff, Litter, MoneyEffect, Balloon, Duck, JumpingFountain, SteamParticle>(ds);
+    uint32_t numSavedSprites = static_cast<uint32_t>(entities.Records.size());
+    ds << numSavedSprites;
+    stream.Write(entities.Data.data(), entities.Data.size());
+
+    if (hasTilesAndRides)
+    {
+        WriteSection(stream, state[EnumValue(SnapshotSectionType::Tiles)]);
+        WriteSection(stream, state[EnumValue(SnapshotSectionType::Rides)]);
+    }
+}
+
+// Returns whether the stream contained tiles and rides.
+static bool ReadState(OpenRCT2::MemoryStream& stream, SnapshotState& state)
+{
+    auto& entities = state[EnumValue(SnapshotSectionType::Entities)];
+
+    stream.SetPosition(0);
+    DataSerialiser ds(false, stream);
+
+    // Encodes and checks the size of each of the entity so that we
+    // can fail gracefully when fields added/removed
+    if (!EntitiesSizeCheck<Vehicle, Guest, Staff, Litter, MoneyEffect, Balloon, Duck, JumpingFountain, SteamParticle>(ds))
+    {
+        log_error("Entity index corrupted!");
+        return false;
+    }
+
+    uint32_t numSavedSprites = 0;
+    ds << numSavedSprites;
+
+    EntitySnapshot sprite;
+    for (uint32_t i = 0; i < numSavedSprites; i++)
+    {
+        auto offset = stream.GetPosition();
+        uint32_t spriteIdx = 0;
+        ds << spriteIdx;
+        if (spriteIdx >= MAX_ENTITIES)
+        {
+            log_error("Entity index corrupted!");
+            return false;
+        }
+        ds << sprite.base.Type;
+        SerialiseEntity(ds, sprite);
+        entities.Add(
+            spriteIdx, static_cast<const uint8_t*>(stream.GetData()) + offset,
+            static_cast<size_t>(stream.GetPosition() - offset));
+    }
+
+    if (stream.GetPosition() >= stream.GetLength())
+        return false;
+
+    ReadSection(stream, state[EnumValue(SnapshotSectionType::Tiles)]);
+    ReadSection(stream, state[EnumValue(SnapshotSectionType::Rides)]);
+    return true;
+}
 
 struct GameStateSnapshots final : public IGameStateSnapshots
 {
     virtual void Reset() override final
     {
         _snapshots.clear();
+        _keyframe = nullptr;
+        _numCapturesSinceKeyframe = 0;
     }
 
     virtual GameStateSnapshot_t& CreateSnapshot() override final
@@ -183,10 +552,27 @@ struct GameStateSnapshots final : public IGameStateSnapshots
 
     virtual void Capture(GameStateSnapshot_t& snapshot) override final
     {
-        snapshot.SerialiseSprites(
-            [](const size_t index) { return reinterpret_cast<EntitySnapshot*>(GetEntity(index)); }, MAX_ENTITIES, true);
+        SnapshotState state;
+        state[EnumValue(SnapshotSectionType::Entities)] = CaptureEntities();
+        state[EnumValue(SnapshotSectionType::Tiles)] = CaptureTiles();
+        state[EnumValue(SnapshotSectionType::Rides)] = CaptureRides();
 
-        // log_info("Snapshot size: %u bytes", static_cast<uint32_t>(snapshot.storedSprites.GetLength()));
+        snapshot.hasTilesAndRides = true;
+        if (_keyframe == nullptr || _numCapturesSinceKeyframe >= SnapshotKeyframeInterval)
+        {
+            _keyframe = std::make_shared<const SnapshotState>(std::move(state));
+            _numCapturesSinceKeyframe = 0;
+            snapshot.keyframe = _keyframe;
+            snapshot.isKeyframe = true;
+            snapshot.delta = {};
+        }
+        else
+        {
+            snapshot.keyframe = _keyframe;
+            snapshot.isKeyframe = false;
+            snapshot.delta = EncodeStateDelta(*_keyframe, state);
+        }
+        _numCapturesSinceKeyframe++;
     }
 
     virtual const GameStateSnapshot_t* GetLinkedSnapshot(uint32_t tick) const override final
@@ -203,11 +589,28 @@ struct GameStateSnapshots final : public IGameStateSnapshots
     {
         ds << snapshot.tick;
         ds << snapshot.srand0;
-        ds << snapshot.storedSprites;
-        ds << snapshot.parkParameters;
+
+        OpenRCT2::MemoryStream storedState;
+        if (ds.IsSaving())
+        {
+            WriteState(storedState, *Materialise(snapshot), snapshot.hasTilesAndRides);
+            ds << storedState;
+            ds << snapshot.parkParameters;
+        }
+        else
+        {
+            ds << storedState;
+            ds << snapshot.parkParameters;
+
+            auto state = std::make_shared<SnapshotState>();
+            snapshot.hasTilesAndRides = ReadState(storedState, *state);
+            snapshot.keyframe = std::move(state);
+            snapshot.isKeyframe = true;
+            snapshot.delta = {};
+        }
     }
 
-    std::vector<EntitySnapshot> BuildSpriteList(GameStateSnapshot_t& snapshot) const
+    std::vector<EntitySnapshot> BuildSpriteList(const SnapshotSection& entities) const
     {
         std::vector<EntitySnapshot> spriteList;
         spriteList.resize(MAX_ENTITIES);
@@ -218,7 +621,18 @@ struct GameStateSnapshots final : public IGameStateSnapshots
             sprite.base.Type = EntityType::Null;
         }
 
-        snapshot.SerialiseSprites([&spriteList](const size_t index) { return &spriteList[index]; }, MAX_ENTITIES, false);
+        OpenRCT2::MemoryStream stream(entities.Data.data(), entities.Data.size());
+        DataSerialiser ds(false, stream);
+        for (const auto& record : entities.Records)
+        {
+            auto& sprite = spriteList[record.Id];
+            stream.SetPosition(record.Offset);
+
+            uint32_t spriteIdx = 0;
+            ds << spriteIdx;
+            ds << sprite.base.Type;
+            SerialiseEntity(ds, sprite);
+        }
 
         return spriteList;
     }
@@ -624,6 +1038,124 @@ struct GameStateSnapshots final : public IGameStateSnapshots
         }
     }
 
+    void CompareRideData(const RideSnapshot& spriteBase, const RideSnapshot& spriteCmp, GameStateRideChange_t& changeData) const
+    {
+        COMPARE_FIELD(RideSnapshot, type);
+        COMPARE_FIELD(RideSnapshot, status);
+        COMPARE_FIELD(RideSnapshot, mode);
+        COMPARE_FIELD(RideSnapshot, num_vehicles);
+        COMPARE_FIELD(RideSnapshot, num_cars_per_train);
+        COMPARE_FIELD(RideSnapshot, ratings.Excitement);
+        COMPARE_FIELD(RideSnapshot, ratings.Intensity);
+        COMPARE_FIELD(RideSnapshot, ratings.Nausea);
+        COMPARE_FIELD(RideSnapshot, value);
+        for (size_t i = 0; i < std::size(spriteBase.price); i++)
+        {
+            COMPARE_FIELD(RideSnapshot, price[i]);
+        }
+        COMPARE_FIELD(RideSnapshot, cur_num_customers);
+        COMPARE_FIELD(RideSnapshot, total_customers);
+        COMPARE_FIELD(RideSnapshot, total_profit);
+        COMPARE_FIELD(RideSnapshot, income_per_hour);
+        COMPARE_FIELD(RideSnapshot, profit);
+        COMPARE_FIELD(RideSnapshot, popularity);
+        COMPARE_FIELD(RideSnapshot, satisfaction);
+        COMPARE_FIELD(RideSnapshot, reliability);
+        COMPARE_FIELD(RideSnapshot, breakdown_reason);
+        COMPARE_FIELD(RideSnapshot, mechanic_status);
+        COMPARE_FIELD(RideSnapshot, mechanic);
+        COMPARE_FIELD(RideSnapshot, downtime);
+    }
+
+    void CompareRides(const SnapshotSection& ridesBase, const SnapshotSection& ridesCmp, GameStateCompareData_t& res) const
+    {
+        for (const auto& recordBase : ridesBase.Records)
+        {
+            GameStateRideChange_t changeData;
+            changeData.rideIndex = recordBase.Id;
+
+            const auto* recordCmp = ridesCmp.Find(recordBase.Id);
+            if (recordCmp == nullptr)
+            {
+                changeData.changeType = GameStateSpriteChange_t::REMOVED;
+                res.rideChanges.push_back(std::move(changeData));
+                continue;
+            }
+
+            RideSnapshot rideBase;
+            RideSnapshot rideCmp;
+            std::memcpy(&rideBase, ridesBase.GetData(recordBase), sizeof(rideBase));
+            std::memcpy(&rideCmp, ridesCmp.GetData(*recordCmp), sizeof(rideCmp));
+            CompareRideData(rideBase, rideCmp, changeData);
+            if (!changeData.diffs.empty())
+            {
+                changeData.changeType = GameStateSpriteChange_t::MODIFIED;
+                res.rideChanges.push_back(std::move(changeData));
+            }
+        }
+
+        for (const auto& recordCmp : ridesCmp.Records)
+        {
+            if (ridesBase.Find(recordCmp.Id) == nullptr)
+            {
+                GameStateRideChange_t changeData;
+                changeData.changeType = GameStateSpriteChange_t::ADDED;
+                changeData.rideIndex = recordCmp.Id;
+                res.rideChanges.push_back(std::move(changeData));
+            }
+        }
+    }
+
+    void CompareTiles(const SnapshotSection& tilesBase, const SnapshotSection& tilesCmp, GameStateCompareData_t& res) const
+    {
+        for (const auto& rowBase : tilesBase.Records)
+        {
+            const auto* rowCmp = tilesCmp.Find(rowBase.Id);
+            if (rowCmp == nullptr)
+                continue;
+
+            const auto* dataBase = tilesBase.GetData(rowBase);
+            const auto* dataCmp = tilesCmp.GetData(*rowCmp);
+            if (rowBase.Size == rowCmp->Size && std::memcmp(dataBase, dataCmp, rowBase.Size) == 0)
+                continue;
+
+            size_t posBase = 0;
+            size_t posCmp = 0;
+            for (int32_t x = 0; posBase < rowBase.Size && posCmp < rowCmp->Size; x++)
+            {
+                uint16_t numElementsBase;
+                uint16_t numElementsCmp;
+                std::memcpy(&numElementsBase, dataBase + posBase, sizeof(numElementsBase));
+                std::memcpy(&numElementsCmp, dataCmp + posCmp, sizeof(numElementsCmp));
+                posBase += sizeof(numElementsBase);
+                posCmp += sizeof(numElementsCmp);
+
+                GameStateTileChange_t changeData;
+                changeData.x = x;
+                changeData.y = static_cast<int32_t>(rowBase.Id);
+                changeData.numElementsLeft = numElementsBase;
+                changeData.numElementsRight = numElementsCmp;
+                changeData.elementIndex = std::min(numElementsBase, numElementsCmp);
+                for (uint32_t i = 0; i < changeData.elementIndex; i++)
+                {
+                    auto offset = i * sizeof(TileElement);
+                    if (std::memcmp(dataBase + posBase + offset, dataCmp + posCmp + offset, sizeof(TileElement)) != 0)
+                    {
+                        changeData.elementIndex = i;
+                        break;
+                    }
+                }
+                if (numElementsBase != numElementsCmp || changeData.elementIndex < numElementsBase)
+                {
+                    res.tileChanges.push_back(changeData);
+                }
+
+                posBase += numElementsBase * sizeof(TileElement);
+                posCmp += numElementsCmp * sizeof(TileElement);
+            }
+        }
+    }
+
     virtual GameStateCompareData_t Compare(const GameStateSnapshot_t& base, const GameStateSnapshot_t& cmp) const override final
     {
         GameStateCompareData_t res;
@@ -632,8 +1164,11 @@ struct GameStateSnapshots final : public IGameStateSnapshots
         res.srand0Left = base.srand0;
         res.srand0Right = cmp.srand0;
 
-        std::vector<EntitySnapshot> spritesBase = BuildSpriteList(const_cast<GameStateSnapshot_t&>(base));
-        std::vector<EntitySnapshot> spritesCmp = BuildSpriteList(const_cast<GameStateSnapshot_t&>(cmp));
+        auto stateBase = Materialise(base);
+        auto stateCmp = Materialise(cmp);
+
+        std::vector<EntitySnapshot> spritesBase = BuildSpriteList((*stateBase)[EnumValue(SnapshotSectionType::Entities)]);
+        std::vector<EntitySnapshot> spritesCmp = BuildSpriteList((*stateCmp)[EnumValue(SnapshotSectionType::Entities)]);
 
         for (uint32_t i = 0; i < static_cast<uint32_t>(spritesBase.size()); i++)
         {
@@ -678,6 +1213,15 @@ struct GameStateSnapshots final : public IGameStateSnapshots
             res.spriteChanges.push_back(std::move(changeData));
         }
 
+        // Snapshots from older versions can only be compared by their entities.
+        if (base.hasTilesAndRides && cmp.hasTilesAndRides)
+        {
+            CompareTiles(
+                (*stateBase)[EnumValue(SnapshotSectionType::Tiles)], (*stateCmp)[EnumValue(SnapshotSectionType::Tiles)], res);
+            CompareRides(
+                (*stateBase)[EnumValue(SnapshotSectionType::Rides)], (*stateCmp)[EnumValue(SnapshotSectionType::Rides)], res);
+        }
+
         return res;
     }
 
@@ -719,6 +1263,19 @@ struct GameStateSnapshots final : public IGameStateSnapshots
         return "Unknown";
     }
 
+    static void AppendDiffsText(std::string& outputBuffer, const std::vector<GameStateSpriteChange_t::Diff_t>& diffs)
+    {
+        char tempBuffer[1024] = {};
+        for (auto& diff : diffs)
+        {
+            snprintf(
+                tempBuffer, sizeof(tempBuffer), "  %s::%s, len = %u, offset = %u, left = 0x%.16llX, right = 0x%.16llX\n",
+                diff.structname, diff.fieldname, static_cast<uint32_t>(diff.length), static_cast<uint32_t>(diff.offset),
+                static_cast<unsigned long long>(diff.valueA), static_cast<unsigned long long>(diff.valueB));
+            outputBuffer += tempBuffer;
+        }
+    }
+
     virtual std::string GetCompareDataText(const GameStateCompareData_t& cmpData) const override
     {
         std::string outputBuffer;
@@ -760,15 +1317,36 @@ struct GameStateSnapshots final : public IGameStateSnapshots
                 snprintf(
                     tempBuffer, sizeof(tempBuffer), "Sprite modifications (%s), index: %u\n", typeName, change.spriteIndex);
                 outputBuffer += tempBuffer;
-                for (auto& diff : change.diffs)
-                {
-                    snprintf(
-                        tempBuffer, sizeof(tempBuffer),
-                        "  %s::%s, len = %u, offset = %u, left = 0x%.16llX, right = 0x%.16llX\n", diff.structname,
-                        diff.fieldname, static_cast<uint32_t>(diff.length), static_cast<uint32_t>(diff.offset),
-                        static_cast<unsigned long long>(diff.valueA), static_cast<unsigned long long>(diff.valueB));
-                    outputBuffer += tempBuffer;
-                }
+                AppendDiffsText(outputBuffer, change.diffs);
+            }
+        }
+
+        for (auto& change : cmpData.tileChanges)
+        {
+            snprintf(
+                tempBuffer, sizeof(tempBuffer),
+                "Tile modifications, x: %d, y: %d, elements left: %u, elements right: %u, first difference: %u\n", change.x,
+                change.y, change.numElementsLeft, change.numElementsRight, change.elementIndex);
+            outputBuffer += tempBuffer;
+        }
+
+        for (auto& change : cmpData.rideChanges)
+        {
+            if (change.changeType == GameStateSpriteChange_t::ADDED)
+            {
+                snprintf(tempBuffer, sizeof(tempBuffer), "Ride added, index: %u\n", change.rideIndex);
+                outputBuffer += tempBuffer;
+            }
+            else if (change.changeType == GameStateSpriteChange_t::REMOVED)
+            {
+                snprintf(tempBuffer, sizeof(tempBuffer), "Ride removed, index: %u\n", change.rideIndex);
+                outputBuffer += tempBuffer;
+            }
+            else if (change.changeType == GameStateSpriteChange_t::MODIFIED)
+            {
+                snprintf(tempBuffer, sizeof(tempBuffer), "Ride modifications, index: %u\n", change.rideIndex);
+                outputBuffer += tempBuffer;
+                AppendDiffsText(outputBuffer, change.diffs);
             }
         }
         return outputBuffer;
@@ -790,6 +1368,8 @@ struct GameStateSnapshots final : public IGameStateSnapshots
 
 private:
     CircularBuffer<std::unique_ptr<GameStateSnapshot_t>, MaximumGameStateSnapshots> _snapshots;
+    std::shared_ptr<const SnapshotState> _keyframe;
+    size_t _numCapturesSinceKeyframe = 0;
 };
 
 std::unique_ptr<IGameStateSnapshots> CreateGameStateSnapshots()
@@ -45,6 +45,24 @@ struct GameStateSpriteChange_t
     std::vector<Diff_t> diffs;
 };
 
+struct GameStateTileChange_t
+{
+    int32_t x;
+    int32_t y;
+    uint32_t numElementsLeft;
+    uint32_t numElementsRight;
+    // Index of the first element that differs, or the number of elements both tiles have when one has more.
+    uint32_t elementIndex;
+};
+
+struct GameStateRideChange_t
+{
+    uint8_t changeType;
+    uint32_t rideIndex;
+
+    std::vector<GameStateSpriteChange_t::Diff_t> diffs;
+};
+
 struct GameStateCompareData_t
 {
     uint32_t tickLeft;
@@ -52,6 +70,9 @@ struct GameStateCompareData_t
     uint32_t srand0Left;
     uint32_t srand0Right;
     std::vector<GameStateSpriteChange_t> spriteChanges;
+    // Unlike spriteChanges these only contain what differs.
+    std::vector<GameStateTileChange_t> tileChanges;
+    std::vector<GameStateRideChange_t> rideChanges;
 };
 
 /*
@@ -80,7 +101,8 @@ struct IGameStateSnapshots
     virtual void LinkSnapshot(GameStateSnapshot_t& snapshot, uint32_t tick, uint32_t srand0) = 0;
 
     /*
-     * This will fill the snapshot with the current game state in a compact form.
+     * This will fill the snapshot with the current game state in a compact form, either in full as a keyframe or as
+     * the changes since the last keyframe.
      */
     virtual void Capture(GameStateSnapshot_t& snapshot) = 0;
 
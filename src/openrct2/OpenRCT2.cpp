@@ -17,6 +17,7 @@ utf8 gCustomRCT1DataPath[MAX_PATH] = { 0 };
 utf8 gCustomRCT2DataPath[MAX_PATH] = { 0 };
 utf8 gCustomPassword[MAX_PATH] = { 0 };
 utf8 gSilentRecordingName[MAX_PATH] = { 0 };
+utf8 gTraceOutputPath[MAX_PATH] = { 0 };
 
 bool gOpenRCT2Headless = false;
 bool gOpenRCT2NoGraphics = false;
@@ -11,6 +11,7 @@
 
 #include "Context.h"
 #include "Game.h"
+#include "GameState.h"
 #include "GameStateSnapshots.h"
 #include "OpenRCT2.h"
 #include "ParkImporter.h"
@@ -31,10 +32,12 @@
 #include "object/ObjectManager.h"
 #include "object/ObjectRepository.h"
 #include "park/ParkFile.h"
+#include "park/ParkSaveWorker.h"
 #include "scenario/Scenario.h"
 #include "world/Park.h"
 #include "zlib.h"
 
+#include <algorithm>
 #include <chrono>
 #include <memory>
 #include <vector>
@@ -78,6 +81,14 @@ namespace OpenRCT2
         OpenRCT2::MemoryStream data;
     };
 
+    // The park as it was at the start of a tick, before the commands of that tick were replayed.
+    struct ReplayKeyframe
+    {
+        uint32_t tick;
+        OpenRCT2::MemoryStream parkData;
+        OpenRCT2::MemoryStream parkParams;
+    };
+
     struct ReplayRecordData
     {
         uint32_t magic;
@@ -95,15 +106,19 @@ namespace OpenRCT2
         std::vector<std::pair<uint32_t, EntitiesChecksum>> checksums;
         uint32_t checksumIndex;
         OpenRCT2::MemoryStream gameStateSnapshots;
+        std::vector<ReplayKeyframe> keyframes;
     };
 
     class ReplayManager final : public IReplayManager
     {
-        static constexpr uint16_t ReplayVersion = 10;
+        static constexpr uint16_t ReplayVersion = 11;
+        static constexpr uint16_t ReplayMinimumVersion = 10;
+        static constexpr uint16_t ReplayKeyframesVersion = 11;
         static constexpr uint32_t ReplayMagic = 0x5243524F; // ORCR.
         static constexpr int ReplayCompressionLevel = 9;
         static constexpr int NormalRecordingChecksumTicks = 1;
         static constexpr int SilentRecordingChecksumTicks = 40; // Same as network server
+        static constexpr uint32_t KeyframeTicks = k_ReplayKeyframeTicks;
 
         enum class ReplayMode
         {
@@ -116,6 +131,9 @@ namespace OpenRCT2
     public:
         virtual ~ReplayManager()
         {
+            // A keyframe that is still being encoded refers to the recording.
+            if (_currentRecording != nullptr)
+                ParkSaveWorker::Flush();
         }
 
         virtual bool IsReplaying() const override
@@ -208,6 +226,44 @@ namespace OpenRCT2
             }
         }
 
+        // Function runs after each Tick, once gCurrentTicks has advanced.
+        virtual void PostUpdate() override
+        {
+            // The keyframe holds everything up to its tick but none of the commands recorded for it, those
+            // are executed before or during the tick and get replayed after loading the keyframe.
+            if ((_mode == ReplayMode::RECORDING || _mode == ReplayMode::NORMALISATION) && gCurrentTicks == _nextKeyframeTick)
+            {
+                AddKeyframe();
+                _nextKeyframeTick = gCurrentTicks + KeyframeTicks;
+            }
+        }
+
+        void AddKeyframe()
+        {
+            auto keyframe = std::make_shared<ReplayKeyframe>();
+            keyframe->tick = gCurrentTicks;
+            DataSerialiser parkParamsDs(true, keyframe->parkParams);
+            SerialiseParkParameters(parkParamsDs);
+
+            auto& objManager = GetContext()->GetObjectManager();
+            ParkFileExporter exporter;
+            exporter.ExportObjectsList = objManager.GetPackableObjects();
+
+            // The park is encoded in the background, recordings wait for it before they are written.
+            auto* recording = _currentRecording.get();
+            auto onComplete = [this, recording, keyframe](ParkSaveWorker::Result& result) {
+                if (!result.Success || _currentRecording.get() != recording)
+                    return;
+
+                keyframe->parkData.Write(result.Data.data(), result.Data.size());
+                recording->keyframes.push_back(std::move(*keyframe));
+            };
+            if (!ParkSaveWorker::Start("Replay keyframe", exporter, nullptr, onComplete))
+            {
+                log_warning("Unable to add replay keyframe at tick %u", gCurrentTicks);
+            }
+        }
+
         void TakeGameStateSnapshot(MemoryStream& snapshotStream)
         {
             IGameStateSnapshots* snapshots = GetContext()->GetGameStateSnapshots();
@@ -267,6 +323,7 @@ namespace OpenRCT2
             _currentRecording = std::move(replayData);
             _recordType = rt;
             _nextChecksumTick = gCurrentTicks + 1;
+            _nextKeyframeTick = gCurrentTicks + KeyframeTicks;
 
             return true;
         }
@@ -276,6 +333,9 @@ namespace OpenRCT2
             if (_mode != ReplayMode::RECORDING && _mode != ReplayMode::NORMALISATION)
                 return false;
 
+            // Completes the keyframe still being encoded.
+            ParkSaveWorker::Flush();
+
             if (discard)
             {
                 _currentRecording.reset();
@@ -371,6 +431,7 @@ namespace OpenRCT2
                 info.Ticks = data->tickEnd - data->tickStart;
             info.NumCommands = static_cast<uint32_t>(data->commands.size());
             info.NumChecksums = static_cast<uint32_t>(data->checksums.size());
+            info.NumKeyframes = static_cast<uint32_t>(data->keyframes.size());
 
             return true;
         }
@@ -397,7 +458,7 @@ namespace OpenRCT2
                     [](const GameStateSpriteChange_t& diff) { return diff.changeType != GameStateSpriteChange_t::EQUAL; });
 
                 // If there are difference write a log to the desyncs folder
-                if (res != cmpData.spriteChanges.end())
+                if (res != cmpData.spriteChanges.end() || !cmpData.tileChanges.empty() || !cmpData.rideChanges.empty())
                 {
                     std::string outputPath = GetContext()->GetPlatformEnvironment()->GetDirectoryPath(
                         DIRBASE::USER, DIRID::LOG_DESYNCS);
@@ -427,7 +488,7 @@ namespace OpenRCT2
                 return false;
             }
 
-            if (!LoadReplayDataMap(*replayData))
+            if (!LoadReplayDataMap(replayData->parkData, replayData->parkParams))
             {
                 log_error("Unable to load map.");
                 return false;
@@ -455,6 +516,53 @@ namespace OpenRCT2
             return _faultyChecksumIndex != -1;
         }
 
+        virtual bool SeekPlayback(uint32_t replayTick) override
+        {
+            if (_mode != ReplayMode::PLAYING)
+                return false;
+
+            uint32_t targetTick = std::min(_currentReplay->tickStart + replayTick, _currentReplay->tickEnd);
+            if (targetTick < gCurrentTicks)
+            {
+                // The commands replayed so far are gone, start over from the file.
+                auto replayData = std::make_unique<ReplayRecordData>();
+                if (!ReadReplayData(_currentReplay->filePath, *replayData))
+                {
+                    log_error("Unable to read replay data.");
+                    return false;
+                }
+
+                if (!LoadReplayDataMap(replayData->parkData, replayData->parkParams))
+                {
+                    log_error("Unable to load map.");
+                    return false;
+                }
+
+                gCurrentTicks = replayData->tickStart;
+
+                LoadAndCompareSnapshot(replayData->gameStateSnapshots);
+
+                _currentReplay = std::move(replayData);
+                _currentReplay->checksumIndex = 0;
+                _faultyChecksumIndex = -1;
+            }
+
+            auto* keyframe = FindKeyframe(*_currentReplay, targetTick);
+            if (keyframe != nullptr && keyframe->tick > gCurrentTicks)
+            {
+                if (!LoadKeyframe(*_currentReplay, *keyframe))
+                    return false;
+            }
+
+            // Playback stops by itself once the target is the end of the replay.
+            auto* gameState = GetContext()->GetGameState();
+            while (_mode == ReplayMode::PLAYING && gCurrentTicks < targetTick)
+            {
+                gameState->UpdateLogic();
+            }
+            return true;
+        }
+
         virtual bool StopPlayback() override
         {
             if (_mode != ReplayMode::PLAYING && _mode != ReplayMode::NORMALISATION)
@@ -513,17 +621,18 @@ namespace OpenRCT2
             }
         }
 
-        bool LoadReplayDataMap(ReplayRecordData& data)
+        bool LoadReplayDataMap(MemoryStream& parkData, MemoryStream& parkParams)
         {
             try
             {
-                data.parkData.SetPosition(0);
+                parkData.SetPosition(0);
+                parkParams.SetPosition(0);
 
                 auto context = GetContext();
                 auto& objManager = context->GetObjectManager();
                 auto importer = ParkImporter::CreateParkFile(context->GetObjectRepository());
 
-                auto loadResult = importer->LoadFromStream(&data.parkData, false);
+                auto loadResult = importer->LoadFromStream(&parkData, false);
                 objManager.LoadObjects(loadResult.RequiredObjects);
 
                 importer->Import();
@@ -531,7 +640,7 @@ namespace OpenRCT2
                 EntityTweener::Get().Reset();
 
                 // Load all map global variables.
-                DataSerialiser parkParamsDs(false, data.parkParams);
+                DataSerialiser parkParamsDs(false, parkParams);
                 SerialiseParkParameters(parkParamsDs);
 
                 game_load_init();
@@ -545,6 +654,38 @@ namespace OpenRCT2
             return true;
         }
 
+        ReplayKeyframe* FindKeyframe(ReplayRecordData& data, uint32_t tick) const
+        {
+            auto it = std::upper_bound(
+                data.keyframes.begin(), data.keyframes.end(), tick,
+                [](uint32_t value, const ReplayKeyframe& keyframe) { return value < keyframe.tick; });
+            if (it == data.keyframes.begin())
+                return nullptr;
+            return &*std::prev(it);
+        }
+
+        bool LoadKeyframe(ReplayRecordData& data, ReplayKeyframe& keyframe)
+        {
+            if (!LoadReplayDataMap(keyframe.parkData, keyframe.parkParams))
+            {
+                log_error("Unable to load replay keyframe at tick %u.", keyframe.tick);
+                return false;
+            }
+
+            gCurrentTicks = keyframe.tick;
+
+            // The keyframe already contains what the commands before its tick did.
+            ReplayCommand firstCommand;
+            firstCommand.tick = keyframe.tick;
+            data.commands.erase(data.commands.begin(), data.commands.lower_bound(firstCommand));
+
+            auto checksum = std::lower_bound(
+                data.checksums.begin(), data.checksums.end(), keyframe.tick,
+                [](const std::pair<uint32_t, EntitiesChecksum>& entry, uint32_t tick) { return entry.first < tick; });
+            data.checksumIndex = static_cast<uint32_t>(std::distance(data.checksums.begin(), checksum));
+            return true;
+        }
+
         bool ReadReplayFromFile(const std::string& file, MemoryStream& stream)
         {
             FILE* fp = fopen(file.c_str(), "rb");
@@ -704,7 +845,7 @@ namespace OpenRCT2
 
         bool Compatible(ReplayRecordData& data)
         {
-            return data.version == ReplayVersion;
+            return data.version >= ReplayMinimumVersion && data.version <= ReplayVersion;
         }
 
         bool Serialise(DataSerialiser& serialiser, ReplayRecordData& data)
@@ -777,6 +918,24 @@ namespace OpenRCT2
             }
 
             serialiser << data.gameStateSnapshots;
+
+            if (data.version >= ReplayKeyframesVersion)
+            {
+                uint32_t countKeyframes = static_cast<uint32_t>(data.keyframes.size());
+                serialiser << countKeyframes;
+
+                if (serialiser.IsLoading())
+                {
+                    data.keyframes.resize(countKeyframes);
+                }
+
+                for (auto& keyframe : data.keyframes)
+                {
+                    serialiser << keyframe.tick;
+                    serialiser << keyframe.parkData;
+                    serialiser << keyframe.parkParams;
+                }
+            }
             return true;
         }
 
@@ -869,6 +1028,7 @@ namespace OpenRCT2
         int32_t _faultyChecksumIndex = -1;
         uint32_t _commandId = 0;
         uint32_t _nextChecksumTick = 0;
+        uint32_t _nextKeyframeTick = 0;
         uint32_t _nextReplayTick = 0;
         RecordType _recordType = RecordType::NORMAL;
     };
@@ -20,6 +20,7 @@ class GameAction;
 namespace OpenRCT2
 {
     static constexpr uint32_t k_MaxReplayTicks = 0xFFFFFFFF;
+    static constexpr uint32_t k_ReplayKeyframeTicks = 40 * 60 * 5; // Five minutes of game time.
 
     struct ReplayRecordInfo
     {
@@ -28,6 +29,7 @@ namespace OpenRCT2
         uint64_t TimeRecorded;
         uint32_t NumCommands;
         uint32_t NumChecksums;
+        uint32_t NumKeyframes;
         std::string Name;
         std::string FilePath;
     };
@@ -44,6 +46,7 @@ namespace OpenRCT2
         virtual ~IReplayManager() = default;
 
         virtual void Update() = 0;
+        virtual void PostUpdate() = 0;
 
         virtual bool IsReplaying() const = 0;
         virtual bool IsRecording() const = 0;
@@ -60,6 +63,8 @@ namespace OpenRCT2
 
         virtual bool StartPlayback(const std::string& file) = 0;
         virtual bool IsPlaybackStateMismatching() const = 0;
+        // Jumps to the nearest keyframe before the tick and simulates the ticks after it without rendering.
+        virtual bool SeekPlayback(uint32_t replayTick) = 0;
         virtual bool StopPlayback() = 0;
 
         virtual bool NormaliseReplay(const std::string& inputFile, const std::string& outputFile) = 0;
@@ -15,6 +15,7 @@
 #include "../interface/Window.h"
 #include "../localisation/StringIds.h"
 #include "../management/Finance.h"
+#include "../peep/SurroundingsCache.h"
 #include "../ride/RideConstruction.h"
 #include "../world/ConstructionClearance.h"
 #include "../world/Footpath.h"
@@ -247,6 +248,7 @@ GameActions::Result FootpathPlaceAction::ElementUpdateExecute(PathElement* pathE
             {
                 pathElement->SetIsBroken(false);
                 pathElement->SetAddition(0);
+                SurroundingsCache::InvalidateTile(_loc);
             }
         }
         else
@@ -256,6 +258,7 @@ GameActions::Result FootpathPlaceAction::ElementUpdateExecute(PathElement* pathE
             {
                 pathElement->SetIsBroken(false);
                 pathElement->SetAddition(0);
+                SurroundingsCache::InvalidateTile(_loc);
             }
         }
     }
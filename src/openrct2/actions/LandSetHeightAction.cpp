@@ -264,7 +264,7 @@ void LandSetHeightAction::SmallSceneryRemoval() const
             continue;
         if (_height + 4 < tileElement->base_height)
             continue;
-        tile_element_remove(tileElement--);
+        tile_element_remove(_coords, tileElement--);
     } while (!(tileElement++)->IsLastForTile());
 }
 
@@ -92,6 +92,6 @@ void ParkEntranceRemoveAction::ParkEntranceRemoveSegment(const CoordsXYZ& loc) c
     }
 
     map_invalidate_tile({ loc, entranceElement->GetBaseZ(), entranceElement->GetClearanceZ() });
-    entranceElement->Remove();
+    tile_element_remove(loc, entranceElement->as<TileElement>());
     update_park_fences({ loc.x, loc.y });
 }
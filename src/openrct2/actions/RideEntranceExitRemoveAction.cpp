@@ -144,7 +144,7 @@ GameActions::Result RideEntranceExitRemoveAction::Execute() const
     maze_entrance_hedge_replacement({ _loc, entranceElement });
     footpath_remove_edges_at(_loc, entranceElement);
 
-    tile_element_remove(entranceElement);
+    tile_element_remove(_loc, entranceElement);
 
     if (_isExit)
     {
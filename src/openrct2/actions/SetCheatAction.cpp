@@ -21,6 +21,7 @@
 #include "../localisation/Localisation.h"
 #include "../localisation/StringIds.h"
 #include "../network/network.h"
+#include "../peep/SurroundingsCache.h"
 #include "../ride/Ride.h"
 #include "../ride/Vehicle.h"
 #include "../scenario/Scenario.h"
@@ -408,6 +409,8 @@ void SetCheatAction::FixVandalism() const
         it.element->AsPath()->SetIsBroken(false);
     } while (tile_element_iterator_next(&it));
 
+    OpenRCT2::SurroundingsCache::Reset();
+
     gfx_invalidate_screen();
 }
 
@@ -9,6 +9,7 @@
 
 #include "TileModifyAction.h"
 
+#include "../peep/PathGraph.h"
 #include "../world/TileInspector.h"
 
 using namespace OpenRCT2;
@@ -42,6 +43,8 @@ GameActions::Result TileModifyAction::Query() const
 
 GameActions::Result TileModifyAction::Execute() const
 {
+    // Tile inspector edits change heights, slopes, directions and the order of elements in place.
+    PathGraph::InvalidateTile(_loc);
     return QueryExecute(true);
 }
 
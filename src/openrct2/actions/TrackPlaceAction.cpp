@@ -11,6 +11,7 @@
 
 #include "../core/Numerics.hpp"
 #include "../management/Finance.h"
+#include "../peep/SurroundingsCache.h"
 #include "../ride/RideData.h"
 #include "../ride/Track.h"
 #include "../ride/TrackData.h"
@@ -266,6 +267,7 @@ GameActions::Result TrackPlaceAction::Query() const
             if (footpathElement != nullptr && footpathElement->AsPath()->HasAddition())
             {
                 footpathElement->AsPath()->SetAddition(0);
+                OpenRCT2::SurroundingsCache::InvalidateTile(mapLoc);
             }
         }
 
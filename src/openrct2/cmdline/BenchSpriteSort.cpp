@@ -32,6 +32,7 @@
 #    include <benchmark/benchmark.h>
 #    include <cstdint>
 #    include <iterator>
+#    include <string>
 #    include <vector>
 
 static void fixup_pointers(std::vector<RecordedPaintSession>& s)
@@ -42,14 +43,15 @@ static void fixup_pointers(std::vector<RecordedPaintSession>& s)
         auto& quadrants = s[i].Session.Quadrants;
         for (size_t j = 0; j < entries.size(); j++)
         {
-            if (entries[j].AsBasic()->next_quadrant_ps == reinterpret_cast<paint_struct*>(-1))
+            auto* ps = entries[j].GetBasic();
+            if (ps->next_quadrant_ps == reinterpret_cast<paint_struct*>(-1))
             {
-                entries[j].AsBasic()->next_quadrant_ps = nullptr;
+                ps->next_quadrant_ps = nullptr;
             }
             else
             {
-                auto nextQuadrantPs = reinterpret_cast<size_t>(entries[j].AsBasic()->next_quadrant_ps) / sizeof(paint_entry);
-                entries[j].AsBasic()->next_quadrant_ps = s[i].Entries[nextQuadrantPs].AsBasic();
+                auto nextQuadrantPs = reinterpret_cast<size_t>(ps->next_quadrant_ps) / sizeof(paint_entry);
+                ps->next_quadrant_ps = entries[nextQuadrantPs].GetBasic();
             }
         }
         for (size_t j = 0; j < std::size(quadrants); j++)
@@ -61,12 +63,42 @@ static void fixup_pointers(std::vector<RecordedPaintSession>& s)
             else
             {
                 auto ps = reinterpret_cast<size_t>(quadrants[j]) / sizeof(paint_entry);
-                quadrants[j] = entries[ps].AsBasic();
+                quadrants[j] = entries[ps].GetBasic();
             }
         }
     }
 }
 
+static std::vector<size_t> get_paint_order(const RecordedPaintSession& session)
+{
+    std::vector<size_t> order;
+    for (auto* ps = session.Session.PaintHead.next_quadrant_ps; ps != nullptr; ps = ps->next_quadrant_ps)
+    {
+        order.push_back(reinterpret_cast<const paint_entry*>(ps) - session.Entries.data());
+    }
+    return order;
+}
+
+// The timings of both algorithms are only comparable if they draw the structs in the same order.
+static bool verify_paint_order(const std::vector<RecordedPaintSession>& inputSessions)
+{
+    auto originalSessions = inputSessions;
+    auto spatialSessions = inputSessions;
+    fixup_pointers(originalSessions);
+    fixup_pointers(spatialSessions);
+    for (size_t i = 0; i < inputSessions.size(); i++)
+    {
+        PaintSessionArrange(originalSessions[i].Session, PaintSortAlgorithm::Original);
+        PaintSessionArrange(spatialSessions[i].Session, PaintSortAlgorithm::Spatial);
+        if (get_paint_order(originalSessions[i]) != get_paint_order(spatialSessions[i]))
+        {
+            log_error("Paint session %zu is sorted differently by the spatial algorithm.", i);
+            return false;
+        }
+    }
+    return true;
+}
+
 static std::vector<RecordedPaintSession> extract_paint_session(std::string_view parkFileName)
 {
     core_init();
@@ -136,7 +168,8 @@ static std::vector<RecordedPaintSession> extract_paint_session(std::string_view
 }
 
 // This function is based on benchgfx_render_screenshots
-static void BM_paint_session_arrange(benchmark::State& state, const std::vector<RecordedPaintSession> inputSessions)
+static void BM_paint_session_arrange(
+    benchmark::State& state, const std::vector<RecordedPaintSession> inputSessions, PaintSortAlgorithm algorithm)
 {
     auto sessions = inputSessions;
     // Fixing up the pointers continuously is wasteful. Fix it up once for `sessions` and store a copy.
@@ -150,7 +183,10 @@ static void BM_paint_session_arrange(benchmark::State& state, const std::vector<
         state.PauseTiming();
         std::copy_n(local_s, std::size(sessions), sessions.begin());
         state.ResumeTiming();
-        PaintSessionArrange(sessions[0].Session);
+        for (auto& session : sessions)
+        {
+            PaintSessionArrange(session.Session, algorithm);
+        }
         benchmark::DoNotOptimize(sessions);
     }
     state.SetItemsProcessed(state.iterations() * std::size(sessions));
@@ -170,7 +206,7 @@ static int cmdline_for_bench_sprite_sort(int argc, const char** argv)
         {
             quad = reinterpret_cast<paint_struct*>(-1);
         }
-        benchmark::RegisterBenchmark("baseline", BM_paint_session_arrange, sessions);
+        benchmark::RegisterBenchmark("baseline", BM_paint_session_arrange, sessions, PaintSortAlgorithm::Original);
     }
 
     // Google benchmark does stuff to argv. It doesn't modify the pointees,
@@ -188,7 +224,18 @@ static int cmdline_for_bench_sprite_sort(int argc, const char** argv)
             // Register benchmark for sv6 if valid
             std::vector<RecordedPaintSession> sessions = extract_paint_session(argv[i]);
             if (!sessions.empty())
-                benchmark::RegisterBenchmark(argv[i], BM_paint_session_arrange, sessions);
+            {
+                if (!verify_paint_order(sessions))
+                {
+                    log_error("The sort algorithms differ for '%s', their timings are not comparable.", argv[i]);
+                    return -1;
+                }
+                auto name = std::string(argv[i]);
+                benchmark::RegisterBenchmark(
+                    (name + "/original").c_str(), BM_paint_session_arrange, sessions, PaintSortAlgorithm::Original);
+                benchmark::RegisterBenchmark(
+                    (name + "/spatial").c_str(), BM_paint_session_arrange, sessions, PaintSortAlgorithm::Spatial);
+            }
         }
         else
         {
@@ -14,8 +14,11 @@
 #    include "../Context.h"
 #    include "../GameState.h"
 #    include "../OpenRCT2.h"
+#    include "../entity/EntityList.h"
+#    include "../entity/EntityRegistry.h"
 #    include "../platform/Platform2.h"
 #    include "../platform/platform.h"
+#    include "../ride/Vehicle.h"
 
 #    include <benchmark/benchmark.h>
 #    include <cstdint>
@@ -87,10 +90,80 @@ static void BM_update(benchmark::State& state, const std::string& filename)
     }
 }
 
+// Close to the entity limit, as in the largest parks.
+constexpr size_t BenchmarkEntityCount = 60000;
+
+static void CreateBenchmarkEntities()
+{
+    ResetAllEntities();
+    for (size_t i = 0; i < BenchmarkEntityCount; i++)
+    {
+        CreateEntity<Vehicle>();
+    }
+}
+
+static void BM_entity_list_create(benchmark::State& state)
+{
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        ResetAllEntities();
+        state.ResumeTiming();
+        for (size_t i = 0; i < BenchmarkEntityCount; i++)
+        {
+            benchmark::DoNotOptimize(CreateEntity<Vehicle>());
+        }
+    }
+    ResetAllEntities();
+    state.SetItemsProcessed(state.iterations() * BenchmarkEntityCount);
+}
+
+static void BM_entity_list_iterate(benchmark::State& state)
+{
+    CreateBenchmarkEntities();
+    for (auto _ : state)
+    {
+        size_t sum = 0;
+        for (auto* vehicle : EntityList<Vehicle>())
+        {
+            sum += vehicle->sprite_index;
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    ResetAllEntities();
+    state.SetItemsProcessed(state.iterations() * BenchmarkEntityCount);
+}
+
+static void BM_entity_list_remove(benchmark::State& state)
+{
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        CreateBenchmarkEntities();
+        state.ResumeTiming();
+
+        // Every other entity, in iteration order, like litter being swept up.
+        bool remove = false;
+        for (auto* vehicle : EntityList<Vehicle>())
+        {
+            if (remove)
+            {
+                EntityRemove(vehicle);
+            }
+            remove = !remove;
+        }
+    }
+    ResetAllEntities();
+    state.SetItemsProcessed(state.iterations() * BenchmarkEntityCount / 2);
+}
+
 static int CmdlineForBenchSpriteSort(int argc, const char* const* argv)
 {
     // Add a baseline test on an empty park
     benchmark::RegisterBenchmark("baseline", BM_update, std::string{});
+    benchmark::RegisterBenchmark("entity_list/create", BM_entity_list_create);
+    benchmark::RegisterBenchmark("entity_list/iterate", BM_entity_list_iterate);
+    benchmark::RegisterBenchmark("entity_list/remove_half", BM_entity_list_remove);
 
     // Google benchmark does stuff to argv. It doesn't modify the pointees,
     // but it wants to reorder the pointers, so present a copy of them.
@@ -10,6 +10,9 @@
 #pragma once
 
 #include "../common.h"
+#include "../core/JsonFwd.hpp"
+
+#include <string>
 
 /**
  * Class for enumerating and retrieving values for a set of command line arguments.
@@ -120,6 +123,7 @@ namespace CommandLine
     extern const CommandLineCommand BenchSpriteSortCommands[];
     extern const CommandLineCommand BenchUpdateCommands[];
     extern const CommandLineCommand SimulateCommands[];
+    extern const CommandLineCommand ReplayCommands[];
 
     extern const CommandLineExample RootExamples[];
 
@@ -128,4 +132,11 @@ namespace CommandLine
 
     exitcode_t HandleCommandConvert(CommandLineArgEnumerator* enumerator);
     exitcode_t HandleCommandUri(CommandLineArgEnumerator* enumerator);
+
+    /**
+     * Simulates a park in a context of its own and returns its results. The game state is global, so only one park can
+     * be simulated per process at a time. The peak memory of a process never goes down, parks that follow others in the
+     * same process report how much it rose above the peak before they were loaded instead.
+     */
+    json_t SimulatePark(const std::string& parkPath, uint32_t ticks, bool sharesProcess);
 } // namespace CommandLine
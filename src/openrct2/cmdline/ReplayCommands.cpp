@@ -0,0 +1,93 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2021 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "../Context.h"
+#include "../Game.h"
+#include "../GameState.h"
+#include "../OpenRCT2.h"
+#include "../ReplayManager.h"
+#include "../core/Console.hpp"
+#include "../entity/EntityRegistry.h"
+#include "../platform/platform.h"
+#include "CommandLine.hpp"
+
+#include <cstdlib>
+#include <memory>
+
+using namespace OpenRCT2;
+
+static exitcode_t HandleReplay(CommandLineArgEnumerator* argEnumerator);
+
+const CommandLineCommand CommandLine::ReplayCommands[]{ // Main commands
+                                                        DefineCommand("", "<replay-file> [tick]", nullptr, HandleReplay),
+                                                        CommandTableEnd
+};
+
+static exitcode_t HandleReplay(CommandLineArgEnumerator* argEnumerator)
+{
+    const char** argv = const_cast<const char**>(argEnumerator->GetArguments()) + argEnumerator->GetIndex();
+    int32_t argc = argEnumerator->GetCount() - argEnumerator->GetIndex();
+
+    if (argc < 1)
+    {
+        Console::Error::WriteLine("Missing arguments <replay-file> [tick].");
+        return EXITCODE_FAIL;
+    }
+
+    core_init();
+
+    const char* inputPath = argv[0];
+    uint32_t startTick = argc >= 2 ? atol(argv[1]) : 0;
+
+    gOpenRCT2Headless = true;
+    gOpenRCT2NoGraphics = true;
+
+    std::unique_ptr<IContext> context(CreateContext());
+    if (!context->Initialise())
+    {
+        Console::Error::WriteLine("Context initialization failed.");
+        return EXITCODE_FAIL;
+    }
+
+    auto* replayManager = context->GetReplayManager();
+    if (!replayManager->StartPlayback(inputPath))
+    {
+        Console::Error::WriteLine("Unable to start replay '%s'.", inputPath);
+        return EXITCODE_FAIL;
+    }
+
+    ReplayRecordInfo info;
+    replayManager->GetCurrentReplayInfo(info);
+    Console::WriteLine("Replay %s: %u ticks, %u keyframes", info.FilePath.c_str(), info.Ticks, info.NumKeyframes);
+
+    if (startTick != 0)
+    {
+        Console::WriteLine("Seeking to tick %u...", startTick);
+        if (!replayManager->SeekPlayback(startTick))
+        {
+            Console::Error::WriteLine("Unable to seek to tick %u.", startTick);
+            return EXITCODE_FAIL;
+        }
+    }
+
+    auto* gameState = context->GetGameState();
+    while (replayManager->IsReplaying() && !replayManager->IsPlaybackStateMismatching())
+    {
+        gameState->UpdateLogic();
+    }
+
+    if (replayManager->IsPlaybackStateMismatching())
+    {
+        Console::Error::WriteLine("Game state mismatch at tick %u.", gCurrentTicks);
+        return EXITCODE_FAIL;
+    }
+
+    Console::WriteLine("Completed: %s", GetAllEntitiesChecksum().ToString().c_str());
+    return EXITCODE_OK;
+}
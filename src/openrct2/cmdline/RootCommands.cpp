@@ -22,6 +22,7 @@
 #include "../object/ObjectRepository.h"
 #include "../platform/Crash.h"
 #include "../platform/Platform2.h"
+#include "../profiling/Profiling.h"
 #include "CommandLine.hpp"
 
 #include <ctime>
@@ -57,6 +58,7 @@ static utf8* _openrct2DataPath = nullptr;
 static utf8* _rct1DataPath = nullptr;
 static utf8* _rct2DataPath = nullptr;
 static bool _silentBreakpad = false;
+static utf8* _traceOutputPath = nullptr;
 
 // clang-format off
 static constexpr const CommandLineOptionDefinition StandardOptions[]
@@ -77,6 +79,7 @@ static constexpr const CommandLineOptionDefinition StandardOptions[]
     { CMDLINE_TYPE_STRING,  &_openrct2DataPath, NAC, "openrct2-data-path", "path to the OpenRCT2 data directory (containing languages)" },
     { CMDLINE_TYPE_STRING,  &_rct1DataPath,     NAC, "rct1-data-path",     "path to the RollerCoaster Tycoon 1 data directory (containing data/csg1.dat)" },
     { CMDLINE_TYPE_STRING,  &_rct2DataPath,     NAC, "rct2-data-path",     "path to the RollerCoaster Tycoon 2 data directory (containing data/g1.dat)" },
+    { CMDLINE_TYPE_STRING,  &_traceOutputPath,  NAC, "trace",              "write a Chrome trace of the session to the given path on exit" },
 #ifdef USE_BREAKPAD
     { CMDLINE_TYPE_SWITCH,  &_silentBreakpad,  NAC, "silent-breakpad",   "make breakpad crash reporting silent"                       },
 #endif // USE_BREAKPAD
@@ -141,6 +144,7 @@ const CommandLineCommand CommandLine::RootCommands[]
     DefineSubCommand("benchspritesort", CommandLine::BenchSpriteSortCommands  ),
     DefineSubCommand("benchsimulate",   CommandLine::BenchUpdateCommands      ),
     DefineSubCommand("simulate",        CommandLine::SimulateCommands         ),
+    DefineSubCommand("replay",          CommandLine::ReplayCommands           ),
     CommandTableEnd
 };
 
@@ -230,6 +234,15 @@ exitcode_t CommandLine::HandleCommandDefault()
         Memory::Free(_password);
     }
 
+    if (_traceOutputPath != nullptr)
+    {
+        utf8 absolutePath[MAX_PATH]{};
+        Path::GetAbsolute(absolutePath, std::size(absolutePath), _traceOutputPath);
+        String::Set(gTraceOutputPath, std::size(gTraceOutputPath), absolutePath);
+        Memory::Free(_traceOutputPath);
+        OpenRCT2::Profiling::StartTrace();
+    }
+
     return result;
 }
 
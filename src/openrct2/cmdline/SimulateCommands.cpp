@@ -12,20 +12,45 @@
 #include "../GameState.h"
 #include "../OpenRCT2.h"
 #include "../core/Console.hpp"
+#include "../core/Json.hpp"
+#include "../core/String.hpp"
+#include "../core/Timer.hpp"
 #include "../entity/EntityRegistry.h"
 #include "../network/network.h"
+#include "../platform/Platform2.h"
 #include "../platform/platform.h"
 #include "CommandLine.hpp"
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
 #include <cstdlib>
 #include <memory>
+#include <string>
+#include <thread>
+#include <vector>
 
 using namespace OpenRCT2;
 
+static int32_t _batchJobs = 1;
+
+// clang-format off
+static constexpr const CommandLineOptionDefinition SimulateBatchOptions[]
+{
+    { CMDLINE_TYPE_INTEGER, &_batchJobs, 'j', "jobs", "number of parks to simulate at the same time, each in its own process" },
+    OptionTableEnd
+};
+// clang-format on
+
 static exitcode_t HandleSimulate(CommandLineArgEnumerator* argEnumerator);
+static exitcode_t HandleSimulateBatch(CommandLineArgEnumerator* argEnumerator);
 
-const CommandLineCommand CommandLine::SimulateCommands[]{ // Main commands
-                                                          DefineCommand("", "<ticks>", nullptr, HandleSimulate), CommandTableEnd
+const CommandLineCommand CommandLine::SimulateCommands[]{
+    // Main commands
+    DefineCommand("", "<ticks>", nullptr, HandleSimulate),
+    DefineCommand("batch", "<ticks> <park-file>...", SimulateBatchOptions, HandleSimulateBatch),
+    CommandTableEnd,
 };
 
 static exitcode_t HandleSimulate(CommandLineArgEnumerator* argEnumerator)
@@ -73,3 +98,193 @@ static exitcode_t HandleSimulate(CommandLineArgEnumerator* argEnumerator)
 
     return EXITCODE_OK;
 }
+
+json_t CommandLine::SimulatePark(const std::string& parkPath, uint32_t ticks, bool sharesProcess)
+{
+    json_t result = { { "park", parkPath } };
+    auto baselineMemory = Platform::GetPeakMemoryUsage();
+
+    std::unique_ptr<IContext> context(CreateContext());
+    if (!context->Initialise())
+    {
+        result["error"] = "Context initialization failed.";
+        return result;
+    }
+    if (!context->LoadParkFromFile(parkPath))
+    {
+        result["error"] = "Unable to load park.";
+        return result;
+    }
+
+    // UpdateLogic records the time since the start of the tick after each part, parts that did not run stay at zero.
+    LogicTimings timings;
+    std::array<std::chrono::duration<double>, EnumValue(LogicTimePart::Scripts) + 1> partTimes{};
+
+    auto* gameState = context->GetGameState();
+    Timer timer;
+    for (uint32_t i = 0; i < ticks; i++)
+    {
+        // UpdateLogic records at CurrentIdx and then advances it, so every tick is recorded at the first index.
+        timings.CurrentIdx = 0;
+        for (size_t part = 0; part < partTimes.size(); part++)
+        {
+            timings.TimingInfo[static_cast<LogicTimePart>(part)][0] = {};
+        }
+
+        gameState->UpdateLogic(&timings);
+
+        std::chrono::duration<double> previousTime{};
+        for (size_t part = 0; part < partTimes.size(); part++)
+        {
+            auto time = timings.TimingInfo[static_cast<LogicTimePart>(part)][0];
+            if (time.count() > 0)
+            {
+                partTimes[part] += time - previousTime;
+                previousTime = time;
+            }
+        }
+    }
+    auto seconds = timer.GetElapsedTime().count();
+
+    json_t partTimings = json_t::object();
+    for (size_t part = 0; part < partTimes.size(); part++)
+    {
+        partTimings[GetLogicTimePartName(static_cast<LogicTimePart>(part))] = partTimes[part].count() * 1000.0;
+    }
+
+    result["ticks"] = ticks;
+    result["seconds"] = seconds;
+    result["ticks_per_second"] = seconds > 0 ? ticks / seconds : 0.0;
+    result["timings_ms"] = partTimings;
+    result["checksum"] = GetAllEntitiesChecksum().ToString();
+    if (sharesProcess)
+    {
+        result["peak_memory_increase"] = Platform::GetPeakMemoryUsage() - baselineMemory;
+    }
+    else
+    {
+        result["peak_memory"] = Platform::GetPeakMemoryUsage();
+    }
+    return result;
+}
+
+static std::string QuoteShellArgument(const std::string& argument)
+{
+    std::string result = "'";
+    for (auto c : argument)
+    {
+        if (c == '\'')
+            result += "'\\''";
+        else
+            result += c;
+    }
+    return result + "'";
+}
+
+// Runs the park in a child process so that it gets a game state of its own, the child prints the results as JSON.
+static json_t SimulateParkInProcess(const std::string& parkPath, uint32_t ticks)
+{
+    auto command = String::StdFormat(
+        "%s simulate batch %u %s --jobs=1", QuoteShellArgument(Platform::GetCurrentExecutablePath()).c_str(), ticks,
+        QuoteShellArgument(parkPath).c_str());
+
+    std::string output;
+    auto exitCode = Platform::Execute(command, &output);
+
+    // The results are the last line that parses, the others are logging.
+    json_t result;
+    auto lineEnd = output.size();
+    while (!result.is_object() && lineEnd != 0)
+    {
+        auto lineStart = output.find_last_of('\n', lineEnd - 1);
+        lineStart = lineStart == std::string::npos ? 0 : lineStart + 1;
+        result = json_t::parse(output.substr(lineStart, lineEnd - lineStart), nullptr, false);
+        lineEnd = lineStart == 0 ? 0 : lineStart - 1;
+    }
+    if (!result.is_object())
+    {
+        result = { { "park", parkPath }, { "error", String::StdFormat("Simulation failed with exit code %d.", exitCode) } };
+    }
+    return result;
+}
+
+static exitcode_t HandleSimulateBatch(CommandLineArgEnumerator* argEnumerator)
+{
+    const char** argv = const_cast<const char**>(argEnumerator->GetArguments()) + argEnumerator->GetIndex();
+    int32_t argc = argEnumerator->GetCount() - argEnumerator->GetIndex();
+
+    // The options follow the park files.
+    int32_t numArguments = 0;
+    while (numArguments < argc && argv[numArguments][0] != '-')
+    {
+        numArguments++;
+    }
+
+    if (numArguments < 2)
+    {
+        Console::Error::WriteLine("Missing arguments <ticks> <park-file>...");
+        return EXITCODE_FAIL;
+    }
+
+    core_init();
+
+    uint32_t ticks = atol(argv[0]);
+    std::vector<std::string> parkPaths(argv + 1, argv + numArguments);
+    std::vector<json_t> results(parkPaths.size());
+
+    gOpenRCT2Headless = true;
+    gOpenRCT2NoGraphics = true;
+
+#ifdef _WIN32
+    if (_batchJobs > 1)
+    {
+        Console::Error::WriteLine("Simulating parks in parallel is not supported on Windows, simulating one at a time.");
+        _batchJobs = 1;
+    }
+    bool useChildProcesses = false;
+#else
+    // Each park gets a process of its own whenever there are several, so that the peak memory is its own as well.
+    bool useChildProcesses = parkPaths.size() > 1;
+#endif
+
+    if (!useChildProcesses)
+    {
+        for (size_t i = 0; i < parkPaths.size(); i++)
+        {
+            results[i] = CommandLine::SimulatePark(parkPaths[i], ticks, i > 0);
+            Console::WriteLine("%s", results[i].dump().c_str());
+        }
+    }
+    else
+    {
+        std::atomic<size_t> nextPark = 0;
+        std::vector<std::thread> workers;
+        for (int32_t i = 0; i < std::max(_batchJobs, 1); i++)
+        {
+            workers.emplace_back([&]() {
+                for (auto park = nextPark++; park < parkPaths.size(); park = nextPark++)
+                {
+                    results[park] = SimulateParkInProcess(parkPaths[park], ticks);
+                }
+            });
+        }
+        for (auto& worker : workers)
+        {
+            worker.join();
+        }
+
+        for (const auto& result : results)
+        {
+            Console::WriteLine("%s", result.dump().c_str());
+        }
+    }
+
+    for (const auto& result : results)
+    {
+        if (result.contains("error"))
+        {
+            return EXITCODE_FAIL;
+        }
+    }
+    return EXITCODE_OK;
+}
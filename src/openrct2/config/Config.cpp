@@ -207,6 +207,11 @@ namespace Config
                 "scale_quality", ScaleQuality::SmoothNearestNeighbour, Enum_ScaleQuality);
             model->show_fps = reader->GetBoolean("show_fps", false);
             model->multithreading = reader->GetBoolean("multi_threading", false);
+            model->sprite_cache_size = reader->GetInt32("sprite_cache_size", 0);
+            model->paint_cache = reader->GetBoolean("paint_cache", false);
+            model->viewport_cache = reader->GetBoolean("viewport_cache", false);
+            model->multithreaded_guest_update = reader->GetBoolean("multi_threaded_guest_update", false);
+            model->improved_guest_pathfinding = reader->GetBoolean("improved_guest_pathfinding", false);
             model->trap_cursor = reader->GetBoolean("trap_cursor", false);
             model->auto_open_shops = reader->GetBoolean("auto_open_shops", false);
             model->scenario_select_mode = reader->GetInt32("scenario_select_mode", SCENARIO_SELECT_MODE_ORIGIN);
@@ -284,6 +289,11 @@ namespace Config
         writer->WriteEnum<ScaleQuality>("scale_quality", model->scale_quality, Enum_ScaleQuality);
         writer->WriteBoolean("show_fps", model->show_fps);
         writer->WriteBoolean("multi_threading", model->multithreading);
+        writer->WriteInt32("sprite_cache_size", model->sprite_cache_size);
+        writer->WriteBoolean("paint_cache", model->paint_cache);
+        writer->WriteBoolean("viewport_cache", model->viewport_cache);
+        writer->WriteBoolean("multi_threaded_guest_update", model->multithreaded_guest_update);
+        writer->WriteBoolean("improved_guest_pathfinding", model->improved_guest_pathfinding);
         writer->WriteBoolean("trap_cursor", model->trap_cursor);
         writer->WriteBoolean("auto_open_shops", model->auto_open_shops);
         writer->WriteInt32("scenario_select_mode", model->scenario_select_mode);
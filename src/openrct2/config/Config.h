@@ -42,6 +42,11 @@ struct GeneralConfiguration
     bool use_vsync;
     bool show_fps;
     bool multithreading;
+    int32_t sprite_cache_size; // MiB, 0 disables the cache
+    bool paint_cache;
+    bool viewport_cache;
+    bool multithreaded_guest_update;
+    bool improved_guest_pathfinding;
     bool minimize_fullscreen_focus_loss;
     bool disable_screensaver;
 
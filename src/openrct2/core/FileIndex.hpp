@@ -224,9 +224,10 @@ private:
 
                 auto& items = containers.emplace_back();
 
-                jobPool.AddTask(std::bind(
-                    &FileIndex<TItem>::BuildRange, this, language, std::cref(scanResult), rangeStart, rangeStart + stepSize,
-                    std::ref(items), std::ref(processed), std::ref(printLock)));
+                const auto rangeEnd = rangeStart + stepSize;
+                jobPool.AddTask([this, language, &scanResult, rangeStart, rangeEnd, &items, &processed, &printLock]() {
+                    BuildRange(language, scanResult, rangeStart, rangeEnd, items, processed, printLock);
+                });
 
                 reportProgress();
             }
@@ -9,28 +9,108 @@
 
 #include "JobPool.h"
 
-#include <algorithm>
+#include "../profiling/Profiling.h"
+
 #include <cassert>
+#include <chrono>
+#include <limits>
+#include <string>
+
+static constexpr size_t ExternalQueueIndex = std::numeric_limits<size_t>::max();
+static constexpr size_t InitialQueueCapacity = 64;
+static constexpr auto ReportInterval = std::chrono::milliseconds(10);
 
-JobPool::TaskData::TaskData(std::function<void()> workFn, std::function<void()> completionFn)
-    : WorkFn(workFn)
-    , CompletionFn(completionFn)
+// Identifies the pool and queue owned by the current thread, tasks submitted from a worker go to its own queue.
+static thread_local const JobPool* _currentPool = nullptr;
+static thread_local size_t _currentQueue = ExternalQueueIndex;
+
+/**
+ * Ring buffer of tasks owned by one worker. The owner pushes and pops at the back, other threads steal from the front.
+ * The buffer only grows, so once it reached the working size no more allocations take place.
+ */
+struct alignas(64) JobPool::WorkQueue
 {
-}
+    std::mutex Mutex;
+    std::vector<TaskData> Items;
+    size_t Head = 0;
+    size_t Count = 0;
+
+    std::atomic<size_t> TasksExecuted = { 0 };
+    std::atomic<size_t> TasksStolen = { 0 };
+    std::atomic<size_t> StealAttempts = { 0 };
+    std::atomic<size_t> Sleeps = { 0 };
+
+    WorkQueue()
+    {
+        Items.resize(InitialQueueCapacity);
+    }
+
+    void PushBack(TaskData&& taskData)
+    {
+        if (Count == Items.size())
+        {
+            Grow();
+        }
+        Items[(Head + Count) % Items.size()] = std::move(taskData);
+        Count++;
+    }
+
+    bool PopBack(TaskData& taskData)
+    {
+        if (Count == 0)
+            return false;
+
+        Count--;
+        taskData = std::move(Items[(Head + Count) % Items.size()]);
+        return true;
+    }
+
+    bool PopFront(TaskData& taskData)
+    {
+        if (Count == 0)
+            return false;
+
+        taskData = std::move(Items[Head]);
+        Head = (Head + 1) % Items.size();
+        Count--;
+        return true;
+    }
+
+private:
+    void Grow()
+    {
+        std::vector<TaskData> newItems(std::max<size_t>(Items.size() * 2, InitialQueueCapacity));
+        for (size_t i = 0; i < Count; i++)
+        {
+            newItems[i] = std::move(Items[(Head + i) % Items.size()]);
+        }
+        Items = std::move(newItems);
+        Head = 0;
+    }
+};
 
 JobPool::JobPool(size_t maxThreads)
 {
     maxThreads = std::min<size_t>(maxThreads, std::thread::hardware_concurrency());
+
+    // There is always at least one queue so tasks can be submitted even without workers, Join will run them.
+    auto queueCount = std::max<size_t>(maxThreads, 1);
+    for (size_t n = 0; n < queueCount; n++)
+    {
+        _queues.push_back(std::make_unique<WorkQueue>());
+    }
+    _externalStats = std::make_unique<WorkQueue>();
+
     for (size_t n = 0; n < maxThreads; n++)
     {
-        _threads.emplace_back(&JobPool::ProcessQueue, this);
+        _threads.emplace_back(&JobPool::ProcessQueue, this, n);
     }
 }
 
 JobPool::~JobPool()
 {
     {
-        unique_lock lock(_mutex);
+        unique_lock lock(_sleepMutex);
         _shouldStop = true;
         _condPending.notify_all();
     }
@@ -42,48 +122,56 @@ JobPool::~JobPool()
     }
 }
 
-void JobPool::AddTask(std::function<void()> workFn, std::function<void()> completionFn)
+void JobPool::Enqueue(TaskData&& taskData)
 {
-    unique_lock lock(_mutex);
-    _pending.emplace_back(workFn, completionFn);
-    _condPending.notify_one();
+    _inFlight++;
+
+    // Announce the task before it becomes visible so workers never see an available task with a zero count.
+    _pendingCount++;
+
+    auto queueIndex = GetCurrentQueueIndex();
+    if (queueIndex == ExternalQueueIndex)
+    {
+        queueIndex = _nextQueue.fetch_add(1, std::memory_order_relaxed) % _queues.size();
+    }
+
+    auto& queue = *_queues[queueIndex];
+    {
+        std::lock_guard<std::mutex> lock(queue.Mutex);
+        queue.PushBack(std::move(taskData));
+    }
+
+    // Workers register as sleeping before checking the pending count, so either they see the new task or we see them.
+    if (_sleeping > 0)
+    {
+        std::lock_guard<std::mutex> lock(_sleepMutex);
+        _condPending.notify_one();
+    }
 }
 
 void JobPool::Join(std::function<void()> reportFn)
 {
-    unique_lock lock(_mutex);
     while (true)
     {
-        // Wait for the queue to become empty or having completed tasks.
-        _condComplete.wait(lock, [this]() { return (_pending.empty() && _processing == 0) || !_completed.empty(); });
-
-        // Dispatch all completion callbacks if there are any.
-        while (!_completed.empty())
+        // Help out with the remaining work, only wait once there is nothing left to take.
+        if (!RunPendingTask(GetCurrentQueueIndex()))
         {
-            auto taskData = _completed.front();
-            _completed.pop_front();
-
-            if (taskData.CompletionFn)
-            {
-                lock.unlock();
+            unique_lock lock(_joinMutex);
+            _condComplete.wait_for(lock, ReportInterval, [this]() { return _inFlight == 0 || !_completed.empty(); });
+        }
 
-                taskData.CompletionFn();
+        // Read before dispatching, all completion callbacks are queued by the time the in flight count reaches zero.
+        bool finished = _inFlight == 0;
 
-                lock.lock();
-            }
-        }
+        DispatchCompletions();
 
         if (reportFn)
         {
-            lock.unlock();
-
             reportFn();
-
-            lock.lock();
         }
 
-        // If everything is empty and no more work has to be done we can stop waiting.
-        if (_completed.empty() && _pending.empty() && _processing == 0)
+        // Completion callbacks may have queued new work.
+        if (finished && _inFlight == 0)
         {
             break;
         }
@@ -92,34 +180,173 @@ void JobPool::Join(std::function<void()> reportFn)
 
 size_t JobPool::CountPending()
 {
-    return _pending.size();
+    return _pendingCount;
 }
 
-void JobPool::ProcessQueue()
+size_t JobPool::CountWorkers() const
 {
-    unique_lock lock(_mutex);
-    do
+    return _threads.size();
+}
+
+std::vector<JobPool::WorkerStatistics> JobPool::GetStatistics() const
+{
+    std::vector<WorkerStatistics> result;
+    auto addStats = [&result](const WorkQueue& queue) {
+        auto& stats = result.emplace_back();
+        stats.TasksExecuted = queue.TasksExecuted;
+        stats.TasksStolen = queue.TasksStolen;
+        stats.StealAttempts = queue.StealAttempts;
+        stats.Sleeps = queue.Sleeps;
+    };
+    for (size_t i = 0; i < _threads.size(); i++)
     {
-        // Wait for work or cancellation.
-        _condPending.wait(lock, [this]() { return _shouldStop || !_pending.empty(); });
+        addStats(*_queues[i]);
+    }
+    addStats(*_externalStats);
+    return result;
+}
 
-        if (!_pending.empty())
+void JobPool::ResetStatistics()
+{
+    auto resetStats = [](WorkQueue& queue) {
+        queue.TasksExecuted = 0;
+        queue.TasksStolen = 0;
+        queue.StealAttempts = 0;
+        queue.Sleeps = 0;
+    };
+    for (auto& queue : _queues)
+    {
+        resetStats(*queue);
+    }
+    resetStats(*_externalStats);
+}
+
+size_t JobPool::GetCurrentQueueIndex() const
+{
+    return _currentPool == this ? _currentQueue : ExternalQueueIndex;
+}
+
+JobPool::WorkQueue& JobPool::GetStatsQueue(size_t queueIndex)
+{
+    return queueIndex == ExternalQueueIndex ? *_externalStats : *_queues[queueIndex];
+}
+
+bool JobPool::TryTakeTask(size_t queueIndex, TaskData& taskData)
+{
+    if (_pendingCount == 0)
+        return false;
+
+    // Newest task of our own queue first, it is most likely still in cache.
+    if (queueIndex != ExternalQueueIndex)
+    {
+        auto& ownQueue = *_queues[queueIndex];
+        std::lock_guard<std::mutex> lock(ownQueue.Mutex);
+        if (ownQueue.PopBack(taskData))
         {
-            _processing++;
+            return true;
+        }
+    }
+
+    // Steal the oldest task from another queue.
+    auto& stats = GetStatsQueue(queueIndex);
+    const auto queueCount = _queues.size();
+    const auto start = queueIndex == ExternalQueueIndex ? _nextQueue.load(std::memory_order_relaxed) : queueIndex + 1;
+    for (size_t i = 0; i < queueCount; i++)
+    {
+        auto victimIndex = (start + i) % queueCount;
+        if (victimIndex == queueIndex)
+            continue;
+
+        stats.StealAttempts.fetch_add(1, std::memory_order_relaxed);
+
+        auto& victim = *_queues[victimIndex];
+        std::lock_guard<std::mutex> lock(victim.Mutex);
+        if (victim.PopFront(taskData))
+        {
+            stats.TasksStolen.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool JobPool::RunPendingTask(size_t queueIndex)
+{
+    TaskData taskData;
+    if (!TryTakeTask(queueIndex, taskData))
+        return false;
+
+    _pendingCount--;
 
-            auto taskData = _pending.front();
-            _pending.pop_front();
+    taskData.WorkFn();
+    taskData.WorkFn.Reset();
 
-            lock.unlock();
+    GetStatsQueue(queueIndex).TasksExecuted.fetch_add(1, std::memory_order_relaxed);
 
-            taskData.WorkFn();
+    if (taskData.CompletionFn)
+    {
+        std::lock_guard<std::mutex> lock(_joinMutex);
+        _completed.push_back(std::move(taskData.CompletionFn));
+        _condComplete.notify_all();
+    }
+
+    if (--_inFlight == 0)
+    {
+        std::lock_guard<std::mutex> lock(_joinMutex);
+        _condComplete.notify_all();
+    }
+    return true;
+}
+
+void JobPool::WaitUntilZero(const std::atomic<size_t>& counter)
+{
+    const auto queueIndex = GetCurrentQueueIndex();
+    while (counter.load(std::memory_order_acquire) != 0)
+    {
+        if (!RunPendingTask(queueIndex))
+        {
+            // The remaining tasks are running on other threads.
+            std::this_thread::yield();
+        }
+    }
+}
 
-            lock.lock();
+void JobPool::DispatchCompletions()
+{
+    std::vector<std::function<void()>> completed;
+    {
+        std::lock_guard<std::mutex> lock(_joinMutex);
+        completed.swap(_completed);
+    }
+    for (auto& completionFn : completed)
+    {
+        completionFn();
+    }
+}
 
-            _completed.push_back(std::move(taskData));
+void JobPool::ProcessQueue(size_t queueIndex)
+{
+    _currentPool = this;
+    _currentQueue = queueIndex;
+    OpenRCT2::Profiling::SetThreadName("JobPool worker " + std::to_string(queueIndex));
 
-            _processing--;
-            _condComplete.notify_one();
+    auto& stats = *_queues[queueIndex];
+    while (!_shouldStop)
+    {
+        if (RunPendingTask(queueIndex))
+            continue;
+
+        // Wait for work or cancellation.
+        unique_lock lock(_sleepMutex);
+        _sleeping++;
+        if (!_shouldStop && _pendingCount == 0)
+        {
+            stats.Sleeps.fetch_add(1, std::memory_order_relaxed);
+            _condPending.wait(lock, [this]() { return _shouldStop || _pendingCount > 0; });
         }
-    } while (!_shouldStop);
+        _sleeping--;
+    }
+
+    _currentPool = nullptr;
+    _currentQueue = ExternalQueueIndex;
 }
@@ -9,33 +9,148 @@
 
 #pragma once
 
+#include <algorithm>
 #include <atomic>
 #include <condition_variable>
-#include <deque>
+#include <cstddef>
 #include <functional>
+#include <memory>
 #include <mutex>
+#include <new>
 #include <thread>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
+/**
+ * Work-stealing thread pool. Every worker owns a queue, tasks submitted from a worker go to its own queue and idle
+ * workers steal from the others, so there is no single lock all threads contend on. Tasks are stored inline in the
+ * queues, submitting a task does not allocate once the queues have grown to their working size.
+ */
 class JobPool
 {
+public:
+    struct WorkerStatistics
+    {
+        size_t TasksExecuted = 0;
+        size_t TasksStolen = 0;
+        size_t StealAttempts = 0;
+        size_t Sleeps = 0;
+    };
+
 private:
-    struct TaskData
+    /**
+     * Type erased callable with a fixed inline buffer, a replacement for std::function that never allocates.
+     */
+    class Task
     {
-        const std::function<void()> WorkFn;
-        const std::function<void()> CompletionFn;
+    public:
+        static constexpr size_t InlineSize = 64;
+
+    private:
+        using InvokeFn = void (*)(void*);
+        using MoveFn = void (*)(void* dst, void* src);
+        using DestroyFn = void (*)(void*);
+
+        alignas(std::max_align_t) unsigned char _storage[InlineSize];
+        InvokeFn _invoke = nullptr;
+        MoveFn _move = nullptr;
+        DestroyFn _destroy = nullptr;
+
+    public:
+        Task() = default;
+
+        template<typename TFn, typename = std::enable_if_t<!std::is_same_v<std::decay_t<TFn>, Task>>> Task(TFn&& fn)
+        {
+            using TStored = std::decay_t<TFn>;
+            static_assert(sizeof(TStored) <= InlineSize, "Task is too large, capture by reference instead.");
+            static_assert(alignof(TStored) <= alignof(std::max_align_t), "Task alignment is not supported.");
+
+            new (_storage) TStored(std::forward<TFn>(fn));
+            _invoke = [](void* fnPtr) { (*static_cast<TStored*>(fnPtr))(); };
+            _move = [](void* dst, void* src) { new (dst) TStored(std::move(*static_cast<TStored*>(src))); };
+            _destroy = [](void* fnPtr) { static_cast<TStored*>(fnPtr)->~TStored(); };
+        }
+
+        Task(Task&& other) noexcept
+        {
+            MoveFrom(other);
+        }
+
+        Task& operator=(Task&& other) noexcept
+        {
+            if (this != &other)
+            {
+                Reset();
+                MoveFrom(other);
+            }
+            return *this;
+        }
+
+        Task(const Task&) = delete;
+        Task& operator=(const Task&) = delete;
+
+        ~Task()
+        {
+            Reset();
+        }
 
-        TaskData(std::function<void()> workFn, std::function<void()> completionFn);
+        void operator()()
+        {
+            _invoke(_storage);
+        }
+
+        explicit operator bool() const
+        {
+            return _invoke != nullptr;
+        }
+
+        void Reset()
+        {
+            if (_destroy != nullptr)
+            {
+                _destroy(_storage);
+            }
+            _invoke = nullptr;
+            _move = nullptr;
+            _destroy = nullptr;
+        }
+
+    private:
+        void MoveFrom(Task& other)
+        {
+            if (other._invoke != nullptr)
+            {
+                other._move(_storage, other._storage);
+                _invoke = other._invoke;
+                _move = other._move;
+                _destroy = other._destroy;
+                other.Reset();
+            }
+        }
+    };
+
+    struct TaskData
+    {
+        Task WorkFn;
+        std::function<void()> CompletionFn;
     };
 
+    struct WorkQueue;
+
     std::atomic_bool _shouldStop = { false };
-    std::atomic<size_t> _processing = { 0 };
+    std::atomic<size_t> _inFlight = { 0 };
+    std::atomic<size_t> _pendingCount = { 0 };
+    std::atomic<size_t> _sleeping = { 0 };
+    std::atomic<size_t> _nextQueue = { 0 };
+    std::vector<std::unique_ptr<WorkQueue>> _queues;
+    std::unique_ptr<WorkQueue> _externalStats;
     std::vector<std::thread> _threads;
-    std::deque<TaskData> _pending;
-    std::deque<TaskData> _completed;
+    std::vector<std::function<void()>> _completed;
     std::condition_variable _condPending;
     std::condition_variable _condComplete;
-    std::mutex _mutex;
+    std::mutex _sleepMutex;
+    std::mutex _joinMutex;
 
     using unique_lock = std::unique_lock<std::mutex>;
 
@@ -43,10 +158,58 @@ public:
     JobPool(size_t maxThreads = 255);
     ~JobPool();
 
-    void AddTask(std::function<void()> workFn, std::function<void()> completionFn = nullptr);
+    template<typename TWorkFn> void AddTask(TWorkFn&& workFn, std::function<void()> completionFn = nullptr)
+    {
+        Enqueue(TaskData{ Task(std::forward<TWorkFn>(workFn)), std::move(completionFn) });
+    }
+
+    /**
+     * Runs all queued tasks and their completion callbacks. The calling thread executes tasks itself while waiting.
+     */
     void Join(std::function<void()> reportFn = nullptr);
     size_t CountPending();
+    size_t CountWorkers() const;
+
+    /**
+     * Calls fn(index) for every index in [begin, end), split into tasks of grainSize indices, and returns once all of
+     * them have completed. Safe to call from within a task, the calling thread helps with the work instead of blocking.
+     */
+    template<typename TFn> void ParallelFor(size_t begin, size_t end, size_t grainSize, TFn&& fn)
+    {
+        if (begin >= end)
+            return;
+
+        grainSize = std::max<size_t>(grainSize, 1);
+        std::atomic<size_t> remaining = { (end - begin + grainSize - 1) / grainSize };
+        for (size_t chunkStart = begin; chunkStart < end; chunkStart += grainSize)
+        {
+            auto chunkEnd = std::min(chunkStart + grainSize, end);
+            Enqueue(TaskData{ Task([&fn, &remaining, chunkStart, chunkEnd]() {
+                                  for (size_t i = chunkStart; i < chunkEnd; i++)
+                                  {
+                                      fn(i);
+                                  }
+                                  remaining.fetch_sub(1, std::memory_order_release);
+                              }),
+                              nullptr });
+        }
+        WaitUntilZero(remaining);
+    }
+
+    /**
+     * Returns one entry per worker thread followed by one entry for tasks executed by threads helping out in Join
+     * or ParallelFor.
+     */
+    std::vector<WorkerStatistics> GetStatistics() const;
+    void ResetStatistics();
 
 private:
-    void ProcessQueue();
+    void Enqueue(TaskData&& taskData);
+    bool RunPendingTask(size_t queueIndex);
+    bool TryTakeTask(size_t queueIndex, TaskData& taskData);
+    void WaitUntilZero(const std::atomic<size_t>& counter);
+    void DispatchCompletions();
+    size_t GetCurrentQueueIndex() const;
+    WorkQueue& GetStatsQueue(size_t queueIndex);
+    void ProcessQueue(size_t queueIndex);
 };
@@ -68,6 +68,7 @@ namespace OpenRCT2
         std::vector<ChunkEntry> _chunks;
         MemoryStream _buffer;
         ChunkEntry _currentChunk;
+        bool _isCaptured{};
 
     public:
         OrcaStream(IStream& stream, const Mode mode)
@@ -122,7 +123,27 @@ namespace OpenRCT2
 
         ~OrcaStream()
         {
-            if (_mode == Mode::WRITING)
+            if (_mode == Mode::WRITING && !_isCaptured)
+            {
+                TakeCapture().Encode(*_stream);
+            }
+        }
+
+        /**
+         * The header and chunks written to an OrcaStream, owning their data so they can be compressed and written to the
+         * stream later, on any thread.
+         */
+        class Capture
+        {
+            friend class OrcaStream;
+
+        private:
+            Header _header{};
+            std::vector<ChunkEntry> _chunks;
+            MemoryStream _buffer;
+
+        public:
+            void Encode(IStream& stream)
             {
                 const void* uncompressedData = _buffer.GetData();
                 const uint64_t uncompressedSize = _buffer.GetLength();
@@ -149,22 +170,36 @@ namespace OpenRCT2
                 }
 
                 // Write header and chunk table
-                _stream->WriteValue(_header);
+                stream.WriteValue(_header);
                 for (const auto& chunk : _chunks)
                 {
-                    _stream->WriteValue(chunk);
+                    stream.WriteValue(chunk);
                 }
 
                 // Write chunk data
                 if (compressedBytes)
                 {
-                    _stream->Write(compressedBytes->data(), compressedBytes->size());
+                    stream.Write(compressedBytes->data(), compressedBytes->size());
                 }
                 else
                 {
-                    _stream->Write(uncompressedData, uncompressedSize);
+                    stream.Write(uncompressedData, uncompressedSize);
                 }
             }
+        };
+
+        /**
+         * Moves everything written so far out of the stream, which then writes nothing to its stream when destroyed.
+         */
+        Capture TakeCapture()
+        {
+            Capture capture;
+            capture._header = _header;
+            capture._chunks = std::move(_chunks);
+            capture._buffer = std::move(_buffer);
+            _chunks.clear();
+            _isCaptured = true;
+            return capture;
         }
 
         Mode GetMode() const
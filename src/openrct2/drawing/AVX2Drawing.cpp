@@ -42,6 +42,37 @@ void mask_avx2(
     }
 }
 
+void remap_run_avx2(const uint8_t* RESTRICT src, uint8_t* RESTRICT dst, int32_t numPixels, const uint8_t* RESTRICT paletteMap)
+{
+    const __m256i zero = {};
+    const __m256i lowNibbleMask = _mm256_set1_epi8(0x0F);
+    int32_t i = 0;
+    for (; i + 32 <= numPixels; i += 32)
+    {
+        const __m256i pixels = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+        const __m256i dest = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(dst + i));
+        const __m256i lowNibbles = _mm256_and_si256(pixels, lowNibbleMask);
+        const __m256i highNibbles = _mm256_and_si256(_mm256_srli_epi16(pixels, 4), lowNibbleMask);
+
+        // _mm256_shuffle_epi8 looks up within each 128 bit lane, so every 16 entry block of the palette map is
+        // broadcast to both lanes.
+        __m256i remapped = zero;
+        for (int32_t block = 0; block < 16; block++)
+        {
+            const __m256i table = _mm256_broadcastsi128_si256(
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(paletteMap + block * 16)));
+            const __m256i lookup = _mm256_shuffle_epi8(table, lowNibbles);
+            const __m256i inBlock = _mm256_cmpeq_epi8(highNibbles, _mm256_set1_epi8(static_cast<char>(block)));
+            remapped = _mm256_blendv_epi8(remapped, lookup, inBlock);
+        }
+
+        const __m256i transparent = _mm256_or_si256(_mm256_cmpeq_epi8(pixels, zero), _mm256_cmpeq_epi8(remapped, zero));
+        const __m256i blended = _mm256_blendv_epi8(remapped, dest, transparent);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), blended);
+    }
+    remap_run_scalar(src + i, dst + i, numPixels - i, paletteMap);
+}
+
 #else
 
 #    ifdef OPENRCT2_X86
@@ -55,4 +86,9 @@ void mask_avx2(
     openrct2_assert(false, "AVX2 function called on a CPU that doesn't support AVX2");
 }
 
+void remap_run_avx2(const uint8_t* RESTRICT src, uint8_t* RESTRICT dst, int32_t numPixels, const uint8_t* RESTRICT paletteMap)
+{
+    openrct2_assert(false, "AVX2 function called on a CPU that doesn't support AVX2");
+}
+
 #endif // __AVX2__
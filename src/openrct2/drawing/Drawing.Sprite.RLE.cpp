@@ -12,6 +12,25 @@
 #include <algorithm>
 #include <cstring>
 
+// Shorter runs are not worth the indirect call into the vectorised remap functions.
+constexpr int32_t MinVectorisedRunLength = 16;
+
+void remap_run_scalar(const uint8_t* RESTRICT src, uint8_t* RESTRICT dst, int32_t numPixels, const uint8_t* RESTRICT paletteMap)
+{
+    for (int32_t i = 0; i < numPixels; i++)
+    {
+        auto pixel = src[i];
+        if (pixel != 0)
+        {
+            pixel = paletteMap[pixel];
+            if (pixel != 0)
+            {
+                dst[i] = pixel;
+            }
+        }
+    }
+}
+
 template<DrawBlendOp TBlendOp, size_t TZoom>
 static void FASTCALL DrawRLESpriteMagnify(rct_drawpixelinfo& dpi, const DrawSpriteArgs& args)
 {
@@ -163,6 +182,23 @@ static void FASTCALL DrawRLESpriteMinify(rct_drawpixelinfo& dpi, const DrawSprit
                     std::memcpy(dst, src, numPixels);
                 }
             }
+            else if constexpr (TBlendOp == (BLEND_TRANSPARENT | BLEND_SRC) && TZoom == 0)
+            {
+                // Every pixel is sampled and remapped independently, which the SIMD remap functions can do 16 or 32 at a time
+                auto lookupTable = args.PalMap.GetLookupTable();
+                if (lookupTable != nullptr && numPixels >= MinVectorisedRunLength)
+                {
+                    remap_run_fn(src, dst, numPixels, lookupTable);
+                }
+                else
+                {
+                    auto& paletteMap = args.PalMap;
+                    for (int32_t j = 0; j < numPixels; j++)
+                    {
+                        BlitPixel<TBlendOp>(src + j, dst + j, paletteMap);
+                    }
+                }
+            }
             else
             {
                 auto& paletteMap = args.PalMap;
@@ -20,6 +20,7 @@
 #include "../ui/UiContext.h"
 #include "../util/Util.h"
 #include "ScrollingText.h"
+#include "SpriteCache.h"
 
 #include <algorithm>
 #include <memory>
@@ -242,6 +243,7 @@ bool gfx_load_g1(const IPlatformEnvironment& env)
 
 void gfx_unload_g1()
 {
+    sprite_cache_clear();
     _g1.data.reset();
     _g1.elements.clear();
     _g1.elements.shrink_to_fit();
@@ -249,6 +251,7 @@ void gfx_unload_g1()
 
 void gfx_unload_g2()
 {
+    sprite_cache_clear();
     _g2.data.reset();
     _g2.elements.clear();
     _g2.elements.shrink_to_fit();
@@ -256,6 +259,7 @@ void gfx_unload_g2()
 
 void gfx_unload_csg()
 {
+    sprite_cache_clear();
     _csg.data.reset();
     _csg.elements.clear();
     _csg.elements.shrink_to_fit();
@@ -575,7 +579,10 @@ void FASTCALL gfx_draw_sprite_palette_set_software(
     dest_pointer += ((dpi->width / zoom_level) + dpi->pitch) * dest_start_y + dest_start_x;
 
     DrawSpriteArgs args(imageId, paletteMap, *g1, source_start_x, source_start_y, width, height, dest_pointer);
-    gfx_sprite_to_buffer(*dpi, args);
+    if (!sprite_cache_draw(*dpi, args, imageId.GetIndex()))
+    {
+        gfx_sprite_to_buffer(*dpi, args);
+    }
 }
 
 void FASTCALL gfx_sprite_to_buffer(rct_drawpixelinfo& dpi, const DrawSpriteArgs& args)
@@ -733,6 +740,7 @@ void gfx_set_g1_element(ImageIndex imageId, const rct_g1_element* g1)
 
     if (g1 != nullptr)
     {
+        sprite_cache_invalidate(imageId);
         if (isTemp)
         {
             _g1Temp = *g1;
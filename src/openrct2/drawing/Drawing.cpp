@@ -13,7 +13,9 @@
 #include "../OpenRCT2.h"
 #include "../common.h"
 #include "../core/Guard.hpp"
+#include "../interface/ViewportCache.h"
 #include "../object/Object.h"
+#include "../paint/PaintCache.h"
 #include "../platform/platform.h"
 #include "../sprites.h"
 #include "../util/Util.h"
@@ -571,6 +573,28 @@ void mask_init()
     }
 }
 
+void (*remap_run_fn)(const uint8_t* RESTRICT src, uint8_t* RESTRICT dst, int32_t numPixels, const uint8_t* RESTRICT paletteMap)
+    = remap_run_scalar;
+
+void remap_run_init()
+{
+    if (avx2_available())
+    {
+        log_verbose("registering AVX2 remap function");
+        remap_run_fn = remap_run_avx2;
+    }
+    else if (sse41_available())
+    {
+        log_verbose("registering SSE4.1 remap function");
+        remap_run_fn = remap_run_sse4_1;
+    }
+    else
+    {
+        log_verbose("registering scalar remap function");
+        remap_run_fn = remap_run_scalar;
+    }
+}
+
 void gfx_filter_pixel(rct_drawpixelinfo* dpi, const ScreenCoordsXY& coords, FilterPaletteID palette)
 {
     gfx_filter_rect(dpi, { coords, coords }, palette);
@@ -651,6 +675,8 @@ void load_palette()
  */
 void gfx_invalidate_screen()
 {
+    OpenRCT2::PaintCache::Reset();
+    OpenRCT2::ViewportCache::Reset();
     gfx_set_dirty_blocks({ { 0, 0 }, { context_get_width(), context_get_height() } });
 }
 
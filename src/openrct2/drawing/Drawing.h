@@ -358,6 +358,16 @@ public:
     uint8_t& operator[](size_t index);
     uint8_t operator[](size_t index) const;
     uint8_t Blend(uint8_t src, uint8_t dst) const;
+
+    /**
+     * Returns the map as a table that can be indexed by any pixel value without bounds checking, or nullptr if the map
+     * has fewer than 256 entries.
+     */
+    const uint8_t* GetLookupTable() const
+    {
+        return _dataLength >= 256 ? _data : nullptr;
+    }
+
     void Copy(size_t dstIndex, const PaletteMap& src, size_t srcIndex, size_t length);
 };
 
@@ -597,6 +607,20 @@ extern void (*mask_fn)(
     int32_t width, int32_t height, const uint8_t* RESTRICT maskSrc, const uint8_t* RESTRICT colourSrc, uint8_t* RESTRICT dst,
     int32_t maskWrap, int32_t colourWrap, int32_t dstWrap);
 
+/**
+ * Remaps a run of pixels through a 256 entry palette map, skipping pixels that are transparent either before or after
+ * remapping. Matches BlitPixel<BLEND_TRANSPARENT | BLEND_SRC> for every pixel of the run.
+ */
+void remap_run_scalar(
+    const uint8_t* RESTRICT src, uint8_t* RESTRICT dst, int32_t numPixels, const uint8_t* RESTRICT paletteMap);
+void remap_run_sse4_1(
+    const uint8_t* RESTRICT src, uint8_t* RESTRICT dst, int32_t numPixels, const uint8_t* RESTRICT paletteMap);
+void remap_run_avx2(const uint8_t* RESTRICT src, uint8_t* RESTRICT dst, int32_t numPixels, const uint8_t* RESTRICT paletteMap);
+void remap_run_init();
+
+extern void (*remap_run_fn)(
+    const uint8_t* RESTRICT src, uint8_t* RESTRICT dst, int32_t numPixels, const uint8_t* RESTRICT paletteMap);
+
 std::optional<uint32_t> GetPaletteG1Index(colour_t paletteId);
 std::optional<PaletteMap> GetPaletteMapForColour(colour_t paletteId);
 
@@ -56,6 +56,37 @@ void mask_sse4_1(
     }
 }
 
+void remap_run_sse4_1(
+    const uint8_t* RESTRICT src, uint8_t* RESTRICT dst, int32_t numPixels, const uint8_t* RESTRICT paletteMap)
+{
+    const __m128i zero128 = {};
+    const __m128i lowNibbleMask = _mm_set1_epi8(0x0F);
+    int32_t i = 0;
+    for (; i + 16 <= numPixels; i += 16)
+    {
+        const __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        const __m128i dest = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + i));
+        const __m128i lowNibbles = _mm_and_si128(pixels, lowNibbleMask);
+        const __m128i highNibbles = _mm_and_si128(_mm_srli_epi16(pixels, 4), lowNibbleMask);
+
+        // _mm_shuffle_epi8 can only look up 16 entries, so look up every 16 entry block of the palette map and keep the
+        // result of the block each pixel falls in.
+        __m128i remapped = zero128;
+        for (int32_t block = 0; block < 16; block++)
+        {
+            const __m128i table = _mm_loadu_si128(reinterpret_cast<const __m128i*>(paletteMap + block * 16));
+            const __m128i lookup = _mm_shuffle_epi8(table, lowNibbles);
+            const __m128i inBlock = _mm_cmpeq_epi8(highNibbles, _mm_set1_epi8(static_cast<char>(block)));
+            remapped = _mm_blendv_epi8(remapped, lookup, inBlock);
+        }
+
+        const __m128i transparent = _mm_or_si128(_mm_cmpeq_epi8(pixels, zero128), _mm_cmpeq_epi8(remapped, zero128));
+        const __m128i blended = _mm_blendv_epi8(remapped, dest, transparent);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), blended);
+    }
+    remap_run_scalar(src + i, dst + i, numPixels - i, paletteMap);
+}
+
 #else
 
 #    ifdef OPENRCT2_X86
@@ -69,4 +100,10 @@ void mask_sse4_1(
     openrct2_assert(false, "SSE 4.1 function called on a CPU that doesn't support SSE 4.1");
 }
 
+void remap_run_sse4_1(
+    const uint8_t* RESTRICT src, uint8_t* RESTRICT dst, int32_t numPixels, const uint8_t* RESTRICT paletteMap)
+{
+    openrct2_assert(false, "SSE 4.1 function called on a CPU that doesn't support SSE 4.1");
+}
+
 #endif // __SSE4_1__
@@ -1458,6 +1458,9 @@ int32_t scrolling_text_setup(
     if (dpi->zoom_level > ZoomLevel{ 0 })
         return SPR_SCROLLING_TEXT_DEFAULT;
 
+    // Copies of the tile would keep using the image after it was handed to other text.
+    session.TileCacheFlags |= PaintCacheFlags::Uncacheable;
+
     _drawSCrollNextIndex++;
     ft.Rewind();
     int32_t scrollIndex = scrolling_text_get_matching_or_oldest(stringId, ft, scroll, scrollingMode, colour);
@@ -0,0 +1,269 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2021 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "SpriteCache.h"
+
+#include "Drawing.h"
+
+#include <algorithm>
+#include <atomic>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+struct DecodedSprite
+{
+    // The data the sprite was decoded from, used to detect images that were replaced without being invalidated.
+    const uint8_t* Source{};
+    int32_t Width{};
+    int32_t Height{};
+
+    // One byte per pixel of the image, pixels that are not part of any run are 0 and therefore transparent.
+    std::vector<uint8_t> Pixels;
+};
+
+struct SpriteCacheEntry
+{
+    ImageIndex Index;
+    std::shared_ptr<const DecodedSprite> Sprite;
+};
+
+// Estimate of the list and map nodes that are allocated for every entry.
+constexpr size_t EntryOverhead = sizeof(DecodedSprite) + 64;
+
+static std::mutex _mutex;
+static std::atomic<size_t> _budget{};
+static size_t _memoryUsed{};
+static SpriteCacheStats _stats{};
+
+// Most recently drawn sprites first.
+static std::list<SpriteCacheEntry> _lruList;
+static std::unordered_map<ImageIndex, std::list<SpriteCacheEntry>::iterator> _entries;
+
+static size_t GetEntrySize(const DecodedSprite& sprite)
+{
+    return sprite.Pixels.size() + EntryOverhead;
+}
+
+static void RemoveEntry(std::list<SpriteCacheEntry>::iterator it)
+{
+    _memoryUsed -= GetEntrySize(*it->Sprite);
+    _entries.erase(it->Index);
+    _lruList.erase(it);
+}
+
+static void EvictToBudget(size_t budget)
+{
+    while (_memoryUsed > budget && !_lruList.empty())
+    {
+        RemoveEntry(std::prev(_lruList.end()));
+        _stats.Evictions++;
+    }
+}
+
+void sprite_cache_set_budget(size_t budget)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _budget = budget;
+    EvictToBudget(budget);
+}
+
+SpriteCacheStats sprite_cache_get_stats()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto stats = _stats;
+    stats.Entries = _entries.size();
+    stats.MemoryUsed = _memoryUsed;
+    stats.MemoryBudget = _budget;
+    return stats;
+}
+
+void sprite_cache_reset_stats()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _stats = {};
+}
+
+void sprite_cache_invalidate(ImageIndex imageIndex)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto it = _entries.find(imageIndex);
+    if (it != _entries.end())
+    {
+        RemoveEntry(it->second);
+    }
+}
+
+void sprite_cache_clear()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _lruList.clear();
+    _entries.clear();
+    _memoryUsed = 0;
+}
+
+static std::shared_ptr<const DecodedSprite> DecodeRLESprite(const rct_g1_element& g1)
+{
+    auto sprite = std::make_shared<DecodedSprite>();
+    sprite->Source = g1.offset;
+    sprite->Width = g1.width;
+    sprite->Height = g1.height;
+    sprite->Pixels.resize(static_cast<size_t>(g1.width) * g1.height);
+
+    for (int32_t y = 0; y < sprite->Height; y++)
+    {
+        uint16_t lineOffset = g1.offset[y * 2] | (g1.offset[y * 2 + 1] << 8);
+        auto nextRun = g1.offset + lineOffset;
+        auto dstLineStart = sprite->Pixels.data() + static_cast<size_t>(sprite->Width) * y;
+
+        bool isEndOfLine = false;
+        while (!isEndOfLine)
+        {
+            auto src = nextRun;
+            auto dataSize = *src++;
+            auto firstPixelX = *src++;
+            isEndOfLine = (dataSize & 0x80) != 0;
+            dataSize &= 0x7F;
+            nextRun = src + dataSize;
+
+            int32_t numPixels = std::min<int32_t>(dataSize, sprite->Width - firstPixelX);
+            if (numPixels > 0)
+            {
+                std::copy_n(src, numPixels, dstLineStart + firstPixelX);
+            }
+        }
+    }
+    return sprite;
+}
+
+static std::shared_ptr<const DecodedSprite> GetDecodedSprite(const rct_g1_element& g1, ImageIndex imageIndex, size_t budget)
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        auto it = _entries.find(imageIndex);
+        if (it != _entries.end())
+        {
+            auto& sprite = *it->second->Sprite;
+            if (sprite.Source == g1.offset && sprite.Width == g1.width && sprite.Height == g1.height)
+            {
+                _stats.Hits++;
+                _lruList.splice(_lruList.begin(), _lruList, it->second);
+                return it->second->Sprite;
+            }
+            RemoveEntry(it->second);
+        }
+        _stats.Misses++;
+    }
+
+    // Decode outside of the lock so other threads can keep drawing cached sprites.
+    auto sprite = DecodeRLESprite(g1);
+    auto size = GetEntrySize(*sprite);
+    if (size <= budget)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_entries.find(imageIndex) == _entries.end())
+        {
+            _lruList.push_front({ imageIndex, sprite });
+            _entries[imageIndex] = _lruList.begin();
+            _memoryUsed += size;
+            EvictToBudget(_budget);
+        }
+    }
+    return sprite;
+}
+
+/**
+ * Samples the same pixels as DrawRLESpriteMinify: every zoom-th column and row starting at the source position.
+ */
+template<DrawBlendOp TBlendOp, size_t TZoom>
+static void FASTCALL DrawDecodedSprite(rct_drawpixelinfo& dpi, const DrawSpriteArgs& args, const DecodedSprite& sprite)
+{
+    auto dst0 = args.DestinationBits;
+    auto srcX = args.SrcX;
+    auto srcY = args.SrcY;
+    auto width = args.Width;
+    auto height = args.Height;
+    auto& paletteMap = args.PalMap;
+    int32_t zoom = 1 << TZoom;
+    auto dstLineWidth = (static_cast<size_t>(dpi.width) >> TZoom) + dpi.pitch;
+
+    if (srcY < 0)
+    {
+        srcY += zoom;
+        height -= zoom;
+        dst0 += dstLineWidth;
+    }
+
+    // Columns left of the image are transparent, start at the first sampled column inside it.
+    int32_t startX = srcX < 0 ? ((-srcX + zoom - 1) >> TZoom) << TZoom : 0;
+    int32_t endX = std::min(width, sprite.Width - srcX);
+
+    for (int32_t i = 0; i < height; i += zoom)
+    {
+        int32_t y = srcY + i;
+        if (y < 0 || y >= sprite.Height)
+        {
+            continue;
+        }
+
+        auto src = sprite.Pixels.data() + static_cast<size_t>(sprite.Width) * y + srcX;
+        auto dst = dst0 + dstLineWidth * (i >> TZoom);
+        for (int32_t x = startX; x < endX; x += zoom)
+        {
+            BlitPixel<TBlendOp>(src + x, dst + (x >> TZoom), paletteMap);
+        }
+    }
+}
+
+template<DrawBlendOp TBlendOp>
+static bool FASTCALL DrawDecodedSprite(rct_drawpixelinfo& dpi, const DrawSpriteArgs& args, const DecodedSprite& sprite)
+{
+    switch (static_cast<int8_t>(dpi.zoom_level))
+    {
+        case 1:
+            DrawDecodedSprite<TBlendOp, 1>(dpi, args, sprite);
+            return true;
+        case 2:
+            DrawDecodedSprite<TBlendOp, 2>(dpi, args, sprite);
+            return true;
+        case 3:
+            DrawDecodedSprite<TBlendOp, 3>(dpi, args, sprite);
+            return true;
+        default:
+            return false;
+    }
+}
+
+bool FASTCALL sprite_cache_draw(rct_drawpixelinfo& dpi, const DrawSpriteArgs& args, ImageIndex imageIndex)
+{
+    // At zoom level 0 the runs are copied directly, which is faster than skipping transparent pixels of a decoded copy.
+    auto budget = _budget.load(std::memory_order_relaxed);
+    auto zoomLevel = static_cast<int8_t>(dpi.zoom_level);
+    if (budget == 0 || zoomLevel < 1 || zoomLevel > 3 || !(args.SourceImage.flags & G1_FLAG_RLE_COMPRESSION))
+    {
+        return false;
+    }
+
+    auto sprite = GetDecodedSprite(args.SourceImage, imageIndex, budget);
+    if (args.Image.HasPrimary())
+    {
+        if (args.Image.IsBlended())
+        {
+            return DrawDecodedSprite<BLEND_TRANSPARENT | BLEND_SRC | BLEND_DST>(dpi, args, *sprite);
+        }
+        return DrawDecodedSprite<BLEND_TRANSPARENT | BLEND_SRC>(dpi, args, *sprite);
+    }
+    if (args.Image.IsBlended())
+    {
+        return DrawDecodedSprite<BLEND_TRANSPARENT | BLEND_DST>(dpi, args, *sprite);
+    }
+    return DrawDecodedSprite<BLEND_TRANSPARENT>(dpi, args, *sprite);
+}
@@ -0,0 +1,47 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2021 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#pragma once
+
+#include "../common.h"
+#include "ImageId.hpp"
+
+struct rct_drawpixelinfo;
+struct DrawSpriteArgs;
+
+struct SpriteCacheStats
+{
+    uint64_t Hits{};
+    uint64_t Misses{};
+    uint64_t Evictions{};
+    size_t Entries{};
+    size_t MemoryUsed{};
+    size_t MemoryBudget{};
+};
+
+/**
+ * Sets the amount of memory the decoded sprites may use, least recently drawn sprites are evicted to stay within it.
+ * A budget of 0 disables the cache.
+ */
+void sprite_cache_set_budget(size_t budget);
+SpriteCacheStats sprite_cache_get_stats();
+void sprite_cache_reset_stats();
+
+/**
+ * Discards the decoded copy of an image, must be called whenever the g1 element of the image is replaced.
+ */
+void sprite_cache_invalidate(ImageIndex imageIndex);
+void sprite_cache_clear();
+
+/**
+ * Draws a zoomed out RLE image from its decoded copy, decoding it first if it is not cached yet. Produces the same pixels
+ * as gfx_rle_sprite_to_buffer. Returns false without drawing anything when the cache is disabled or does not handle the
+ * zoom level.
+ */
+bool FASTCALL sprite_cache_draw(rct_drawpixelinfo& dpi, const DrawSpriteArgs& args, ImageIndex imageIndex);
@@ -17,6 +17,7 @@
 #include "../interface/Screenshot.h"
 #include "../interface/Viewport.h"
 #include "../interface/Window.h"
+#include "../profiling/Profiling.h"
 #include "../ui/UiContext.h"
 #include "../util/Util.h"
 #include "../world/Climate.h"
@@ -207,17 +208,24 @@ void X8DrawingEngine::EndDraw()
 
 void X8DrawingEngine::PaintWindows()
 {
+    TRACED_SCOPE("X8DrawingEngine::PaintWindows");
+
     window_reset_visibilities();
 
     // Redraw dirty regions before updating the viewports, otherwise
     // when viewports get panned, they copy dirty pixels
     DrawAllDirtyBlocks();
-    window_update_all_viewports();
+    {
+        TRACED_SCOPE("window_update_all_viewports");
+        window_update_all_viewports();
+    }
     DrawAllDirtyBlocks();
 }
 
 void X8DrawingEngine::PaintWeather()
 {
+    TRACED_SCOPE("X8DrawingEngine::PaintWeather");
+
     DrawWeather(&_bitsDPI, &_weatherDrawer);
 }
 
@@ -442,6 +450,7 @@ void X8DrawingEngine::DrawDirtyBlocks(uint32_t x, uint32_t y, uint32_t columns,
     }
 
     // Draw region
+    TRACED_SCOPE("window_draw_all");
     OnDrawDirtyBlock(x, y, columns, rows);
     window_draw_all(&_bitsDPI, left, top, right, bottom);
 }
@@ -15,27 +15,26 @@
 #include "EntityBase.h"
 #include "EntityRegistry.h"
 
-#include <list>
+#include <algorithm>
 #include <vector>
 
-const std::list<uint16_t>& GetEntityList(const EntityType id);
+const std::vector<uint16_t>& GetEntityList(const EntityType id);
 
 uint16_t GetEntityListCount(EntityType list);
 uint16_t GetMiscEntityCount();
 uint16_t GetNumFreeEntities();
-const std::vector<uint16_t>& GetEntityTileList(const CoordsXY& spritePos);
+uint16_t GetFirstEntityOnTile(const CoordsXY& spritePos);
+uint16_t GetNextEntityOnTile(uint16_t entityIndex);
 
 template<typename T> class EntityTileIterator
 {
 private:
-    std::vector<uint16_t>::const_iterator iter;
-    std::vector<uint16_t>::const_iterator end;
+    uint16_t nextId;
     T* Entity = nullptr;
 
 public:
-    EntityTileIterator(std::vector<uint16_t>::const_iterator _iter, std::vector<uint16_t>::const_iterator _end)
-        : iter(_iter)
-        , end(_end)
+    EntityTileIterator(uint16_t _nextId)
+        : nextId(_nextId)
     {
         ++(*this);
     }
@@ -43,9 +42,11 @@ public:
     {
         Entity = nullptr;
 
-        while (iter != end && Entity == nullptr)
+        while (nextId != SPRITE_INDEX_NULL && Entity == nullptr)
         {
-            Entity = GetEntity<T>(*iter++);
+            const auto id = nextId;
+            nextId = GetNextEntityOnTile(id);
+            Entity = GetEntity<T>(id);
         }
         return *this;
     }
@@ -54,7 +55,7 @@ public:
     {
         EntityTileIterator retval = *this;
         ++(*this);
-        return *iter;
+        return retval;
     }
     bool operator==(EntityTileIterator other) const
     {
@@ -79,35 +80,88 @@ public:
 template<typename T = EntityBase> class EntityTileList
 {
 private:
-    const std::vector<uint16_t>& vec;
+    uint16_t firstId;
 
 public:
     EntityTileList(const CoordsXY& loc)
-        : vec(GetEntityTileList(loc))
+        : firstId(GetFirstEntityOnTile(loc))
     {
     }
 
     EntityTileIterator<T> begin()
     {
-        return EntityTileIterator<T>(std::begin(vec), std::end(vec));
+        return EntityTileIterator<T>(firstId);
     }
     EntityTileIterator<T> end()
     {
-        return EntityTileIterator<T>(std::end(vec), std::end(vec));
+        return EntityTileIterator<T>(SPRITE_INDEX_NULL);
+    }
+};
+
+/**
+ * Position in one of the entity lists, which are sorted vectors of sprite indices. Entities may be created and removed
+ * while iterating, the cursor then behaves exactly like the linked lists the entity lists used to be: the entity
+ * following the current one is fixed as soon as the current one is reached, so entities created after that point are
+ * only visited when they come after the following entity.
+ */
+class EntityListCursor
+{
+private:
+    static constexpr uint16_t End = SPRITE_INDEX_NULL;
+
+    const std::vector<uint16_t>* vec;
+    size_t pos = 0;
+    uint16_t nextId = End;
+
+public:
+    EntityListCursor(const std::vector<uint16_t>& _vec, bool atEnd)
+        : vec(&_vec)
+    {
+        if (!atEnd && !_vec.empty())
+        {
+            nextId = _vec.front();
+        }
+    }
+
+    bool AtEnd() const
+    {
+        return nextId == End;
+    }
+
+    /**
+     * Returns the sprite index at the cursor and moves past it, or SPRITE_INDEX_NULL once the end is reached.
+     */
+    uint16_t Next()
+    {
+        if (nextId == End)
+            return End;
+
+        // The list may have changed since the cursor was moved, find the entity again.
+        if (pos >= vec->size() || (*vec)[pos] != nextId)
+        {
+            pos = std::lower_bound(vec->begin(), vec->end(), nextId) - vec->begin();
+            if (pos >= vec->size())
+            {
+                nextId = End;
+                return End;
+            }
+        }
+
+        const auto id = (*vec)[pos++];
+        nextId = pos < vec->size() ? (*vec)[pos] : End;
+        return id;
     }
 };
 
 template<typename T> class EntityListIterator
 {
 private:
-    std::list<uint16_t>::const_iterator iter;
-    std::list<uint16_t>::const_iterator end;
+    EntityListCursor cursor;
     T* Entity = nullptr;
 
 public:
-    EntityListIterator(std::list<uint16_t>::const_iterator _iter, std::list<uint16_t>::const_iterator _end)
-        : iter(_iter)
-        , end(_end)
+    EntityListIterator(const EntityListCursor& _cursor)
+        : cursor(_cursor)
     {
         ++(*this);
     }
@@ -115,9 +169,9 @@ public:
     {
         Entity = nullptr;
 
-        while (iter != end && Entity == nullptr)
+        while (!cursor.AtEnd() && Entity == nullptr)
         {
-            Entity = GetEntity<T>(*iter++);
+            Entity = GetEntity<T>(cursor.Next());
         }
         return *this;
     }
@@ -126,7 +180,7 @@ public:
     {
         EntityListIterator retval = *this;
         ++(*this);
-        return *iter;
+        return retval;
     }
     bool operator==(EntityListIterator other) const
     {
@@ -152,7 +206,7 @@ template<typename T = EntityBase> class EntityList
 {
 private:
     using EntityListIterator_t = EntityListIterator<T>;
-    const std::list<uint16_t>& vec;
+    const std::vector<uint16_t>& vec;
 
 public:
     EntityList()
@@ -162,10 +216,10 @@ public:
 
     EntityListIterator_t begin() const
     {
-        return EntityListIterator_t(std::cbegin(vec), std::cend(vec));
+        return EntityListIterator_t(EntityListCursor(vec, false));
     }
     EntityListIterator_t end() const
     {
-        return EntityListIterator_t(std::cend(vec), std::cend(vec));
+        return EntityListIterator_t(EntityListCursor(vec, true));
     }
 };
@@ -15,6 +15,7 @@
 #include "../core/DataSerialiser.h"
 #include "../core/Guard.hpp"
 #include "../core/MemoryStream.h"
+#include "../entity/Guest.h"
 #include "../entity/Peep.h"
 #include "../entity/Staff.h"
 #include "../interface/Viewport.h"
@@ -25,35 +26,128 @@
 #include "Duck.h"
 #include "EntityTweener.h"
 #include "Fountain.h"
+#include "Litter.h"
+#include "LitterIndex.h"
+#include "MechanicIndex.h"
 #include "MoneyEffect.h"
 #include "Particle.h"
 
 #include <algorithm>
 #include <cmath>
+#include <cstring>
 #include <iterator>
+#include <limits>
+#include <memory>
 #include <numeric>
 #include <vector>
 
-union Entity
+/**
+ * Storage for all entities of one type. Entities are kept in chunks of consecutive slots so that iterating a type
+ * touches only memory of that type, slots do not move while in use so pointers to entities stay valid until they are
+ * removed.
+ */
+struct EntityPool
 {
-    uint8_t pad_00[0x200];
-    EntityBase base;
-    Entity()
-        : pad_00()
+    static constexpr size_t ChunkSize = 256;
+
+    size_t Stride{};
+    std::vector<std::unique_ptr<uint8_t[]>> Chunks;
+    // Reverse order, so the lowest slot is used first like sprite indices are.
+    std::vector<uint16_t> FreeSlots;
+
+    EntityBase* Get(uint16_t slot) const
+    {
+        return reinterpret_cast<EntityBase*>(Chunks[slot / ChunkSize].get() + (slot % ChunkSize) * Stride);
+    }
+
+    uint16_t Allocate()
+    {
+        if (FreeSlots.empty())
+        {
+            const auto firstSlot = Chunks.size() * ChunkSize;
+            Chunks.push_back(std::make_unique<uint8_t[]>(ChunkSize * Stride));
+            for (auto slot = firstSlot + ChunkSize; slot > firstSlot; slot--)
+            {
+                FreeSlots.push_back(static_cast<uint16_t>(slot - 1));
+            }
+        }
+        const auto slot = FreeSlots.back();
+        FreeSlots.pop_back();
+        return slot;
+    }
+
+    void Free(uint16_t slot)
     {
+        FreeSlots.insert(std::upper_bound(std::rbegin(FreeSlots), std::rend(FreeSlots), slot).base(), slot);
+    }
+
+    void Clear()
+    {
+        // The chunks are kept so that pointers to removed entities still point to null entities.
+        FreeSlots.clear();
+        for (auto chunk = Chunks.size(); chunk > 0; chunk--)
+        {
+            std::memset(Chunks[chunk - 1].get(), 0, ChunkSize * Stride);
+            for (auto slot = chunk * ChunkSize; slot > (chunk - 1) * ChunkSize; slot--)
+            {
+                Get(static_cast<uint16_t>(slot - 1))->Type = EntityType::Null;
+                FreeSlots.push_back(static_cast<uint16_t>(slot - 1));
+            }
+        }
     }
 };
 
-static Entity _entities[MAX_ENTITIES]{};
-static std::array<std::list<uint16_t>, EnumValue(EntityType::Count)> gEntityLists;
+template<typename... T> static std::array<EntityPool, EnumValue(EntityType::Count)> CreateEntityPools()
+{
+    std::array<EntityPool, EnumValue(EntityType::Count)> pools;
+    ((pools[EnumValue(T::cEntityType)].Stride = sizeof(T)), ...);
+    return pools;
+}
+
+static std::array<EntityPool, EnumValue(EntityType::Count)> _entityPools = CreateEntityPools<
+    Vehicle, Guest, Staff, Litter, SteamParticle, MoneyEffect, VehicleCrashParticle, ExplosionCloud, CrashSplashParticle,
+    ExplosionFlare, JumpingFountain, Balloon, Duck>();
+
+// Stands in for every sprite index that is not in use.
+static EntityBase _nullEntities[MAX_ENTITIES]{};
+
+static std::array<EntityBase*, MAX_ENTITIES> CreateEntityPointers()
+{
+    std::array<EntityBase*, MAX_ENTITIES> entities;
+    for (size_t i = 0; i < MAX_ENTITIES; i++)
+    {
+        _nullEntities[i].Type = EntityType::Null;
+        _nullEntities[i].sprite_index = static_cast<uint16_t>(i);
+        entities[i] = &_nullEntities[i];
+    }
+    return entities;
+}
+
+static std::array<EntityBase*, MAX_ENTITIES> _entities = CreateEntityPointers();
+static std::array<uint16_t, MAX_ENTITIES> _entitySlots{};
+// Sprite indices of each type, sorted so that entities are always updated in the same order.
+static std::array<std::vector<uint16_t>, EnumValue(EntityType::Count)> gEntityLists;
 static std::vector<uint16_t> _freeIdList;
 
 static bool _entityFlashingList[MAX_ENTITIES];
 
 constexpr const uint32_t SPATIAL_INDEX_SIZE = (MAXIMUM_MAP_SIZE_TECHNICAL * MAXIMUM_MAP_SIZE_TECHNICAL) + 1;
 constexpr const uint32_t SPATIAL_INDEX_LOCATION_NULL = SPATIAL_INDEX_SIZE - 1;
+constexpr const uint32_t SPATIAL_INDEX_NONE = std::numeric_limits<uint32_t>::max();
+
+struct EntitySpatialNode
+{
+    uint32_t Tile = SPATIAL_INDEX_NONE;
+    uint16_t Prev = SPRITE_INDEX_NULL;
+    uint16_t Next = SPRITE_INDEX_NULL;
+};
 
-static std::array<std::vector<uint16_t>, SPATIAL_INDEX_SIZE> gEntitySpatialIndex;
+// The entities on each tile form a doubly linked list in sprite index order, with the first entity of every tile in
+// _spatialHeads and the links stored per entity. Entities without a location can be numerous, so their sprite indices
+// are also kept in a sorted vector to find where to insert without walking the list.
+static std::vector<uint16_t> _spatialHeads(SPATIAL_INDEX_SIZE, SPRITE_INDEX_NULL);
+static std::vector<EntitySpatialNode> _spatialNodes(MAX_ENTITIES);
+static std::vector<uint16_t> _spatialNullList;
 
 static void FreeEntity(EntityBase& entity);
 
@@ -118,7 +212,7 @@ std::string EntitiesChecksum::ToString() const
 
 EntityBase* TryGetEntity(size_t entityIndex)
 {
-    return entityIndex >= MAX_ENTITIES ? nullptr : &_entities[entityIndex].base;
+    return entityIndex >= MAX_ENTITIES ? nullptr : _entities[entityIndex];
 }
 
 EntityBase* GetEntity(size_t entityIndex)
@@ -131,9 +225,14 @@ EntityBase* GetEntity(size_t entityIndex)
     return TryGetEntity(entityIndex);
 }
 
-const std::vector<uint16_t>& GetEntityTileList(const CoordsXY& spritePos)
+uint16_t GetFirstEntityOnTile(const CoordsXY& spritePos)
 {
-    return gEntitySpatialIndex[GetSpatialIndexOffset(spritePos)];
+    return _spatialHeads[GetSpatialIndexOffset(spritePos)];
+}
+
+uint16_t GetNextEntityOnTile(uint16_t entityIndex)
+{
+    return _spatialNodes[entityIndex].Next;
 }
 
 static void ResetEntityLists()
@@ -153,7 +252,7 @@ static void ResetFreeIds()
     std::iota(std::rbegin(_freeIdList), std::rend(_freeIdList), 0);
 }
 
-const std::list<uint16_t>& GetEntityList(const EntityType id)
+const std::vector<uint16_t>& GetEntityList(const EntityType id)
 {
     return gEntityLists[EnumValue(id)];
 }
@@ -177,18 +276,19 @@ void ResetAllEntities()
         FreeEntity(*spr);
     }
 
-    std::fill(std::begin(_entities), std::end(_entities), Entity());
+    for (auto& pool : _entityPools)
+    {
+        pool.Clear();
+    }
     OpenRCT2::RideUse::GetHistory().Clear();
     OpenRCT2::RideUse::GetTypeHistory().Clear();
     for (int32_t i = 0; i < MAX_ENTITIES; ++i)
     {
-        auto* spr = GetEntity(i);
-        if (spr == nullptr)
-        {
-            continue;
-        }
+        auto* spr = &_nullEntities[i];
+        *spr = {};
         spr->Type = EntityType::Null;
         spr->sprite_index = i;
+        _entities[i] = spr;
 
         _entityFlashingList[i] = false;
     }
@@ -197,6 +297,7 @@ void ResetAllEntities()
     ResetEntitySpatialIndices();
 }
 
+static void EntitySpatialLink(uint16_t entityIndex, uint32_t tile, uint16_t prev, uint16_t next);
 static void EntitySpatialInsert(EntityBase* entity, const CoordsXY& newLoc);
 
 /**
@@ -207,18 +308,27 @@ static void EntitySpatialInsert(EntityBase* entity, const CoordsXY& newLoc);
  */
 void ResetEntitySpatialIndices()
 {
-    for (auto& vec : gEntitySpatialIndex)
-    {
-        vec.clear();
-    }
-    for (size_t i = 0; i < MAX_ENTITIES; i++)
+    std::fill(std::begin(_spatialHeads), std::end(_spatialHeads), SPRITE_INDEX_NULL);
+    std::fill(std::begin(_spatialNodes), std::end(_spatialNodes), EntitySpatialNode{});
+    _spatialNullList.clear();
+
+    // Back to front so that every entity goes to the start of its list.
+    for (size_t i = MAX_ENTITIES; i > 0; i--)
     {
-        auto* spr = GetEntity(i);
+        auto* spr = GetEntity(i - 1);
         if (spr != nullptr && spr->Type != EntityType::Null)
         {
-            EntitySpatialInsert(spr, { spr->x, spr->y });
+            const auto tile = static_cast<uint32_t>(GetSpatialIndexOffset({ spr->x, spr->y }));
+            EntitySpatialLink(spr->sprite_index, tile, SPRITE_INDEX_NULL, _spatialHeads[tile]);
+            if (tile == SPATIAL_INDEX_LOCATION_NULL)
+            {
+                _spatialNullList.push_back(spr->sprite_index);
+            }
         }
     }
+    std::reverse(std::begin(_spatialNullList), std::end(_spatialNullList));
+    OpenRCT2::LitterIndex::Reset();
+    OpenRCT2::MechanicIndex::Reset();
 }
 
 #ifndef DISABLE_NETWORK
@@ -255,17 +365,41 @@ EntitiesChecksum GetAllEntitiesChecksum()
 
 #endif // DISABLE_NETWORK
 
-static void EntityReset(EntityBase* entity)
+static EntityBase* EntityAllocate(uint16_t entityIndex, const EntityType type)
 {
-    // Need to retain how the sprite is linked in lists
-    uint16_t entityIndex = entity->sprite_index;
+    auto& pool = _entityPools[EnumValue(type)];
+    const auto slot = pool.Allocate();
+    auto* entity = pool.Get(slot);
+
+    // Need to reset all sprite data, as the uninitialised values
+    // may contain garbage and cause a desync later on.
+    std::memset(static_cast<void*>(entity), 0, pool.Stride);
+    entity->sprite_index = entityIndex;
+    entity->Type = EntityType::Null;
     _entityFlashingList[entityIndex] = false;
 
-    Entity* spr = reinterpret_cast<Entity*>(entity);
-    *spr = Entity();
+    _entities[entityIndex] = entity;
+    _entitySlots[entityIndex] = slot;
+    return entity;
+}
 
+static void EntityReset(EntityBase* entity)
+{
+    const auto entityIndex = entity->sprite_index;
+    auto& pool = _entityPools[EnumValue(entity->Type)];
+    _entityFlashingList[entityIndex] = false;
+
+    // Left as a null entity for anything still holding a pointer to it.
+    std::memset(static_cast<void*>(entity), 0, pool.Stride);
     entity->sprite_index = entityIndex;
     entity->Type = EntityType::Null;
+    pool.Free(_entitySlots[entityIndex]);
+
+    auto* nullEntity = &_nullEntities[entityIndex];
+    *nullEntity = {};
+    nullEntity->sprite_index = entityIndex;
+    nullEntity->Type = EntityType::Null;
+    _entities[entityIndex] = nullEntity;
 }
 
 static constexpr uint16_t MAX_MISC_SPRITES = 300;
@@ -304,11 +438,9 @@ uint16_t GetMiscEntityCount()
     return count;
 }
 
-static void PrepareNewEntity(EntityBase* base, const EntityType type)
+static EntityBase* PrepareNewEntity(uint16_t entityIndex, const EntityType type)
 {
-    // Need to reset all sprite data, as the uninitialised values
-    // may contain garbage and cause a desync later on.
-    EntityReset(base);
+    auto* base = EntityAllocate(entityIndex, type);
 
     base->Type = type;
     AddToEntityList(base);
@@ -322,6 +454,11 @@ static void PrepareNewEntity(EntityBase* base, const EntityType type)
     base->SpriteRect = {};
 
     EntitySpatialInsert(base, { LOCATION_NULL, 0 });
+    if (type == EntityType::Litter)
+    {
+        OpenRCT2::LitterIndex::Add(*base);
+    }
+    return base;
 }
 
 EntityBase* CreateEntity(EntityType type)
@@ -344,16 +481,10 @@ EntityBase* CreateEntity(EntityType type)
         }
     }
 
-    auto* entity = GetEntity(_freeIdList.back());
-    if (entity == nullptr)
-    {
-        return nullptr;
-    }
+    const auto entityIndex = _freeIdList.back();
     _freeIdList.pop_back();
 
-    PrepareNewEntity(entity, type);
-
-    return entity;
+    return PrepareNewEntity(entityIndex, type);
 }
 
 EntityBase* CreateEntityAt(const uint16_t index, const EntityType type)
@@ -364,16 +495,9 @@ EntityBase* CreateEntityAt(const uint16_t index, const EntityType type)
         return nullptr;
     }
 
-    auto* entity = GetEntity(index);
-    if (entity == nullptr)
-    {
-        return nullptr;
-    }
-
     _freeIdList.erase(std::next(id).base());
 
-    PrepareNewEntity(entity, type);
-    return entity;
+    return PrepareNewEntity(index, type);
 }
 
 template<typename T> void MiscUpdateAllType()
@@ -400,29 +524,88 @@ void UpdateAllMiscEntities()
         Balloon, Duck>();
 }
 
+static void EntitySpatialLink(uint16_t entityIndex, uint32_t tile, uint16_t prev, uint16_t next)
+{
+    auto& link = _spatialNodes[entityIndex];
+    link.Tile = tile;
+    link.Prev = prev;
+    link.Next = next;
+    if (prev == SPRITE_INDEX_NULL)
+    {
+        _spatialHeads[tile] = entityIndex;
+    }
+    else
+    {
+        _spatialNodes[prev].Next = entityIndex;
+    }
+    if (next != SPRITE_INDEX_NULL)
+    {
+        _spatialNodes[next].Prev = entityIndex;
+    }
+}
+
+static void EntitySpatialUnlink(uint16_t entityIndex)
+{
+    auto& link = _spatialNodes[entityIndex];
+    if (link.Tile == SPATIAL_INDEX_NONE)
+        return;
+
+    if (link.Prev == SPRITE_INDEX_NULL)
+    {
+        _spatialHeads[link.Tile] = link.Next;
+    }
+    else
+    {
+        _spatialNodes[link.Prev].Next = link.Next;
+    }
+    if (link.Next != SPRITE_INDEX_NULL)
+    {
+        _spatialNodes[link.Next].Prev = link.Prev;
+    }
+    if (link.Tile == SPATIAL_INDEX_LOCATION_NULL)
+    {
+        auto it = std::lower_bound(std::begin(_spatialNullList), std::end(_spatialNullList), entityIndex);
+        _spatialNullList.erase(it);
+    }
+    link = {};
+}
+
 // Performs a search to ensure that insert keeps next_in_quadrant in sprite_index order
 static void EntitySpatialInsert(EntityBase* entity, const CoordsXY& newLoc)
 {
-    size_t newIndex = GetSpatialIndexOffset(newLoc);
-    auto& spatialVector = gEntitySpatialIndex[newIndex];
-    auto index = std::lower_bound(std::begin(spatialVector), std::end(spatialVector), entity->sprite_index);
-    spatialVector.insert(index, entity->sprite_index);
+    const auto entityIndex = entity->sprite_index;
+    EntitySpatialUnlink(entityIndex);
+
+    const auto tile = static_cast<uint32_t>(GetSpatialIndexOffset(newLoc));
+    uint16_t prev = SPRITE_INDEX_NULL;
+    uint16_t next = _spatialHeads[tile];
+    if (tile == SPATIAL_INDEX_LOCATION_NULL)
+    {
+        auto it = std::lower_bound(std::begin(_spatialNullList), std::end(_spatialNullList), entityIndex);
+        prev = it == std::begin(_spatialNullList) ? SPRITE_INDEX_NULL : *std::prev(it);
+        next = it == std::end(_spatialNullList) ? SPRITE_INDEX_NULL : *it;
+        _spatialNullList.insert(it, entityIndex);
+    }
+    else
+    {
+        while (next != SPRITE_INDEX_NULL && next < entityIndex)
+        {
+            prev = next;
+            next = _spatialNodes[next].Next;
+        }
+    }
+    EntitySpatialLink(entityIndex, tile, prev, next);
 }
 
 static void EntitySpatialRemove(EntityBase* entity)
 {
     size_t currentIndex = GetSpatialIndexOffset({ entity->x, entity->y });
-    auto& spatialVector = gEntitySpatialIndex[currentIndex];
-    auto index = std::lower_bound(std::begin(spatialVector), std::end(spatialVector), entity->sprite_index);
-    if (index != std::end(spatialVector) && *index == entity->sprite_index)
-    {
-        spatialVector.erase(index, index + 1);
-    }
-    else
+    if (_spatialNodes[entity->sprite_index].Tile != currentIndex)
     {
         log_warning("Bad sprite spatial index. Rebuilding the spatial index...");
         ResetEntitySpatialIndices();
     }
+    EntitySpatialUnlink(entity->sprite_index);
 }
 
 static void EntitySpatialMove(EntityBase* entity, const CoordsXY& newLoc)
@@ -451,6 +634,14 @@ void EntityBase::MoveTo(const CoordsXYZ& newLocation)
     }
 
     EntitySpatialMove(this, loc);
+    if (Type == EntityType::Litter)
+    {
+        OpenRCT2::LitterIndex::Remove(*this);
+    }
+    else if (Type == EntityType::Staff)
+    {
+        OpenRCT2::MechanicIndex::Remove(*this);
+    }
 
     if (loc.x == LOCATION_NULL)
     {
@@ -463,6 +654,15 @@ void EntityBase::MoveTo(const CoordsXYZ& newLocation)
         EntitySetCoordinates(loc, this);
         Invalidate(); // Invalidate new position.
     }
+
+    if (Type == EntityType::Litter)
+    {
+        OpenRCT2::LitterIndex::Add(*this);
+    }
+    else if (Type == EntityType::Staff)
+    {
+        OpenRCT2::MechanicIndex::Add(*this);
+    }
 }
 
 void EntitySetCoordinates(const CoordsXYZ& entityPos, EntityBase* entity)
@@ -505,6 +705,14 @@ void EntityRemove(EntityBase* entity)
 
     EntityTweener::Get().RemoveEntity(entity);
     RemoveFromEntityList(entity); // remove from existing list
+    if (entity->Type == EntityType::Litter)
+    {
+        OpenRCT2::LitterIndex::Remove(*entity);
+    }
+    else if (entity->Type == EntityType::Staff)
+    {
+        OpenRCT2::MechanicIndex::Remove(*entity);
+    }
     AddToFreeList(entity->sprite_index);
 
     EntitySpatialRemove(entity);
@@ -29,7 +29,10 @@
 #include "../management/NewsItem.h"
 #include "../network/network.h"
 #include "../peep/GuestPathfinding.h"
+#include "../peep/GuestThink.h"
 #include "../peep/RideUseSystem.h"
+#include "../peep/SurroundingsCache.h"
+#include "../profiling/Profiling.h"
 #include "../rct2/RCT2.h"
 #include "../ride/Ride.h"
 #include "../ride/RideData.h"
@@ -41,12 +44,14 @@
 #include "../scripting/HookEngine.h"
 #include "../scripting/ScriptEngine.h"
 #include "../util/Math.hpp"
+#include "../util/Util.h"
 #include "../windows/Intent.h"
 #include "../world/Climate.h"
 #include "../world/Footpath.h"
 #include "../world/LargeScenery.h"
 #include "../world/Map.h"
 #include "../world/Park.h"
+#include "../world/RidePresenceIndex.h"
 #include "../world/Scenery.h"
 #include "../world/Surface.h"
 #include "../world/TileElementsView.h"
@@ -432,7 +437,6 @@ static void peep_update_ride_nausea_growth(Guest* peep, Ride* ride);
 static bool peep_should_go_on_ride_again(Guest* peep, Ride* ride);
 static bool peep_should_preferred_intensity_increase(Guest* peep);
 static bool peep_really_liked_ride(Guest* peep, Ride* ride);
-static PeepThoughtType peep_assess_surroundings(int16_t centre_x, int16_t centre_y, int16_t centre_z);
 static void peep_update_hunger(Guest* peep);
 static void peep_decide_whether_to_leave_park(Guest* peep);
 static void peep_leave_park(Guest* peep);
@@ -892,6 +896,8 @@ void Guest::loc_68FA89()
 
 void Guest::Tick128UpdateGuest(int32_t index)
 {
+    PROFILED_SCOPE("Guest::Tick128UpdateGuest");
+
     if (static_cast<uint32_t>(index & 0x1FF) == (gCurrentTicks & 0x1FF))
     {
         /* Effect of masking with 0x1FF here vs mask 0x7F,
@@ -958,7 +964,11 @@ void Guest::Tick128UpdateGuest(int32_t index)
                 SurroundingsThoughtTimeout = 0;
                 if (x != LOCATION_NULL)
                 {
-                    PeepThoughtType thought_type = peep_assess_surroundings(x & 0xFFE0, y & 0xFFE0, z);
+                    PeepThoughtType thought_type;
+                    if (!OpenRCT2::GuestThink::TryTakeSurroundingsThought(*this, thought_type))
+                    {
+                        thought_type = peep_assess_surroundings(x & 0xFFE0, y & 0xFFE0, z);
+                    }
 
                     if (thought_type != PeepThoughtType::None)
                     {
@@ -1833,7 +1843,11 @@ void Guest::PickRideToGoOn()
 Ride* Guest::FindBestRideToGoOn()
 {
     // Pick the most exciting ride
-    auto rideConsideration = FindRidesToGoOn();
+    BitSet<MAX_RIDES> rideConsideration;
+    if (!OpenRCT2::GuestThink::TryTakeRidesToGoOn(*this, rideConsideration))
+    {
+        rideConsideration = FindRidesToGoOn();
+    }
     Ride* mostExcitingRide = nullptr;
     for (auto& ride : GetRideManager())
     {
@@ -1855,7 +1869,7 @@ Ride* Guest::FindBestRideToGoOn()
     return mostExcitingRide;
 }
 
-BitSet<MAX_RIDES> Guest::FindRidesToGoOn()
+BitSet<MAX_RIDES> Guest::FindRidesToGoOn() const
 {
     BitSet<MAX_RIDES> rideConsideration;
 
@@ -1879,24 +1893,7 @@ BitSet<MAX_RIDES> Guest::FindRidesToGoOn()
         constexpr auto radius = 10 * 32;
         int32_t cx = floor2(x, 32);
         int32_t cy = floor2(y, 32);
-        for (int32_t tileX = cx - radius; tileX <= cx + radius; tileX += COORDS_XY_STEP)
-        {
-            for (int32_t tileY = cy - radius; tileY <= cy + radius; tileY += COORDS_XY_STEP)
-            {
-                auto location = CoordsXY{ tileX, tileY };
-                if (!map_is_location_valid(location))
-                    continue;
-
-                for (auto* trackElement : TileElementsView<TrackElement>(location))
-                {
-                    auto rideIndex = trackElement->GetRideIndex();
-                    if (rideIndex != RIDE_ID_NULL)
-                    {
-                        rideConsideration[EnumValue(rideIndex)] = true;
-                    }
-                }
-            }
-        }
+        OpenRCT2::RidePresenceIndex::GetRidesInRange({ cx, cy }, radius, rideConsideration);
 
         // Always take the tall rides into consideration (realistic as you can usually see them from anywhere in the park)
         for (auto& ride : GetRideManager())
@@ -2878,11 +2875,55 @@ static bool peep_really_liked_ride(Guest* peep, Ride* ride)
     return true;
 }
 
+static uint16_t peep_get_nearby_music(const OpenRCT2::BitSet<MAX_RIDES>& rides)
+{
+    constexpr size_t bitsPerBlock = std::numeric_limits<OpenRCT2::BitSet<MAX_RIDES>::BlockType>::digits;
+
+    uint16_t nearby_music = 0;
+    const auto& blocks = rides.data();
+    for (size_t blockIndex = 0; blockIndex < blocks.size(); blockIndex++)
+    {
+        auto block = blocks[blockIndex];
+        while (block != 0)
+        {
+            const auto bit = bitscanforward(static_cast<int64_t>(block));
+            block &= block - 1;
+
+            auto ride = get_ride(static_cast<ride_id_t>(blockIndex * bitsPerBlock + bit));
+            if (ride == nullptr)
+                continue;
+
+            if (ride->lifecycle_flags & RIDE_LIFECYCLE_MUSIC && ride->status != RideStatus::Closed
+                && !(ride->lifecycle_flags & (RIDE_LIFECYCLE_BROKEN_DOWN | RIDE_LIFECYCLE_CRASHED)))
+            {
+                if (ride->type == RIDE_TYPE_MERRY_GO_ROUND)
+                {
+                    nearby_music |= 1;
+                    continue;
+                }
+
+                if (ride->music == MUSIC_STYLE_ORGAN)
+                {
+                    nearby_music |= 1;
+                    continue;
+                }
+
+                if (ride->type == RIDE_TYPE_DODGEMS)
+                {
+                    // Dodgems drown out music?
+                    nearby_music |= 2;
+                }
+            }
+        }
+    }
+    return nearby_music;
+}
+
 /**
  *
  *  rct2: 0x0069BC9A
  */
-static PeepThoughtType peep_assess_surroundings(int16_t centre_x, int16_t centre_y, int16_t centre_z)
+PeepThoughtType peep_assess_surroundings(int16_t centre_x, int16_t centre_y, int16_t centre_z)
 {
     if ((tile_element_height({ centre_x, centre_y })) > centre_z)
         return PeepThoughtType::None;
@@ -2892,93 +2933,41 @@ static PeepThoughtType peep_assess_surroundings(int16_t centre_x, int16_t centre
     uint16_t nearby_music = 0;
     uint16_t num_rubbish = 0;
 
-    int16_t initial_x = std::max(centre_x - 160, 0);
-    int16_t initial_y = std::max(centre_y - 160, 0);
-    int16_t final_x = std::min(centre_x + 160, MAXIMUM_MAP_SIZE_BIG);
-    int16_t final_y = std::min(centre_y + 160, MAXIMUM_MAP_SIZE_BIG);
-
-    for (int16_t x = initial_x; x < final_x; x += COORDS_XY_STEP)
+    // Scenery and path additions are counted over the same tiles as ride music.
+    const auto& surroundings = OpenRCT2::SurroundingsCache::GetSummary({ centre_x, centre_y });
+    for (const auto& addition : surroundings.PathAdditions)
     {
-        for (int16_t y = initial_y; y < final_y; y += COORDS_XY_STEP)
+        auto* pathAddEntry = get_footpath_item_entry(addition.EntryIndex);
+        if (pathAddEntry == nullptr)
         {
-            for (auto* tileElement : TileElementsView({ x, y }))
-            {
-                Ride* ride;
-
-                switch (tileElement->GetType())
-                {
-                    case TileElementType::Path:
-                    {
-                        if (!tileElement->AsPath()->HasAddition())
-                            break;
-
-                        auto* pathAddEntry = tileElement->AsPath()->GetAdditionEntry();
-                        if (pathAddEntry == nullptr)
-                        {
-                            return PeepThoughtType::None;
-                        }
-                        if (tileElement->AsPath()->AdditionIsGhost())
-                            break;
+            return PeepThoughtType::None;
+        }
 
-                        if (pathAddEntry->flags & (PATH_BIT_FLAG_JUMPING_FOUNTAIN_WATER | PATH_BIT_FLAG_JUMPING_FOUNTAIN_SNOW))
-                        {
-                            num_fountains++;
-                            break;
-                        }
-                        if (tileElement->AsPath()->IsBroken())
-                        {
-                            num_rubbish++;
-                        }
-                        break;
-                    }
-                    case TileElementType::LargeScenery:
-                    case TileElementType::SmallScenery:
-                        num_scenery++;
-                        break;
-                    case TileElementType::Track:
-                        ride = get_ride(tileElement->AsTrack()->GetRideIndex());
-                        if (ride != nullptr)
-                        {
-                            if (ride->lifecycle_flags & RIDE_LIFECYCLE_MUSIC && ride->status != RideStatus::Closed
-                                && !(ride->lifecycle_flags & (RIDE_LIFECYCLE_BROKEN_DOWN | RIDE_LIFECYCLE_CRASHED)))
-                            {
-                                if (ride->type == RIDE_TYPE_MERRY_GO_ROUND)
-                                {
-                                    nearby_music |= 1;
-                                    break;
-                                }
-
-                                if (ride->music == MUSIC_STYLE_ORGAN)
-                                {
-                                    nearby_music |= 1;
-                                    break;
-                                }
-
-                                if (ride->type == RIDE_TYPE_DODGEMS)
-                                {
-                                    // Dodgems drown out music?
-                                    nearby_music |= 2;
-                                }
-                            }
-                        }
-                        break;
-                    default:
-                        break;
-                }
-            }
+        if (pathAddEntry->flags & (PATH_BIT_FLAG_JUMPING_FOUNTAIN_WATER | PATH_BIT_FLAG_JUMPING_FOUNTAIN_SNOW))
+        {
+            num_fountains += addition.Count;
+        }
+        else
+        {
+            num_rubbish += addition.BrokenCount;
         }
     }
+    num_scenery = surroundings.Scenery;
 
-    for (auto litter : EntityList<Litter>())
+    int16_t initial_x = std::max(centre_x - 160, 0);
+    int16_t initial_y = std::max(centre_y - 160, 0);
+    int16_t final_x = std::min(centre_x + 160, MAXIMUM_MAP_SIZE_BIG);
+    int16_t final_y = std::min(centre_y + 160, MAXIMUM_MAP_SIZE_BIG);
+    if (initial_x < final_x && initial_y < final_y)
     {
-        int16_t dist_x = abs(litter->x - centre_x);
-        int16_t dist_y = abs(litter->y - centre_y);
-        if (std::max(dist_x, dist_y) <= 160)
-        {
-            num_rubbish++;
-        }
+        OpenRCT2::BitSet<MAX_RIDES> rides;
+        OpenRCT2::RidePresenceIndex::GetRidesOnTiles(
+            TileCoordsXY(CoordsXY{ initial_x, initial_y }), TileCoordsXY(CoordsXY{ final_x - 1, final_y - 1 }), rides);
+        nearby_music = peep_get_nearby_music(rides);
     }
 
+    num_rubbish += OpenRCT2::SurroundingsCache::CountLitter({ centre_x, centre_y });
+
     if (num_fountains >= 5 && num_rubbish < 20)
         return PeepThoughtType::Fountains;
 
@@ -5058,6 +5047,8 @@ void Guest::UpdateRideShopLeave()
 
 void Guest::UpdateGuest()
 {
+    PROFILED_SCOPE("Guest::UpdateGuest");
+
     switch (State)
     {
         case PeepState::QueuingFront:
@@ -6132,6 +6123,8 @@ static void peep_update_walking_break_scenery(Guest* peep)
     }
 
     tileElement->SetIsBroken(true);
+    OpenRCT2::GuestThink::InvalidateLocation(peep->NextLoc);
+    OpenRCT2::SurroundingsCache::InvalidateTile(peep->NextLoc);
 
     map_invalidate_tile_zoom1({ peep->NextLoc, tileElement->GetBaseZ(), tileElement->GetBaseZ() + 32 });
 
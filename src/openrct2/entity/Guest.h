@@ -334,6 +334,7 @@ public:
     void TryGetUpFromSitting();
     void ChoseNotToGoOnRide(Ride* ride, bool peepAtRide, bool updateLastRide);
     void PickRideToGoOn();
+    OpenRCT2::BitSet<MAX_RIDES> FindRidesToGoOn() const;
     void ReadMap();
     bool ShouldGoOnRide(Ride* ride, int32_t entranceNum, bool atQueue, bool thinking);
     bool ShouldGoToShop(Ride* ride, bool peepAtShop);
@@ -418,7 +419,6 @@ private:
     void MakePassingPeepsSick(Guest* passingPeep);
     void GivePassingPeepsIceCream(Guest* passingPeep);
     Ride* FindBestRideToGoOn();
-    OpenRCT2::BitSet<MAX_RIDES> FindRidesToGoOn();
     bool FindVehicleToEnter(Ride* ride, std::vector<uint8_t>& car_array);
     void GoToRideEntrance(Ride* ride);
 };
@@ -468,6 +468,7 @@ extern uint32_t gNextGuestNumber;
 void guest_set_name(uint16_t spriteIndex, const char* name);
 
 void peep_thought_set_format_args(const PeepThought* thought, Formatter& ft);
+PeepThoughtType peep_assess_surroundings(int16_t centre_x, int16_t centre_y, int16_t centre_z);
 
 void increment_guests_in_park();
 void increment_guests_heading_for_park();
@@ -5,6 +5,7 @@
 #include "../core/DataSerialiser.h"
 #include "../localisation/StringIds.h"
 #include "../paint/Paint.h"
+#include "../peep/GuestThink.h"
 #include "../sprites.h"
 #include "../world/Map.h"
 #include "EntityList.h"
@@ -70,6 +71,7 @@ void Litter::Create(const CoordsXYZD& litterPos, Type type)
 
         if (newestLitter != nullptr)
         {
+            OpenRCT2::GuestThink::InvalidateLocation(newestLitter->GetLocation());
             newestLitter->Invalidate();
             EntityRemove(newestLitter);
         }
@@ -86,6 +88,8 @@ void Litter::Create(const CoordsXYZD& litterPos, Type type)
     litter->SubType = type;
     litter->MoveTo(offsetLitterPos);
     litter->creationTick = gCurrentTicks;
+
+    OpenRCT2::GuestThink::InvalidateLocation(offsetLitterPos);
 }
 
 /**
@@ -0,0 +1,169 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2021 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "LitterIndex.h"
+
+#include "../peep/SurroundingsCache.h"
+#include "../world/Map.h"
+#include "EntityList.h"
+#include "Litter.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace OpenRCT2::LitterIndex
+{
+    // Litter outside of the map, sorted by sprite index.
+    static std::vector<uint16_t> _unplacedLitter;
+
+    // Heights of the litter on the map, only ever widened until the next reset.
+    static int32_t _minZ = std::numeric_limits<int32_t>::max();
+    static int32_t _maxZ = std::numeric_limits<int32_t>::min();
+
+    static bool IsPlaced(const EntityBase& litter)
+    {
+        return map_is_location_valid({ litter.x, litter.y });
+    }
+
+    static uint16_t GetDistance(const Litter& litter, const CoordsXYZ& loc)
+    {
+        return abs(litter.x - loc.x) + abs(litter.y - loc.y) + abs(litter.z - loc.z) * 4;
+    }
+
+    static void AddPlaced(const EntityBase& litter)
+    {
+        _minZ = std::min<int32_t>(_minZ, litter.z);
+        _maxZ = std::max<int32_t>(_maxZ, litter.z);
+    }
+
+    // Whether litter on the map can be far enough from loc for its distance to wrap around to within maxDistance.
+    static bool CanDistanceWrap(const CoordsXYZ& loc, uint16_t maxDistance)
+    {
+        if (_minZ > _maxZ)
+            return false;
+
+        const int64_t farX = std::max(std::abs(loc.x), std::abs(MAXIMUM_MAP_SIZE_BIG - 1 - loc.x));
+        const int64_t farY = std::max(std::abs(loc.y), std::abs(MAXIMUM_MAP_SIZE_BIG - 1 - loc.y));
+        const int64_t farZ = std::max(std::abs(loc.z - _minZ), std::abs(loc.z - _maxZ));
+        return farX + farY + farZ * 4 > std::numeric_limits<uint16_t>::max() - maxDistance;
+    }
+
+    static void Consider(
+        Litter* litter, const CoordsXYZ& loc, uint16_t maxDistance, Litter*& nearest, uint16_t& nearestDistance)
+    {
+        const auto distance = GetDistance(*litter, loc);
+        if (distance > maxDistance)
+            return;
+
+        if (nearest == nullptr || distance < nearestDistance
+            || (distance == nearestDistance && litter->sprite_index < nearest->sprite_index))
+        {
+            nearest = litter;
+            nearestDistance = distance;
+        }
+    }
+
+    void Add(const EntityBase& litter)
+    {
+        if (IsPlaced(litter))
+        {
+            AddPlaced(litter);
+            SurroundingsCache::InvalidateLitter({ litter.x, litter.y });
+        }
+        else
+        {
+            auto it = std::lower_bound(_unplacedLitter.begin(), _unplacedLitter.end(), litter.sprite_index);
+            _unplacedLitter.insert(it, litter.sprite_index);
+        }
+    }
+
+    void Remove(const EntityBase& litter)
+    {
+        if (IsPlaced(litter))
+        {
+            SurroundingsCache::InvalidateLitter({ litter.x, litter.y });
+        }
+        else
+        {
+            auto it = std::lower_bound(_unplacedLitter.begin(), _unplacedLitter.end(), litter.sprite_index);
+            if (it != _unplacedLitter.end() && *it == litter.sprite_index)
+            {
+                _unplacedLitter.erase(it);
+            }
+        }
+    }
+
+    void Reset()
+    {
+        _unplacedLitter.clear();
+        _minZ = std::numeric_limits<int32_t>::max();
+        _maxZ = std::numeric_limits<int32_t>::min();
+        for (auto* litter : EntityList<Litter>())
+        {
+            if (IsPlaced(*litter))
+            {
+                AddPlaced(*litter);
+            }
+            else
+            {
+                _unplacedLitter.push_back(litter->sprite_index);
+            }
+        }
+        SurroundingsCache::InvalidateAllLitter();
+    }
+
+    const std::vector<uint16_t>& GetUnplaced()
+    {
+        return _unplacedLitter;
+    }
+
+    Litter* FindNearest(const CoordsXYZ& loc, uint16_t maxDistance)
+    {
+        Litter* nearest = nullptr;
+        uint16_t nearestDistance = 0;
+        if (CanDistanceWrap(loc, maxDistance))
+        {
+            for (auto* litter : EntityList<Litter>())
+            {
+                if (IsPlaced(*litter))
+                {
+                    Consider(litter, loc, maxDistance, nearest, nearestDistance);
+                }
+            }
+        }
+        else
+        {
+            // Without wrapping around only litter within maxDistance on both axes is near enough.
+            const auto tileX0 = std::max(0, (loc.x - maxDistance) / COORDS_XY_STEP);
+            const auto tileY0 = std::max(0, (loc.y - maxDistance) / COORDS_XY_STEP);
+            const auto tileX1 = std::min(MAXIMUM_MAP_SIZE_TECHNICAL - 1, (loc.x + maxDistance) / COORDS_XY_STEP);
+            const auto tileY1 = std::min(MAXIMUM_MAP_SIZE_TECHNICAL - 1, (loc.y + maxDistance) / COORDS_XY_STEP);
+            for (auto tileX = tileX0; tileX <= tileX1; tileX++)
+            {
+                for (auto tileY = tileY0; tileY <= tileY1; tileY++)
+                {
+                    for (auto* litter : EntityTileList<Litter>(TileCoordsXY{ tileX, tileY }.ToCoordsXY()))
+                    {
+                        Consider(litter, loc, maxDistance, nearest, nearestDistance);
+                    }
+                }
+            }
+        }
+
+        for (auto spriteIndex : _unplacedLitter)
+        {
+            auto* litter = GetEntity<Litter>(spriteIndex);
+            if (litter != nullptr)
+            {
+                Consider(litter, loc, maxDistance, nearest, nearestDistance);
+            }
+        }
+        return nearest;
+    }
+} // namespace OpenRCT2::LitterIndex
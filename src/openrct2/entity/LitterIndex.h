@@ -0,0 +1,45 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2021 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#pragma once
+
+#include "../world/Location.hpp"
+
+#include <vector>
+
+struct EntityBase;
+struct Litter;
+
+/**
+ * Bookkeeping of litter on top of the entity spatial index: the litter that has no location and the range of heights of
+ * the litter that has, which together are all the litter that can not be found by searching the tiles around a point.
+ */
+namespace OpenRCT2::LitterIndex
+{
+    /**
+     * Records litter appearing or disappearing at its current location. Litter that moves is removed before and added
+     * after the move.
+     */
+    void Add(const EntityBase& litter);
+    void Remove(const EntityBase& litter);
+
+    /**
+     * Rebuilds the index from the litter entities, used when the entities are replaced.
+     */
+    void Reset();
+
+    const std::vector<uint16_t>& GetUnplaced();
+
+    /**
+     * Returns the litter a handyman at loc is nearest to, if its distance is at most maxDistance. Distances are the
+     * sum of the horizontal distances and four times the vertical distance truncated to 16 bits, and ties go to the
+     * lowest sprite index, which is exactly what scanning every litter entity in order gives.
+     */
+    Litter* FindNearest(const CoordsXYZ& loc, uint16_t maxDistance);
+} // namespace OpenRCT2::LitterIndex
@@ -0,0 +1,152 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2021 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "MechanicIndex.h"
+
+#include "../world/Map.h"
+#include "EntityList.h"
+#include "EntityRegistry.h"
+#include "Staff.h"
+
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <vector>
+
+namespace OpenRCT2::MechanicIndex
+{
+    constexpr int32_t CellSize = 16 * COORDS_XY_STEP;
+    constexpr int32_t GridSize = (MAXIMUM_MAP_SIZE_BIG + CellSize - 1) / CellSize;
+
+    constexpr uint16_t NoCell = std::numeric_limits<uint16_t>::max();
+    static_assert(GridSize * GridSize < NoCell);
+
+    // Sprite indices of the mechanics in each cell, sorted.
+    static std::array<std::vector<uint16_t>, GridSize * GridSize> _cells;
+
+    static size_t _numMechanics;
+
+    // The cell each mechanic was added to, the location of an entity is not always the one it was last moved to.
+    static std::array<uint16_t, MAX_ENTITIES> _entityCells = [] {
+        std::array<uint16_t, MAX_ENTITIES> entityCells;
+        entityCells.fill(NoCell);
+        return entityCells;
+    }();
+
+    // Locations outside of the grid go to the cells at its edges, which are still nearer than the mechanic is.
+    static int32_t GetCell(int32_t coord)
+    {
+        return std::clamp(coord / CellSize, 0, GridSize - 1);
+    }
+
+    void Add(const EntityBase& staff)
+    {
+        const auto* mechanic = staff.As<Staff>();
+        if (mechanic == nullptr || !mechanic->IsMechanic() || staff.x == LOCATION_NULL)
+            return;
+
+        Remove(staff);
+        const auto cellIndex = static_cast<uint16_t>(GetCell(staff.y) * GridSize + GetCell(staff.x));
+        auto& cell = _cells[cellIndex];
+        cell.insert(std::lower_bound(cell.begin(), cell.end(), staff.sprite_index), staff.sprite_index);
+        _entityCells[staff.sprite_index] = cellIndex;
+        _numMechanics++;
+    }
+
+    void Remove(const EntityBase& staff)
+    {
+        auto& cellIndex = _entityCells[staff.sprite_index];
+        if (cellIndex == NoCell)
+            return;
+
+        auto& cell = _cells[cellIndex];
+        auto it = std::lower_bound(cell.begin(), cell.end(), staff.sprite_index);
+        if (it != cell.end() && *it == staff.sprite_index)
+        {
+            cell.erase(it);
+        }
+        cellIndex = NoCell;
+        _numMechanics--;
+    }
+
+    void Reset()
+    {
+        for (auto& cell : _cells)
+        {
+            cell.clear();
+        }
+        _entityCells.fill(NoCell);
+        _numMechanics = 0;
+        for (auto* staff : EntityList<Staff>())
+        {
+            Add(*staff);
+        }
+    }
+
+    static void ConsiderCell(
+        const std::vector<uint16_t>& cell, const CoordsXY& loc, const std::function<bool(const Staff&)>& isSuitable,
+        Staff*& nearest, uint32_t& nearestDistance)
+    {
+        for (auto spriteIndex : cell)
+        {
+            auto* mechanic = GetEntity<Staff>(spriteIndex);
+            if (mechanic == nullptr)
+                continue;
+
+            uint32_t distance = std::abs(mechanic->x - loc.x) + std::abs(mechanic->y - loc.y);
+            if (distance > nearestDistance
+                || (distance == nearestDistance && nearest != nullptr && spriteIndex > nearest->sprite_index))
+                continue;
+
+            if (isSuitable(*mechanic))
+            {
+                nearest = mechanic;
+                nearestDistance = distance;
+            }
+        }
+    }
+
+    Staff* FindNearest(const CoordsXY& loc, const std::function<bool(const Staff&)>& isSuitable)
+    {
+        Staff* nearest = nullptr;
+        uint32_t nearestDistance = std::numeric_limits<uint32_t>::max();
+
+        const auto centreX = GetCell(loc.x);
+        const auto centreY = GetCell(loc.y);
+        const auto maxRadius = std::max({ centreX, GridSize - 1 - centreX, centreY, GridSize - 1 - centreY });
+
+        // Rings of cells around the cell of loc, mechanics in a ring are further away than radius - 1 whole cells. The
+        // search ends once every mechanic has been seen.
+        size_t numSeen = 0;
+        for (int32_t radius = 0; radius <= maxRadius && numSeen < _numMechanics; radius++)
+        {
+            if (nearest != nullptr && radius > 0 && nearestDistance <= static_cast<uint32_t>((radius - 1) * CellSize))
+                break;
+
+            for (auto cellY = centreY - radius; cellY <= centreY + radius; cellY++)
+            {
+                if (cellY < 0 || cellY >= GridSize)
+                    continue;
+
+                const bool isEdgeRow = cellY == centreY - radius || cellY == centreY + radius;
+                const auto step = isEdgeRow ? 1 : std::max(1, 2 * radius);
+                for (auto cellX = centreX - radius; cellX <= centreX + radius; cellX += step)
+                {
+                    if (cellX < 0 || cellX >= GridSize)
+                        continue;
+
+                    const auto& cell = _cells[cellY * GridSize + cellX];
+                    ConsiderCell(cell, loc, isSuitable, nearest, nearestDistance);
+                    numSeen += cell.size();
+                }
+            }
+        }
+        return nearest;
+    }
+} // namespace OpenRCT2::MechanicIndex
@@ -0,0 +1,43 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2021 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#pragma once
+
+#include "../world/Location.hpp"
+
+#include <functional>
+
+struct EntityBase;
+struct Staff;
+
+/**
+ * The mechanics on the map by the block of 16x16 tiles they are on, so that the mechanic nearest to a ride can be found
+ * without going through every staff member.
+ */
+namespace OpenRCT2::MechanicIndex
+{
+    /**
+     * Records staff appearing or disappearing at their current location, only mechanics are kept. Staff that move are
+     * removed before and added after the move.
+     */
+    void Add(const EntityBase& staff);
+    void Remove(const EntityBase& staff);
+
+    /**
+     * Rebuilds the index from the staff entities, used when the entities are replaced.
+     */
+    void Reset();
+
+    /**
+     * Returns the mechanic nearest to loc by Manhattan distance that isSuitable accepts. Ties go to the lowest sprite
+     * index, which is exactly what scanning every staff member in order gives. isSuitable is only called for mechanics
+     * that would be nearer than the nearest one so far.
+     */
+    Staff* FindNearest(const CoordsXY& loc, const std::function<bool(const Staff&)>& isSuitable);
+} // namespace OpenRCT2::MechanicIndex
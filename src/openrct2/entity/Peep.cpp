@@ -32,6 +32,8 @@
 #include "../network/network.h"
 #include "../paint/Paint.h"
 #include "../peep/GuestPathfinding.h"
+#include "../peep/GuestThink.h"
+#include "../profiling/Profiling.h"
 #include "../ride/Ride.h"
 #include "../ride/RideData.h"
 #include "../ride/ShopItem.h"
@@ -48,6 +50,7 @@
 #include "../world/LargeScenery.h"
 #include "../world/Map.h"
 #include "../world/Park.h"
+#include "../world/RidePresenceIndex.h"
 #include "../world/Scenery.h"
 #include "../world/SmallScenery.h"
 #include "../world/Surface.h"
@@ -200,10 +203,15 @@ void peep_update_all()
     if (gScreenFlags & SCREEN_FLAGS_EDITOR)
         return;
 
+    OpenRCT2::RidePresenceIndex::Update();
+    OpenRCT2::GuestThink::Prepare();
+
     int32_t i = 0;
     // Warning this loop can delete peeps
     for (auto peep : EntityList<Guest>())
     {
+        PROFILED_SCOPE("Guest::Update");
+
         if (static_cast<uint32_t>(i & 0x7F) != (gCurrentTicks & 0x7F))
         {
             peep->Update();
@@ -221,6 +229,8 @@ void peep_update_all()
         i++;
     }
 
+    OpenRCT2::GuestThink::Finish();
+
     for (auto staff : EntityList<Staff>())
     {
         if (static_cast<uint32_t>(i & 0x7F) != (gCurrentTicks & 0x7F))
@@ -17,6 +17,7 @@
 #include "../config/Config.h"
 #include "../core/DataSerialiser.h"
 #include "../entity/EntityRegistry.h"
+#include "../entity/LitterIndex.h"
 #include "../interface/Viewport.h"
 #include "../localisation/Date.h"
 #include "../localisation/Localisation.h"
@@ -396,20 +397,8 @@ bool Staff::HasPatrolArea() const
  */
 Direction Staff::HandymanDirectionToNearestLitter() const
 {
-    uint16_t nearestLitterDist = 0xFFFF;
-    Litter* nearestLitter = nullptr;
-    for (auto litter : EntityList<Litter>())
-    {
-        uint16_t distance = abs(litter->x - x) + abs(litter->y - y) + abs(litter->z - z) * 4;
-
-        if (distance < nearestLitterDist)
-        {
-            nearestLitterDist = distance;
-            nearestLitter = litter;
-        }
-    }
-
-    if (nearestLitterDist > MAX_LITTER_DISTANCE)
+    auto* nearestLitter = OpenRCT2::LitterIndex::FindNearest(GetLocation(), MAX_LITTER_DISTANCE);
+    if (nearestLitter == nullptr)
     {
         return INVALID_DIRECTION;
     }
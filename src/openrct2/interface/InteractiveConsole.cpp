@@ -29,11 +29,13 @@
 #include "../drawing/Drawing.h"
 #include "../drawing/Font.h"
 #include "../drawing/Image.h"
+#include "../drawing/SpriteCache.h"
 #include "../entity/EntityList.h"
 #include "../entity/EntityRegistry.h"
 #include "../entity/Staff.h"
 #include "../interface/Chat.h"
 #include "../interface/Colour.h"
+#include "../interface/ViewportCache.h"
 #include "../interface/Window_internal.h"
 #include "../localisation/Localisation.h"
 #include "../management/Finance.h"
@@ -44,7 +46,10 @@
 #include "../object/ObjectList.h"
 #include "../object/ObjectManager.h"
 #include "../object/ObjectRepository.h"
+#include "../paint/Paint.h"
+#include "../paint/PaintCache.h"
 #include "../platform/platform.h"
+#include "../profiling/Profiling.h"
 #include "../ride/Ride.h"
 #include "../ride/RideData.h"
 #include "../ride/Vehicle.h"
@@ -56,11 +61,13 @@
 #include "Viewport.h"
 
 #include <algorithm>
+#include <cinttypes>
 #include <cmath>
 #include <cstdarg>
 #include <cstdlib>
 #include <deque>
 #include <exception>
+#include <map>
 #include <string>
 #include <thread>
 #include <vector>
@@ -1555,6 +1562,32 @@ static int32_t cc_replay_stop(InteractiveConsole& console, const arguments_t& ar
     return 0;
 }
 
+static int32_t cc_replay_seek(InteractiveConsole& console, const arguments_t& argv)
+{
+    if (network_get_mode() != NETWORK_MODE_NONE)
+    {
+        console.WriteFormatLine("This command is currently not supported in multiplayer mode.");
+        return 0;
+    }
+
+    if (argv.size() < 1)
+    {
+        console.WriteFormatLine("Parameters required <ticks>");
+        return 0;
+    }
+
+    uint32_t ticks = atol(argv[0].c_str());
+
+    auto* replayManager = OpenRCT2::GetContext()->GetReplayManager();
+    if (replayManager->SeekPlayback(ticks))
+    {
+        console.WriteFormatLine("Replay at tick %u", ticks);
+        return 1;
+    }
+
+    return 0;
+}
+
 static int32_t cc_replay_normalise(InteractiveConsole& console, const arguments_t& argv)
 {
     if (network_get_mode() != NETWORK_MODE_NONE)
@@ -1590,6 +1623,201 @@ static int32_t cc_replay_normalise(InteractiveConsole& console, const arguments_
     return 0;
 }
 
+static int32_t cc_profiler_start(InteractiveConsole& console, [[maybe_unused]] const arguments_t& argv)
+{
+    OpenRCT2::Profiling::Enable();
+    console.WriteLine("Profiler started");
+    return 0;
+}
+
+static int32_t cc_profiler_stop(InteractiveConsole& console, [[maybe_unused]] const arguments_t& argv)
+{
+    OpenRCT2::Profiling::Disable();
+    console.WriteLine("Profiler stopped");
+    return 0;
+}
+
+static int32_t cc_profiler_reset(InteractiveConsole& console, [[maybe_unused]] const arguments_t& argv)
+{
+    OpenRCT2::Profiling::ResetData();
+    console.WriteLine("Profiler data cleared");
+    return 0;
+}
+
+static void console_write_profiler_function(
+    InteractiveConsole& console,
+    const std::map<OpenRCT2::Profiling::Function*, std::vector<OpenRCT2::Profiling::Function*>>& children,
+    OpenRCT2::Profiling::Function* function, int32_t depth)
+{
+    auto stats = OpenRCT2::Profiling::GetStats(*function);
+    if (stats.Ticks == 0)
+    {
+        return;
+    }
+
+    auto name = std::string(depth * 2, ' ') + function->GetName();
+    console.WriteFormatLine(
+        "%-44s %9.3f %9.3f %9.3f %9.3f %12" PRIu64, name.c_str(), stats.P50Ms, stats.P99Ms, stats.MaxMs, stats.MeanMs,
+        stats.Calls);
+
+    auto it = children.find(function);
+    if (it != children.end())
+    {
+        for (auto* child : it->second)
+        {
+            console_write_profiler_function(console, children, child, depth + 1);
+        }
+    }
+}
+
+static int32_t cc_profiler_show(InteractiveConsole& console, [[maybe_unused]] const arguments_t& argv)
+{
+    if (!OpenRCT2::Profiling::IsEnabled())
+    {
+        console.WriteLine("Profiler is not running, use profiler_start to start it.");
+    }
+
+    // Times are per tick over the last ticks each function was entered in.
+    std::map<OpenRCT2::Profiling::Function*, std::vector<OpenRCT2::Profiling::Function*>> children;
+    for (auto* function : OpenRCT2::Profiling::GetFunctions())
+    {
+        children[function->GetParent()].push_back(function);
+    }
+
+    console.WriteFormatLine("%-44s %9s %9s %9s %9s %12s", "Function", "p50 ms", "p99 ms", "max ms", "mean ms", "calls");
+    for (auto* root : children[nullptr])
+    {
+        console_write_profiler_function(console, children, root, 0);
+    }
+    return 0;
+}
+
+static int32_t cc_profiler_trace_start(InteractiveConsole& console, [[maybe_unused]] const arguments_t& argv)
+{
+    OpenRCT2::Profiling::StartTrace();
+    console.WriteLine("Trace started");
+    return 0;
+}
+
+static int32_t cc_profiler_trace_stop(InteractiveConsole& console, const arguments_t& argv)
+{
+    if (!OpenRCT2::Profiling::IsTracing())
+    {
+        console.WriteLine("No trace is being recorded");
+        return 0;
+    }
+
+    if (argv.size() < 1)
+    {
+        console.WriteFormatLine("Parameters required <file>");
+        return 0;
+    }
+
+    if (OpenRCT2::Profiling::StopTrace(argv[0]))
+    {
+        console.WriteFormatLine("Trace written to %s", argv[0].c_str());
+        return 1;
+    }
+
+    console.WriteLineError("Unable to write trace");
+    return 0;
+}
+
+static int32_t cc_sprite_cache(InteractiveConsole& console, const arguments_t& argv)
+{
+    if (argv.size() >= 1 && argv[0] == "reset")
+    {
+        sprite_cache_reset_stats();
+        console.WriteLine("Sprite cache statistics cleared");
+        return 0;
+    }
+
+    auto stats = sprite_cache_get_stats();
+    if (stats.MemoryBudget == 0)
+    {
+        console.WriteLine("Sprite cache is disabled, set sprite_cache_size in config.ini to enable it.");
+        return 0;
+    }
+
+    auto lookups = stats.Hits + stats.Misses;
+    console.WriteFormatLine(
+        "Hits: %" PRIu64 " (%.1f%%), misses: %" PRIu64 ", evictions: %" PRIu64, stats.Hits,
+        lookups != 0 ? 100.0 * stats.Hits / lookups : 0.0, stats.Misses, stats.Evictions);
+    console.WriteFormatLine(
+        "Sprites: %zu, memory: %zu / %zu KiB", stats.Entries, stats.MemoryUsed / 1024, stats.MemoryBudget / 1024);
+    return 0;
+}
+
+static int32_t cc_paint_cache(InteractiveConsole& console, const arguments_t& argv)
+{
+    if (argv.size() >= 1 && argv[0] == "reset")
+    {
+        OpenRCT2::PaintCache::ResetStats();
+        console.WriteLine("Paint cache statistics cleared");
+        return 0;
+    }
+
+    if (!gConfigGeneral.paint_cache)
+    {
+        console.WriteLine("Paint cache is disabled, set paint_cache in config.ini to enable it.");
+        return 0;
+    }
+
+    auto stats = OpenRCT2::PaintCache::GetStats();
+    auto lookups = stats.Hits + stats.Misses + stats.Uncacheable;
+    console.WriteFormatLine(
+        "Hits: %" PRIu64 " (%.1f%%), misses: %" PRIu64 ", uncacheable: %" PRIu64, stats.Hits,
+        lookups != 0 ? 100.0 * stats.Hits / lookups : 0.0, stats.Misses, stats.Uncacheable);
+    console.WriteFormatLine("Tiles: %zu", stats.Tiles);
+    return 0;
+}
+
+static int32_t cc_viewport_cache(InteractiveConsole& console, const arguments_t& argv)
+{
+    if (argv.size() >= 1 && argv[0] == "reset")
+    {
+        OpenRCT2::ViewportCache::ResetStats();
+        console.WriteLine("Viewport cache statistics cleared");
+        return 0;
+    }
+
+    if (!gConfigGeneral.viewport_cache)
+    {
+        console.WriteLine("Viewport cache is disabled, set viewport_cache in config.ini to enable it.");
+        return 0;
+    }
+
+    auto stats = OpenRCT2::ViewportCache::GetStats();
+    console.WriteFormatLine("Blits: %" PRIu64 ", paints: %" PRIu64, stats.BlitCount, stats.PaintCount);
+    console.WriteFormatLine("Pages: %zu, memory: %zu KiB", stats.Pages, stats.MemoryUsed / 1024);
+    return 0;
+}
+
+static int32_t cc_paint_sort(InteractiveConsole& console, const arguments_t& argv)
+{
+    if (argv.size() >= 1)
+    {
+        if (argv[0] == "original")
+        {
+            gPaintSortAlgorithm = PaintSortAlgorithm::Original;
+        }
+        else if (argv[0] == "spatial")
+        {
+            gPaintSortAlgorithm = PaintSortAlgorithm::Spatial;
+        }
+        else
+        {
+            console.WriteLineError("Unknown algorithm, use original or spatial");
+            return 1;
+        }
+    }
+
+    console.WriteFormatLine(
+        "Paint structs are sorted by the %s algorithm",
+        gPaintSortAlgorithm == PaintSortAlgorithm::Spatial ? "spatial" : "original");
+    return 0;
+}
+
 static int32_t cc_mp_desync(InteractiveConsole& console, const arguments_t& argv)
 {
     int32_t desyncType = 0;
@@ -1825,8 +2053,21 @@ static constexpr const console_command console_command_table[] = {
     { "replay_stoprecord", cc_replay_stoprecord, "Stops recording a new replay.", "replay_stoprecord" },
     { "replay_start", cc_replay_start, "Starts a replay", "replay_start <name>" },
     { "replay_stop", cc_replay_stop, "Stops the replay", "replay_stop" },
+    { "replay_seek", cc_replay_seek, "Jumps to a tick of the replay", "replay_seek <ticks>" },
     { "replay_normalise", cc_replay_normalise, "Normalises the replay to remove all gaps",
       "replay_normalise <input file> <output file>" },
+    { "profiler_start", cc_profiler_start, "Starts timing the game logic", "profiler_start" },
+    { "profiler_stop", cc_profiler_stop, "Stops timing the game logic", "profiler_stop" },
+    { "profiler_reset", cc_profiler_reset, "Clears the collected timings", "profiler_reset" },
+    { "profiler_show", cc_profiler_show, "Shows the collected timings per tick", "profiler_show" },
+    { "profiler_trace_start", cc_profiler_trace_start, "Starts recording a trace", "profiler_trace_start" },
+    { "profiler_trace_stop", cc_profiler_trace_stop, "Stops recording a trace and writes it to a Chrome trace file",
+      "profiler_trace_stop <file>" },
+    { "sprite_cache", cc_sprite_cache, "Shows the hit rate and memory use of the sprite cache", "sprite_cache [reset]" },
+    { "paint_cache", cc_paint_cache, "Shows the hit rate of the paint cache", "paint_cache [reset]" },
+    { "viewport_cache", cc_viewport_cache, "Shows the number of blitted and painted pages of the viewport cache",
+      "viewport_cache [reset]" },
+    { "paint_sort", cc_paint_sort, "Selects the algorithm that sorts paint structs", "paint_sort [original|spatial]" },
     { "mp_desync", cc_mp_desync, "Forces a multiplayer desync",
       "cc_mp_desync [desync_type, 0 = Random t-shirt color on random guest, 1 = Remove random guest ]" },
 };
@@ -19,6 +19,7 @@
 #include "../core/Console.hpp"
 #include "../core/Imaging.h"
 #include "../drawing/Drawing.h"
+#include "../drawing/SpriteCache.h"
 #include "../drawing/X8DrawingEngine.h"
 #include "../localisation/Formatter.h"
 #include "../localisation/Localisation.h"
@@ -509,6 +510,16 @@ static void benchgfx_render_screenshots(const char* inputPath, std::unique_ptr<I
         }
         std::printf("Total average: %.06fs, %.f FPS\n", average, 1.0 / average);
         std::printf("Time: %.05fs\n", totalTime);
+
+        const auto spriteCacheStats = sprite_cache_get_stats();
+        if (spriteCacheStats.MemoryBudget != 0)
+        {
+            const auto lookups = spriteCacheStats.Hits + spriteCacheStats.Misses;
+            std::printf(
+                "Sprite cache: %.1f%% hit rate, %zu sprites, %zu KiB\n",
+                lookups != 0 ? 100.0 * spriteCacheStats.Hits / lookups : 0.0, spriteCacheStats.Entries,
+                spriteCacheStats.MemoryUsed / 1024);
+        }
     }
     catch (const std::exception& e)
     {
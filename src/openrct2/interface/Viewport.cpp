@@ -22,6 +22,8 @@
 #include "../entity/Guest.h"
 #include "../entity/Staff.h"
 #include "../paint/Paint.h"
+#include "../paint/PaintCache.h"
+#include "../profiling/Profiling.h"
 #include "../ride/Ride.h"
 #include "../ride/TrackDesign.h"
 #include "../ride/Vehicle.h"
@@ -31,6 +33,7 @@
 #include "../world/Climate.h"
 #include "../world/Map.h"
 #include "Colour.h"
+#include "ViewportCache.h"
 #include "Window.h"
 #include "Window_internal.h"
 
@@ -220,6 +223,7 @@ void viewport_remove(rct_viewport* viewport)
 
 void viewports_invalidate(const ScreenRect& screenRect, ZoomLevel maxZoom)
 {
+    ViewportCache::Invalidate(screenRect);
     for (auto& vp : _viewports)
     {
         if (maxZoom == ZoomLevel{ -1 } || vp.zoom <= ZoomLevel{ maxZoom })
@@ -394,6 +398,8 @@ static void viewport_redraw_after_shift(
 static void viewport_shift_pixels(
     rct_drawpixelinfo* dpi, rct_window* window, rct_viewport* viewport, int32_t x_diff, int32_t y_diff)
 {
+    TRACED_SCOPE("viewport_shift_pixels");
+
     auto it = window_get_iterator(window);
     for (; it != g_window_list.end(); it++)
     {
@@ -824,7 +830,12 @@ void viewport_render(
         std::min(bottomRight.y, viewport->height) * viewport->zoom,
     } + viewport->viewPos;
 
-    viewport_paint(viewport, dpi, { topLeft, bottomRight }, sessions);
+    // Screenshots and recorded sessions are painted with their own drawing engine.
+    if (sessions != nullptr || dpi->DrawingEngine != GetContext()->GetDrawingEngine()
+        || !ViewportCache::Render(*dpi, *viewport, { topLeft, bottomRight }))
+    {
+        viewport_paint(viewport, dpi, { topLeft, bottomRight }, sessions);
+    }
 
 #ifdef DEBUG_SHOW_DIRTY_BOX
     // FIXME g_viewport_list doesn't exist anymore
@@ -845,57 +856,60 @@ static void record_session(
     recordedSession.Entries.resize(session.PaintEntryChain.GetCount());
 
     // Mind the offset needs to be calculated against the original `session`, not `session_copy`
-    std::unordered_map<paint_struct*, paint_struct*> entryRemap;
+    std::unordered_map<const paint_struct*, size_t> entryIndices;
 
     // Copy all entries
-    auto paintIndex = 0;
+    size_t paintIndex = 0;
     auto chain = session.PaintEntryChain.Head;
     while (chain != nullptr)
     {
         for (size_t i = 0; i < chain->Count; i++)
         {
             auto& src = chain->PaintStructs[i];
-            auto& dst = recordedSession.Entries[paintIndex++];
-            dst = src;
-            entryRemap[src.AsBasic()] = reinterpret_cast<paint_struct*>(i * sizeof(paint_entry));
+            entryIndices[src.GetBasic()] = paintIndex;
+            recordedSession.Entries[paintIndex++] = src;
         }
         chain = chain->Next;
     }
-    entryRemap[nullptr] = reinterpret_cast<paint_struct*>(-1);
 
-    // Remap all entries
-    for (auto& ps : recordedSession.Entries)
-    {
-        auto& ptr = ps.AsBasic()->next_quadrant_ps;
-        auto it = entryRemap.find(ptr);
-        if (it == entryRemap.end())
+    auto remap = [&entryIndices](const paint_struct* ps) {
+        if (ps == nullptr)
         {
-            assert(false);
-            ptr = nullptr;
+            return reinterpret_cast<paint_struct*>(-1);
         }
-        else
+        auto it = entryIndices.find(ps);
+        if (it == entryIndices.end())
         {
-            ptr = it->second;
+            assert(false);
+            return reinterpret_cast<paint_struct*>(-1);
         }
+        return reinterpret_cast<paint_struct*>(it->second * sizeof(paint_entry));
+    };
+
+    // Remap all entries, only the ones linked from the quadrants are paint_structs, the others are attached or string
+    // structs that are never sorted.
+    for (auto& entry : recordedSession.Entries)
+    {
+        entry.GetBasic()->next_quadrant_ps = reinterpret_cast<paint_struct*>(-1);
     }
-    for (auto& ptr : recordedSession.Session.Quadrants)
+    for (const auto* quadrant : session.Quadrants)
     {
-        auto it = entryRemap.find(ptr);
-        if (it == entryRemap.end())
-        {
-            assert(false);
-            ptr = nullptr;
-        }
-        else
+        for (auto* ps = quadrant; ps != nullptr; ps = ps->next_quadrant_ps)
         {
-            ptr = it->second;
+            recordedSession.Entries[entryIndices.at(ps)].GetBasic()->next_quadrant_ps = remap(ps->next_quadrant_ps);
         }
     }
+    for (auto& ptr : recordedSession.Session.Quadrants)
+    {
+        ptr = remap(ptr);
+    }
 }
 
 static void viewport_fill_column(
     paint_session& session, std::vector<RecordedPaintSession>* recorded_sessions, size_t record_index)
 {
+    TRACED_SCOPE("viewport_fill_column");
+
     PaintSessionGenerate(session);
     if (recorded_sessions != nullptr)
     {
@@ -906,6 +920,8 @@ static void viewport_fill_column(
 
 static void viewport_paint_column(paint_session& session)
 {
+    TRACED_SCOPE("viewport_paint_column");
+
     if (session.ViewFlags
             & (VIEWPORT_FLAG_HIDE_VERTICAL | VIEWPORT_FLAG_HIDE_BASE | VIEWPORT_FLAG_UNDERGROUND_INSIDE
                | VIEWPORT_FLAG_CLIP_VIEW)
@@ -947,6 +963,8 @@ void viewport_paint(
     const rct_viewport* viewport, rct_drawpixelinfo* dpi, const ScreenRect& screenRect,
     std::vector<RecordedPaintSession>* recorded_sessions)
 {
+    TRACED_SCOPE("viewport_paint");
+
     const uint32_t viewFlags = viewport->flags;
     uint32_t width = screenRect.GetWidth();
     uint32_t height = screenRect.GetHeight();
@@ -1010,6 +1028,8 @@ void viewport_paint(
         recorded_sessions->resize(columnCount);
     }
 
+    bool useTileCache = PaintCache::BeginViewport();
+
     // Generate and sort columns.
     for (x = alignedX; x < rightBorder; x += 32, index++)
     {
@@ -1035,6 +1055,8 @@ void viewport_paint(
         }
         dpi2.width = paintRight - dpi2.x;
 
+        session->UseTileCache = useTileCache;
+
         if (useMultithreading)
         {
             _paintJobs->AddTask(
@@ -1048,6 +1070,7 @@ void viewport_paint(
 
     if (useMultithreading)
     {
+        TRACED_SCOPE("viewport_paint wait for columns");
         _paintJobs->Join();
     }
 
@@ -1065,6 +1088,7 @@ void viewport_paint(
     }
     if (useParallelDrawing)
     {
+        TRACED_SCOPE("viewport_paint wait for drawing");
         _paintJobs->Join();
     }
 
@@ -0,0 +1,428 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2021 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "ViewportCache.h"
+
+#include "../OpenRCT2.h"
+#include "../config/Config.h"
+#include "../drawing/Drawing.h"
+#include "../drawing/IDrawingEngine.h"
+#include "../drawing/LightFX.h"
+#include "../entity/Staff.h"
+#include "../paint/Paint.h"
+#include "../paint/tile_element/Paint.TileElement.h"
+#include "../ride/TrackDesign.h"
+#include "../world/Climate.h"
+#include "../world/Map.h"
+#include "Viewport.h"
+#include "Window.h"
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+using namespace OpenRCT2::Drawing;
+
+namespace OpenRCT2::ViewportCache
+{
+    // Bounds the memory used by the pages to 16 MiB.
+    constexpr size_t MaxPages = 256;
+
+    // Pages are painted in blocks of 32x32 pixels, the bits of a 64 bit mask.
+    constexpr int32_t BlockSize = 32;
+    constexpr int32_t BlocksPerRow = PageSize / BlockSize;
+    static_assert(BlocksPerRow * BlocksPerRow == 64);
+
+    // Flags of the viewport that do not change what is drawn.
+    constexpr uint32_t IgnoredViewFlags = VIEWPORT_FLAG_SOUND_ON;
+
+    struct PageKey
+    {
+        int32_t X;
+        int32_t Y;
+        int8_t ZoomLevel;
+        uint32_t ViewFlags;
+
+        bool operator==(const PageKey& other) const
+        {
+            return X == other.X && Y == other.Y && ZoomLevel == other.ZoomLevel && ViewFlags == other.ViewFlags;
+        }
+    };
+
+    struct PageKeyHash
+    {
+        size_t operator()(const PageKey& key) const
+        {
+            size_t hash = 5381;
+            auto combine = [&hash](uint32_t value) { hash = ((hash << 5) + hash) + value; };
+            combine(static_cast<uint32_t>(key.X));
+            combine(static_cast<uint32_t>(key.Y));
+            combine(static_cast<uint32_t>(key.ZoomLevel));
+            combine(key.ViewFlags);
+            return hash;
+        }
+    };
+
+    // Zoom level and view flags of the pages that are kept, invalidations only look up the pages of the layers in use.
+    struct Layer
+    {
+        int8_t ZoomLevel;
+        uint32_t ViewFlags;
+        size_t Pages;
+    };
+
+    struct Page
+    {
+        uint8_t Pixels[PageSize * PageSize];
+        uint64_t DirtyBlocks = UINT64_MAX;
+        uint32_t LastUsed{};
+    };
+
+    // State of the game that pages are painted from without the screen being invalidated when it changes.
+    struct GlobalState
+    {
+        uint8_t ClipHeight{};
+        CoordsXY ClipSelectionA;
+        CoordsXY ClipSelectionB;
+        bool PaintWidePathsAsGhost{};
+        bool PaintBlockedTiles{};
+        bool ShowSupportSegmentHeights{};
+        uint8_t ScreenFlags{};
+        int32_t MapSize{};
+        uint8_t Rotation{};
+        uint16_t StaffDrawPatrolAreas{};
+        bool TrackDesignSaveMode{};
+        FilterPaletteID WeatherGloom{};
+
+        bool operator==(const GlobalState& other) const
+        {
+            return ClipHeight == other.ClipHeight && ClipSelectionA == other.ClipSelectionA
+                && ClipSelectionB == other.ClipSelectionB && PaintWidePathsAsGhost == other.PaintWidePathsAsGhost
+                && PaintBlockedTiles == other.PaintBlockedTiles && ShowSupportSegmentHeights == other.ShowSupportSegmentHeights
+                && ScreenFlags == other.ScreenFlags && MapSize == other.MapSize && Rotation == other.Rotation
+                && StaffDrawPatrolAreas == other.StaffDrawPatrolAreas && TrackDesignSaveMode == other.TrackDesignSaveMode
+                && WeatherGloom == other.WeatherGloom;
+        }
+    };
+
+    static std::unordered_map<PageKey, std::unique_ptr<Page>, PageKeyHash> _pages;
+    static std::vector<Layer> _layers;
+    static GlobalState _globalState;
+    static uint32_t _render;
+
+    static uint64_t _blitCount;
+    static uint64_t _paintCount;
+
+    // Returns the top left of the page in coordinates at zoom level 0.
+    static ScreenCoordsXY GetPageOrigin(const PageKey& key)
+    {
+        const int32_t pageSpan = PageSize * ZoomLevel{ key.ZoomLevel };
+        return { key.X * pageSpan, key.Y * pageSpan };
+    }
+
+    static GlobalState CaptureGlobalState()
+    {
+        GlobalState state;
+        state.ClipHeight = gClipHeight;
+        state.ClipSelectionA = gClipSelectionA;
+        state.ClipSelectionB = gClipSelectionB;
+        state.PaintWidePathsAsGhost = gPaintWidePathsAsGhost;
+        state.PaintBlockedTiles = gPaintBlockedTiles;
+        state.ShowSupportSegmentHeights = gShowSupportSegmentHeights;
+        state.ScreenFlags = gScreenFlags;
+        state.MapSize = gMapSize;
+        state.Rotation = get_current_rotation();
+        state.StaffDrawPatrolAreas = gStaffDrawPatrolAreas;
+        state.TrackDesignSaveMode = gTrackDesignSaveMode;
+        state.WeatherGloom = gConfigGeneral.render_weather_gloom ? climate_get_weather_gloom_palette_id(gClimateCurrent)
+                                                                 : FilterPaletteID::PaletteNull;
+        return state;
+    }
+
+    // Returns the mask of the blocks between the pixels of a page, the ends being exclusive.
+    static uint64_t GetBlockMask(int32_t left, int32_t top, int32_t right, int32_t bottom)
+    {
+        uint64_t mask = 0;
+        for (int32_t y = top / BlockSize; y < (bottom + BlockSize - 1) / BlockSize; y++)
+        {
+            for (int32_t x = left / BlockSize; x < (right + BlockSize - 1) / BlockSize; x++)
+            {
+                mask |= 1ULL << (y * BlocksPerRow + x);
+            }
+        }
+        return mask;
+    }
+
+    static Page* GetPage(const PageKey& key)
+    {
+        auto it = _pages.find(key);
+        if (it != _pages.end())
+        {
+            return it->second.get();
+        }
+
+        if (_pages.size() >= MaxPages)
+        {
+            // Pages drawn by this render are still in use, there are always others as the number of pages is checked first.
+            auto oldest = _pages.end();
+            for (auto pageIt = _pages.begin(); pageIt != _pages.end(); pageIt++)
+            {
+                if (pageIt->second->LastUsed != _render
+                    && (oldest == _pages.end() || pageIt->second->LastUsed < oldest->second->LastUsed))
+                {
+                    oldest = pageIt;
+                }
+            }
+            if (oldest == _pages.end())
+            {
+                return nullptr;
+            }
+
+            auto layer = std::find_if(_layers.begin(), _layers.end(), [&oldest](const Layer& l) {
+                return l.ZoomLevel == oldest->first.ZoomLevel && l.ViewFlags == oldest->first.ViewFlags;
+            });
+            if (layer != _layers.end() && --layer->Pages == 0)
+            {
+                _layers.erase(layer);
+            }
+            _pages.erase(oldest);
+        }
+
+        auto layer = std::find_if(_layers.begin(), _layers.end(), [&key](const Layer& l) {
+            return l.ZoomLevel == key.ZoomLevel && l.ViewFlags == key.ViewFlags;
+        });
+        if (layer != _layers.end())
+        {
+            layer->Pages++;
+        }
+        else
+        {
+            _layers.push_back({ key.ZoomLevel, key.ViewFlags, 1 });
+        }
+        return _pages.emplace(key, std::make_unique<Page>()).first->second.get();
+    }
+
+    // Paints the blocks of the page between the pixels, the ends being exclusive.
+    static void PaintPage(
+        Page& page, const PageKey& key, IDrawingEngine* drawingEngine, int32_t left, int32_t top, int32_t right,
+        int32_t bottom)
+    {
+        for (int32_t y = top; y < bottom; y++)
+        {
+            std::memset(&page.Pixels[y * PageSize + left], PALETTE_INDEX_0, right - left);
+        }
+
+        auto zoom = ZoomLevel{ key.ZoomLevel };
+        auto pageOrigin = GetPageOrigin(key);
+
+        rct_viewport viewport{};
+        viewport.width = PageSize;
+        viewport.height = PageSize;
+        viewport.viewPos = pageOrigin;
+        viewport.view_width = PageSize * zoom;
+        viewport.view_height = PageSize * zoom;
+        viewport.flags = key.ViewFlags;
+        viewport.zoom = zoom;
+
+        rct_drawpixelinfo dpi;
+        dpi.bits = page.Pixels;
+        dpi.width = PageSize;
+        dpi.height = PageSize;
+        dpi.DrawingEngine = drawingEngine;
+
+        ScreenRect viewRect = { pageOrigin + ScreenCoordsXY{ left * zoom, top * zoom },
+                                pageOrigin + ScreenCoordsXY{ right * zoom, bottom * zoom } };
+        viewport_paint(&viewport, &dpi, viewRect, nullptr);
+        _paintCount++;
+    }
+
+    void Reset()
+    {
+        _pages.clear();
+        _layers.clear();
+    }
+
+    void Invalidate(const ScreenRect& screenRect)
+    {
+        if (_pages.empty() || screenRect.GetLeft() > screenRect.GetRight() || screenRect.GetTop() > screenRect.GetBottom())
+        {
+            return;
+        }
+
+        for (const auto& layer : _layers)
+        {
+            // The right and bottom of the rect are inclusive.
+            const int32_t pageShift = 8 + layer.ZoomLevel;
+            auto pageLeft = screenRect.GetLeft() >> pageShift;
+            auto pageTop = screenRect.GetTop() >> pageShift;
+            auto pageRight = screenRect.GetRight() >> pageShift;
+            auto pageBottom = screenRect.GetBottom() >> pageShift;
+            for (auto pageY = pageTop; pageY <= pageBottom; pageY++)
+            {
+                for (auto pageX = pageLeft; pageX <= pageRight; pageX++)
+                {
+                    PageKey key{ pageX, pageY, layer.ZoomLevel, layer.ViewFlags };
+                    auto it = _pages.find(key);
+                    if (it == _pages.end())
+                    {
+                        continue;
+                    }
+
+                    auto zoom = ZoomLevel{ key.ZoomLevel };
+                    auto pageOrigin = GetPageOrigin(key);
+                    auto left = std::max((screenRect.GetLeft() - pageOrigin.x) / zoom, 0);
+                    auto top = std::max((screenRect.GetTop() - pageOrigin.y) / zoom, 0);
+                    auto right = std::min((screenRect.GetRight() - pageOrigin.x) / zoom + 1, PageSize);
+                    auto bottom = std::min((screenRect.GetBottom() - pageOrigin.y) / zoom + 1, PageSize);
+                    it->second->DirtyBlocks |= GetBlockMask(left, top, right, bottom);
+                }
+            }
+        }
+    }
+
+    bool Render(rct_drawpixelinfo& dpi, const rct_viewport& viewport, const ScreenRect& screenRect)
+    {
+        if (!gConfigGeneral.viewport_cache)
+        {
+            Reset();
+            return false;
+        }
+
+        // Zoomed in viewports draw sprites scaled up, pages only hold whole pixels. Pages are drawn into the pixels of the
+        // screen directly, which is not possible for drawing engines that draw the viewports themselves.
+        auto zoom = viewport.zoom;
+        if (zoom < ZoomLevel{ 0 } || dpi.zoom_level != ZoomLevel{ 0 } || dpi.DrawingEngine == nullptr
+            || !(dpi.DrawingEngine->GetFlags() & DEF_DIRTY_OPTIMISATIONS)
+            || (viewport.flags & VIEWPORT_FLAG_TRANSPARENT_BACKGROUND))
+        {
+            return false;
+        }
+
+#ifdef __ENABLE_LIGHTFX__
+        // Lights are collected while the viewport is painted, copying it from the pages would not add them.
+        if (lightfx_is_available())
+        {
+            return false;
+        }
+#endif
+
+        auto globalState = CaptureGlobalState();
+        if (!(globalState == _globalState))
+        {
+            Reset();
+            _globalState = globalState;
+        }
+
+        // Same area as viewport_paint draws.
+        const int32_t bitmask = ~((1 << static_cast<int8_t>(zoom)) - 1);
+        auto left = screenRect.GetLeft() & bitmask;
+        auto top = screenRect.GetTop() & bitmask;
+        auto right = left + (screenRect.GetWidth() & bitmask);
+        auto bottom = top + (screenRect.GetHeight() & bitmask);
+        if (left >= right || top >= bottom)
+        {
+            return true;
+        }
+
+        const int32_t pageShift = 8 + static_cast<int8_t>(zoom);
+        static_assert(PageSize == 1 << 8);
+        auto pageLeft = left >> pageShift;
+        auto pageTop = top >> pageShift;
+        auto pageRight = ((right - 1) >> pageShift) + 1;
+        auto pageBottom = ((bottom - 1) >> pageShift) + 1;
+        if (static_cast<size_t>((pageRight - pageLeft) * (pageBottom - pageTop)) > MaxPages)
+        {
+            return false;
+        }
+
+        _render++;
+        const auto viewOrigin = ScreenCoordsXY{ viewport.viewPos.x & bitmask, viewport.viewPos.y & bitmask };
+        const auto viewFlags = viewport.flags & ~IgnoredViewFlags;
+        const auto stride = dpi.width + dpi.pitch;
+        for (auto pageY = pageTop; pageY < pageBottom; pageY++)
+        {
+            for (auto pageX = pageLeft; pageX < pageRight; pageX++)
+            {
+                PageKey key{ pageX, pageY, static_cast<int8_t>(zoom), viewFlags };
+                auto* page = GetPage(key);
+                if (page == nullptr)
+                {
+                    return false;
+                }
+                page->LastUsed = _render;
+
+                // Pixels of the page within the area, then within the dpi.
+                auto pageOrigin = GetPageOrigin(key);
+                auto screenOrigin = ScreenCoordsXY{ (pageOrigin.x - viewOrigin.x) / zoom, (pageOrigin.y - viewOrigin.y) / zoom }
+                    + viewport.pos;
+                auto srcLeft = std::max((left - pageOrigin.x) / zoom, 0);
+                auto srcTop = std::max((top - pageOrigin.y) / zoom, 0);
+                auto srcRight = std::min((right - pageOrigin.x) / zoom, PageSize);
+                auto srcBottom = std::min((bottom - pageOrigin.y) / zoom, PageSize);
+                srcLeft = std::max(srcLeft, dpi.x - screenOrigin.x);
+                srcTop = std::max(srcTop, dpi.y - screenOrigin.y);
+                srcRight = std::min(srcRight, dpi.x + dpi.width - screenOrigin.x);
+                srcBottom = std::min(srcBottom, dpi.y + dpi.height - screenOrigin.y);
+                if (srcLeft >= srcRight || srcTop >= srcBottom)
+                {
+                    continue;
+                }
+
+                // Dirty blocks are painted as one area, their bounds are usually the area of a single invalidation.
+                auto dirtyBlocks = page->DirtyBlocks & GetBlockMask(srcLeft, srcTop, srcRight, srcBottom);
+                if (dirtyBlocks != 0)
+                {
+                    int32_t blockLeft = BlocksPerRow, blockTop = BlocksPerRow, blockRight = 0, blockBottom = 0;
+                    for (int32_t block = 0; block < 64; block++)
+                    {
+                        if (dirtyBlocks & (1ULL << block))
+                        {
+                            blockLeft = std::min(blockLeft, block % BlocksPerRow);
+                            blockTop = std::min(blockTop, block / BlocksPerRow);
+                            blockRight = std::max(blockRight, block % BlocksPerRow + 1);
+                            blockBottom = std::max(blockBottom, block / BlocksPerRow + 1);
+                        }
+                    }
+                    PaintPage(
+                        *page, key, dpi.DrawingEngine, blockLeft * BlockSize, blockTop * BlockSize, blockRight * BlockSize,
+                        blockBottom * BlockSize);
+                    page->DirtyBlocks &= ~GetBlockMask(
+                        blockLeft * BlockSize, blockTop * BlockSize, blockRight * BlockSize, blockBottom * BlockSize);
+                }
+
+                auto* dst = dpi.bits + (screenOrigin.x + srcLeft - dpi.x) + (screenOrigin.y + srcTop - dpi.y) * stride;
+                for (auto y = srcTop; y < srcBottom; y++)
+                {
+                    std::memcpy(dst, &page->Pixels[y * PageSize + srcLeft], srcRight - srcLeft);
+                    dst += stride;
+                }
+                _blitCount++;
+            }
+        }
+        return true;
+    }
+
+    Stats GetStats()
+    {
+        Stats stats;
+        stats.BlitCount = _blitCount;
+        stats.PaintCount = _paintCount;
+        stats.Pages = _pages.size();
+        stats.MemoryUsed = _pages.size() * sizeof(Page);
+        return stats;
+    }
+
+    void ResetStats()
+    {
+        _blitCount = 0;
+        _paintCount = 0;
+    }
+} // namespace OpenRCT2::ViewportCache
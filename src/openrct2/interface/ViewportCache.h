@@ -0,0 +1,55 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2021 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#pragma once
+
+#include "../common.h"
+#include "../world/Location.hpp"
+
+struct rct_drawpixelinfo;
+struct rct_viewport;
+
+/**
+ * Keeps painted pages of the world, 256x256 pixels each per zoom level and view flags, that viewports are copied from
+ * instead of being painted. Pages are marked dirty by the same invalidations that mark the screen dirty, so only the
+ * parts that changed are painted again, no matter which viewport shows them or where it scrolled to.
+ */
+namespace OpenRCT2::ViewportCache
+{
+    constexpr int32_t PageSize = 256;
+
+    struct Stats
+    {
+        uint64_t BlitCount{};
+        uint64_t PaintCount{};
+        size_t Pages{};
+        size_t MemoryUsed{};
+    };
+
+    /**
+     * Discards every page, used when the whole screen is invalidated or the map is replaced.
+     */
+    void Reset();
+
+    /**
+     * Marks the pages of every zoom level dirty within screenRect, which is in coordinates at zoom level 0. Unlike the
+     * screen, pages of zoom levels that skip an invalidation would keep showing the old contents after scrolling.
+     */
+    void Invalidate(const ScreenRect& screenRect);
+
+    /**
+     * Draws the area of the viewport within screenRect, in coordinates at zoom level 0, from the pages, painting the
+     * dirty parts of them first. Returns false without drawing anything when the cache is disabled or can not be used
+     * for the viewport, in which case it must be painted directly.
+     */
+    bool Render(rct_drawpixelinfo& dpi, const rct_viewport& viewport, const ScreenRect& screenRect);
+
+    Stats GetStats();
+    void ResetStats();
+} // namespace OpenRCT2::ViewportCache
@@ -25,6 +25,7 @@
 #include "../localisation/Formatter.h"
 #include "../localisation/Formatting.h"
 #include "../park/ParkFile.h"
+#include "../park/ParkSaveWorker.h"
 #include "../platform/Platform2.h"
 #include "../scenario/Scenario.h"
 #include "../scripting/ScriptEngine.h"
@@ -41,7 +42,7 @@
 // This string specifies which version of network stream current build uses.
 // It is used for making sure only compatible builds get connected, even within
 // single OpenRCT2 version.
-#define NETWORK_STREAM_VERSION "9"
+#define NETWORK_STREAM_VERSION "10"
 #define NETWORK_STREAM_ID OPENRCT2_VERSION "-" NETWORK_STREAM_VERSION
 
 static Peep* _pickup_peep = nullptr;
@@ -57,6 +58,10 @@ static constexpr uint32_t CHUNK_SIZE = 1024 * 63;
 // This limit is per connection, the current value was determined by tests with fuzzing.
 static constexpr uint32_t MaxPacketsPerUpdate = 100;
 
+// Clients joining within this many ticks of the last map export receive that map and replay what happened since.
+static constexpr uint32_t MapSnapshotMaxAge = GAME_UPDATE_FPS * 5;
+static constexpr size_t MapSnapshotMaxReplay = 1000;
+
 #    include "../Cheats.h"
 #    include "../ParkImporter.h"
 #    include "../Version.h"
@@ -201,6 +206,7 @@ void NetworkBase::Close()
         _serverTickData.clear();
         _pendingPlayerLists.clear();
         _pendingPlayerInfo.clear();
+        _mapSnapshot = {};
 
         gfx_invalidate_screen();
 
@@ -231,6 +237,7 @@ void NetworkBase::CloseConnection()
     }
     else if (mode == NETWORK_MODE_SERVER)
     {
+        _socketPoller.reset();
         _listenSocket.reset();
         _advertiser.reset();
     }
@@ -359,6 +366,8 @@ bool NetworkBase::BeginServer(uint16_t port, const std::string& address)
     try
     {
         _listenSocket->Listen(address, port);
+        _socketPoller = CreateTcpSocketPoller();
+        _socketPoller->Add(*_listenSocket);
     }
     catch (const std::exception& ex)
     {
@@ -502,13 +511,20 @@ void NetworkBase::Flush()
 
 void NetworkBase::UpdateServer()
 {
+    // Only the connections with data waiting are read from, the others are just checked for timeouts.
+    auto readySockets = _socketPoller->Poll(0);
+    std::sort(readySockets.begin(), readySockets.end());
+    auto isReady = [&readySockets](ITcpSocket* socket) {
+        return std::binary_search(readySockets.begin(), readySockets.end(), socket);
+    };
+
     for (auto& connection : client_connection_list)
     {
         // This can be called multiple times before the connection is removed.
         if (!connection->IsValid())
             continue;
 
-        if (!ProcessConnection(*connection))
+        if (!ProcessConnection(*connection, isReady(connection->Socket.get())))
         {
             connection->Disconnect();
         }
@@ -530,10 +546,13 @@ void NetworkBase::UpdateServer()
         _advertiser->Update();
     }
 
-    std::unique_ptr<ITcpSocket> tcpSocket = _listenSocket->Accept();
-    if (tcpSocket != nullptr)
+    if (isReady(_listenSocket.get()))
     {
-        AddClient(std::move(tcpSocket));
+        std::unique_ptr<ITcpSocket> tcpSocket = _listenSocket->Accept();
+        if (tcpSocket != nullptr)
+        {
+            AddClient(std::move(tcpSocket));
+        }
     }
 }
 
@@ -715,6 +734,9 @@ const char* NetworkBase::FormatChat(NetworkPlayer* fromplayer, const char* text)
 
 void NetworkBase::SendPacketToClients(const NetworkPacket& packet, bool front, bool gameCmd)
 {
+    // Serialised once, all connections share the same buffer.
+    auto buffer = std::make_shared<const NetworkPacketBuffer>(packet);
+    RecordMapSnapshotReplay(buffer);
     for (auto& client_connection : client_connection_list)
     {
         if (gameCmd)
@@ -728,9 +750,46 @@ void NetworkBase::SendPacketToClients(const NetworkPacket& packet, bool front, b
                 continue;
             }
         }
-        auto packetCopy = packet;
-        client_connection->QueuePacket(std::move(packetCopy), front);
+        client_connection->QueuePacket(buffer, front);
+    }
+}
+
+bool NetworkBase::IsMapSnapshotUsable(const std::vector<const ObjectRepositoryItem*>& objects) const
+{
+    return _mapSnapshot.IsValid && gCurrentTicks - _mapSnapshot.Tick <= MapSnapshotMaxAge
+        && _mapSnapshot.Replay.size() < MapSnapshotMaxReplay
+        && std::includes(_mapSnapshot.Objects.begin(), _mapSnapshot.Objects.end(), objects.begin(), objects.end());
+}
+
+void NetworkBase::RecordMapSnapshotReplay(const std::shared_ptr<const NetworkPacketBuffer>& buffer)
+{
+    if (!_mapSnapshot.IsValid)
+    {
+        return;
+    }
+
+    // A client receiving the map replays these to catch up, anything else it gets once it has joined.
+    switch (buffer->Command)
+    {
+        case NetworkCommand::GameAction:
+        case NetworkCommand::Tick:
+        case NetworkCommand::PlayerInfo:
+        case NetworkCommand::PlayerList:
+            break;
+        default:
+            return;
+    }
+
+    if (!IsMapSnapshotUsable({}))
+    {
+        // Still needed by the clients waiting for it, otherwise no longer of any use.
+        if (!_mapSnapshot.IsEncoding)
+        {
+            _mapSnapshot = {};
+        }
+        return;
     }
+    _mapSnapshot.Replay.push_back(buffer);
 }
 
 bool NetworkBase::CheckSRAND(uint32_t tick, uint32_t srand0)
@@ -752,14 +811,20 @@ bool NetworkBase::CheckSRAND(uint32_t tick, uint32_t srand0)
         return false;
     }
 
-    if (!storedTick.spriteHash.empty())
+    if (storedTick.hasChecksum)
     {
-        EntitiesChecksum checksum = GetAllEntitiesChecksum();
-        std::string clientSpriteHash = checksum.ToString();
-        if (clientSpriteHash != storedTick.spriteHash)
+        auto checksum = NetworkGetSliceChecksum(tick);
+        for (size_t i = 0; i < checksum.Hashes.size(); i++)
         {
-            log_info("Sprite hash mismatch, client = %s, server = %s", clientSpriteHash.c_str(), storedTick.spriteHash.c_str());
-            return false;
+            if (checksum.Hashes[i] != storedTick.checksum.Hashes[i])
+            {
+                log_info(
+                    "Checksum mismatch for %s in slice %u of %u, client = %016llX, server = %016llX",
+                    NetworkGetChecksumSubsystemName(static_cast<NetworkChecksumSubsystem>(i)), checksum.Slice,
+                    NetworkChecksumSliceCount, static_cast<unsigned long long>(checksum.Hashes[i]),
+                    static_cast<unsigned long long>(storedTick.checksum.Hashes[i]));
+                return false;
+            }
         }
     }
 
@@ -1394,48 +1459,126 @@ void NetworkBase::Server_Send_MAP(NetworkConnection* connection)
         objects = objManager.GetPackableObjects();
     }
 
-    auto header = save_for_network(objects);
-    if (header.empty())
+    std::sort(objects.begin(), objects.end());
+    objects.erase(std::unique(objects.begin(), objects.end()), objects.end());
+
+    // Clients joining shortly after one another share the map instead of exporting it again.
+    if (connection != nullptr && IsMapSnapshotUsable(objects))
     {
-        if (connection != nullptr)
+        connection->DeferPackets();
+        auto replayCount = _mapSnapshot.Replay.size();
+        if (_mapSnapshot.IsEncoding)
         {
-            connection->SetLastDisconnectReason(STR_MULTIPLAYER_CONNECTION_CLOSED);
-            connection->Disconnect();
+            _mapSnapshot.Recipients.push_back({ connection, replayCount, true });
+        }
+        else
+        {
+            Server_Send_MAP_SNAPSHOT(*connection, replayCount);
         }
         return;
     }
-    size_t chunksize = CHUNK_SIZE;
-    for (size_t i = 0; i < header.size(); i += chunksize)
+
+    // A map still being encoded is sent first, releasing the packets held back for it.
+    ParkSaveWorker::Flush();
+
+    _mapSnapshot = {};
+    _mapSnapshot.IsValid = true;
+    _mapSnapshot.IsEncoding = true;
+    _mapSnapshot.Tick = gCurrentTicks;
+    _mapSnapshot.Objects = objects;
+
+    // The map is encoded in the background, the packets queued in the meantime have to follow it.
+    if (connection != nullptr)
     {
-        size_t datasize = std::min(chunksize, header.size() - i);
-        NetworkPacket packet(NetworkCommand::Map);
-        packet << static_cast<uint32_t>(header.size()) << static_cast<uint32_t>(i);
-        packet.Write(&header[i], datasize);
-        if (connection != nullptr)
+        _mapSnapshot.Recipients.push_back({ connection, 0, true });
+    }
+    else
+    {
+        for (auto& clientConnection : client_connection_list)
         {
-            connection->QueuePacket(std::move(packet));
+            _mapSnapshot.Recipients.push_back({ clientConnection.get(), 0, false });
         }
-        else
+    }
+    for (auto& recipient : _mapSnapshot.Recipients)
+    {
+        recipient.Connection->DeferPackets();
+    }
+
+    viewport_set_saved_view();
+    auto exporter = ParkFileExporter();
+    exporter.ExportObjectsList = objects;
+    auto onComplete = [this](ParkSaveWorker::Result& result) {
+        if (!result.Success)
         {
-            SendPacketToClients(packet);
+            log_warning("Failed to export map.");
+            result.Data.clear();
         }
+        Server_Send_MAP_DATA(result.Data);
+    };
+    if (!ParkSaveWorker::Start("Network map", exporter, nullptr, onComplete))
+    {
+        Server_Send_MAP_DATA({});
     }
 }
 
-std::vector<uint8_t> NetworkBase::save_for_network(const std::vector<const ObjectRepositoryItem*>& objects) const
+void NetworkBase::Server_Send_MAP_DATA(const std::vector<uint8_t>& data)
 {
-    std::vector<uint8_t> result;
-    auto ms = OpenRCT2::MemoryStream();
-    if (SaveMap(&ms, objects))
+    // The network may have been closed while the map was being encoded.
+    if (!_mapSnapshot.IsEncoding)
     {
-        result.resize(ms.GetLength());
-        std::memcpy(result.data(), ms.GetData(), result.size());
+        return;
     }
-    else
+
+    _mapSnapshot.IsEncoding = false;
+    size_t chunksize = CHUNK_SIZE;
+    for (size_t i = 0; i < data.size(); i += chunksize)
     {
-        log_warning("Failed to export map.");
+        size_t datasize = std::min(chunksize, data.size() - i);
+        NetworkPacket packet(NetworkCommand::Map);
+        packet << static_cast<uint32_t>(data.size()) << static_cast<uint32_t>(i);
+        packet.Write(&data[i], datasize);
+        _mapSnapshot.Chunks.push_back(std::make_shared<const NetworkPacketBuffer>(packet));
     }
-    return result;
+
+    // Connections may have closed while the map was being encoded.
+    auto recipients = std::move(_mapSnapshot.Recipients);
+    for (auto& clientConnection : client_connection_list)
+    {
+        auto* connection = clientConnection.get();
+        auto it = std::find_if(recipients.begin(), recipients.end(), [connection](const MapSnapshotRecipient& recipient) {
+            return recipient.Connection == connection;
+        });
+        if (it == recipients.end() || !connection->IsDeferringPackets())
+        {
+            continue;
+        }
+
+        if (data.empty())
+        {
+            if (it->DisconnectOnFailure)
+            {
+                connection->SetLastDisconnectReason(STR_MULTIPLAYER_CONNECTION_CLOSED);
+                connection->Disconnect();
+            }
+            connection->ReleaseDeferredPackets({});
+        }
+        else
+        {
+            Server_Send_MAP_SNAPSHOT(*connection, it->ReplayCount);
+        }
+    }
+
+    if (data.empty())
+    {
+        _mapSnapshot = {};
+    }
+}
+
+void NetworkBase::Server_Send_MAP_SNAPSHOT(NetworkConnection& connection, size_t replayCount)
+{
+    auto packets = _mapSnapshot.Chunks;
+    packets.insert(packets.end(), _mapSnapshot.Replay.begin(), _mapSnapshot.Replay.begin() + replayCount);
+    connection.ReleaseDeferredPackets(packets);
 }
 
 void NetworkBase::Client_Send_CHAT(const char* text)
@@ -1505,24 +1648,17 @@ void NetworkBase::Server_Send_TICK()
 {
     NetworkPacket packet(NetworkCommand::Tick);
     packet << gCurrentTicks << scenario_rand_state().s0;
-    uint32_t flags = 0;
-    // Simple counter which limits how often a sprite checksum gets sent.
-    // This can get somewhat expensive, so we don't want to push it every tick in release,
-    // but debug version can check more often.
-    static int32_t checksum_counter = 0;
-    checksum_counter++;
-    if (checksum_counter >= 100)
-    {
-        checksum_counter = 0;
-        flags |= NETWORK_TICK_FLAG_CHECKSUMS;
-    }
+
     // Send flags always, so we can understand packet structure on the other end,
     // and allow for some expansion.
+    uint32_t flags = NETWORK_TICK_FLAG_CHECKSUMS;
     packet << flags;
-    if (flags & NETWORK_TICK_FLAG_CHECKSUMS)
+
+    // Each tick carries the checksums of a different slice of the game state, cheap enough to send every tick.
+    auto checksum = NetworkGetSliceChecksum(gCurrentTicks);
+    for (auto hash : checksum.Hashes)
     {
-        EntitiesChecksum checksum = GetAllEntitiesChecksum();
-        packet.WriteString(checksum.ToString().c_str());
+        packet << hash;
     }
 
     SendPacketToClients(packet);
@@ -1655,40 +1791,43 @@ void NetworkBase::Server_Send_EVENT_PLAYER_DISCONNECTED(const char* playerName,
     SendPacketToClients(packet);
 }
 
-bool NetworkBase::ProcessConnection(NetworkConnection& connection)
+bool NetworkBase::ProcessConnection(NetworkConnection& connection, bool hasData)
 {
-    NetworkReadPacket packetStatus;
-
-    uint32_t countProcessed = 0;
-    do
+    if (hasData)
     {
-        countProcessed++;
-        packetStatus = connection.ReadPacket();
-        switch (packetStatus)
+        NetworkReadPacket packetStatus;
+
+        uint32_t countProcessed = 0;
+        do
         {
-            case NetworkReadPacket::Disconnected:
-                // closed connection or network error
-                if (!connection.GetLastDisconnectReason())
-                {
-                    connection.SetLastDisconnectReason(STR_MULTIPLAYER_CONNECTION_CLOSED);
-                }
-                return false;
-            case NetworkReadPacket::Success:
-                // done reading in packet
-                ProcessPacket(connection, connection.InboundPacket);
-                if (!connection.IsValid())
-                {
+            countProcessed++;
+            packetStatus = connection.ReadPacket();
+            switch (packetStatus)
+            {
+                case NetworkReadPacket::Disconnected:
+                    // closed connection or network error
+                    if (!connection.GetLastDisconnectReason())
+                    {
+                        connection.SetLastDisconnectReason(STR_MULTIPLAYER_CONNECTION_CLOSED);
+                    }
                     return false;
-                }
-                break;
-            case NetworkReadPacket::MoreData:
-                // more data required to be read
-                break;
-            case NetworkReadPacket::NoData:
-                // could not read anything from socket
-                break;
-        }
-    } while (packetStatus == NetworkReadPacket::Success && countProcessed < MaxPacketsPerUpdate);
+                case NetworkReadPacket::Success:
+                    // done reading in packet
+                    ProcessPacket(connection, connection.InboundPacket);
+                    if (!connection.IsValid())
+                    {
+                        return false;
+                    }
+                    break;
+                case NetworkReadPacket::MoreData:
+                    // more data required to be read
+                    break;
+                case NetworkReadPacket::NoData:
+                    // could not read anything from socket
+                    break;
+            }
+        } while (packetStatus == NetworkReadPacket::Success && countProcessed < MaxPacketsPerUpdate);
+    }
 
     if (!connection.ReceivedPacketRecently())
     {
@@ -1938,6 +2077,7 @@ void NetworkBase::ProcessDisconnectedClients()
         // Make sure to send all remaining packets out before disconnecting.
         connection->SendQueuedPackets();
         connection->Socket->Disconnect();
+        _socketPoller->Remove(*connection->Socket);
 
         ServerClientDisconnected(connection);
         RemovePlayer(connection);
@@ -1956,6 +2096,7 @@ void NetworkBase::AddClient(std::unique_ptr<ITcpSocket>&& socket)
     // Store connection
     auto connection = std::make_unique<NetworkConnection>();
     connection->Socket = std::move(socket);
+    _socketPoller->Add(*connection->Socket);
 
     client_connection_list.push_back(std::move(connection));
 }
@@ -2773,24 +2914,6 @@ bool NetworkBase::LoadMap(IStream* stream)
     return result;
 }
 
-bool NetworkBase::SaveMap(IStream* stream, const std::vector<const ObjectRepositoryItem*>& objects) const
-{
-    bool result = false;
-    viewport_set_saved_view();
-    try
-    {
-        auto exporter = std::make_unique<ParkFileExporter>();
-        exporter->ExportObjectsList = objects;
-        exporter->Export(*stream);
-        result = true;
-    }
-    catch (const std::exception& e)
-    {
-        Console::Error::WriteLine("Unable to serialise map: %s", e.what());
-    }
-    return result;
-}
-
 void NetworkBase::Client_Handle_CHAT([[maybe_unused]] NetworkConnection& connection, NetworkPacket& packet)
 {
     auto text = packet.ReadString();
@@ -2985,13 +3108,14 @@ void NetworkBase::Client_Handle_TICK([[maybe_unused]] NetworkConnection& connect
     ServerTickData_t tickData;
     tickData.srand0 = srand0;
     tickData.tick = serverTick;
+    tickData.hasChecksum = (flags & NETWORK_TICK_FLAG_CHECKSUMS) != 0;
 
-    if (flags & NETWORK_TICK_FLAG_CHECKSUMS)
+    if (tickData.hasChecksum)
     {
-        auto text = packet.ReadString();
-        if (!text.empty())
+        tickData.checksum.Slice = serverTick % NetworkChecksumSliceCount;
+        for (auto& hash : tickData.checksum.Hashes)
         {
-            tickData.spriteHash = text;
+            packet >> hash;
         }
     }
 
@@ -3,6 +3,7 @@
 #include "../System.hpp"
 #include "../actions/GameAction.h"
 #include "../object/Object.h"
+#include "NetworkChecksum.h"
 #include "NetworkConnection.h"
 #include "NetworkGroup.h"
 #include "NetworkPlayer.h"
@@ -50,7 +51,7 @@ public: // Common
     void CloseChatLog();
     NetworkStats_t GetStats() const;
     json_t GetServerInfoAsJson() const;
-    bool ProcessConnection(NetworkConnection& connection);
+    bool ProcessConnection(NetworkConnection& connection, bool hasData = true);
     void CloseConnection();
     NetworkPlayer* AddPlayer(const std::string& name, const std::string& keyhash);
     void ProcessPacket(NetworkConnection& connection, NetworkPacket& packet);
@@ -75,14 +76,16 @@ public: // Server
     void RemovePlayer(std::unique_ptr<NetworkConnection>& connection);
     void UpdateServer();
     void ServerClientDisconnected(std::unique_ptr<NetworkConnection>& connection);
-    bool SaveMap(OpenRCT2::IStream* stream, const std::vector<const ObjectRepositoryItem*>& objects) const;
-    std::vector<uint8_t> save_for_network(const std::vector<const ObjectRepositoryItem*>& objects) const;
     std::string MakePlayerNameUnique(const std::string& name);
+    bool IsMapSnapshotUsable(const std::vector<const ObjectRepositoryItem*>& objects) const;
+    void RecordMapSnapshotReplay(const std::shared_ptr<const NetworkPacketBuffer>& buffer);
 
     // Packet dispatchers.
     void Server_Send_AUTH(NetworkConnection& connection);
     void Server_Send_TOKEN(NetworkConnection& connection);
     void Server_Send_MAP(NetworkConnection* connection = nullptr);
+    void Server_Send_MAP_DATA(const std::vector<uint8_t>& data);
+    void Server_Send_MAP_SNAPSHOT(NetworkConnection& connection, size_t replayCount);
     void Server_Send_CHAT(const char* text, const std::vector<uint8_t>& playerIds = {});
     void Server_Send_GAME_ACTION(const GameAction* action);
     void Server_Send_TICK();
@@ -191,13 +194,37 @@ private: // Common Data
     bool wsa_initialized = false;
 
 private: // Server Data
+    struct MapSnapshotRecipient
+    {
+        NetworkConnection* Connection{};
+        // The number of replayed packets the connection missed before it was added.
+        size_t ReplayCount{};
+        bool DisconnectOnFailure{};
+    };
+
+    // The last map sent to clients, shared by the clients joining shortly after it was captured.
+    struct MapSnapshot
+    {
+        bool IsValid{};
+        bool IsEncoding{};
+        uint32_t Tick{};
+        // Sorted, the objects packed into the map.
+        std::vector<const ObjectRepositoryItem*> Objects;
+        std::vector<std::shared_ptr<const NetworkPacketBuffer>> Chunks;
+        // The packets changing the game state that were sent to clients since the map was captured.
+        std::vector<std::shared_ptr<const NetworkPacketBuffer>> Replay;
+        std::vector<MapSnapshotRecipient> Recipients;
+    };
+
     std::unordered_map<NetworkCommand, CommandHandler> server_command_handlers;
     std::unique_ptr<ITcpSocket> _listenSocket;
+    std::unique_ptr<ITcpSocketPoller> _socketPoller;
     std::unique_ptr<INetworkServerAdvertiser> _advertiser;
     std::list<std::unique_ptr<NetworkConnection>> client_connection_list;
     std::string _serverLogPath;
     std::string _serverLogFilenameFormat = "%Y%m%d-%H%M%S.txt";
     std::ofstream _server_log_fs;
+    MapSnapshot _mapSnapshot;
     uint16_t listening_port = 0;
     bool _playerListInvalidated = false;
 
@@ -211,7 +238,8 @@ private: // Client Data
     {
         uint32_t srand0;
         uint32_t tick;
-        std::string spriteHash;
+        bool hasChecksum;
+        NetworkSliceChecksum checksum;
     };
 
     std::unordered_map<NetworkCommand, CommandHandler> client_command_handlers;
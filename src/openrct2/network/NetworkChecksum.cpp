@@ -0,0 +1,180 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2021 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#ifndef DISABLE_NETWORK
+
+#    include "NetworkChecksum.h"
+
+#    include "../core/ChecksumStream.h"
+#    include "../core/DataSerialiser.h"
+#    include "../entity/EntityRegistry.h"
+#    include "../entity/Guest.h"
+#    include "../entity/Litter.h"
+#    include "../entity/Staff.h"
+#    include "../ride/Ride.h"
+#    include "../ride/Vehicle.h"
+#    include "../world/Map.h"
+
+#    include <cstring>
+#    include <utility>
+
+using namespace OpenRCT2;
+
+static std::pair<size_t, size_t> GetSliceRange(uint32_t slice, size_t count)
+{
+    return { count * slice / NetworkChecksumSliceCount, count * (slice + 1) / NetworkChecksumSliceCount };
+}
+
+static uint64_t GetHash(const std::array<std::byte, 20>& checksum)
+{
+    uint64_t hash;
+    std::memcpy(&hash, checksum.data(), sizeof(hash));
+    return hash;
+}
+
+template<typename T> static void HashValue(ChecksumStream& stream, const T& value)
+{
+    stream.Write(&value, sizeof(value));
+}
+
+// Only the entities that are part of the simulation, the same ones as GetAllEntitiesChecksum.
+static uint64_t HashEntities(uint32_t slice)
+{
+    std::array<std::byte, 20> checksum{};
+    ChecksumStream ms(checksum);
+    DataSerialiser ds(true, ms);
+
+    auto [begin, end] = GetSliceRange(slice, MAX_ENTITIES);
+    for (auto i = begin; i < end; i++)
+    {
+        auto* entity = GetEntity(static_cast<uint16_t>(i));
+        if (entity == nullptr)
+            continue;
+
+        switch (entity->Type)
+        {
+            case EntityType::Guest:
+                entity->As<Guest>()->Serialise(ds);
+                break;
+            case EntityType::Staff:
+                entity->As<Staff>()->Serialise(ds);
+                break;
+            case EntityType::Vehicle:
+                entity->As<Vehicle>()->Serialise(ds);
+                break;
+            case EntityType::Litter:
+                entity->As<Litter>()->Serialise(ds);
+                break;
+            default:
+                break;
+        }
+    }
+    return GetHash(checksum);
+}
+
+// Ghosts are local to each player and left out, which also changes which element is the last one of its tile.
+static uint64_t HashTiles(uint32_t slice)
+{
+    std::array<std::byte, 20> checksum{};
+    ChecksumStream ms(checksum);
+
+    auto [begin, end] = GetSliceRange(slice, gMapSize);
+    for (auto y = static_cast<int32_t>(begin); y < static_cast<int32_t>(end); y++)
+    {
+        for (int32_t x = 0; x < gMapSize; x++)
+        {
+            auto* tileElement = map_get_first_element_at(TileCoordsXY{ x, y });
+            if (tileElement == nullptr)
+                continue;
+
+            uint16_t numElements = 0;
+            do
+            {
+                if (tileElement->IsGhost())
+                    continue;
+
+                auto element = *tileElement;
+                element.Flags &= ~TILE_ELEMENT_FLAG_LAST_TILE;
+                HashValue(ms, element);
+                numElements++;
+            } while (!(tileElement++)->IsLastForTile());
+            HashValue(ms, numElements);
+        }
+    }
+    return GetHash(checksum);
+}
+
+// Only the state the simulation changes, ride construction also touches rides while placing ghosts.
+static uint64_t HashRides(uint32_t slice)
+{
+    std::array<std::byte, 20> checksum{};
+    ChecksumStream ms(checksum);
+
+    auto [begin, end] = GetSliceRange(slice, MAX_RIDES);
+    for (auto i = begin; i < end; i++)
+    {
+        auto* ride = get_ride(static_cast<ride_id_t>(i));
+        if (ride == nullptr)
+            continue;
+
+        HashValue(ms, ride->id);
+        HashValue(ms, ride->type);
+        HashValue(ms, ride->status);
+        HashValue(ms, ride->mode);
+        HashValue(ms, ride->num_vehicles);
+        HashValue(ms, ride->num_cars_per_train);
+        for (size_t j = 0; j < ride->num_vehicles; j++)
+        {
+            HashValue(ms, ride->vehicles[j]);
+        }
+        HashValue(ms, ride->ratings);
+        HashValue(ms, ride->value);
+        HashValue(ms, ride->price);
+        HashValue(ms, ride->cur_num_customers);
+        HashValue(ms, ride->total_customers);
+        HashValue(ms, ride->total_profit);
+        HashValue(ms, ride->income_per_hour);
+        HashValue(ms, ride->profit);
+        HashValue(ms, ride->popularity);
+        HashValue(ms, ride->satisfaction);
+        HashValue(ms, ride->reliability);
+        HashValue(ms, ride->breakdown_reason);
+        HashValue(ms, ride->mechanic_status);
+        HashValue(ms, ride->mechanic);
+        HashValue(ms, ride->downtime);
+    }
+    return GetHash(checksum);
+}
+
+NetworkSliceChecksum NetworkGetSliceChecksum(uint32_t tick)
+{
+    NetworkSliceChecksum checksum;
+    checksum.Slice = tick % NetworkChecksumSliceCount;
+    checksum.Hashes[EnumValue(NetworkChecksumSubsystem::Entities)] = HashEntities(checksum.Slice);
+    checksum.Hashes[EnumValue(NetworkChecksumSubsystem::Tiles)] = HashTiles(checksum.Slice);
+    checksum.Hashes[EnumValue(NetworkChecksumSubsystem::Rides)] = HashRides(checksum.Slice);
+    return checksum;
+}
+
+const char* NetworkGetChecksumSubsystemName(NetworkChecksumSubsystem subsystem)
+{
+    switch (subsystem)
+    {
+        case NetworkChecksumSubsystem::Entities:
+            return "entities";
+        case NetworkChecksumSubsystem::Tiles:
+            return "tiles";
+        case NetworkChecksumSubsystem::Rides:
+            return "rides";
+        default:
+            return "unknown";
+    }
+}
+
+#endif // DISABLE_NETWORK
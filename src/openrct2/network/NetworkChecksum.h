@@ -0,0 +1,44 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2021 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#pragma once
+
+#ifndef DISABLE_NETWORK
+
+#    include "../common.h"
+#    include "../util/Util.h"
+
+#    include <array>
+
+enum class NetworkChecksumSubsystem : uint8_t
+{
+    Entities,
+    Tiles,
+    Rides,
+    Count,
+};
+
+// The number of ticks it takes for the slices to cover the whole game state once.
+constexpr uint32_t NetworkChecksumSliceCount = 40;
+
+/**
+ * Checksums of one slice of the game state, sent with every tick. Each tick covers a different slice of the entities,
+ * of the map rows and of the rides, so hashing stays cheap while every part of the park is compared regularly. A
+ * mismatch tells which subsystem and which part of it went out of sync.
+ */
+struct NetworkSliceChecksum
+{
+    uint32_t Slice{};
+    std::array<uint64_t, EnumValue(NetworkChecksumSubsystem::Count)> Hashes{};
+};
+
+NetworkSliceChecksum NetworkGetSliceChecksum(uint32_t tick);
+const char* NetworkGetChecksumSubsystemName(NetworkChecksumSubsystem subsystem);
+
+#endif // DISABLE_NETWORK
@@ -17,8 +17,12 @@
 #    include "Socket.h"
 #    include "network.h"
 
+#    include <algorithm>
+#    include <array>
+
 constexpr size_t NETWORK_DISCONNECT_REASON_BUFFER_SIZE = 256;
 constexpr size_t NetworkBufferSize = 1024 * 64; // 64 KiB, maximum packet size.
+constexpr size_t MaxPacketsPerSend = 64;
 
 NetworkConnection::NetworkConnection()
 {
@@ -89,7 +93,7 @@ NetworkReadPacket NetworkConnection::ReadPacket()
             // Received complete packet.
             _lastPacketTime = platform_get_ticks();
 
-            RecordPacketStats(InboundPacket, false);
+            RecordPacketStats(InboundPacket.GetCommand(), InboundPacket.BytesTransferred, false);
 
             return NetworkReadPacket::Success;
         }
@@ -98,42 +102,15 @@ NetworkReadPacket NetworkConnection::ReadPacket()
     return NetworkReadPacket::MoreData;
 }
 
-bool NetworkConnection::SendPacket(NetworkPacket& packet)
+void NetworkConnection::QueuePacket(const NetworkPacket& packet, bool front)
 {
-    auto header = packet.Header;
-
-    std::vector<uint8_t> buffer;
-    buffer.reserve(sizeof(header) + header.Size);
-
-    // NOTE: For compatibility reasons for the master server we need to add sizeof(Header.Id) to the size.
-    // Previously the Id field was not part of the header rather part of the body.
-    header.Size += sizeof(header.Id);
-    header.Size = Convert::HostToNetwork(header.Size);
-    header.Id = ByteSwapBE(header.Id);
-
-    buffer.insert(buffer.end(), reinterpret_cast<uint8_t*>(&header), reinterpret_cast<uint8_t*>(&header) + sizeof(header));
-    buffer.insert(buffer.end(), packet.Data.begin(), packet.Data.end());
-
-    size_t bufferSize = buffer.size() - packet.BytesTransferred;
-    size_t sent = Socket->SendData(buffer.data() + packet.BytesTransferred, bufferSize);
-    if (sent > 0)
-    {
-        packet.BytesTransferred += sent;
-    }
-
-    bool sendComplete = packet.BytesTransferred == buffer.size();
-    if (sendComplete)
-    {
-        RecordPacketStats(packet, true);
-    }
-    return sendComplete;
+    QueuePacket(std::make_shared<const NetworkPacketBuffer>(packet), front);
 }
 
-void NetworkConnection::QueuePacket(NetworkPacket&& packet, bool front)
+void NetworkConnection::QueuePacket(const std::shared_ptr<const NetworkPacketBuffer>& buffer, bool front)
 {
-    if (AuthStatus == NetworkAuth::Ok || !packet.CommandRequiresAuth())
+    if (AuthStatus == NetworkAuth::Ok || !buffer->CommandRequiresAuth())
     {
-        packet.Header.Size = static_cast<uint16_t>(packet.Data.size());
         if (front)
         {
             // If the first packet was already partially sent add new packet to second position
@@ -141,20 +118,48 @@ void NetworkConnection::QueuePacket(NetworkPacket&& packet, bool front)
             {
                 auto it = _outboundPackets.begin();
                 it++; // Second position
-                _outboundPackets.insert(it, std::move(packet));
+                _outboundPackets.insert(it, { buffer });
             }
             else
             {
-                _outboundPackets.push_front(std::move(packet));
+                _outboundPackets.push_front({ buffer });
             }
         }
+        else if (_isDeferringPackets)
+        {
+            _deferredPackets.push_back(buffer);
+        }
         else
         {
-            _outboundPackets.push_back(std::move(packet));
+            _outboundPackets.push_back({ buffer });
         }
     }
 }
 
+void NetworkConnection::DeferPackets()
+{
+    _isDeferringPackets = true;
+}
+
+void NetworkConnection::ReleaseDeferredPackets(const std::vector<std::shared_ptr<const NetworkPacketBuffer>>& leadingPackets)
+{
+    _isDeferringPackets = false;
+    for (const auto& buffer : leadingPackets)
+    {
+        QueuePacket(buffer);
+    }
+    for (const auto& buffer : _deferredPackets)
+    {
+        _outboundPackets.push_back({ buffer });
+    }
+    _deferredPackets.clear();
+}
+
+bool NetworkConnection::IsDeferringPackets() const
+{
+    return _isDeferringPackets;
+}
+
 void NetworkConnection::Disconnect()
 {
     ShouldDisconnect = true;
@@ -167,9 +172,39 @@ bool NetworkConnection::IsValid() const
 
 void NetworkConnection::SendQueuedPackets()
 {
-    while (!_outboundPackets.empty() && SendPacket(_outboundPackets.front()))
+    // Hand as many of the queued packets as possible to the socket at once, for as long as it accepts all of them.
+    while (!_outboundPackets.empty())
     {
-        _outboundPackets.pop_front();
+        std::array<SocketBuffer, MaxPacketsPerSend> buffers;
+        size_t count = 0;
+        size_t size = 0;
+        for (auto it = _outboundPackets.begin(); it != _outboundPackets.end() && count < buffers.size(); it++)
+        {
+            const auto& data = it->Buffer->Data;
+            buffers[count] = { data.data() + it->BytesTransferred, data.size() - it->BytesTransferred };
+            size += buffers[count].Size;
+            count++;
+        }
+
+        size_t sent = Socket->SendData(buffers.data(), count);
+        for (size_t remaining = sent; remaining > 0;)
+        {
+            auto& packet = _outboundPackets.front();
+            size_t packetRemaining = packet.Buffer->Data.size() - packet.BytesTransferred;
+            if (remaining < packetRemaining)
+            {
+                packet.BytesTransferred += remaining;
+                break;
+            }
+            remaining -= packetRemaining;
+            RecordPacketStats(packet.Buffer->Command, packet.Buffer->Data.size(), true);
+            _outboundPackets.pop_front();
+        }
+
+        if (sent < size)
+        {
+            break;
+        }
     }
 }
 
@@ -206,12 +241,12 @@ void NetworkConnection::SetLastDisconnectReason(const rct_string_id string_id, v
     SetLastDisconnectReason(buffer);
 }
 
-void NetworkConnection::RecordPacketStats(const NetworkPacket& packet, bool sending)
+void NetworkConnection::RecordPacketStats(NetworkCommand command, size_t size, bool sending)
 {
-    uint32_t packetSize = static_cast<uint32_t>(packet.BytesTransferred);
+    uint32_t packetSize = static_cast<uint32_t>(size);
     NetworkStatisticsGroup trafficGroup;
 
-    switch (packet.GetCommand())
+    switch (command)
     {
         case NetworkCommand::GameAction:
             trafficGroup = NetworkStatisticsGroup::Commands;
@@ -42,17 +42,22 @@ public:
     ~NetworkConnection();
 
     NetworkReadPacket ReadPacket();
-    void QueuePacket(NetworkPacket&& packet, bool front = false);
-    void QueuePacket(const NetworkPacket& packet, bool front = false)
-    {
-        auto copy = packet;
-        return QueuePacket(std::move(copy), front);
-    }
+    void QueuePacket(const NetworkPacket& packet, bool front = false);
+    void QueuePacket(const std::shared_ptr<const NetworkPacketBuffer>& buffer, bool front = false);
 
     // This will not immediately disconnect the client. The disconnect
     // will happen post-tick.
     void Disconnect();
 
+    /**
+     * Holds back the packets queued from now on, except those queued at the front, until ReleaseDeferredPackets queues
+     * leadingPackets ahead of them. Used while the map for the connection is encoded in the background, as everything
+     * sent after the map was captured has to follow it.
+     */
+    void DeferPackets();
+    void ReleaseDeferredPackets(const std::vector<std::shared_ptr<const NetworkPacketBuffer>>& leadingPackets);
+    bool IsDeferringPackets() const;
+
     bool IsValid() const;
     void SendQueuedPackets();
     void ResetLastPacketTime();
@@ -63,12 +68,19 @@ public:
     void SetLastDisconnectReason(const rct_string_id string_id, void* args = nullptr);
 
 private:
-    std::deque<NetworkPacket> _outboundPackets;
+    struct OutboundPacket
+    {
+        std::shared_ptr<const NetworkPacketBuffer> Buffer;
+        size_t BytesTransferred{};
+    };
+
+    std::deque<OutboundPacket> _outboundPackets;
+    std::deque<std::shared_ptr<const NetworkPacketBuffer>> _deferredPackets;
+    bool _isDeferringPackets = false;
     uint32_t _lastPacketTime = 0;
     std::string _lastDisconnectReason;
 
-    void RecordPacketStats(const NetworkPacket& packet, bool sending);
-    bool SendPacket(NetworkPacket& packet);
+    void RecordPacketStats(NetworkCommand command, size_t size, bool sending);
 };
 
 #endif // DISABLE_NETWORK
@@ -12,6 +12,7 @@
 #    include "NetworkPacket.h"
 
 #    include "NetworkTypes.h"
+#    include "Socket.h"
 
 #    include <memory>
 
@@ -42,9 +43,9 @@ void NetworkPacket::Clear()
     Data.clear();
 }
 
-bool NetworkPacket::CommandRequiresAuth()
+static bool CommandRequiresAuth(NetworkCommand command)
 {
-    switch (GetCommand())
+    switch (command)
     {
         case NetworkCommand::Ping:
         case NetworkCommand::Auth:
@@ -60,6 +61,11 @@ bool NetworkPacket::CommandRequiresAuth()
     }
 }
 
+bool NetworkPacket::CommandRequiresAuth()
+{
+    return ::CommandRequiresAuth(GetCommand());
+}
+
 void NetworkPacket::Write(const void* bytes, size_t size)
 {
     const uint8_t* src = reinterpret_cast<const uint8_t*>(bytes);
@@ -107,4 +113,25 @@ std::string_view NetworkPacket::ReadString()
     return std::string_view(str, stringLen);
 }
 
+NetworkPacketBuffer::NetworkPacketBuffer(const NetworkPacket& packet)
+    : Command(packet.GetCommand())
+{
+    auto header = packet.Header;
+
+    // NOTE: For compatibility reasons for the master server we need to add sizeof(Header.Id) to the size.
+    // Previously the Id field was not part of the header rather part of the body.
+    header.Size = static_cast<uint16_t>(packet.Data.size() + sizeof(header.Id));
+    header.Size = Convert::HostToNetwork(header.Size);
+    header.Id = ByteSwapBE(header.Id);
+
+    Data.reserve(sizeof(header) + packet.Data.size());
+    Data.insert(Data.end(), reinterpret_cast<uint8_t*>(&header), reinterpret_cast<uint8_t*>(&header) + sizeof(header));
+    Data.insert(Data.end(), packet.Data.begin(), packet.Data.end());
+}
+
+bool NetworkPacketBuffer::CommandRequiresAuth() const
+{
+    return ::CommandRequiresAuth(Command);
+}
+
 #endif
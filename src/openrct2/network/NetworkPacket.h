@@ -79,3 +79,18 @@ public:
     size_t BytesTransferred = 0;
     size_t BytesRead = 0;
 };
+
+/**
+ * A packet as sent over the network, header included. It is immutable so a single buffer can be shared by the send
+ * queues of all connections the packet is sent to.
+ */
+struct NetworkPacketBuffer final
+{
+    explicit NetworkPacketBuffer(const NetworkPacket& packet);
+
+    bool CommandRequiresAuth() const;
+
+public:
+    NetworkCommand Command = NetworkCommand::Invalid;
+    std::vector<uint8_t> Data;
+};
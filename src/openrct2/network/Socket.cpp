@@ -9,6 +9,7 @@
 
 #ifndef DISABLE_NETWORK
 
+#    include <algorithm>
 #    include <atomic>
 #    include <chrono>
 #    include <cmath>
@@ -49,8 +50,10 @@
     #include <netdb.h>
     #include <netinet/in.h>
     #include <netinet/tcp.h>
+    #include <poll.h>
     #include <sys/ioctl.h>
     #include <sys/socket.h>
+    #include <sys/uio.h>
     #include "../common.h"
     using SOCKET = int32_t;
     #define SOCKET_ERROR -1
@@ -59,6 +62,7 @@
     #define closesocket close
     #define ioctlsocket ioctl
     #if defined(__linux__)
+        #include <sys/epoll.h>
         #define FLAG_NO_PIPE MSG_NOSIGNAL
     #else
         #define FLAG_NO_PIPE 0
@@ -563,6 +567,45 @@ public:
         return totalSent;
     }
 
+    size_t SendData(const SocketBuffer* buffers, size_t count) override
+    {
+        if (_status != SocketStatus::Connected)
+        {
+            throw std::runtime_error("Socket not connected.");
+        }
+
+#    ifdef _WIN32
+        std::vector<WSABUF> wsaBuffers(count);
+        for (size_t i = 0; i < count; i++)
+        {
+            wsaBuffers[i].buf = const_cast<CHAR*>(static_cast<const CHAR*>(buffers[i].Data));
+            wsaBuffers[i].len = static_cast<ULONG>(buffers[i].Size);
+        }
+        DWORD sentBytes = 0;
+        if (WSASend(_socket, wsaBuffers.data(), static_cast<DWORD>(count), &sentBytes, 0, nullptr, nullptr) == SOCKET_ERROR)
+        {
+            return 0;
+        }
+        return sentBytes;
+#    else
+        std::vector<iovec> ioBuffers(count);
+        for (size_t i = 0; i < count; i++)
+        {
+            ioBuffers[i].iov_base = const_cast<void*>(buffers[i].Data);
+            ioBuffers[i].iov_len = buffers[i].Size;
+        }
+        msghdr message{};
+        message.msg_iov = ioBuffers.data();
+        message.msg_iovlen = static_cast<decltype(message.msg_iovlen)>(count);
+        auto sentBytes = sendmsg(_socket, &message, FLAG_NO_PIPE);
+        if (sentBytes == SOCKET_ERROR)
+        {
+            return 0;
+        }
+        return static_cast<size_t>(sentBytes);
+#    endif
+    }
+
     NetworkReadPacket ReceiveData(void* buffer, size_t size, size_t* sizeReceived) override
     {
         if (_status != SocketStatus::Connected)
@@ -623,6 +666,11 @@ public:
         return _ipAddress;
     }
 
+    SOCKET GetHandle() const
+    {
+        return _socket;
+    }
+
 private:
     explicit TcpSocket(SOCKET socket, const std::string& hostName, const std::string& ipAddress)
         : _status(SocketStatus::Connected)
@@ -669,6 +717,107 @@ private:
     }
 };
 
+#    ifdef __linux__
+class EpollTcpSocketPoller final : public ITcpSocketPoller
+{
+private:
+    int _epoll = -1;
+    size_t _count = 0;
+
+public:
+    explicit EpollTcpSocketPoller(int epoll)
+        : _epoll(epoll)
+    {
+    }
+
+    ~EpollTcpSocketPoller() override
+    {
+        close(_epoll);
+    }
+
+    void Add(ITcpSocket& socket) override
+    {
+        epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.ptr = &socket;
+        if (epoll_ctl(_epoll, EPOLL_CTL_ADD, static_cast<TcpSocket&>(socket).GetHandle(), &event) == 0)
+        {
+            _count++;
+        }
+        else
+        {
+            log_error("Unable to watch socket: %s", strerror(errno));
+        }
+    }
+
+    void Remove(ITcpSocket& socket) override
+    {
+        if (epoll_ctl(_epoll, EPOLL_CTL_DEL, static_cast<TcpSocket&>(socket).GetHandle(), nullptr) == 0)
+        {
+            _count--;
+        }
+    }
+
+    std::vector<ITcpSocket*> Poll(int32_t timeoutMs) override
+    {
+        std::vector<ITcpSocket*> result;
+        std::vector<epoll_event> events(std::max<size_t>(_count, 1));
+        int32_t numEvents = epoll_wait(_epoll, events.data(), static_cast<int32_t>(events.size()), timeoutMs);
+        for (int32_t i = 0; i < numEvents; i++)
+        {
+            result.push_back(static_cast<ITcpSocket*>(events[i].data.ptr));
+        }
+        return result;
+    }
+};
+#    endif
+
+class PollTcpSocketPoller final : public ITcpSocketPoller
+{
+private:
+    std::vector<ITcpSocket*> _sockets;
+
+public:
+    void Add(ITcpSocket& socket) override
+    {
+        _sockets.push_back(&socket);
+    }
+
+    void Remove(ITcpSocket& socket) override
+    {
+        _sockets.erase(std::remove(_sockets.begin(), _sockets.end(), &socket), _sockets.end());
+    }
+
+    std::vector<ITcpSocket*> Poll(int32_t timeoutMs) override
+    {
+#    ifdef _WIN32
+        std::vector<WSAPOLLFD> descriptors(_sockets.size());
+#    else
+        std::vector<pollfd> descriptors(_sockets.size());
+#    endif
+        for (size_t i = 0; i < _sockets.size(); i++)
+        {
+            descriptors[i].fd = static_cast<TcpSocket*>(_sockets[i])->GetHandle();
+            descriptors[i].events = POLLIN;
+        }
+
+        std::vector<ITcpSocket*> result;
+#    ifdef _WIN32
+        int32_t numReady = WSAPoll(descriptors.data(), static_cast<ULONG>(descriptors.size()), timeoutMs);
+#    else
+        int32_t numReady = poll(descriptors.data(), static_cast<nfds_t>(descriptors.size()), timeoutMs);
+#    endif
+        for (size_t i = 0; i < descriptors.size() && numReady > 0; i++)
+        {
+            if (descriptors[i].revents != 0)
+            {
+                result.push_back(_sockets[i]);
+            }
+        }
+        return result;
+    }
+};
+
 class UdpSocket final : public IUdpSocket, protected Socket
 {
 private:
@@ -887,6 +1036,19 @@ std::unique_ptr<IUdpSocket> CreateUdpSocket()
     return std::make_unique<UdpSocket>();
 }
 
+std::unique_ptr<ITcpSocketPoller> CreateTcpSocketPoller()
+{
+#    ifdef __linux__
+    int epoll = epoll_create1(EPOLL_CLOEXEC);
+    if (epoll != -1)
+    {
+        return std::make_unique<EpollTcpSocketPoller>(epoll);
+    }
+    log_warning("Unable to create epoll instance, falling back to poll: %s", strerror(errno));
+#    endif
+    return std::make_unique<PollTcpSocketPoller>();
+}
+
 #    ifdef _WIN32
 static std::vector<INTERFACE_INFO> GetNetworkInterfaces()
 {
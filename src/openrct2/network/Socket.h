@@ -33,6 +33,15 @@ enum class NetworkReadPacket : int32_t
     Disconnected
 };
 
+/**
+ * A block of data to send, several of which can be handed to a socket at once.
+ */
+struct SocketBuffer
+{
+    const void* Data{};
+    size_t Size{};
+};
+
 /**
  * Represents an address and port.
  */
@@ -66,6 +75,8 @@ public:
     virtual void ConnectAsync(const std::string& address, uint16_t port) abstract;
 
     virtual size_t SendData(const void* buffer, size_t size) abstract;
+    // Sends the buffers in order with a single system call, returns how much of them was sent.
+    virtual size_t SendData(const SocketBuffer* buffers, size_t count) abstract;
     virtual NetworkReadPacket ReceiveData(void* buffer, size_t size, size_t* sizeReceived) abstract;
 
     virtual void SetNoDelay(bool noDelay) abstract;
@@ -75,6 +86,22 @@ public:
     virtual void Close() abstract;
 };
 
+/**
+ * Tells which of a set of TCP sockets have data to read or a connection to accept, so that idle sockets are left alone.
+ * Uses epoll on Linux and poll elsewhere.
+ */
+struct ITcpSocketPoller
+{
+public:
+    virtual ~ITcpSocketPoller() = default;
+
+    virtual void Add(ITcpSocket& socket) abstract;
+    virtual void Remove(ITcpSocket& socket) abstract;
+
+    // Waits at most timeoutMs milliseconds for any of the sockets to become ready and returns those that are.
+    virtual std::vector<ITcpSocket*> Poll(int32_t timeoutMs) abstract;
+};
+
 /**
  * Represents a UDP socket / listener.
  */
@@ -100,6 +127,7 @@ public:
 
 [[nodiscard]] std::unique_ptr<ITcpSocket> CreateTcpSocket();
 [[nodiscard]] std::unique_ptr<IUdpSocket> CreateUdpSocket();
+[[nodiscard]] std::unique_ptr<ITcpSocketPoller> CreateTcpSocketPoller();
 [[nodiscard]] std::vector<std::unique_ptr<INetworkEndpoint>> GetBroadcastAddresses();
 
 namespace Convert
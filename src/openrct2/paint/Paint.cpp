@@ -17,13 +17,17 @@
 #include "../localisation/Localisation.h"
 #include "../localisation/LocalisationService.h"
 #include "../paint/Painter.h"
+#include "../profiling/Profiling.h"
 #include "../util/Math.hpp"
 #include "Paint.Entity.h"
+#include "PaintCache.h"
 #include "tile_element/Paint.TileElement.h"
 
 #include <algorithm>
 #include <array>
 #include <atomic>
+#include <limits>
+#include <vector>
 
 using namespace OpenRCT2;
 
@@ -51,6 +55,7 @@ static constexpr const uint8_t BoundBoxDebugColours[] = {
 bool gShowDirtyVisuals;
 bool gPaintBoundingBoxes;
 bool gPaintBlockedTiles;
+PaintSortAlgorithm gPaintSortAlgorithm = PaintSortAlgorithm::Original;
 
 static void PaintAttachedPS(rct_drawpixelinfo* dpi, paint_struct* ps, uint32_t viewFlags);
 static void PaintPSImageWithBoundingBoxes(rct_drawpixelinfo* dpi, paint_struct* ps, ImageId imageId, int32_t x, int32_t y);
@@ -83,7 +88,7 @@ static int32_t RemapPositionToQuadrant(const paint_struct& ps, uint8_t rotation)
     return 0;
 }
 
-static void PaintSessionAddPSToQuadrant(paint_session& session, paint_struct* ps)
+void PaintSessionAddPSToQuadrant(paint_session& session, paint_struct* ps)
 {
     const auto positionHash = RemapPositionToQuadrant(*ps, session.CurrentRotation);
 
@@ -221,14 +226,14 @@ template<uint8_t direction> void PaintSessionGenerateRotate(paint_session& sessi
 
     for (; numVerticalTiles > 0; --numVerticalTiles)
     {
-        tile_element_paint_setup(session, mapTile);
+        PaintCache::PaintTile(session, mapTile);
         EntityPaintSetup(session, mapTile);
 
         const auto loc1 = mapTile + adjacentTiles[0];
         EntityPaintSetup(session, loc1);
 
         const auto loc2 = mapTile + adjacentTiles[1];
-        tile_element_paint_setup(session, loc2);
+        PaintCache::PaintTile(session, loc2);
         EntityPaintSetup(session, loc2);
 
         const auto loc3 = mapTile + adjacentTiles[2];
@@ -244,6 +249,8 @@ template<uint8_t direction> void PaintSessionGenerateRotate(paint_session& sessi
  */
 void PaintSessionGenerate(paint_session& session)
 {
+    TRACED_SCOPE("PaintSessionGenerate");
+
     session.CurrentRotation = get_current_rotation();
     switch (DirectionFlipXAxis(session.CurrentRotation))
     {
@@ -460,22 +467,275 @@ template<int TRotation> static void PaintSessionArrange(PaintSessionCore& sessio
     }
 }
 
+struct PaintSortCandidate
+{
+    int32_t X;
+    uint32_t Node;
+};
+
+/**
+ * The sort order of a session as an array of node indices, so structs can be found by their bounds instead of walking
+ * the linked list.
+ */
+struct PaintSortState
+{
+    std::vector<paint_struct*> Nodes;
+    std::vector<uint32_t> Order;
+    std::vector<uint32_t> Positions;
+    std::vector<PaintSortCandidate> Candidates;
+    std::vector<uint32_t> Moved;
+    std::vector<uint32_t> Reordered;
+};
+
+// Sessions of different columns are arranged on different threads.
+static thread_local PaintSortState _paintSortState;
+
+template<uint8_t TRotation> static int32_t GetPaintSortKey(const paint_struct_bound_box& bbox)
+{
+    if constexpr (TRotation == 1)
+    {
+        return bbox.y - bbox.x;
+    }
+    else if constexpr (TRotation == 3)
+    {
+        return bbox.x - bbox.y;
+    }
+    else
+    {
+        return bbox.x + bbox.y;
+    }
+}
+
+/**
+ * Returns the range of x that a struct, whose key is within the given range, must start at to pass CheckBoundingBox
+ * against the given bounding box.
+ */
+template<uint8_t TRotation>
+static std::pair<int32_t, int32_t> GetPaintSortCandidateRange(
+    const paint_struct_bound_box& bbox, int32_t minKey, int32_t maxKey)
+{
+    switch (TRotation)
+    {
+        case 0:
+            // x <= x_end, y <= y_end and y = key - x
+            return { minKey - bbox.y_end, bbox.x_end };
+        case 1:
+            // x > x_end, y <= y_end and y = key + x
+            return { bbox.x_end + 1, bbox.y_end - minKey };
+        case 2:
+            // x > x_end, y > y_end and y = key - x
+            return { bbox.x_end + 1, maxKey - bbox.y_end - 1 };
+        default:
+            // x <= x_end, y > y_end and y = x - key
+            return { bbox.y_end + minKey + 1, bbox.x_end };
+    }
+}
+
+/**
+ * Same as PaintArrangeStructsHelperRotation, but only compares the structs whose position could pass CheckBoundingBox
+ * instead of every struct that follows the visited one.
+ */
+template<uint8_t TRotation>
+static size_t PaintArrangeStructsSpatial(PaintSortState& state, size_t startPos, uint16_t quadrantIndex, uint8_t flag)
+{
+    auto& nodes = state.Nodes;
+    auto& order = state.Order;
+    auto& positions = state.Positions;
+    auto& candidates = state.Candidates;
+    const size_t count = order.size();
+
+    // Get the first node in the specified quadrant.
+    size_t entryPos = startPos;
+    while (true)
+    {
+        if (entryPos + 1 >= count)
+        {
+            return entryPos;
+        }
+        if (quadrantIndex <= nodes[order[entryPos + 1]]->quadrant_index)
+        {
+            break;
+        }
+        entryPos++;
+    }
+
+    // Determine the current sorting relevancy of the nodes, the same way as PaintArrangeStructsHelperRotation.
+    for (size_t pos = entryPos + 1; pos < count; pos++)
+    {
+        auto* ps = nodes[order[pos]];
+        if (ps->quadrant_index > quadrantIndex + 1)
+        {
+            ps->SortFlags = PaintSortFlags::OutsideQuadrant;
+            break;
+        }
+        if (ps->quadrant_index == quadrantIndex + 1)
+        {
+            ps->SortFlags = PaintSortFlags::Neighbour | PaintSortFlags::PendingVisit;
+        }
+        else if (ps->quadrant_index == quadrantIndex)
+        {
+            ps->SortFlags = flag | PaintSortFlags::PendingVisit;
+        }
+    }
+
+    // Nodes are only ever moved in front of a visited node, so the end of the range never moves.
+    size_t endPos = entryPos + 1;
+    while (endPos < count && !(nodes[order[endPos]]->SortFlags & PaintSortFlags::OutsideQuadrant))
+    {
+        endPos++;
+    }
+
+    // Only neighbours can be moved, index them by x.
+    candidates.clear();
+    int32_t minKey = std::numeric_limits<int32_t>::max();
+    int32_t maxKey = std::numeric_limits<int32_t>::min();
+    for (size_t pos = entryPos + 1; pos < endPos; pos++)
+    {
+        auto* ps = nodes[order[pos]];
+        if (ps->SortFlags & PaintSortFlags::Neighbour)
+        {
+            candidates.push_back({ ps->bounds.x, order[pos] });
+            auto key = GetPaintSortKey<TRotation>(ps->bounds);
+            minKey = std::min(minKey, key);
+            maxKey = std::max(maxKey, key);
+        }
+    }
+    std::sort(candidates.begin(), candidates.end(), [](const auto& a, const auto& b) { return a.X < b.X; });
+
+    size_t pos = entryPos;
+    while (true)
+    {
+        // Get the first pending node in the quadrant list
+        size_t visitPos = pos + 1;
+        while (visitPos < endPos && !(nodes[order[visitPos]]->SortFlags & PaintSortFlags::PendingVisit))
+        {
+            visitPos++;
+        }
+        if (visitPos >= endPos)
+        {
+            return entryPos;
+        }
+
+        // Mark visited.
+        auto* visited = nodes[order[visitPos]];
+        visited->SortFlags &= ~PaintSortFlags::PendingVisit;
+
+        // Find the nodes after the visited one that intersect with it.
+        const paint_struct_bound_box& initialBBox = visited->bounds;
+        auto [minX, maxX] = GetPaintSortCandidateRange<TRotation>(initialBBox, minKey, maxKey);
+        auto& moved = state.Moved;
+        moved.clear();
+        auto it = std::lower_bound(
+            candidates.begin(), candidates.end(), minX, [](const auto& candidate, int32_t x) { return candidate.X < x; });
+        for (; it != candidates.end() && it->X <= maxX; it++)
+        {
+            auto candidatePos = positions[it->Node];
+            if (candidatePos > visitPos && CheckBoundingBox<TRotation>(initialBBox, nodes[it->Node]->bounds))
+            {
+                moved.push_back(candidatePos);
+            }
+        }
+
+        if (!moved.empty())
+        {
+            // Each moved node is inserted directly in front of the visited node, so the last one found ends up first.
+            std::sort(moved.begin(), moved.end());
+            auto& reordered = state.Reordered;
+            reordered.clear();
+            for (auto movedIt = moved.rbegin(); movedIt != moved.rend(); movedIt++)
+            {
+                reordered.push_back(order[*movedIt]);
+            }
+            size_t movedIndex = 0;
+            for (size_t i = visitPos; i <= moved.back(); i++)
+            {
+                if (moved[movedIndex] == i)
+                {
+                    movedIndex++;
+                    continue;
+                }
+                reordered.push_back(order[i]);
+            }
+            for (size_t i = 0; i < reordered.size(); i++)
+            {
+                order[visitPos + i] = reordered[i];
+                positions[reordered[i]] = static_cast<uint32_t>(visitPos + i);
+            }
+        }
+
+        pos = visitPos - 1;
+    }
+}
+
+template<int TRotation> static void PaintSessionArrangeSpatial(PaintSessionCore& session)
+{
+    auto& state = _paintSortState;
+    state.Nodes.clear();
+    state.Nodes.push_back(&session.PaintHead);
+    session.PaintHead.next_quadrant_ps = nullptr;
+
+    uint32_t quadrantIndex = session.QuadrantBackIndex;
+    if (quadrantIndex == UINT32_MAX)
+    {
+        return;
+    }
+
+    do
+    {
+        for (auto* ps = session.Quadrants[quadrantIndex]; ps != nullptr; ps = ps->next_quadrant_ps)
+        {
+            state.Nodes.push_back(ps);
+        }
+    } while (++quadrantIndex <= session.QuadrantFrontIndex);
+
+    const auto count = state.Nodes.size();
+    state.Order.resize(count);
+    state.Positions.resize(count);
+    for (uint32_t i = 0; i < count; i++)
+    {
+        state.Order[i] = i;
+        state.Positions[i] = i;
+    }
+
+    size_t entryPos = PaintArrangeStructsSpatial<TRotation>(
+        state, 0, session.QuadrantBackIndex & 0xFFFF, PaintSortFlags::Neighbour);
+
+    quadrantIndex = session.QuadrantBackIndex;
+    while (++quadrantIndex < session.QuadrantFrontIndex)
+    {
+        entryPos = PaintArrangeStructsSpatial<TRotation>(state, entryPos, quadrantIndex & 0xFFFF, PaintSortFlags::None);
+    }
+
+    for (size_t i = 0; i < count; i++)
+    {
+        state.Nodes[state.Order[i]]->next_quadrant_ps = i + 1 < count ? state.Nodes[state.Order[i + 1]] : nullptr;
+    }
+}
+
 /**
  *
  *  rct2: 0x00688217
  */
 void PaintSessionArrange(PaintSessionCore& session)
 {
+    PaintSessionArrange(session, gPaintSortAlgorithm);
+}
+
+void PaintSessionArrange(PaintSessionCore& session, PaintSortAlgorithm algorithm)
+{
+    TRACED_SCOPE("PaintSessionArrange");
+
+    const bool spatial = algorithm == PaintSortAlgorithm::Spatial;
     switch (session.CurrentRotation)
     {
         case 0:
-            return PaintSessionArrange<0>(session, true);
+            return spatial ? PaintSessionArrangeSpatial<0>(session) : PaintSessionArrange<0>(session, true);
         case 1:
-            return PaintSessionArrange<1>(session, true);
+            return spatial ? PaintSessionArrangeSpatial<1>(session) : PaintSessionArrange<1>(session, true);
         case 2:
-            return PaintSessionArrange<2>(session, true);
+            return spatial ? PaintSessionArrangeSpatial<2>(session) : PaintSessionArrange<2>(session, true);
         case 3:
-            return PaintSessionArrange<3>(session, true);
+            return spatial ? PaintSessionArrangeSpatial<3>(session) : PaintSessionArrange<3>(session, true);
     }
     Guard::Assert(false);
 }
@@ -527,6 +787,8 @@ static void PaintDrawStruct(paint_session& session, paint_struct* ps)
  */
 void PaintDrawStructs(paint_session& session)
 {
+    TRACED_SCOPE("PaintDrawStructs");
+
     paint_struct* ps = &session.PaintHead;
 
     for (ps = ps->next_quadrant_ps; ps != nullptr;)
@@ -762,6 +1024,11 @@ paint_struct* PaintAddImageAsParent(
     paint_session& session, ImageId image_id, const CoordsXYZ& offset, const CoordsXYZ& boundBoxSize,
     const CoordsXYZ& boundBoxOffset)
 {
+    if (session.TileRecording != nullptr)
+    {
+        PaintCache::BeginOperation(session, PaintCache::Operation::Parent);
+    }
+
     session.LastPS = nullptr;
     session.LastAttachedPS = nullptr;
 
@@ -773,6 +1040,10 @@ paint_struct* PaintAddImageAsParent(
 
     PaintSessionAddPSToQuadrant(session, ps);
 
+    if (session.TileRecording != nullptr)
+    {
+        PaintCache::EndOperation(session, ps);
+    }
     return ps;
 }
 
@@ -797,11 +1068,53 @@ paint_struct* PaintAddImageAsParent(
     paint_session& session, ImageId imageId, const CoordsXYZ& offset, const CoordsXYZ& boundBoxSize,
     const CoordsXYZ& boundBoxOffset)
 {
+    if (session.TileRecording != nullptr)
+    {
+        PaintCache::BeginOperation(session, PaintCache::Operation::Orphan);
+    }
+
     session.LastPS = nullptr;
     session.LastAttachedPS = nullptr;
     return CreateNormalPaintStruct(session, imageId, offset, boundBoxSize, boundBoxOffset);
 }
 
+/**
+ * Adds the image as the child of session.WoodenSupportsPrependTo, so that it is drawn together with the track piece
+ * the wooden supports belong to. If there is no such track piece then the image is added as a parent.
+ */
+paint_struct* PaintAddImageAsWoodenSupportsChild(
+    paint_session& session, ImageId imageId, const CoordsXYZ& offset, const CoordsXYZ& boundBoxSize,
+    const CoordsXYZ& boundBoxOffset)
+{
+    auto* prependTo = session.WoodenSupportsPrependTo;
+    if (prependTo == nullptr)
+    {
+        return PaintAddImageAsParent(session, imageId, offset, boundBoxSize, boundBoxOffset);
+    }
+
+    if (session.TileRecording != nullptr)
+    {
+        PaintCache::BeginOperation(session, PaintCache::Operation::WoodenSupportsChild);
+    }
+
+    session.LastPS = nullptr;
+    session.LastAttachedPS = nullptr;
+
+    auto* ps = CreateNormalPaintStruct(session, imageId, offset, boundBoxSize, boundBoxOffset);
+    if (ps == nullptr)
+    {
+        return nullptr;
+    }
+
+    prependTo->children = ps;
+
+    if (session.TileRecording != nullptr)
+    {
+        PaintCache::EndOperation(session, ps);
+    }
+    return ps;
+}
+
 paint_struct* PaintAddImageAsChild(
     paint_session& session, uint32_t image_id, const CoordsXYZ& offset, const CoordsXYZ& boundBoxLength,
     const CoordsXYZ& boundBoxOffset)
@@ -836,6 +1149,11 @@ paint_struct* PaintAddImageAsChild(
         return PaintAddImageAsParent(session, image_id, offset, boundBoxLength, boundBoxOffset);
     }
 
+    if (session.TileRecording != nullptr)
+    {
+        PaintCache::BeginOperation(session, PaintCache::Operation::Child);
+    }
+
     auto* ps = CreateNormalPaintStruct(session, image_id, offset, boundBoxLength, boundBoxOffset);
     if (ps == nullptr)
     {
@@ -844,6 +1162,10 @@ paint_struct* PaintAddImageAsChild(
 
     parentPS->children = ps;
 
+    if (session.TileRecording != nullptr)
+    {
+        PaintCache::EndOperation(session, ps);
+    }
     return ps;
 }
 
@@ -873,6 +1195,11 @@ bool PaintAttachToPreviousAttach(paint_session& session, ImageId imageId, int32_
         return PaintAttachToPreviousPS(session, imageId, x, y);
     }
 
+    if (session.TileRecording != nullptr)
+    {
+        PaintCache::BeginOperation(session, PaintCache::Operation::AttachToAttachedPS);
+    }
+
     auto* ps = session.AllocateAttachedPaintEntry();
     if (ps == nullptr)
     {
@@ -887,6 +1214,10 @@ bool PaintAttachToPreviousAttach(paint_session& session, ImageId imageId, int32_
 
     previousAttachedPS->next = ps;
 
+    if (session.TileRecording != nullptr)
+    {
+        PaintCache::EndOperation(session, ps);
+    }
     return true;
 }
 
@@ -911,6 +1242,11 @@ bool PaintAttachToPreviousPS(paint_session& session, ImageId image_id, int32_t x
         return false;
     }
 
+    if (session.TileRecording != nullptr)
+    {
+        PaintCache::BeginOperation(session, PaintCache::Operation::AttachToPS);
+    }
+
     auto* ps = session.AllocateAttachedPaintEntry();
     if (ps == nullptr)
     {
@@ -926,6 +1262,10 @@ bool PaintAttachToPreviousPS(paint_session& session, ImageId image_id, int32_t x
     masterPs->attached_ps = ps;
     ps->next = oldFirstAttached;
 
+    if (session.TileRecording != nullptr)
+    {
+        PaintCache::EndOperation(session, ps);
+    }
     return true;
 }
 
@@ -972,6 +1312,8 @@ void PaintFloatingMoneyEffect(
  */
 void PaintDrawMoneyStructs(rct_drawpixelinfo* dpi, paint_string_struct* ps)
 {
+    TRACED_SCOPE("PaintDrawMoneyStructs");
+
     do
     {
         char buffer[256]{};
@@ -23,6 +23,11 @@ struct TileElement;
 enum class RailingEntrySupportType : uint8_t;
 enum class ViewportInteractionItem : uint8_t;
 
+namespace OpenRCT2::PaintCache
+{
+    struct Recording;
+} // namespace OpenRCT2::PaintCache
+
 struct attached_paint_struct
 {
     attached_paint_struct* next;
@@ -78,6 +83,11 @@ private:
     std::array<uint8_t, std::max({ sizeof(paint_struct), sizeof(attached_paint_struct), sizeof(paint_string_struct) })> data;
 
 public:
+    // Accesses an entry that already holds a paint_struct, unlike AsBasic it does not reset the struct.
+    paint_struct* GetBasic()
+    {
+        return reinterpret_cast<paint_struct*>(data.data());
+    }
     paint_struct* AsBasic()
     {
         auto* res = reinterpret_cast<paint_struct*>(data.data());
@@ -216,10 +226,23 @@ struct PaintSessionCore
     uint32_t TrackColours[4];
 };
 
+namespace PaintCacheFlags
+{
+    // The tile is painted differently every tick.
+    constexpr uint8_t Animated = 1;
+    // The tile uses resources that are set up whenever it is painted, like scrolling text.
+    constexpr uint8_t Uncacheable = 2;
+} // namespace PaintCacheFlags
+
 struct paint_session : public PaintSessionCore
 {
     rct_drawpixelinfo DPI;
     PaintEntryPool::Chain PaintEntryChain;
+    // Whether tiles are copied from the paint cache instead of being painted.
+    bool UseTileCache;
+    // Receives the paint operations while a tile is recorded for the paint cache, nullptr otherwise.
+    OpenRCT2::PaintCache::Recording* TileRecording;
+    uint8_t TileCacheFlags;
 
     paint_struct* AllocateNormalPaintEntry() noexcept
     {
@@ -296,6 +319,18 @@ extern bool gPaintBoundingBoxes;
 extern bool gPaintBlockedTiles;
 extern bool gPaintWidePathsAsGhost;
 
+enum class PaintSortAlgorithm : uint8_t
+{
+    // Walks the linked quadrant lists, comparing every struct with the rest of its quadrants.
+    Original,
+    // Produces the same order as Original, but only compares structs whose position is within reach of each other.
+    Spatial,
+};
+
+extern PaintSortAlgorithm gPaintSortAlgorithm;
+
+void PaintSessionAddPSToQuadrant(paint_session& session, paint_struct* ps);
+
 paint_struct* PaintAddImageAsParent(
     paint_session& session, uint32_t image_id, const CoordsXYZ& offset, const CoordsXYZ& boundBoxSize);
 paint_struct* PaintAddImageAsParent(
@@ -309,6 +344,9 @@ paint_struct* PaintAddImageAsParent(
 [[nodiscard]] paint_struct* PaintAddImageAsOrphan(
     paint_session& session, ImageId image_id, const CoordsXYZ& offset, const CoordsXYZ& boundBoxSize,
     const CoordsXYZ& boundBoxOffset);
+paint_struct* PaintAddImageAsWoodenSupportsChild(
+    paint_session& session, ImageId imageId, const CoordsXYZ& offset, const CoordsXYZ& boundBoxSize,
+    const CoordsXYZ& boundBoxOffset);
 paint_struct* PaintAddImageAsChild(
     paint_session& session, uint32_t image_id, int32_t x_offset, int32_t y_offset, int32_t bound_box_length_x,
     int32_t bound_box_length_y, int32_t bound_box_length_z, int32_t z_offset, int32_t bound_box_offset_x,
@@ -354,6 +392,7 @@ paint_session* PaintSessionAlloc(rct_drawpixelinfo* dpi, uint32_t viewFlags);
 void PaintSessionFree(paint_session* session);
 void PaintSessionGenerate(paint_session& session);
 void PaintSessionArrange(PaintSessionCore& session);
+void PaintSessionArrange(PaintSessionCore& session, PaintSortAlgorithm algorithm);
 void PaintDrawStructs(paint_session& session);
 void PaintDrawMoneyStructs(rct_drawpixelinfo* dpi, paint_string_struct* ps);
 
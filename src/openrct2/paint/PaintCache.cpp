@@ -0,0 +1,907 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2021 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "PaintCache.h"
+
+#include "../Game.h"
+#include "../OpenRCT2.h"
+#include "../config/Config.h"
+#include "../drawing/Drawing.h"
+#include "../drawing/LightFX.h"
+#include "../entity/Staff.h"
+#include "../interface/Viewport.h"
+#include "../ride/TrackDesign.h"
+#include "../world/Map.h"
+#include "Paint.h"
+#include "VirtualFloor.h"
+#include "tile_element/Paint.TileElement.h"
+
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace OpenRCT2::PaintCache
+{
+    // Bounds the memory used by the cache, a viewport of 1920x1080 pixels shows about 6000 tiles.
+    constexpr size_t MaxTiles = 16384;
+
+    // Links to LastPS and LastAttachedPS refer to the value before the first operation of the tile (0) or after an
+    // operation (its index plus one). Links to WoodenSupportsPrependTo refer to the value before the first operation
+    // (0) or to the paint struct an operation created (its index plus one).
+    constexpr int32_t NullLink = -1;
+
+    constexpr uint32_t NoStruct = std::numeric_limits<uint32_t>::max();
+
+    struct TileKey
+    {
+        int32_t X;
+        int32_t Y;
+        uint8_t Rotation;
+        int8_t ZoomLevel;
+        uint32_t ViewFlags;
+
+        bool operator==(const TileKey& other) const
+        {
+            return X == other.X && Y == other.Y && Rotation == other.Rotation && ZoomLevel == other.ZoomLevel
+                && ViewFlags == other.ViewFlags;
+        }
+    };
+
+    struct TileKeyHash
+    {
+        size_t operator()(const TileKey& key) const
+        {
+            size_t hash = 5381;
+            auto combine = [&hash](uint32_t value) { hash = ((hash << 5) + hash) + value; };
+            combine(static_cast<uint32_t>(key.X));
+            combine(static_cast<uint32_t>(key.Y));
+            combine(key.Rotation);
+            combine(static_cast<uint32_t>(key.ZoomLevel));
+            combine(key.ViewFlags);
+            return hash;
+        }
+    };
+
+    struct RecordedOperation
+    {
+        Operation Type{};
+        int32_t LastPS = NullLink;
+        int32_t LastAttachedPS = NullLink;
+        int32_t WoodenSupportsPrependTo = NullLink;
+        // Index of the struct the operation created in Structs or AttachedStructs of the tile.
+        uint32_t Struct = NoStruct;
+        // Area the image of a paint struct covers on the screen, it is culled against the area being drawn.
+        int32_t Left{};
+        int32_t Top{};
+        int32_t Right{};
+        int32_t Bottom{};
+    };
+
+    // State of the session that tile elements leave behind besides the paint structs.
+    struct SessionState
+    {
+        const TileElement* SurfaceElement{};
+        const TileElement* PathElementOnSameHeight{};
+        const TileElement* TrackElementOnSameHeight{};
+        const void* CurrentlyDrawnItem{};
+        CoordsXY MapPosition;
+        CoordsXY SpritePosition;
+        ViewportInteractionItem InteractionType{};
+        bool DidPassSurface{};
+        uint8_t Unk141E9DB{};
+        uint16_t WaterHeight{};
+        support_height SupportSegments[9]{};
+        support_height Support{};
+        tunnel_entry LeftTunnels[TUNNEL_MAX_COUNT]{};
+        uint8_t LeftTunnelCount{};
+        tunnel_entry RightTunnels[TUNNEL_MAX_COUNT]{};
+        uint8_t RightTunnelCount{};
+        uint8_t VerticalTunnelHeight{};
+        uint32_t TrackColours[4]{};
+    };
+
+    struct CachedTile
+    {
+        const TileElement* FirstElement{};
+        uint32_t Version{};
+        uint32_t Tick{};
+        bool IsCacheable{};
+        bool IsAnimated{};
+
+        // The state the previous tile left behind that the tile reads, it is only replayed from the same state.
+        bool ReadsSurfaceElement{};
+        bool ReadsElementsOnSameHeight{};
+        bool HasLastPS{};
+        bool HasLastAttachedPS{};
+        bool HasWoodenSupportsPrependTo{};
+        const TileElement* SurfaceElement{};
+        const TileElement* PathElementOnSameHeight{};
+        const TileElement* TrackElementOnSameHeight{};
+
+        std::vector<RecordedOperation> Operations;
+        std::vector<paint_struct> Structs;
+        std::vector<attached_paint_struct> AttachedStructs;
+
+        int32_t LastPS = NullLink;
+        int32_t LastAttachedPS = NullLink;
+        int32_t WoodenSupportsPrependTo = NullLink;
+        SessionState Output;
+    };
+
+    struct Recording
+    {
+        std::vector<RecordedOperation> Operations;
+        // The structs each operation created and the values of the links after it.
+        std::vector<const paint_struct*> Structs;
+        std::vector<const attached_paint_struct*> AttachedStructs;
+        std::vector<const paint_struct*> LastPSStates;
+        std::vector<const attached_paint_struct*> LastAttachedPSStates;
+        const paint_struct* WoodenSupportsPrependTo{};
+        bool IsCacheable{};
+    };
+
+    struct CacheEntry
+    {
+        std::shared_ptr<const CachedTile> Tile;
+        uint32_t LastUsed{};
+    };
+
+    // Game state that tile elements are painted differently for without the tiles being invalidated.
+    struct GlobalState
+    {
+        uint8_t ClipHeight{};
+        CoordsXY ClipSelectionA;
+        CoordsXY ClipSelectionB;
+        bool PaintWidePathsAsGhost{};
+        bool PaintBlockedTiles{};
+        bool ShowSupportSegmentHeights{};
+        bool LandscapeSmoothing{};
+        bool TransparentWater{};
+        uint8_t ScreenFlags{};
+        int32_t MapSize{};
+
+        bool operator==(const GlobalState& other) const
+        {
+            return ClipHeight == other.ClipHeight && ClipSelectionA == other.ClipSelectionA
+                && ClipSelectionB == other.ClipSelectionB && PaintWidePathsAsGhost == other.PaintWidePathsAsGhost
+                && PaintBlockedTiles == other.PaintBlockedTiles && ShowSupportSegmentHeights == other.ShowSupportSegmentHeights
+                && LandscapeSmoothing == other.LandscapeSmoothing && TransparentWater == other.TransparentWater
+                && ScreenFlags == other.ScreenFlags && MapSize == other.MapSize;
+        }
+    };
+
+    // Columns are painted by several threads at once.
+    static std::unordered_map<TileKey, CacheEntry, TileKeyHash> _tiles;
+    static std::mutex _tilesMutex;
+    static GlobalState _globalState;
+    static uint32_t _frame;
+
+    // Incremented whenever a tile is invalidated, allocated when the cache is first used.
+    static std::vector<uint32_t> _tileVersions;
+
+    static std::atomic<uint64_t> _hits;
+    static std::atomic<uint64_t> _misses;
+    static std::atomic<uint64_t> _uncacheable;
+
+    // Tiles are recorded into a session of their own, which does not cull anything.
+    static PaintEntryPool _recordingPool;
+    static thread_local paint_session _recordingSession;
+    static thread_local Recording _recording;
+
+    // Stand-ins for the structs of previous tiles while a tile is recorded.
+    static thread_local paint_struct _previousPS;
+    static thread_local attached_paint_struct _previousAttachedPS;
+    static thread_local paint_struct _previousWoodenSupportsPrependTo;
+
+    // Stand-in for the state of the session that the tile does not read, to tell whether it was changed.
+    static TileElement _unsetElement;
+
+    static thread_local std::vector<paint_struct*> _replayStructs;
+    static thread_local std::vector<paint_struct*> _replayLastPSStates;
+    static thread_local std::vector<attached_paint_struct*> _replayLastAttachedPSStates;
+
+    static GlobalState CaptureGlobalState()
+    {
+        GlobalState state;
+        state.ClipHeight = gClipHeight;
+        state.ClipSelectionA = gClipSelectionA;
+        state.ClipSelectionB = gClipSelectionB;
+        state.PaintWidePathsAsGhost = gPaintWidePathsAsGhost;
+        state.PaintBlockedTiles = gPaintBlockedTiles;
+        state.ShowSupportSegmentHeights = gShowSupportSegmentHeights;
+        state.LandscapeSmoothing = gConfigGeneral.landscape_smoothing;
+        state.TransparentWater = gConfigGeneral.transparent_water;
+        state.ScreenFlags = gScreenFlags;
+        state.MapSize = gMapSize;
+        return state;
+    }
+
+    static SessionState CaptureSessionState(const paint_session& session)
+    {
+        SessionState state;
+        state.SurfaceElement = session.SurfaceElement;
+        state.PathElementOnSameHeight = session.PathElementOnSameHeight;
+        state.TrackElementOnSameHeight = session.TrackElementOnSameHeight;
+        state.CurrentlyDrawnItem = session.CurrentlyDrawnItem;
+        state.MapPosition = session.MapPosition;
+        state.SpritePosition = session.SpritePosition;
+        state.InteractionType = session.InteractionType;
+        state.DidPassSurface = session.DidPassSurface;
+        state.Unk141E9DB = session.Unk141E9DB;
+        state.WaterHeight = session.WaterHeight;
+        std::copy(std::begin(session.SupportSegments), std::end(session.SupportSegments), state.SupportSegments);
+        state.Support = session.Support;
+        std::copy(std::begin(session.LeftTunnels), std::end(session.LeftTunnels), state.LeftTunnels);
+        state.LeftTunnelCount = session.LeftTunnelCount;
+        std::copy(std::begin(session.RightTunnels), std::end(session.RightTunnels), state.RightTunnels);
+        state.RightTunnelCount = session.RightTunnelCount;
+        state.VerticalTunnelHeight = session.VerticalTunnelHeight;
+        std::copy(std::begin(session.TrackColours), std::end(session.TrackColours), state.TrackColours);
+        return state;
+    }
+
+    template<typename T> static void ApplyUnlessUnset(T& target, T value)
+    {
+        if (value != &_unsetElement)
+        {
+            target = value;
+        }
+    }
+
+    static void ApplySessionState(paint_session& session, const SessionState& state)
+    {
+        ApplyUnlessUnset(session.SurfaceElement, state.SurfaceElement);
+        ApplyUnlessUnset(session.PathElementOnSameHeight, state.PathElementOnSameHeight);
+        ApplyUnlessUnset(session.TrackElementOnSameHeight, state.TrackElementOnSameHeight);
+        ApplyUnlessUnset(session.CurrentlyDrawnItem, state.CurrentlyDrawnItem);
+        session.MapPosition = state.MapPosition;
+        session.SpritePosition = state.SpritePosition;
+        session.InteractionType = state.InteractionType;
+        session.DidPassSurface = state.DidPassSurface;
+        session.Unk141E9DB = state.Unk141E9DB;
+        session.WaterHeight = state.WaterHeight;
+        std::copy(std::begin(state.SupportSegments), std::end(state.SupportSegments), session.SupportSegments);
+        session.Support = state.Support;
+        std::copy(std::begin(state.LeftTunnels), std::end(state.LeftTunnels), session.LeftTunnels);
+        session.LeftTunnelCount = state.LeftTunnelCount;
+        std::copy(std::begin(state.RightTunnels), std::end(state.RightTunnels), session.RightTunnels);
+        session.RightTunnelCount = state.RightTunnelCount;
+        session.VerticalTunnelHeight = state.VerticalTunnelHeight;
+        std::copy(std::begin(state.TrackColours), std::end(state.TrackColours), session.TrackColours);
+    }
+
+    /**
+     * Tiles can read the state the previous tile left behind, a tile is only replayed when it is painted after the
+     * same state it was recorded after.
+     */
+    static bool IsSameInput(const CachedTile& tile, const paint_session& session)
+    {
+        return tile.HasLastPS == (session.LastPS != nullptr) && tile.HasLastAttachedPS == (session.LastAttachedPS != nullptr)
+            && tile.HasWoodenSupportsPrependTo == (session.WoodenSupportsPrependTo != nullptr)
+            && (!tile.ReadsSurfaceElement || tile.SurfaceElement == session.SurfaceElement)
+            && (!tile.ReadsElementsOnSameHeight
+                || (tile.PathElementOnSameHeight == session.PathElementOnSameHeight
+                    && tile.TrackElementOnSameHeight == session.TrackElementOnSameHeight));
+    }
+
+    static uint32_t* GetTileVersion(const CoordsXY& loc)
+    {
+        if (_tileVersions.empty() || !map_is_location_valid(loc))
+        {
+            return nullptr;
+        }
+        auto tileLoc = TileCoordsXY(loc);
+        return &_tileVersions[static_cast<size_t>(tileLoc.y) * MAXIMUM_MAP_SIZE_TECHNICAL + tileLoc.x];
+    }
+
+    void Reset()
+    {
+        std::lock_guard<std::mutex> lock(_tilesMutex);
+        _tiles.clear();
+    }
+
+    void InvalidateTile(const CoordsXY& loc)
+    {
+        InvalidateRange(loc, loc);
+    }
+
+    void InvalidateRange(const CoordsXY& mins, const CoordsXY& maxs)
+    {
+        if (_tileVersions.empty())
+        {
+            return;
+        }
+
+        // Surfaces and paths are painted depending on the tiles around them.
+        for (int32_t y = mins.y - COORDS_XY_STEP; y <= maxs.y + COORDS_XY_STEP; y += COORDS_XY_STEP)
+        {
+            for (int32_t x = mins.x - COORDS_XY_STEP; x <= maxs.x + COORDS_XY_STEP; x += COORDS_XY_STEP)
+            {
+                auto* version = GetTileVersion({ x, y });
+                if (version != nullptr)
+                {
+                    (*version)++;
+                }
+            }
+        }
+    }
+
+    /**
+     * Discards the tiles that were not used for the longest time once there are too many, no tiles are painted while
+     * this runs.
+     */
+    static void EvictTiles()
+    {
+        if (_tiles.size() <= MaxTiles)
+        {
+            return;
+        }
+
+        std::vector<decltype(_tiles)::iterator> entries;
+        entries.reserve(_tiles.size());
+        for (auto it = _tiles.begin(); it != _tiles.end(); it++)
+        {
+            entries.push_back(it);
+        }
+
+        auto numEvicted = _tiles.size() - MaxTiles * 3 / 4;
+        std::nth_element(entries.begin(), entries.begin() + numEvicted, entries.end(), [](const auto& a, const auto& b) {
+            return a->second.LastUsed < b->second.LastUsed;
+        });
+        for (size_t i = 0; i < numEvicted; i++)
+        {
+            _tiles.erase(entries[i]);
+        }
+    }
+
+    bool BeginViewport()
+    {
+        if (!gConfigGeneral.paint_cache)
+        {
+            Reset();
+            _tileVersions.clear();
+            _tileVersions.shrink_to_fit();
+            return false;
+        }
+
+#ifdef __ENABLE_LIGHTFX__
+        // Lights are collected while the tile elements are painted, replaying a tile would not add them.
+        if (lightfx_is_available())
+        {
+            return false;
+        }
+#endif
+
+        // These are painted from state that changes without the tiles being invalidated.
+        if (gMapSelectFlags != 0 || virtual_floor_is_enabled() || gStaffDrawPatrolAreas != SPRITE_INDEX_NULL
+            || gTrackDesignSaveMode)
+        {
+            return false;
+        }
+
+        auto globalState = CaptureGlobalState();
+        if (!(globalState == _globalState))
+        {
+            Reset();
+            _globalState = globalState;
+        }
+
+        if (_tileVersions.empty())
+        {
+            Reset();
+            _tileVersions.resize(MAXIMUM_MAP_SIZE_TECHNICAL * MAXIMUM_MAP_SIZE_TECHNICAL);
+        }
+        _frame++;
+        EvictTiles();
+        return true;
+    }
+
+    static std::shared_ptr<const CachedTile> FindTile(const TileKey& key)
+    {
+        std::lock_guard<std::mutex> lock(_tilesMutex);
+        auto it = _tiles.find(key);
+        if (it == _tiles.end())
+        {
+            return nullptr;
+        }
+        it->second.LastUsed = _frame;
+        return it->second.Tile;
+    }
+
+    static void StoreTile(const TileKey& key, std::shared_ptr<const CachedTile> tile)
+    {
+        std::lock_guard<std::mutex> lock(_tilesMutex);
+        _tiles[key] = CacheEntry{ std::move(tile), _frame };
+    }
+
+    /**
+     * Returns the link to the latest value of a session link, the tile can not be replayed when the link was set to
+     * something else than the value it had before or after a paint operation.
+     */
+    template<typename T> static int32_t FindState(Recording& recording, const std::vector<const T*>& states, const T* value)
+    {
+        if (value == nullptr)
+        {
+            return NullLink;
+        }
+        for (size_t i = states.size(); i > 0; i--)
+        {
+            if (states[i - 1] == value)
+            {
+                return static_cast<int32_t>(i - 1);
+            }
+        }
+        recording.IsCacheable = false;
+        return NullLink;
+    }
+
+    static int32_t FindWoodenSupports(Recording& recording, const paint_struct* ps)
+    {
+        if (ps == nullptr)
+        {
+            return NullLink;
+        }
+        if (ps == recording.WoodenSupportsPrependTo)
+        {
+            return 0;
+        }
+        for (size_t i = recording.Structs.size(); i > 0; i--)
+        {
+            if (recording.Structs[i - 1] == ps)
+            {
+                return static_cast<int32_t>(i);
+            }
+        }
+        recording.IsCacheable = false;
+        return NullLink;
+    }
+
+    void BeginOperation(paint_session& session, Operation operation)
+    {
+        auto& recording = *session.TileRecording;
+        if (operation == Operation::Orphan)
+        {
+            recording.IsCacheable = false;
+            return;
+        }
+
+        RecordedOperation recorded;
+        recorded.Type = operation;
+        recorded.LastPS = FindState(recording, recording.LastPSStates, static_cast<const paint_struct*>(session.LastPS));
+        recorded.LastAttachedPS = FindState(
+            recording, recording.LastAttachedPSStates, static_cast<const attached_paint_struct*>(session.LastAttachedPS));
+        if (operation == Operation::WoodenSupportsChild)
+        {
+            recorded.WoodenSupportsPrependTo = FindWoodenSupports(recording, session.WoodenSupportsPrependTo);
+        }
+        recording.Operations.push_back(recorded);
+        recording.Structs.push_back(nullptr);
+        recording.AttachedStructs.push_back(nullptr);
+    }
+
+    void EndOperation(paint_session& session, const paint_struct* ps)
+    {
+        auto& recording = *session.TileRecording;
+        recording.Structs.back() = ps;
+        recording.LastPSStates.push_back(session.LastPS);
+        recording.LastAttachedPSStates.push_back(session.LastAttachedPS);
+    }
+
+    void EndOperation(paint_session& session, const attached_paint_struct* ps)
+    {
+        auto& recording = *session.TileRecording;
+        recording.AttachedStructs.back() = ps;
+        recording.LastPSStates.push_back(session.LastPS);
+        recording.LastAttachedPSStates.push_back(session.LastAttachedPS);
+    }
+
+    static bool IsSameImage(ImageId a, ImageId b)
+    {
+        return a.ToUInt32() == b.ToUInt32();
+    }
+
+    /**
+     * Paint operations only link structs of previous tiles to the structs of the tile, anything else they changed about
+     * them can not be replayed.
+     */
+    static bool IsUnchanged(const paint_struct& ps)
+    {
+        const paint_struct initial{};
+        return IsSameImage(ps.image_id, initial.image_id) && IsSameImage(ps.colour_image_id, initial.colour_image_id)
+            && ps.x == initial.x && ps.y == initial.y && ps.flags == initial.flags && ps.bounds.x == initial.bounds.x
+            && ps.bounds.y == initial.bounds.y && ps.bounds.z == initial.bounds.z && ps.bounds.x_end == initial.bounds.x_end
+            && ps.bounds.y_end == initial.bounds.y_end && ps.bounds.z_end == initial.bounds.z_end
+            && ps.next_quadrant_ps == initial.next_quadrant_ps;
+    }
+
+    static bool IsUnchanged(const attached_paint_struct& ps)
+    {
+        const attached_paint_struct initial{};
+        return IsSameImage(ps.image_id, initial.image_id) && IsSameImage(ps.colour_image_id, initial.colour_image_id)
+            && ps.x == initial.x && ps.y == initial.y && ps.flags == initial.flags;
+    }
+
+    static bool StoreOperations(CachedTile& tile, Recording& recording, const paint_session& recordingSession)
+    {
+        for (size_t i = 0; i < recording.Operations.size(); i++)
+        {
+            auto operation = recording.Operations[i];
+            if (operation.Type == Operation::AttachToPS || operation.Type == Operation::AttachToAttachedPS)
+            {
+                auto* attached = recording.AttachedStructs[i];
+                if (attached == nullptr)
+                {
+                    return false;
+                }
+                operation.Struct = static_cast<uint32_t>(tile.AttachedStructs.size());
+                auto& stored = tile.AttachedStructs.emplace_back(*attached);
+                stored.next = nullptr;
+            }
+            else
+            {
+                // Nothing is culled while recording, the struct is only missing when the image does not exist.
+                auto* ps = recording.Structs[i];
+                auto* g1 = ps != nullptr ? gfx_get_g1_element(ps->image_id) : nullptr;
+                if (g1 == nullptr)
+                {
+                    return false;
+                }
+                operation.Left = ps->x + g1->x_offset;
+                operation.Top = ps->y + g1->y_offset;
+                operation.Right = operation.Left + g1->width;
+                operation.Bottom = operation.Top + g1->height;
+                operation.Struct = static_cast<uint32_t>(tile.Structs.size());
+                auto& stored = tile.Structs.emplace_back(*ps);
+                stored.attached_ps = nullptr;
+                stored.children = nullptr;
+                stored.next_quadrant_ps = nullptr;
+            }
+            tile.Operations.push_back(operation);
+        }
+
+        tile.LastPS = FindState(recording, recording.LastPSStates, static_cast<const paint_struct*>(recordingSession.LastPS));
+        tile.LastAttachedPS = FindState(
+            recording, recording.LastAttachedPSStates,
+            static_cast<const attached_paint_struct*>(recordingSession.LastAttachedPS));
+        tile.WoodenSupportsPrependTo = FindWoodenSupports(recording, recordingSession.WoodenSupportsPrependTo);
+        tile.Output = CaptureSessionState(recordingSession);
+        return recording.IsCacheable;
+    }
+
+    /**
+     * Paints the tile elements into a session that does not cull anything, recording the paint operations.
+     */
+    static std::shared_ptr<CachedTile> RecordTile(
+        const paint_session& session, const CoordsXY& loc, const TileElement* firstElement)
+    {
+        auto tile = std::make_shared<CachedTile>();
+        tile->FirstElement = firstElement;
+        tile->Tick = gCurrentTicks;
+
+        // Surfaces set the surface element and new heights reset the elements on the same height before they are read.
+        tile->ReadsSurfaceElement = (session.ViewFlags & VIEWPORT_FLAG_CLIP_VIEW) || firstElement->IsInvisible()
+            || firstElement->GetType() != TileElementType::Surface;
+        tile->ReadsElementsOnSameHeight = firstElement->GetBaseZ() == 0;
+        tile->HasLastPS = session.LastPS != nullptr;
+        tile->HasLastAttachedPS = session.LastAttachedPS != nullptr;
+        tile->HasWoodenSupportsPrependTo = session.WoodenSupportsPrependTo != nullptr;
+        tile->SurfaceElement = session.SurfaceElement;
+        tile->PathElementOnSameHeight = session.PathElementOnSameHeight;
+        tile->TrackElementOnSameHeight = session.TrackElementOnSameHeight;
+
+        auto& recording = _recording;
+        recording.Operations.clear();
+        recording.Structs.clear();
+        recording.AttachedStructs.clear();
+        recording.LastPSStates.clear();
+        recording.LastAttachedPSStates.clear();
+        recording.IsCacheable = true;
+
+        _previousPS = {};
+        _previousAttachedPS = {};
+        _previousWoodenSupportsPrependTo = {};
+
+        auto& recordingSession = _recordingSession;
+        static_cast<PaintSessionCore&>(recordingSession) = session;
+        recordingSession.DPI = session.DPI;
+        recordingSession.DPI.x = std::numeric_limits<int32_t>::min() / 2;
+        recordingSession.DPI.y = std::numeric_limits<int32_t>::min() / 2;
+        recordingSession.DPI.width = std::numeric_limits<int32_t>::max();
+        recordingSession.DPI.height = std::numeric_limits<int32_t>::max();
+        if (recordingSession.PaintEntryChain.Pool == nullptr)
+        {
+            recordingSession.PaintEntryChain = _recordingPool.Create();
+        }
+        recordingSession.UseTileCache = false;
+        recordingSession.TileRecording = &recording;
+        recordingSession.TileCacheFlags = 0;
+
+        recordingSession.LastPS = tile->HasLastPS ? &_previousPS : nullptr;
+        recordingSession.LastAttachedPS = tile->HasLastAttachedPS ? &_previousAttachedPS : nullptr;
+        recordingSession.WoodenSupportsPrependTo = tile->HasWoodenSupportsPrependTo ? &_previousWoodenSupportsPrependTo
+                                                                                     : nullptr;
+        recordingSession.PSStringHead = nullptr;
+        recordingSession.LastPSString = nullptr;
+        recordingSession.CurrentlyDrawnItem = &_unsetElement;
+        if (!tile->ReadsSurfaceElement)
+        {
+            recordingSession.SurfaceElement = &_unsetElement;
+        }
+        if (!tile->ReadsElementsOnSameHeight)
+        {
+            recordingSession.PathElementOnSameHeight = &_unsetElement;
+            recordingSession.TrackElementOnSameHeight = &_unsetElement;
+        }
+
+        recording.WoodenSupportsPrependTo = recordingSession.WoodenSupportsPrependTo;
+        recording.LastPSStates.push_back(recordingSession.LastPS);
+        recording.LastAttachedPSStates.push_back(recordingSession.LastAttachedPS);
+
+        tile_element_paint_setup(recordingSession, loc);
+        recordingSession.TileRecording = nullptr;
+
+        tile->IsAnimated = (recordingSession.TileCacheFlags & PaintCacheFlags::Animated) != 0;
+        tile->IsCacheable = !(recordingSession.TileCacheFlags & PaintCacheFlags::Uncacheable)
+            && recordingSession.PSStringHead == nullptr && IsUnchanged(_previousPS) && IsUnchanged(_previousAttachedPS)
+            && IsUnchanged(_previousWoodenSupportsPrependTo) && StoreOperations(*tile, recording, recordingSession);
+        if (!tile->IsCacheable)
+        {
+            tile->Operations.clear();
+            tile->Structs.clear();
+            tile->AttachedStructs.clear();
+        }
+
+        recordingSession.PaintEntryChain.Clear();
+        return tile;
+    }
+
+    static paint_struct* GetState(const std::vector<paint_struct*>& states, int32_t link)
+    {
+        return link == NullLink ? nullptr : states[link];
+    }
+
+    static attached_paint_struct* GetState(const std::vector<attached_paint_struct*>& states, int32_t link)
+    {
+        return link == NullLink ? nullptr : states[link];
+    }
+
+    static paint_struct* GetWoodenSupports(paint_struct* previous, int32_t link)
+    {
+        if (link == NullLink)
+        {
+            return nullptr;
+        }
+        return link == 0 ? previous : _replayStructs[link - 1];
+    }
+
+    static bool IsWithinDPI(const RecordedOperation& operation, const rct_drawpixelinfo& dpi)
+    {
+        return operation.Right > dpi.x && operation.Bottom > dpi.y && operation.Left < dpi.x + dpi.width
+            && operation.Top < dpi.y + dpi.height;
+    }
+
+    /**
+     * The replayed operations do what the paint functions would have done, including culling and running out of paint
+     * entries, so the session ends up with the same structs as if the tile was painted.
+     */
+    static paint_struct* ReplayStruct(paint_session& session, const CachedTile& tile, const RecordedOperation& operation)
+    {
+        if (!IsWithinDPI(operation, session.DPI))
+        {
+            return nullptr;
+        }
+
+        auto* ps = session.AllocateNormalPaintEntry();
+        if (ps != nullptr)
+        {
+            *ps = tile.Structs[operation.Struct];
+        }
+        return ps;
+    }
+
+    static paint_struct* ReplayParent(paint_session& session, const CachedTile& tile, const RecordedOperation& operation)
+    {
+        session.LastPS = nullptr;
+        session.LastAttachedPS = nullptr;
+
+        auto* ps = ReplayStruct(session, tile, operation);
+        if (ps != nullptr)
+        {
+            PaintSessionAddPSToQuadrant(session, ps);
+        }
+        return ps;
+    }
+
+    static paint_struct* ReplayChild(paint_session& session, const CachedTile& tile, const RecordedOperation& operation)
+    {
+        auto* parent = session.LastPS;
+        if (parent == nullptr)
+        {
+            return ReplayParent(session, tile, operation);
+        }
+
+        auto* ps = ReplayStruct(session, tile, operation);
+        if (ps != nullptr)
+        {
+            parent->children = ps;
+        }
+        return ps;
+    }
+
+    static paint_struct* ReplayWoodenSupportsChild(
+        paint_session& session, const CachedTile& tile, const RecordedOperation& operation, paint_struct* prependTo)
+    {
+        if (prependTo == nullptr)
+        {
+            return ReplayParent(session, tile, operation);
+        }
+
+        session.LastPS = nullptr;
+        session.LastAttachedPS = nullptr;
+
+        auto* ps = ReplayStruct(session, tile, operation);
+        if (ps != nullptr)
+        {
+            prependTo->children = ps;
+        }
+        return ps;
+    }
+
+    static void ReplayAttachToPS(paint_session& session, const CachedTile& tile, const RecordedOperation& operation)
+    {
+        auto* master = session.LastPS;
+        if (master == nullptr)
+        {
+            return;
+        }
+
+        auto* attached = session.AllocateAttachedPaintEntry();
+        if (attached != nullptr)
+        {
+            *attached = tile.AttachedStructs[operation.Struct];
+            attached->next = master->attached_ps;
+            master->attached_ps = attached;
+        }
+    }
+
+    static void ReplayAttachToAttachedPS(paint_session& session, const CachedTile& tile, const RecordedOperation& operation)
+    {
+        auto* previous = session.LastAttachedPS;
+        if (previous == nullptr)
+        {
+            ReplayAttachToPS(session, tile, operation);
+            return;
+        }
+
+        auto* attached = session.AllocateAttachedPaintEntry();
+        if (attached != nullptr)
+        {
+            *attached = tile.AttachedStructs[operation.Struct];
+            previous->next = attached;
+        }
+    }
+
+    static void ReplayTile(paint_session& session, const CachedTile& tile)
+    {
+        auto* previousWoodenSupportsPrependTo = session.WoodenSupportsPrependTo;
+        _replayStructs.clear();
+        _replayLastPSStates.clear();
+        _replayLastAttachedPSStates.clear();
+        _replayLastPSStates.push_back(session.LastPS);
+        _replayLastAttachedPSStates.push_back(session.LastAttachedPS);
+
+        for (const auto& operation : tile.Operations)
+        {
+            session.LastPS = GetState(_replayLastPSStates, operation.LastPS);
+            session.LastAttachedPS = GetState(_replayLastAttachedPSStates, operation.LastAttachedPS);
+
+            paint_struct* ps = nullptr;
+            switch (operation.Type)
+            {
+                case Operation::Parent:
+                    ps = ReplayParent(session, tile, operation);
+                    break;
+                case Operation::Child:
+                    ps = ReplayChild(session, tile, operation);
+                    break;
+                case Operation::WoodenSupportsChild:
+                    ps = ReplayWoodenSupportsChild(
+                        session, tile, operation,
+                        GetWoodenSupports(previousWoodenSupportsPrependTo, operation.WoodenSupportsPrependTo));
+                    break;
+                case Operation::AttachToPS:
+                    ReplayAttachToPS(session, tile, operation);
+                    break;
+                case Operation::AttachToAttachedPS:
+                    ReplayAttachToAttachedPS(session, tile, operation);
+                    break;
+                case Operation::Orphan:
+                    break;
+            }
+
+            _replayStructs.push_back(ps);
+            _replayLastPSStates.push_back(session.LastPS);
+            _replayLastAttachedPSStates.push_back(session.LastAttachedPS);
+        }
+
+        session.LastPS = GetState(_replayLastPSStates, tile.LastPS);
+        session.LastAttachedPS = GetState(_replayLastAttachedPSStates, tile.LastAttachedPS);
+        session.WoodenSupportsPrependTo = GetWoodenSupports(previousWoodenSupportsPrependTo, tile.WoodenSupportsPrependTo);
+        ApplySessionState(session, tile.Output);
+    }
+
+    void PaintTile(paint_session& session, const CoordsXY& loc)
+    {
+        // Culled tiles are painted directly, it is cheaper than looking them up.
+        if (!session.UseTileCache || map_is_edge(loc) || tile_element_paint_is_culled(session, loc))
+        {
+            tile_element_paint_setup(session, loc);
+            return;
+        }
+
+        // Tiles that are not culled have elements.
+        const auto* firstElement = map_get_first_element_at(loc);
+        auto* version = GetTileVersion(loc);
+        auto tileVersion = version != nullptr ? *version : 0;
+        TileKey key{ loc.x / COORDS_XY_STEP, loc.y / COORDS_XY_STEP, session.CurrentRotation,
+                     static_cast<int8_t>(session.DPI.zoom_level), session.ViewFlags };
+
+        auto tile = FindTile(key);
+        if (tile != nullptr && tile->FirstElement == firstElement && tile->Version == tileVersion)
+        {
+            if (!tile->IsCacheable)
+            {
+                _uncacheable++;
+                tile_element_paint_setup(session, loc);
+                return;
+            }
+            if ((!tile->IsAnimated || tile->Tick == gCurrentTicks) && IsSameInput(*tile, session))
+            {
+                _hits++;
+                ReplayTile(session, *tile);
+                return;
+            }
+        }
+
+        _misses++;
+        auto recorded = RecordTile(session, loc, firstElement);
+        recorded->Version = tileVersion;
+        if (recorded->IsCacheable)
+        {
+            ReplayTile(session, *recorded);
+        }
+        else
+        {
+            tile_element_paint_setup(session, loc);
+        }
+        StoreTile(key, std::move(recorded));
+    }
+
+    Stats GetStats()
+    {
+        Stats stats;
+        stats.Hits = _hits;
+        stats.Misses = _misses;
+        stats.Uncacheable = _uncacheable;
+        std::lock_guard<std::mutex> lock(_tilesMutex);
+        stats.Tiles = _tiles.size();
+        return stats;
+    }
+
+    void ResetStats()
+    {
+        _hits = 0;
+        _misses = 0;
+        _uncacheable = 0;
+    }
+} // namespace OpenRCT2::PaintCache
@@ -0,0 +1,85 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2021 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#pragma once
+
+#include "../common.h"
+#include "../world/Location.hpp"
+
+struct attached_paint_struct;
+struct paint_session;
+struct paint_struct;
+
+/**
+ * Keeps the paint operations the tile elements of a tile performed, per rotation, zoom level and view flags, so that
+ * they can be replayed into any session that paints the tile instead of painting its elements again. Tiles are
+ * recorded without culling and the paint structs are culled against the area of the session when they are replayed,
+ * so a tile is reused by every column and viewport that shows it, no matter where it scrolled to. Entities are always
+ * painted. Tiles are recorded again after they were invalidated, animated tiles are only reused within the same tick.
+ */
+namespace OpenRCT2::PaintCache
+{
+    struct Recording;
+
+    enum class Operation : uint8_t
+    {
+        Parent,
+        Child,
+        WoodenSupportsChild,
+        AttachToPS,
+        AttachToAttachedPS,
+        // Orphans are linked by the caller, which can not be recorded.
+        Orphan,
+    };
+
+    struct Stats
+    {
+        uint64_t Hits{};
+        uint64_t Misses{};
+        uint64_t Uncacheable{};
+        size_t Tiles{};
+    };
+
+    /**
+     * Discards every cached tile, used when the tile elements are replaced or the whole screen is invalidated.
+     */
+    void Reset();
+
+    /**
+     * Discards the tile and its neighbours, whose edges can depend on it.
+     */
+    void InvalidateTile(const CoordsXY& loc);
+
+    /**
+     * Discards the tiles between mins and maxs, both inclusive, and their neighbours.
+     */
+    void InvalidateRange(const CoordsXY& mins, const CoordsXY& maxs);
+
+    /**
+     * Prepares the cache for painting a viewport, must be called from the main thread. Returns false when the cache is
+     * disabled or the state of the game that painting depends on can not be cached.
+     */
+    bool BeginViewport();
+
+    /**
+     * Paints the tile elements of a tile, replaying them from the cache when the session uses it.
+     */
+    void PaintTile(paint_session& session, const CoordsXY& loc);
+
+    /**
+     * Called by the paint functions while a tile is recorded, before an operation changes the session and after it
+     * created its paint struct.
+     */
+    void BeginOperation(paint_session& session, Operation operation);
+    void EndOperation(paint_session& session, const paint_struct* ps);
+    void EndOperation(paint_session& session, const attached_paint_struct* ps);
+
+    Stats GetStats();
+    void ResetStats();
+} // namespace OpenRCT2::PaintCache
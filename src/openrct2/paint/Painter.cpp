@@ -22,6 +22,7 @@
 #include "../localisation/Formatting.h"
 #include "../localisation/Language.h"
 #include "../paint/Paint.h"
+#include "../profiling/Profiling.h"
 #include "../title/TitleScreen.h"
 #include "../ui/UiContext.h"
 
@@ -37,6 +38,8 @@ Painter::Painter(const std::shared_ptr<IUiContext>& uiContext)
 
 void Painter::Paint(IDrawingEngine& de)
 {
+    TRACED_SCOPE("Painter::Paint");
+
     auto dpi = de.GetDrawingPixelInfo();
     if (gIntroState != IntroState::None)
     {
@@ -47,7 +50,10 @@ void Painter::Paint(IDrawingEngine& de)
         de.PaintWindows();
 
         update_palette_effects();
-        _uiContext->Draw(dpi);
+        {
+            TRACED_SCOPE("UiContext::Draw");
+            _uiContext->Draw(dpi);
+        }
 
         if ((gScreenFlags & SCREEN_FLAGS_TITLE_DEMO) && !title_should_hide_version_info())
         {
@@ -161,6 +167,9 @@ paint_session* Painter::CreateSession(rct_drawpixelinfo* dpi, uint32_t viewFlags
     session->WoodenSupportsPrependTo = nullptr;
     session->CurrentlyDrawnItem = nullptr;
     session->SurfaceElement = nullptr;
+    session->UseTileCache = false;
+    session->TileRecording = nullptr;
+    session->TileCacheFlags = 0;
 
     return session;
 }
@@ -592,7 +592,7 @@ bool wooden_a_supports_paint_setup(
 
             unk_supports_desc_bound_box bBox = byte_97B23C[special].bounding_box;
 
-            if (byte_97B23C[special].var_6 == 0 || session.WoodenSupportsPrependTo == nullptr)
+            if (byte_97B23C[special].var_6 == 0)
             {
                 PaintAddImageAsParent(
                     session, imageId, { 0, 0, z }, bBox.length, { bBox.offset.x, bBox.offset.y, bBox.offset.z + z });
@@ -601,12 +601,8 @@ bool wooden_a_supports_paint_setup(
             else
             {
                 hasSupports = true;
-                auto* ps = PaintAddImageAsOrphan(
+                PaintAddImageAsWoodenSupportsChild(
                     session, imageId, { 0, 0, z }, bBox.length, { bBox.offset.x, bBox.offset.y, bBox.offset.z + z });
-                if (ps != nullptr)
-                {
-                    session.WoodenSupportsPrependTo->children = ps;
-                }
             }
         }
     }
@@ -763,7 +759,7 @@ bool wooden_b_supports_paint_setup(
 
             const unk_supports_desc_bound_box& boundBox = supportsDesc.bounding_box;
 
-            if (supportsDesc.var_6 == 0 || session.WoodenSupportsPrependTo == nullptr)
+            if (supportsDesc.var_6 == 0)
             {
                 PaintAddImageAsParent(
                     session, imageId, { 0, 0, baseHeight }, boundBox.length,
@@ -772,14 +768,10 @@ bool wooden_b_supports_paint_setup(
             }
             else
             {
-                auto* paintStruct = PaintAddImageAsOrphan(
+                PaintAddImageAsWoodenSupportsChild(
                     session, imageId, { 0, 0, baseHeight }, boundBox.length,
                     { boundBox.offset.x, boundBox.offset.y, boundBox.offset.z + baseHeight });
                 _9E32B1 = true;
-                if (paintStruct != nullptr)
-                {
-                    session.WoodenSupportsPrependTo->children = paintStruct;
-                }
             }
         }
     }
@@ -1286,7 +1278,7 @@ bool path_a_supports_paint_setup(
         const unk_supports_desc& supportsDesc = byte_98D8D4[specialIndex];
         const unk_supports_desc_bound_box& boundBox = supportsDesc.bounding_box;
 
-        if (supportsDesc.var_6 == 0 || session.WoodenSupportsPrependTo == nullptr)
+        if (supportsDesc.var_6 == 0)
         {
             PaintAddImageAsParent(
                 session, imageTemplate.WithIndex(imageIndex), { 0, 0, baseHeight }, boundBox.length,
@@ -1295,14 +1287,10 @@ bool path_a_supports_paint_setup(
         }
         else
         {
-            paint_struct* paintStruct = PaintAddImageAsOrphan(
+            PaintAddImageAsWoodenSupportsChild(
                 session, imageTemplate.WithIndex(imageIndex), { 0, 0, baseHeight }, boundBox.length,
                 { boundBox.offset.x, boundBox.offset.y, baseHeight + boundBox.offset.z });
             hasSupports = true;
-            if (paintStruct != nullptr)
-            {
-                session.WoodenSupportsPrependTo->children = paintStruct;
-            }
         }
     }
 
@@ -232,6 +232,7 @@ void PaintSmallScenery(paint_session& session, uint8_t direction, int32_t height
     {
         if (sceneryEntry->HasFlag(SMALL_SCENERY_FLAG_VISIBLE_WHEN_ZOOMED) || (session.DPI.zoom_level <= ZoomLevel{ 1 }))
         {
+            session.TileCacheFlags |= PaintCacheFlags::Animated;
             if (sceneryEntry->HasFlag(SMALL_SCENERY_FLAG_FOUNTAIN_SPRAY_1))
             {
                 auto imageIndex = sceneryEntry->image + 4 + ((gCurrentTicks / 2) & 0xF);
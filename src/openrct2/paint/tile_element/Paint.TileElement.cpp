@@ -110,6 +110,104 @@ static void blank_tiles_paint(paint_session& session, int32_t x, int32_t y)
 
 bool gShowSupportSegmentHeights = false;
 
+/**
+ * Returns the position of the corner of the tile that is drawn at the top of the screen.
+ */
+static CoordsXY tile_element_paint_get_top_corner(uint8_t rotation, CoordsXY pos)
+{
+    switch (rotation)
+    {
+        case 0:
+            break;
+        case 1:
+            pos.x += 32;
+            break;
+        case 2:
+            pos.x += 32;
+            pos.y += 32;
+            break;
+        case 3:
+            pos.y += 32;
+            break;
+    }
+    return pos;
+}
+
+static uint16_t tile_element_paint_get_max_height(const TileElement* element, bool partOfVirtualFloor)
+{
+    uint16_t max_height = 0;
+    do
+    {
+        max_height = std::max(max_height, static_cast<uint16_t>(element->GetClearanceZ()));
+    } while (!(element++)->IsLastForTile());
+
+    element--;
+
+    if (element->GetType() == TileElementType::Surface && (element->AsSurface()->GetWaterHeight() > 0))
+    {
+        max_height = element->AsSurface()->GetWaterHeight();
+    }
+
+#ifndef __TESTPAINT__
+    if (partOfVirtualFloor)
+    {
+        // We must pretend this tile is at least as tall as the virtual floor
+        max_height = std::max(max_height, virtual_floor_get_height());
+    }
+#endif // __TESTPAINT__
+    return max_height;
+}
+
+static bool tile_element_paint_is_part_of_virtual_floor([[maybe_unused]] const CoordsXY& mapCoords)
+{
+#ifndef __TESTPAINT__
+    if (gConfigGeneral.virtual_floor_style != VirtualFloorStyles::Off)
+    {
+        return virtual_floor_tile_is_floor(mapCoords);
+    }
+#endif // __TESTPAINT__
+    return false;
+}
+
+static bool tile_element_paint_is_arrow_tile(const CoordsXY& mapCoords)
+{
+    return (gMapSelectFlags & MAP_SELECT_FLAG_ENABLE_ARROW) && mapCoords.x == gMapSelectArrowPosition.x
+        && mapCoords.y == gMapSelectArrowPosition.y;
+}
+
+bool tile_element_paint_is_culled(const paint_session& session, const CoordsXY& mapCoords)
+{
+    if (map_is_edge(mapCoords))
+    {
+        return false;
+    }
+
+    if ((session.ViewFlags & VIEWPORT_FLAG_CLIP_VIEW))
+    {
+        if (mapCoords.x < gClipSelectionA.x || mapCoords.x > gClipSelectionB.x)
+            return true;
+        if (mapCoords.y < gClipSelectionA.y || mapCoords.y > gClipSelectionB.y)
+            return true;
+    }
+
+    const TileElement* tile_element = map_get_first_element_at(mapCoords);
+    if (tile_element == nullptr)
+        return true;
+
+    // The arrow is painted before the tile is culled.
+    if (tile_element_paint_is_arrow_tile(mapCoords))
+        return false;
+
+    const auto& dpi = session.DPI;
+    const auto topCorner = tile_element_paint_get_top_corner(session.CurrentRotation, mapCoords);
+    int32_t screenMinY = translate_3d_to_2d_with_z(session.CurrentRotation, { topCorner, 0 }).y;
+    if (screenMinY + 52 <= dpi.y)
+        return true;
+
+    auto max_height = tile_element_paint_get_max_height(tile_element, tile_element_paint_is_part_of_virtual_floor(mapCoords));
+    return screenMinY - (max_height + 32) >= dpi.y + dpi.height;
+}
+
 /**
  *
  *  rct2: 0x0068B3FB
@@ -139,35 +237,16 @@ static void sub_68B3FB(paint_session& session, int32_t x, int32_t y)
         return;
     uint8_t rotation = session.CurrentRotation;
 
-    bool partOfVirtualFloor = false;
-#ifndef __TESTPAINT__
-    if (gConfigGeneral.virtual_floor_style != VirtualFloorStyles::Off)
-    {
-        partOfVirtualFloor = virtual_floor_tile_is_floor(session.MapPosition);
-    }
-#endif // __TESTPAINT__
+    bool partOfVirtualFloor = tile_element_paint_is_part_of_virtual_floor(session.MapPosition);
 
-    switch (rotation)
-    {
-        case 0:
-            break;
-        case 1:
-            x += 32;
-            break;
-        case 2:
-            x += 32;
-            y += 32;
-            break;
-        case 3:
-            y += 32;
-            break;
-    }
+    const auto topCorner = tile_element_paint_get_top_corner(rotation, { x, y });
+    x = topCorner.x;
+    y = topCorner.y;
 
     int32_t screenMinY = translate_3d_to_2d_with_z(rotation, { x, y, 0 }).y;
 
     // Display little yellow arrow when building footpaths?
-    if ((gMapSelectFlags & MAP_SELECT_FLAG_ENABLE_ARROW) && session.MapPosition.x == gMapSelectArrowPosition.x
-        && session.MapPosition.y == gMapSelectArrowPosition.y)
+    if (tile_element_paint_is_arrow_tile(session.MapPosition))
     {
         uint8_t arrowRotation = (rotation + (gMapSelectArrowDirection & 3)) & 3;
 
@@ -184,28 +263,7 @@ static void sub_68B3FB(paint_session& session, int32_t x, int32_t y)
     if (screenMinY + 52 <= dpi->y)
         return;
 
-    const TileElement* element = tile_element; // push tile_element
-
-    uint16_t max_height = 0;
-    do
-    {
-        max_height = std::max(max_height, static_cast<uint16_t>(element->GetClearanceZ()));
-    } while (!(element++)->IsLastForTile());
-
-    element--;
-
-    if (element->GetType() == TileElementType::Surface && (element->AsSurface()->GetWaterHeight() > 0))
-    {
-        max_height = element->AsSurface()->GetWaterHeight();
-    }
-
-#ifndef __TESTPAINT__
-    if (partOfVirtualFloor)
-    {
-        // We must pretend this tile is at least as tall as the virtual floor
-        max_height = std::max(max_height, virtual_floor_get_height());
-    }
-#endif // __TESTPAINT__
+    uint16_t max_height = tile_element_paint_get_max_height(tile_element, partOfVirtualFloor);
 
     if (screenMinY - (max_height + 32) >= dpi->y + dpi->height)
         return;
@@ -267,12 +325,15 @@ static void sub_68B3FB(paint_session& session, int32_t x, int32_t y)
                 PaintPath(session, baseZ, *(tile_element->AsPath()));
                 break;
             case TileElementType::Track:
+                // Track pieces are painted from the state of the ride and its vehicles.
+                session.TileCacheFlags |= PaintCacheFlags::Animated;
                 PaintTrack(session, direction, baseZ, *(tile_element->AsTrack()));
                 break;
             case TileElementType::SmallScenery:
                 PaintSmallScenery(session, direction, baseZ, *(tile_element->AsSmallScenery()));
                 break;
             case TileElementType::Entrance:
+                session.TileCacheFlags |= PaintCacheFlags::Animated;
                 PaintEntrance(session, direction, baseZ, *(tile_element->AsEntrance()));
                 break;
             case TileElementType::Wall:
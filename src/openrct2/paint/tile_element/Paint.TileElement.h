@@ -102,6 +102,12 @@ uint16_t paint_util_rotate_segments(uint16_t segments, uint8_t rotation);
 
 void tile_element_paint_setup(paint_session& session, const CoordsXY& mapCoords, bool isTrackPiecePreview = false);
 
+/**
+ * Returns true when tile_element_paint_setup would not paint any tile element of the tile, because it is not shown by
+ * the clip view or lies outside the area of the dpi of the session.
+ */
+bool tile_element_paint_is_culled(const paint_session& session, const CoordsXY& mapCoords);
+
 void PaintEntrance(paint_session& session, uint8_t direction, int32_t height, const EntranceElement& entranceElement);
 void PaintBanner(paint_session& session, uint8_t direction, int32_t height, const BannerElement& bannerElement);
 void PaintSurface(paint_session& session, uint8_t direction, uint16_t height, const SurfaceElement& tileElement);
@@ -151,7 +151,12 @@ static void PaintWallWall(
     paint_session& session, const WallSceneryEntry& wallEntry, ImageId imageTemplate, uint32_t imageOffset, CoordsXYZ offset,
     CoordsXYZ bounds, CoordsXYZ boundsOffset, bool isGhost)
 {
-    auto frameNum = (wallEntry.flags2 & WALL_SCENERY_2_ANIMATED) ? (gCurrentTicks & 7) * 2 : 0;
+    uint32_t frameNum = 0;
+    if (wallEntry.flags2 & WALL_SCENERY_2_ANIMATED)
+    {
+        frameNum = (gCurrentTicks & 7) * 2;
+        session.TileCacheFlags |= PaintCacheFlags::Animated;
+    }
     auto imageIndex = wallEntry.image + imageOffset + frameNum;
     PaintAddImageAsParent(session, imageTemplate.WithIndex(imageIndex), offset, bounds, boundsOffset);
     if ((wallEntry.flags & WALL_SCENERY_HAS_GLASS) && !isGhost)
@@ -152,28 +152,7 @@ namespace OpenRCT2
         void Save(IStream& stream)
         {
             OrcaStream os(stream, OrcaStream::Mode::WRITING);
-
-            auto& header = os.GetHeader();
-            header.Magic = PARK_FILE_MAGIC;
-            header.TargetVersion = PARK_FILE_CURRENT_VERSION;
-            header.MinVersion = PARK_FILE_MIN_VERSION;
-
-            ReadWriteAuthoringChunk(os);
-            ReadWriteObjectsChunk(os);
-            ReadWriteTilesChunk(os);
-            ReadWriteBannersChunk(os);
-            ReadWriteRidesChunk(os);
-            ReadWriteEntitiesChunk(os);
-            ReadWriteScenarioChunk(os);
-            ReadWriteGeneralChunk(os);
-            ReadWriteParkChunk(os);
-            ReadWriteClimateChunk(os);
-            ReadWriteResearchChunk(os);
-            ReadWriteNotificationsChunk(os);
-            ReadWriteInterfaceChunk(os);
-            ReadWriteCheatsChunk(os);
-            ReadWriteRestrictedObjectsChunk(os);
-            ReadWritePackedObjectsChunk(os);
+            WriteChunks(os);
         }
 
         void Save(const std::string_view& path)
@@ -182,6 +161,17 @@ namespace OpenRCT2
             Save(fs);
         }
 
+        /**
+         * Writes the park into memory without compressing it, which is left to the capture.
+         */
+        OrcaStream::Capture Capture()
+        {
+            MemoryStream unused;
+            OrcaStream os(unused, OrcaStream::Mode::WRITING);
+            WriteChunks(os);
+            return os.TakeCapture();
+        }
+
         scenario_index_entry ReadScenarioChunk()
         {
             scenario_index_entry entry{};
@@ -212,6 +202,31 @@ namespace OpenRCT2
         }
 
     private:
+        void WriteChunks(OrcaStream& os)
+        {
+            auto& header = os.GetHeader();
+            header.Magic = PARK_FILE_MAGIC;
+            header.TargetVersion = PARK_FILE_CURRENT_VERSION;
+            header.MinVersion = PARK_FILE_MIN_VERSION;
+
+            ReadWriteAuthoringChunk(os);
+            ReadWriteObjectsChunk(os);
+            ReadWriteTilesChunk(os);
+            ReadWriteBannersChunk(os);
+            ReadWriteRidesChunk(os);
+            ReadWriteEntitiesChunk(os);
+            ReadWriteScenarioChunk(os);
+            ReadWriteGeneralChunk(os);
+            ReadWriteParkChunk(os);
+            ReadWriteClimateChunk(os);
+            ReadWriteResearchChunk(os);
+            ReadWriteNotificationsChunk(os);
+            ReadWriteInterfaceChunk(os);
+            ReadWriteCheatsChunk(os);
+            ReadWriteRestrictedObjectsChunk(os);
+            ReadWritePackedObjectsChunk(os);
+        }
+
         static uint8_t GetMinCarsPerTrain(uint8_t value)
         {
             return value >> 4;
@@ -2228,6 +2243,24 @@ void ParkFileExporter::Export(IStream& stream)
     parkFile->Save(stream);
 }
 
+struct ParkFileCapture
+{
+    OrcaStream::Capture Data;
+};
+
+std::shared_ptr<ParkFileCapture> ParkFileExporter::Capture()
+{
+    auto parkFile = std::make_unique<OpenRCT2::ParkFile>();
+    parkFile->ExportObjectsList = ExportObjectsList;
+    parkFile->OmitTracklessRides = OmitTracklessRides;
+    return std::make_shared<ParkFileCapture>(ParkFileCapture{ parkFile->Capture() });
+}
+
+void ParkFileExporter::Encode(ParkFileCapture& capture, IStream& stream)
+{
+    capture.Data.Encode(stream);
+}
+
 enum : uint32_t
 {
     S6_SAVE_FLAG_EXPORT = 1 << 0,
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <memory>
 #include <string_view>
 #include <vector>
 
@@ -12,11 +13,22 @@ namespace OpenRCT2
     struct IStream;
 } // namespace OpenRCT2
 
+// A park written into memory by ParkFileExporter::Capture.
+struct ParkFileCapture;
+
 class ParkFileExporter
 {
 public:
     std::vector<const ObjectRepositoryItem*> ExportObjectsList;
+    bool OmitTracklessRides{};
 
     void Export(std::string_view path);
     void Export(OpenRCT2::IStream& stream);
+
+    /**
+     * Writes the park into memory, leaving the compression for Encode. The capture does not refer to the game state, so
+     * it can be encoded on another thread while the game carries on.
+     */
+    std::shared_ptr<ParkFileCapture> Capture();
+    static void Encode(ParkFileCapture& capture, OpenRCT2::IStream& stream);
 };
@@ -0,0 +1,121 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2021 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "ParkSaveWorker.h"
+
+#include "../Diagnostic.h"
+#include "../core/MemoryStream.h"
+#include "../core/Timer.hpp"
+#include "ParkFile.h"
+
+#include <chrono>
+#include <future>
+#include <string>
+
+namespace OpenRCT2::ParkSaveWorker
+{
+    struct PendingSave
+    {
+        std::future<Result> Future;
+        CompletionFunc OnComplete;
+    };
+
+    static PendingSave _pending;
+
+    static float ToMilliseconds(std::chrono::duration<float> duration)
+    {
+        return duration.count() * 1000.0f;
+    }
+
+    static Result Encode(
+        const std::string& name, std::shared_ptr<ParkFileCapture> capture, const WriteFunc& write, float captureTime)
+    {
+        Result result;
+        try
+        {
+            Timer timer;
+            MemoryStream ms;
+            ParkFileExporter::Encode(*capture, ms);
+            capture = nullptr;
+            const auto* data = static_cast<const uint8_t*>(ms.GetData());
+            result.Data.assign(data, data + ms.GetLength());
+            const auto encodeTime = ToMilliseconds(timer.GetElapsedTimeAndRestart());
+
+            result.Success = write == nullptr || write(result.Data);
+            const auto writeTime = ToMilliseconds(timer.GetElapsedTime());
+            log_verbose(
+                "%s: captured in %.1f ms, encoded in %.1f ms, written in %.1f ms", name.c_str(), captureTime, encodeTime,
+                writeTime);
+        }
+        catch (const std::exception& e)
+        {
+            log_error("%s: unable to encode park: %s", name.c_str(), e.what());
+            result.Success = false;
+        }
+        return result;
+    }
+
+    static void Complete()
+    {
+        auto result = _pending.Future.get();
+        auto onComplete = std::move(_pending.OnComplete);
+        _pending = {};
+        if (onComplete != nullptr)
+        {
+            onComplete(result);
+        }
+    }
+
+    bool Start(std::string_view name, ParkFileExporter& exporter, WriteFunc write, CompletionFunc onComplete)
+    {
+        Flush();
+
+        std::shared_ptr<ParkFileCapture> capture;
+        Timer timer;
+        try
+        {
+            capture = exporter.Capture();
+        }
+        catch (const std::exception& e)
+        {
+            log_error("%s: unable to capture park: %s", std::string(name).c_str(), e.what());
+            return false;
+        }
+        const auto captureTime = ToMilliseconds(timer.GetElapsedTime());
+
+        _pending.OnComplete = std::move(onComplete);
+        _pending.Future = std::async(
+            std::launch::async,
+            [name = std::string(name), capture = std::move(capture), write = std::move(write), captureTime]() mutable {
+                return Encode(name, std::move(capture), write, captureTime);
+            });
+        return true;
+    }
+
+    bool IsBusy()
+    {
+        return _pending.Future.valid();
+    }
+
+    void Update()
+    {
+        if (IsBusy() && _pending.Future.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
+        {
+            Complete();
+        }
+    }
+
+    void Flush()
+    {
+        if (IsBusy())
+        {
+            Complete();
+        }
+    }
+} // namespace OpenRCT2::ParkSaveWorker
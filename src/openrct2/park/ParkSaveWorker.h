@@ -0,0 +1,54 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2021 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string_view>
+#include <vector>
+
+class ParkFileExporter;
+
+/**
+ * Saves the park without holding up the game: the park is captured into memory on the game thread, then compressed and
+ * written out on a background thread. At most one save is in flight, starting another one completes the first.
+ */
+namespace OpenRCT2::ParkSaveWorker
+{
+    struct Result
+    {
+        bool Success{};
+        // The encoded park.
+        std::vector<uint8_t> Data;
+    };
+
+    // Writes the encoded park out on the background thread, returns whether that succeeded.
+    using WriteFunc = std::function<bool(const std::vector<uint8_t>& data)>;
+    // Called on the game thread once the save has finished.
+    using CompletionFunc = std::function<void(Result& result)>;
+
+    /**
+     * Captures the park with exporter and starts encoding it and passing it to write, which may be null to only keep the
+     * data for onComplete. Returns false without starting anything if the park could not be captured.
+     */
+    bool Start(std::string_view name, ParkFileExporter& exporter, WriteFunc write, CompletionFunc onComplete);
+
+    bool IsBusy();
+
+    /**
+     * Calls the completion callback of the save in flight if it has finished, called every game tick.
+     */
+    void Update();
+
+    /**
+     * Waits for the save in flight and calls its completion callback.
+     */
+    void Flush();
+} // namespace OpenRCT2::ParkSaveWorker
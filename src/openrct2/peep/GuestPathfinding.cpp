@@ -12,6 +12,7 @@
 #include "../core/Guard.hpp"
 #include "../entity/Guest.h"
 #include "../entity/Staff.h"
+#include "../profiling/Profiling.h"
 #include "../ride/RideData.h"
 #include "../ride/Station.h"
 #include "../ride/Track.h"
@@ -19,17 +20,22 @@
 #include "../util/Util.h"
 #include "../world/Entrance.h"
 #include "../world/Footpath.h"
+#include "GuestThink.h"
+#include "PathGraph.h"
 
+#include <algorithm>
 #include <bitset>
 #include <cstring>
 
 using namespace OpenRCT2;
 
-static bool _peepPathFindIsStaff;
-static int8_t _peepPathFindNumJunctions;
-static int8_t _peepPathFindMaxJunctions;
-static int32_t _peepPathFindTilesChecked;
-static uint8_t _peepPathFindFewestNumSteps;
+// The state of the search is per thread, guests search the junctions they are about to reach in parallel.
+static thread_local bool _peepPathFindIsStaff;
+static thread_local int8_t _peepPathFindNumJunctions;
+static thread_local int8_t _peepPathFindMaxJunctions;
+static thread_local int32_t _peepPathFindTilesChecked;
+static thread_local uint8_t _peepPathFindFewestNumSteps;
+static thread_local const PathfindJunction* _peepPathFindJunction;
 
 TileCoordsXYZ gPeepPathFindGoalPosition;
 bool gPeepPathFindIgnoreForeignQueues;
@@ -48,7 +54,7 @@ static int32_t guest_surface_path_finding(Peep* peep);
  * The magic number 16 is the largest value returned by
  * peep_pathfind_get_max_number_junctions() which should eventually
  * be declared properly. */
-static struct
+static thread_local struct
 {
     TileCoordsXYZ location;
     Direction direction;
@@ -96,9 +102,9 @@ static TileElement* get_banner_on_path(TileElement* path_element)
     return nullptr;
 }
 
-static int32_t banner_clear_path_edges(PathElement* pathElement, int32_t edges)
+static int32_t banner_clear_path_edges(bool ignoreBanners, PathElement* pathElement, int32_t edges)
 {
-    if (_peepPathFindIsStaff)
+    if (ignoreBanners)
         return edges;
     TileElement* bannerElement = get_banner_on_path(reinterpret_cast<TileElement*>(pathElement));
     if (bannerElement != nullptr)
@@ -116,7 +122,12 @@ static int32_t banner_clear_path_edges(PathElement* pathElement, int32_t edges)
  */
 static int32_t path_get_permitted_edges(PathElement* pathElement)
 {
-    return banner_clear_path_edges(pathElement, pathElement->GetEdgesAndCorners()) & 0x0F;
+    return banner_clear_path_edges(_peepPathFindIsStaff, pathElement, pathElement->GetEdgesAndCorners()) & 0x0F;
+}
+
+uint8_t path_get_guest_permitted_edges(PathElement* pathElement)
+{
+    return banner_clear_path_edges(false, pathElement, pathElement->GetEdgesAndCorners()) & 0x0F;
 }
 
 /**
@@ -482,6 +493,22 @@ static int32_t guest_path_find_aimless(Peep* peep, uint8_t edges)
     }
 }
 
+static uint8_t guest_pathfind_get_max_number_junctions(const Guest& guest)
+{
+    if (guest.PeepFlags & PEEP_FLAGS_LEAVING_PARK && guest.GuestIsLostCountdown < 90)
+    {
+        return 8;
+    }
+
+    if (guest.HasItem(ShopItem::Map))
+        return 7;
+
+    if (guest.PeepFlags & PEEP_FLAGS_LEAVING_PARK)
+        return 7;
+
+    return 5;
+}
+
 /**
  *
  *  rct2: 0x0069A60A
@@ -504,18 +531,7 @@ static uint8_t peep_pathfind_get_max_number_junctions(Peep* peep)
     if (guest == nullptr)
         return 8;
 
-    if (guest->PeepFlags & PEEP_FLAGS_LEAVING_PARK && guest->GuestIsLostCountdown < 90)
-    {
-        return 8;
-    }
-
-    if (guest->HasItem(ShopItem::Map))
-        return 7;
-
-    if (guest->PeepFlags & PEEP_FLAGS_LEAVING_PARK)
-        return 7;
-
-    return 5;
+    return guest_pathfind_get_max_number_junctions(*guest);
 }
 
 /**
@@ -854,9 +870,10 @@ static void peep_pathfind_heuristic_search(
                 else
                 { // numEdges == 2
                     if (tileElement->AsPath()->IsQueue()
-                        && tileElement->AsPath()->GetRideIndex() != gPeepPathFindQueueRideIndex)
+                        && tileElement->AsPath()->GetRideIndex() != _peepPathFindJunction->QueueRideIndex)
                     {
-                        if (gPeepPathFindIgnoreForeignQueues && (tileElement->AsPath()->GetRideIndex() != RIDE_ID_NULL))
+                        if (_peepPathFindJunction->IgnoreForeignQueues
+                            && (tileElement->AsPath()->GetRideIndex() != RIDE_ID_NULL))
                         {
                             // Path is a queue we aren't interested in
                             /* The rideIndex will be useful for
@@ -891,7 +908,7 @@ static void peep_pathfind_heuristic_search(
          * Ignore for now. */
 
         // Calculate the heuristic score of this map element.
-        uint16_t new_score = CalculateHeuristicPathingScore(loc, gPeepPathFindGoalPosition);
+        uint16_t new_score = CalculateHeuristicPathingScore(loc, _peepPathFindJunction->Goal);
 
         /* If this map element is the search goal the current search path ends here. */
         if (new_score == 0)
@@ -1080,7 +1097,7 @@ static void peep_pathfind_heuristic_search(
                 bool pathLoop = false;
                 /* Check the peep->PathfindHistory to see if this junction has
                  * already been visited by the peep while heading for this goal. */
-                for (auto& pathfindHistory : peep->PathfindHistory)
+                for (const auto& pathfindHistory : _peepPathFindJunction->PathfindHistory)
                 {
                     if (pathfindHistory == loc)
                     {
@@ -1252,37 +1269,45 @@ static void peep_pathfind_heuristic_search(
     }
 }
 
+bool PathfindJunction::operator==(const PathfindJunction& other) const
+{
+    // The coordinates with a direction compare without it.
+    auto isSameEntry = [](const TileCoordsXYZD& left, const TileCoordsXYZD& right) {
+        return left == right && left.direction == right.direction;
+    };
+    return Location == other.Location && Goal == other.Goal && QueueRideIndex == other.QueueRideIndex
+        && IgnoreForeignQueues == other.IgnoreForeignQueues && IsStaff == other.IsStaff && MaxJunctions == other.MaxJunctions
+        && FirstElementIndex == other.FirstElementIndex && PermittedEdges == other.PermittedEdges && IsThin == other.IsThin
+        && Edges == other.Edges && isSameEntry(PathfindGoal, other.PathfindGoal)
+        && std::equal(PathfindHistory.begin(), PathfindHistory.end(), other.PathfindHistory.begin(), isSameEntry);
+}
+
 /**
- * Returns:
- *   -1   - no direction chosen
- *   0..3 - chosen direction
- *
- *  rct2: 0x0069A5F0
+ * Works out the junction a peep at loc heading for the goal chooses a
+ * direction at, along with the pathfind goal and history of the peep as
+ * updated for it. The peep itself is left unchanged.
+ * Returns nothing if the peep is not on a path.
  */
-Direction peep_pathfind_choose_direction(const TileCoordsXYZ& loc, Peep* peep)
+static std::optional<PathfindJunction> peep_pathfind_get_junction(
+    const TileCoordsXYZ& loc, const Peep& peep, const TileCoordsXYZ& goal, ride_id_t queueRideIndex,
+    bool ignoreForeignQueues, uint8_t maxJunctions)
 {
-    // The max number of thin junctions searched - a per-search-path limit.
-    _peepPathFindMaxJunctions = peep_pathfind_get_max_number_junctions(peep);
+    PathfindJunction junction;
+    junction.Location = loc;
+    junction.Goal = goal;
+    junction.QueueRideIndex = queueRideIndex;
+    junction.IgnoreForeignQueues = ignoreForeignQueues;
+    junction.IsStaff = peep.Is<Staff>();
+    junction.MaxJunctions = maxJunctions;
+    junction.PathfindGoal = peep.PathfindGoal;
+    junction.PathfindHistory = peep.PathfindHistory;
 
-    /* The max number of tiles to check - a whole-search limit.
-     * Mainly to limit the performance impact of the path finding. */
-    int32_t maxTilesChecked = (peep->Is<Staff>()) ? 50000 : 15000;
     // Used to allow walking through no entry banners
-    _peepPathFindIsStaff = peep->Is<Staff>();
-
-    TileCoordsXYZ goal = gPeepPathFindGoalPosition;
-
-#if defined(DEBUG_LEVEL_1) && DEBUG_LEVEL_1
-    if (_pathFindDebug)
-    {
-        log_verbose(
-            "Choose direction for %s for goal %d,%d,%d from %d,%d,%d", _pathFindDebugPeepName, goal.x, goal.y, goal.z, loc.x,
-            loc.y, loc.z);
-    }
-#endif // defined(DEBUG_LEVEL_1) && DEBUG_LEVEL_1
+    _peepPathFindIsStaff = junction.IsStaff;
 
     // Get the path element at this location
-    TileElement* dest_tile_element = map_get_first_element_at(loc);
+    TileElement* tileElements = map_get_first_element_at(loc);
+    TileElement* dest_tile_element = tileElements;
     /* Where there are multiple matching map elements placed with zero
      * clearance, save the first one for later use to determine the path
      * slope - this maintains the original behaviour (which only processes
@@ -1298,11 +1323,7 @@ Direction peep_pathfind_choose_direction(const TileCoordsXYZ& loc, Peep* peep)
      * EXPECT to experience path finding irregularities due to those paths!
      * In particular common edges at different heights will not work
      * in a useful way. Simply do not do it! :-) */
-    TileElement* first_tile_element = nullptr;
-
     bool found = false;
-    uint8_t permitted_edges = 0;
-    bool isThin = false;
     do
     {
         if (dest_tile_element == nullptr)
@@ -1311,11 +1332,11 @@ Direction peep_pathfind_choose_direction(const TileCoordsXYZ& loc, Peep* peep)
             continue;
         if (dest_tile_element->GetType() != TileElementType::Path)
             continue;
-        found = true;
-        if (first_tile_element == nullptr)
+        if (!found)
         {
-            first_tile_element = dest_tile_element;
+            junction.FirstElementIndex = static_cast<uint32_t>(dest_tile_element - tileElements);
         }
+        found = true;
 
         /* Check if this path element is a thin junction.
          * Only 'thin' junctions are remembered in peep->PathfindHistory.
@@ -1323,18 +1344,18 @@ Direction peep_pathfind_choose_direction(const TileCoordsXYZ& loc, Peep* peep)
          * check if the combination is 'thin'!
          * The junction is considered 'thin' simply if any of the
          * overlaid path elements there is a 'thin junction'. */
-        isThin = isThin || path_is_thin_junction(dest_tile_element->AsPath(), loc);
+        junction.IsThin = junction.IsThin || path_is_thin_junction(dest_tile_element->AsPath(), loc);
 
         // Collect the permitted edges of ALL matching path elements at this location.
-        permitted_edges |= path_get_permitted_edges(dest_tile_element->AsPath());
+        junction.PermittedEdges |= path_get_permitted_edges(dest_tile_element->AsPath());
     } while (!(dest_tile_element++)->IsLastForTile());
     // Peep is not on a path.
     if (!found)
-        return INVALID_DIRECTION;
+        return std::nullopt;
 
-    permitted_edges &= 0xF;
-    uint8_t edges = permitted_edges;
-    if (isThin && peep->PathfindGoal == goal)
+    junction.PermittedEdges &= 0xF;
+    junction.Edges = junction.PermittedEdges;
+    if (junction.IsThin && junction.PathfindGoal == goal)
     {
         /* Use of peep->PathfindHistory[]:
          * When walking to a goal, the peep PathfindHistory stores
@@ -1351,7 +1372,7 @@ Direction peep_pathfind_choose_direction(const TileCoordsXYZ& loc, Peep* peep)
         /* If the peep remembers walking through this junction
          * previously while heading for its goal, retrieve the
          * directions it has not yet tried. */
-        for (auto& pathfindHistory : peep->PathfindHistory)
+        for (auto& pathfindHistory : junction.PathfindHistory)
         {
             if (pathfindHistory == loc)
             {
@@ -1361,20 +1382,21 @@ Direction peep_pathfind_choose_direction(const TileCoordsXYZ& loc, Peep* peep)
                  * changes or in earlier code .directions was
                  * initialised to 0xF rather than the permitted
                  * edges. */
-                pathfindHistory.direction &= permitted_edges;
+                pathfindHistory.direction &= junction.PermittedEdges;
 
-                edges = pathfindHistory.direction;
+                junction.Edges = pathfindHistory.direction;
 
 #if defined(DEBUG_LEVEL_1) && DEBUG_LEVEL_1
                 if (_pathFindDebug)
                 {
+                    uint8_t edges = junction.Edges;
                     log_verbose(
                         "Getting untried edges from pf_history for %d,%d,%d:  %s,%s,%s,%s", loc.x, loc.y, loc.z,
                         (edges & 1) ? "0" : "-", (edges & 2) ? "1" : "-", (edges & 4) ? "2" : "-", (edges & 8) ? "3" : "-");
                 }
 #endif // defined(DEBUG_LEVEL_1) && DEBUG_LEVEL_1
 
-                if (edges == 0)
+                if (junction.Edges == 0)
                 {
                     /* If peep has tried all edges, reset to
                      * all edges are untried.
@@ -1384,8 +1406,8 @@ Direction peep_pathfind_choose_direction(const TileCoordsXYZ& loc, Peep* peep)
                      * the paths or the pathfinding itself
                      * has changed (been fixed) since
                      * the game was saved. */
-                    pathfindHistory.direction = permitted_edges;
-                    edges = pathfindHistory.direction;
+                    pathfindHistory.direction = junction.PermittedEdges;
+                    junction.Edges = pathfindHistory.direction;
 
 #if defined(DEBUG_LEVEL_1) && DEBUG_LEVEL_1
                     if (_pathFindDebug)
@@ -1401,15 +1423,15 @@ Direction peep_pathfind_choose_direction(const TileCoordsXYZ& loc, Peep* peep)
 
     /* If this is a new goal for the peep. Store it and reset the peep's
      * PathfindHistory. */
-    if (!direction_valid(peep->PathfindGoal.direction) || peep->PathfindGoal != goal)
+    if (!direction_valid(junction.PathfindGoal.direction) || junction.PathfindGoal != goal)
     {
-        peep->PathfindGoal = { goal, 0 };
+        junction.PathfindGoal = { goal, 0 };
 
         // Clear pathfinding history
         TileCoordsXYZD nullPos;
         nullPos.SetNull();
 
-        std::fill(std::begin(peep->PathfindHistory), std::end(peep->PathfindHistory), nullPos);
+        std::fill(std::begin(junction.PathfindHistory), std::end(junction.PathfindHistory), nullPos);
 #if defined(DEBUG_LEVEL_1) && DEBUG_LEVEL_1
         if (_pathFindDebug)
         {
@@ -1417,174 +1439,257 @@ Direction peep_pathfind_choose_direction(const TileCoordsXYZ& loc, Peep* peep)
         }
 #endif // defined(DEBUG_LEVEL_1) && DEBUG_LEVEL_1
     }
+    return junction;
+}
 
-    // Peep has tried all edges.
-    if (edges == 0)
-        return INVALID_DIRECTION;
+Direction peep_pathfind_search_junction(const PathfindJunction& junction, Peep* peep)
+{
+    const auto& loc = junction.Location;
+    _peepPathFindJunction = &junction;
+    _peepPathFindIsStaff = junction.IsStaff;
+    // The max number of thin junctions searched - a per-search-path limit.
+    _peepPathFindMaxJunctions = junction.MaxJunctions;
 
-    int32_t chosen_edge = bitscanforward(edges);
+    /* The max number of tiles to check - a whole-search limit.
+     * Mainly to limit the performance impact of the path finding. */
+    int32_t maxTilesChecked = junction.IsStaff ? 50000 : 15000;
 
-    // Peep has multiple edges still to try.
-    if (edges & ~(1 << chosen_edge))
-    {
-        uint16_t best_score = 0xFFFF;
-        uint8_t best_sub = 0xFF;
+    TileElement* firstElement = map_get_first_element_at(loc) + junction.FirstElementIndex;
+    uint8_t edges = junction.Edges;
+    int32_t chosen_edge = bitscanforward(edges);
+    uint16_t best_score = 0xFFFF;
+    uint8_t best_sub = 0xFF;
 
 #if defined(DEBUG_LEVEL_1) && DEBUG_LEVEL_1
-        uint8_t bestJunctions = 0;
-        TileCoordsXYZ bestJunctionList[16];
-        uint8_t bestDirectionList[16];
-        TileCoordsXYZ bestXYZ;
+    uint8_t bestJunctions = 0;
+    TileCoordsXYZ bestJunctionList[16];
+    uint8_t bestDirectionList[16];
+    TileCoordsXYZ bestXYZ;
 
-        if (_pathFindDebug)
-        {
-            log_verbose("Pathfind start for goal %d,%d,%d from %d,%d,%d", goal.x, goal.y, goal.z, loc.x, loc.y, loc.z);
-        }
+    if (_pathFindDebug)
+    {
+        const auto& goal = junction.Goal;
+        log_verbose("Pathfind start for goal %d,%d,%d from %d,%d,%d", goal.x, goal.y, goal.z, loc.x, loc.y, loc.z);
+    }
 #endif // defined(DEBUG_LEVEL_1) && DEBUG_LEVEL_1
 
-        /* Call the search heuristic on each edge, keeping track of the
-         * edge that gives the best (i.e. smallest) value (best_score)
-         * or for different edges with equal value, the edge with the
-         * least steps (best_sub). */
-        int32_t numEdges = bitcount(edges);
-        for (int32_t test_edge = chosen_edge; test_edge != -1; test_edge = bitscanforward(edges))
-        {
-            edges &= ~(1 << test_edge);
-            uint8_t height = loc.z;
+    /* Call the search heuristic on each edge, keeping track of the
+     * edge that gives the best (i.e. smallest) value (best_score)
+     * or for different edges with equal value, the edge with the
+     * least steps (best_sub). */
+    int32_t numEdges = bitcount(edges);
+    for (int32_t test_edge = chosen_edge; test_edge != -1; test_edge = bitscanforward(edges))
+    {
+        edges &= ~(1 << test_edge);
+        uint8_t height = loc.z;
 
-            if (first_tile_element->AsPath()->IsSloped() && first_tile_element->AsPath()->GetSlopeDirection() == test_edge)
-            {
-                height += 0x2;
-            }
+        if (firstElement->AsPath()->IsSloped() && firstElement->AsPath()->GetSlopeDirection() == test_edge)
+        {
+            height += 0x2;
+        }
 
-            _peepPathFindFewestNumSteps = 255;
-            /* Divide the maxTilesChecked global search limit
-             * between the remaining edges to ensure the search
-             * covers all of the remaining edges. */
-            _peepPathFindTilesChecked = maxTilesChecked / numEdges;
-            _peepPathFindNumJunctions = _peepPathFindMaxJunctions;
+        _peepPathFindFewestNumSteps = 255;
+        /* Divide the maxTilesChecked global search limit
+         * between the remaining edges to ensure the search
+         * covers all of the remaining edges. */
+        _peepPathFindTilesChecked = maxTilesChecked / numEdges;
+        _peepPathFindNumJunctions = _peepPathFindMaxJunctions;
 
-            // Initialise _peepPathFindHistory.
+        // Initialise _peepPathFindHistory.
 
-            for (auto& entry : _peepPathFindHistory)
-            {
-                entry.location.SetNull();
-                entry.direction = INVALID_DIRECTION;
-            }
+        for (auto& entry : _peepPathFindHistory)
+        {
+            entry.location.SetNull();
+            entry.direction = INVALID_DIRECTION;
+        }
 
-            /* The pathfinding will only use elements
-             * 1.._peepPathFindMaxJunctions, so the starting point
-             * is placed in element 0 */
-            _peepPathFindHistory[0].location = loc;
-            _peepPathFindHistory[0].direction = 0xF;
-
-            uint16_t score = 0xFFFF;
-            /* Variable endXYZ contains the end location of the
-             * search path. */
-            TileCoordsXYZ endXYZ;
-            endXYZ.x = 0;
-            endXYZ.y = 0;
-            endXYZ.z = 0;
-
-            uint8_t endSteps = 255;
-
-            /* Variable endJunctions is the number of junctions
-             * passed through in the search path.
-             * Variables endJunctionList and endDirectionList
-             * contain the junctions and corresponding directions
-             * of the search path.
-             * In the future these could be used to visualise the
-             * pathfinding on the map. */
-            uint8_t endJunctions = 0;
-            TileCoordsXYZ endJunctionList[16];
-            uint8_t endDirectionList[16] = { 0 };
-
-            bool inPatrolArea = false;
-            auto* staff = peep->As<Staff>();
-            if (staff != nullptr && staff->IsMechanic())
-            {
-                /* Mechanics are the only staff type that
-                 * pathfind to a destination. Determine if the
-                 * mechanic is in their patrol area. */
-                inPatrolArea = staff->IsLocationInPatrol(peep->NextLoc);
-            }
+        /* The pathfinding will only use elements
+         * 1.._peepPathFindMaxJunctions, so the starting point
+         * is placed in element 0 */
+        _peepPathFindHistory[0].location = loc;
+        _peepPathFindHistory[0].direction = 0xF;
+
+        uint16_t score = 0xFFFF;
+        /* Variable endXYZ contains the end location of the
+         * search path. */
+        TileCoordsXYZ endXYZ;
+        endXYZ.x = 0;
+        endXYZ.y = 0;
+        endXYZ.z = 0;
+
+        uint8_t endSteps = 255;
+
+        /* Variable endJunctions is the number of junctions
+         * passed through in the search path.
+         * Variables endJunctionList and endDirectionList
+         * contain the junctions and corresponding directions
+         * of the search path.
+         * In the future these could be used to visualise the
+         * pathfinding on the map. */
+        uint8_t endJunctions = 0;
+        TileCoordsXYZ endJunctionList[16];
+        uint8_t endDirectionList[16] = { 0 };
+
+        bool inPatrolArea = false;
+        auto* staff = peep->As<Staff>();
+        if (staff != nullptr && staff->IsMechanic())
+        {
+            /* Mechanics are the only staff type that
+             * pathfind to a destination. Determine if the
+             * mechanic is in their patrol area. */
+            inPatrolArea = staff->IsLocationInPatrol(peep->NextLoc);
+        }
 
 #if defined(DEBUG_LEVEL_2) && DEBUG_LEVEL_2
-            if (gPathFindDebug)
-            {
-                log_verbose("Pathfind searching in direction: %d from %d,%d,%d", test_edge, loc.x >> 5, loc.y >> 5, loc.z);
-            }
+        if (gPathFindDebug)
+        {
+            log_verbose("Pathfind searching in direction: %d from %d,%d,%d", test_edge, loc.x >> 5, loc.y >> 5, loc.z);
+        }
 #endif // defined(DEBUG_LEVEL_2) && DEBUG_LEVEL_2
 
-            peep_pathfind_heuristic_search(
-                { loc.x, loc.y, height }, peep, first_tile_element, inPatrolArea, 0, &score, test_edge, &endJunctions,
-                endJunctionList, endDirectionList, &endXYZ, &endSteps);
+        peep_pathfind_heuristic_search(
+            { loc.x, loc.y, height }, peep, firstElement, inPatrolArea, 0, &score, test_edge, &endJunctions,
+            endJunctionList, endDirectionList, &endXYZ, &endSteps);
 
 #if defined(DEBUG_LEVEL_1) && DEBUG_LEVEL_1
-            if (_pathFindDebug)
-            {
-                log_verbose(
-                    "Pathfind test edge: %d score: %d steps: %d end: %d,%d,%d junctions: %d", test_edge, score, endSteps,
-                    endXYZ.x, endXYZ.y, endXYZ.z, endJunctions);
-                for (uint8_t listIdx = 0; listIdx < endJunctions; listIdx++)
-                {
-                    log_info(
-                        "Junction#%d %d,%d,%d Direction %d", listIdx + 1, endJunctionList[listIdx].x,
-                        endJunctionList[listIdx].y, endJunctionList[listIdx].z, endDirectionList[listIdx]);
-                }
-            }
-#endif // defined(DEBUG_LEVEL_1) && DEBUG_LEVEL_1
-
-            if (score < best_score || (score == best_score && endSteps < best_sub))
+        if (_pathFindDebug)
+        {
+            log_verbose(
+                "Pathfind test edge: %d score: %d steps: %d end: %d,%d,%d junctions: %d", test_edge, score, endSteps,
+                endXYZ.x, endXYZ.y, endXYZ.z, endJunctions);
+            for (uint8_t listIdx = 0; listIdx < endJunctions; listIdx++)
             {
-                chosen_edge = test_edge;
-                best_score = score;
-                best_sub = endSteps;
-#if defined(DEBUG_LEVEL_1) && DEBUG_LEVEL_1
-                bestJunctions = endJunctions;
-                for (uint8_t index = 0; index < endJunctions; index++)
-                {
-                    bestJunctionList[index].x = endJunctionList[index].x;
-                    bestJunctionList[index].y = endJunctionList[index].y;
-                    bestJunctionList[index].z = endJunctionList[index].z;
-                    bestDirectionList[index] = endDirectionList[index];
-                }
-                bestXYZ.x = endXYZ.x;
-                bestXYZ.y = endXYZ.y;
-                bestXYZ.z = endXYZ.z;
-#endif // defined(DEBUG_LEVEL_1) && DEBUG_LEVEL_1
+                log_info(
+                    "Junction#%d %d,%d,%d Direction %d", listIdx + 1, endJunctionList[listIdx].x,
+                    endJunctionList[listIdx].y, endJunctionList[listIdx].z, endDirectionList[listIdx]);
             }
         }
+#endif // defined(DEBUG_LEVEL_1) && DEBUG_LEVEL_1
 
-        /* Check if the heuristic search failed. e.g. all connected
-         * paths are within the search limits and none reaches the
-         * goal. */
-        if (best_score == 0xFFFF)
+        if (score < best_score || (score == best_score && endSteps < best_sub))
         {
+            chosen_edge = test_edge;
+            best_score = score;
+            best_sub = endSteps;
 #if defined(DEBUG_LEVEL_1) && DEBUG_LEVEL_1
-            if (_pathFindDebug)
+            bestJunctions = endJunctions;
+            for (uint8_t index = 0; index < endJunctions; index++)
             {
-                log_verbose("Pathfind heuristic search failed.");
+                bestJunctionList[index].x = endJunctionList[index].x;
+                bestJunctionList[index].y = endJunctionList[index].y;
+                bestJunctionList[index].z = endJunctionList[index].z;
+                bestDirectionList[index] = endDirectionList[index];
             }
+            bestXYZ.x = endXYZ.x;
+            bestXYZ.y = endXYZ.y;
+            bestXYZ.z = endXYZ.z;
 #endif // defined(DEBUG_LEVEL_1) && DEBUG_LEVEL_1
-            return INVALID_DIRECTION;
         }
+    }
+
+    /* Check if the heuristic search failed. e.g. all connected
+     * paths are within the search limits and none reaches the
+     * goal. */
+    if (best_score == 0xFFFF)
+    {
 #if defined(DEBUG_LEVEL_1) && DEBUG_LEVEL_1
         if (_pathFindDebug)
         {
-            log_verbose("Pathfind best edge %d with score %d steps %d", chosen_edge, best_score, best_sub);
-            for (uint8_t listIdx = 0; listIdx < bestJunctions; listIdx++)
-            {
-                log_verbose(
-                    "Junction#%d %d,%d,%d Direction %d", listIdx + 1, bestJunctionList[listIdx].x, bestJunctionList[listIdx].y,
-                    bestJunctionList[listIdx].z, bestDirectionList[listIdx]);
-            }
-            log_verbose("End at %d,%d,%d", bestXYZ.x, bestXYZ.y, bestXYZ.z);
+            log_verbose("Pathfind heuristic search failed.");
         }
 #endif // defined(DEBUG_LEVEL_1) && DEBUG_LEVEL_1
+        return INVALID_DIRECTION;
+    }
+#if defined(DEBUG_LEVEL_1) && DEBUG_LEVEL_1
+    if (_pathFindDebug)
+    {
+        log_verbose("Pathfind best edge %d with score %d steps %d", chosen_edge, best_score, best_sub);
+        for (uint8_t listIdx = 0; listIdx < bestJunctions; listIdx++)
+        {
+            log_verbose(
+                "Junction#%d %d,%d,%d Direction %d", listIdx + 1, bestJunctionList[listIdx].x, bestJunctionList[listIdx].y,
+                bestJunctionList[listIdx].z, bestDirectionList[listIdx]);
+        }
+        log_verbose("End at %d,%d,%d", bestXYZ.x, bestXYZ.y, bestXYZ.z);
+    }
+#endif // defined(DEBUG_LEVEL_1) && DEBUG_LEVEL_1
+
+    return chosen_edge;
+}
+
+/**
+ * Returns:
+ *   -1   - no direction chosen
+ *   0..3 - chosen direction
+ *
+ *  rct2: 0x0069A5F0
+ */
+Direction peep_pathfind_choose_direction(const TileCoordsXYZ& loc, Peep* peep)
+{
+    // The max number of thin junctions searched - a per-search-path limit.
+    uint8_t maxJunctions = peep_pathfind_get_max_number_junctions(peep);
+
+    TileCoordsXYZ goal = gPeepPathFindGoalPosition;
+
+#if defined(DEBUG_LEVEL_1) && DEBUG_LEVEL_1
+    if (_pathFindDebug)
+    {
+        log_verbose(
+            "Choose direction for %s for goal %d,%d,%d from %d,%d,%d", _pathFindDebugPeepName, goal.x, goal.y, goal.z, loc.x,
+            loc.y, loc.z);
+    }
+#endif // defined(DEBUG_LEVEL_1) && DEBUG_LEVEL_1
+
+    auto junction = peep_pathfind_get_junction(
+        loc, *peep, goal, gPeepPathFindQueueRideIndex, gPeepPathFindIgnoreForeignQueues, maxJunctions);
+    // Peep is not on a path.
+    if (!junction.has_value())
+        return INVALID_DIRECTION;
+
+    peep->PathfindGoal = junction->PathfindGoal;
+    peep->PathfindHistory = junction->PathfindHistory;
+
+    // Peep has tried all edges.
+    uint8_t edges = junction->Edges;
+    if (edges == 0)
+        return INVALID_DIRECTION;
+
+    int32_t chosen_edge = bitscanforward(edges);
+
+    /* In the improved mode guests look the best edge up in the path
+     * graph routing tables, falling back to the heuristic search when
+     * none of the edges leads to the goal. */
+    Direction routedEdge = INVALID_DIRECTION;
+    if ((edges & ~(1 << chosen_edge)) && peep->Is<Guest>() && PathGraph::IsImprovedModeActive())
+    {
+        routedEdge = PathGraph::ChooseDirection(
+            loc, edges, goal, gPeepPathFindQueueRideIndex, gPeepPathFindIgnoreForeignQueues);
     }
 
-    if (isThin)
+    if (routedEdge != INVALID_DIRECTION)
+    {
+        chosen_edge = routedEdge;
+    }
+    // Peep has multiple edges still to try.
+    else if (edges & ~(1 << chosen_edge))
+    {
+        /* Guests take the edge the think phase searched for them
+         * if they reached the junction it expected them to. */
+        Direction searchedEdge = INVALID_DIRECTION;
+        auto* guest = peep->As<Guest>();
+        if (guest == nullptr || !GuestThink::TryTakeJunctionChoice(*guest, *junction, searchedEdge))
+        {
+            searchedEdge = peep_pathfind_search_junction(*junction, peep);
+        }
+
+        // The heuristic search failed.
+        if (searchedEdge == INVALID_DIRECTION)
+            return INVALID_DIRECTION;
+
+        chosen_edge = searchedEdge;
+    }
+
+    if (junction->IsThin)
     {
         for (int32_t i = 0; i < 4; ++i)
         {
@@ -1612,7 +1717,7 @@ Direction peep_pathfind_choose_direction(const TileCoordsXYZ& loc, Peep* peep)
          * and remember this junction. */
         int32_t i = peep->PathfindGoal.direction++;
         peep->PathfindGoal.direction &= 3;
-        peep->PathfindHistory[i] = { loc, permitted_edges };
+        peep->PathfindHistory[i] = { loc, junction->PermittedEdges };
         /* Remove the chosen_edge from those left to try. */
         peep->PathfindHistory[i].direction &= ~(1 << chosen_edge);
         /* Also remove the edge through which the peep
@@ -1963,12 +2068,79 @@ static StationIndex guest_pathfinding_select_random_station(
 
     return 0;
 }
+/**
+ * The end of the queue of the entrance the guest heads for to get on a ride,
+ * or the start of its first station if the ride has no entrances.
+ */
+static TileCoordsXYZ guest_pathfinding_get_ride_goal(const Guest& guest, const Ride& ride)
+{
+    TileCoordsXYZ loc;
+
+    /* Find the ride's closest entrance station to the peep.
+     * At the same time, count how many entrance stations there are and
+     * which stations are entrance stations. */
+    auto bestScore = std::numeric_limits<int32_t>::max();
+    StationIndex closestStationNum = 0;
+
+    int32_t numEntranceStations = 0;
+    BitSet<MAX_STATIONS> entranceStations = {};
+
+    for (StationIndex stationNum = 0; stationNum < MAX_STATIONS; ++stationNum)
+    {
+        // Skip if stationNum has no entrance (so presumably an exit only station)
+        if (ride_get_entrance_location(&ride, stationNum).IsNull())
+            continue;
+
+        numEntranceStations++;
+        entranceStations[stationNum] = true;
+
+        TileCoordsXYZD entranceLocation = ride_get_entrance_location(&ride, stationNum);
+        auto score = CalculateHeuristicPathingScore(entranceLocation, TileCoordsXYZ{ guest.NextLoc });
+        if (score < bestScore)
+        {
+            bestScore = score;
+            closestStationNum = stationNum;
+            continue;
+        }
+    }
+
+    // Ride has no stations with an entrance, so head to station 0.
+    if (numEntranceStations == 0)
+        closestStationNum = 0;
+
+    if (numEntranceStations > 1 && (ride.depart_flags & RIDE_DEPART_SYNCHRONISE_WITH_ADJACENT_STATIONS))
+    {
+        closestStationNum = guest_pathfinding_select_random_station(&guest, numEntranceStations, entranceStations);
+    }
+
+    if (numEntranceStations == 0)
+    {
+        // closestStationNum is always 0 here.
+        auto entranceXY = TileCoordsXY(ride.stations[closestStationNum].Start);
+        loc.x = entranceXY.x;
+        loc.y = entranceXY.y;
+        loc.z = ride.stations[closestStationNum].Height;
+    }
+    else
+    {
+        TileCoordsXYZD entranceXYZD = ride_get_entrance_location(&ride, closestStationNum);
+        loc.x = entranceXYZD.x;
+        loc.y = entranceXYZD.y;
+        loc.z = entranceXYZD.z;
+    }
+
+    get_ride_queue_end(loc);
+    return loc;
+}
+
 /**
  *
  *  rct2: 0x00694C35
  */
 int32_t guest_path_finding(Guest* peep)
 {
+    PROFILED_SCOPE("guest_path_finding");
+
 #if defined(DEBUG_LEVEL_1) && DEBUG_LEVEL_1
     PathfindLoggingEnable(peep);
     if (_pathFindDebug)
@@ -2169,62 +2341,7 @@ int32_t guest_path_finding(Guest* peep)
     // The ride is open.
     gPeepPathFindQueueRideIndex = rideIndex;
 
-    /* Find the ride's closest entrance station to the peep.
-     * At the same time, count how many entrance stations there are and
-     * which stations are entrance stations. */
-    auto bestScore = std::numeric_limits<int32_t>::max();
-    StationIndex closestStationNum = 0;
-
-    int32_t numEntranceStations = 0;
-    BitSet<MAX_STATIONS> entranceStations = {};
-
-    for (StationIndex stationNum = 0; stationNum < MAX_STATIONS; ++stationNum)
-    {
-        // Skip if stationNum has no entrance (so presumably an exit only station)
-        if (ride_get_entrance_location(ride, stationNum).IsNull())
-            continue;
-
-        numEntranceStations++;
-        entranceStations[stationNum] = true;
-
-        TileCoordsXYZD entranceLocation = ride_get_entrance_location(ride, stationNum);
-        auto score = CalculateHeuristicPathingScore(entranceLocation, TileCoordsXYZ{ peep->NextLoc });
-        if (score < bestScore)
-        {
-            bestScore = score;
-            closestStationNum = stationNum;
-            continue;
-        }
-    }
-
-    // Ride has no stations with an entrance, so head to station 0.
-    if (numEntranceStations == 0)
-        closestStationNum = 0;
-
-    if (numEntranceStations > 1 && (ride->depart_flags & RIDE_DEPART_SYNCHRONISE_WITH_ADJACENT_STATIONS))
-    {
-        closestStationNum = guest_pathfinding_select_random_station(peep, numEntranceStations, entranceStations);
-    }
-
-    if (numEntranceStations == 0)
-    {
-        // closestStationNum is always 0 here.
-        auto entranceXY = TileCoordsXY(ride->stations[closestStationNum].Start);
-        loc.x = entranceXY.x;
-        loc.y = entranceXY.y;
-        loc.z = ride->stations[closestStationNum].Height;
-    }
-    else
-    {
-        TileCoordsXYZD entranceXYZD = ride_get_entrance_location(ride, closestStationNum);
-        loc.x = entranceXYZD.x;
-        loc.y = entranceXYZD.y;
-        loc.z = entranceXYZD.z;
-    }
-
-    get_ride_queue_end(loc);
-
-    gPeepPathFindGoalPosition = loc;
+    gPeepPathFindGoalPosition = guest_pathfinding_get_ride_goal(*peep, *ride);
     gPeepPathFindIgnoreForeignQueues = true;
 
     direction = peep_pathfind_choose_direction(TileCoordsXYZ{ peep->NextLoc }, peep);
@@ -2259,6 +2376,27 @@ int32_t guest_path_finding(Guest* peep)
     return peep_move_one_tile(direction, peep);
 }
 
+std::optional<PathfindJunction> guest_pathfind_get_ride_junction(const Guest& guest)
+{
+    // Guests with PEEP_FLAGS_2 draw a random number for their search limit.
+    if ((guest.PeepFlags & PEEP_FLAGS_2) || PathGraph::IsImprovedModeActive())
+        return std::nullopt;
+    if (guest.OutsideOfPark || (guest.PeepFlags & PEEP_FLAGS_LEAVING_PARK) || guest.GetNextIsSurface())
+        return std::nullopt;
+
+    auto ride = get_ride(guest.GuestHeadingToRideId);
+    if (ride == nullptr || ride->status != RideStatus::Open)
+        return std::nullopt;
+
+    auto junction = peep_pathfind_get_junction(
+        TileCoordsXYZ{ guest.NextLoc }, guest, guest_pathfinding_get_ride_goal(guest, *ride), ride->id, true,
+        guest_pathfind_get_max_number_junctions(guest));
+    if (!junction.has_value() || bitcount(junction->Edges) < 2)
+        return std::nullopt;
+
+    return junction;
+}
+
 bool IsValidPathZAndDirection(TileElement* tileElement, int32_t currentZ, int32_t currentDirection)
 {
     if (tileElement->AsPath()->IsSloped())
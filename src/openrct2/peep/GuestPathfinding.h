@@ -13,8 +13,12 @@
 #include "../ride/RideTypes.h"
 #include "../world/Location.hpp"
 
+#include <array>
+#include <optional>
+
 struct Peep;
 struct Guest;
+struct PathElement;
 struct TileElement;
 
 // The tile position of the place the peep is trying to get to (park entrance/exit, ride
@@ -41,6 +45,40 @@ extern bool gPeepPathFindIgnoreForeignQueues;
 // the direction the peep should walk in from the current tile.
 Direction peep_pathfind_choose_direction(const TileCoordsXYZ& loc, Peep* peep);
 
+// Everything the heuristic search at a junction depends on besides the map. PathfindGoal and PathfindHistory are
+// those of the peep as peep_pathfind_choose_direction updates them before searching, and Edges the ones left to try.
+// The first path element is kept as its index within the tile, which stays valid when the tile elements are moved.
+struct PathfindJunction
+{
+    TileCoordsXYZ Location;
+    TileCoordsXYZ Goal;
+    ride_id_t QueueRideIndex{};
+    bool IgnoreForeignQueues{};
+    bool IsStaff{};
+    uint8_t MaxJunctions{};
+    uint32_t FirstElementIndex{};
+    uint8_t PermittedEdges{};
+    bool IsThin{};
+    uint8_t Edges{};
+    TileCoordsXYZD PathfindGoal;
+    std::array<TileCoordsXYZD, 4> PathfindHistory;
+
+    bool operator==(const PathfindJunction& other) const;
+};
+
+// Runs the heuristic search along each of the edges of the junction that are left to try, returning the one that gets
+// closest to the goal or INVALID_DIRECTION if none of them does. Only reads the map and the peep, so it can run on any
+// thread while the game state is not being changed.
+Direction peep_pathfind_search_junction(const PathfindJunction& junction, Peep* peep);
+
+// The junction guest_path_finding would search at the next tile of a guest heading for a ride, if the guest were to
+// pathfind from there before anything else changes. Nothing is returned when the guest would not get to the search,
+// or only by using random numbers or the path graph.
+std::optional<PathfindJunction> guest_pathfind_get_ride_junction(const Guest& guest);
+
+// Gets the connected edges of a path that guests may walk through, i.e. without 'no entry' signs.
+uint8_t path_get_guest_permitted_edges(PathElement* pathElement);
+
 // Test whether the given tile can be walked onto, if the peep is currently at height currentZ and
 // moving in direction currentDirection.
 bool IsValidPathZAndDirection(TileElement* tileElement, int32_t currentZ, int32_t currentDirection);
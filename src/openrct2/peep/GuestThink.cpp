@@ -0,0 +1,284 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2021 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "GuestThink.h"
+
+#include "../Game.h"
+#include "../config/Config.h"
+#include "../core/JobPool.h"
+#include "../entity/EntityList.h"
+#include "../entity/EntityRegistry.h"
+#include "../entity/Guest.h"
+#include "GuestPathfinding.h"
+#include "SurroundingsCache.h"
+
+#include <memory>
+#include <vector>
+
+namespace OpenRCT2::GuestThink
+{
+    // Below this many guests the thread hand-off costs more than it saves.
+    static constexpr size_t MinimumCandidates = 4;
+
+    // Surroundings assessment looks 160 units around the tile the guest stands on.
+    static constexpr int32_t SurroundingsRange = 160 + COORDS_XY_STEP;
+
+    static constexpr uint32_t NoResult = std::numeric_limits<uint32_t>::max();
+
+    struct ThinkResult
+    {
+        Guest* Peep{};
+        uint16_t SpriteIndex{};
+        CoordsXYZ Location;
+        bool HasMap{};
+        bool HasRidesToGoOn{};
+        bool HasSurroundingsThought{};
+        bool HasJunction{};
+        PeepThoughtType SurroundingsThought{};
+        Direction JunctionChoice = INVALID_DIRECTION;
+        OpenRCT2::BitSet<MAX_RIDES> RidesToGoOn;
+        PathfindJunction Junction;
+    };
+
+    static std::unique_ptr<JobPool> _thinkJobs;
+    static std::vector<ThinkResult> _results;
+    static std::vector<uint32_t> _resultIndex;
+    static std::vector<CoordsXY> _changedLocations;
+    static bool _pathsChanged;
+    static bool _active;
+    static Stats _stats;
+
+    static bool WillPickRide(const Guest& guest)
+    {
+        // Mirrors the early outs of Guest::PickRideToGoOn.
+        return guest.State == PeepState::Walking && guest.GuestHeadingToRideId == RIDE_ID_NULL
+            && !(guest.PeepFlags & PEEP_FLAGS_LEAVING_PARK) && !guest.HasFoodOrDrink();
+    }
+
+    static bool WillAssessSurroundings(const Guest& guest)
+    {
+        // Mirrors the surroundings thought timeout in Guest::Tick128UpdateGuest.
+        return (guest.State == PeepState::Walking || guest.State == PeepState::Sitting)
+            && guest.SurroundingsThoughtTimeout + 1 >= 18;
+    }
+
+    static bool WillReachJunction(const Guest& guest)
+    {
+        // Mirrors the walking speed logic of Peep::Update and the destination check of Peep::UpdateAction. Guests
+        // take at most one step per tick, those already at their destination pathfind before moving.
+        if (guest.State != PeepState::Walking || !guest.IsActionWalking() || guest.GuestHeadingToRideId == RIDE_ID_NULL)
+            return false;
+
+        uint32_t stepsToTake = guest.Energy;
+        if (guest.PeepFlags & PEEP_FLAGS_SLOW_WALK)
+            stepsToTake /= 2;
+        if (guest.GetNextIsSloped())
+            stepsToTake /= 2;
+        if (guest.StepProgress + stepsToTake <= 255)
+            return false;
+
+        const auto destination = guest.GetDestination();
+        return std::abs(guest.x - destination.x) + std::abs(guest.y - destination.y) <= guest.DestinationTolerance;
+    }
+
+    static void Think(ThinkResult& result)
+    {
+        const auto& guest = *result.Peep;
+        if (result.HasRidesToGoOn)
+        {
+            result.RidesToGoOn = guest.FindRidesToGoOn();
+        }
+        if (result.HasSurroundingsThought)
+        {
+            const auto& loc = result.Location;
+            result.SurroundingsThought = peep_assess_surroundings(loc.x & 0xFFE0, loc.y & 0xFFE0, loc.z);
+        }
+        if (result.HasJunction)
+        {
+            auto junction = guest_pathfind_get_ride_junction(guest);
+            result.HasJunction = junction.has_value();
+            if (junction.has_value())
+            {
+                result.Junction = *junction;
+                result.JunctionChoice = peep_pathfind_search_junction(result.Junction, result.Peep);
+            }
+        }
+    }
+
+    void Prepare()
+    {
+        if (!gConfigGeneral.multithreaded_guest_update)
+        {
+            _thinkJobs.reset();
+            return;
+        }
+
+        // Guests are indexed in the same order peep_update_all visits them.
+        int32_t index = 0;
+        for (auto* guest : EntityList<Guest>())
+        {
+            const auto guestIndex = index++;
+            if (guest->x == LOCATION_NULL)
+                continue;
+
+            // Junctions are reached on any tick, the other queries are only made on the tick of the guest.
+            const bool isThinkTick = static_cast<uint32_t>(guestIndex & 0x1FF) == (gCurrentTicks & 0x1FF);
+            const bool pickRide = isThinkTick && WillPickRide(*guest);
+            const bool assessSurroundings = isThinkTick && WillAssessSurroundings(*guest);
+            const bool reachJunction = WillReachJunction(*guest);
+            if (!pickRide && !assessSurroundings && !reachJunction)
+                continue;
+
+            auto& result = _results.emplace_back();
+            result.Peep = guest;
+            result.SpriteIndex = guest->sprite_index;
+            result.Location = guest->GetLocation();
+            result.HasMap = guest->HasItem(ShopItem::Map);
+            result.HasRidesToGoOn = pickRide;
+            result.HasSurroundingsThought = assessSurroundings;
+            result.HasJunction = reachJunction;
+        }
+
+        if (_results.size() < MinimumCandidates)
+        {
+            _results.clear();
+            return;
+        }
+
+        // The jobs may only read the surroundings cache, so fill it for every guest beforehand.
+        for (const auto& result : _results)
+        {
+            if (result.HasSurroundingsThought)
+            {
+                const auto centre = CoordsXY{ result.Location.x & 0xFFE0, result.Location.y & 0xFFE0 };
+                SurroundingsCache::GetSummary(centre);
+                SurroundingsCache::CountLitter(centre);
+            }
+        }
+
+        if (_thinkJobs == nullptr)
+        {
+            _thinkJobs = std::make_unique<JobPool>();
+        }
+        _thinkJobs->ParallelFor(0, _results.size(), 1, [](size_t i) { Think(_results[i]); });
+
+        if (_resultIndex.empty())
+        {
+            _resultIndex.resize(MAX_ENTITIES, NoResult);
+        }
+        for (size_t i = 0; i < _results.size(); i++)
+        {
+            _resultIndex[_results[i].SpriteIndex] = static_cast<uint32_t>(i);
+        }
+        _active = true;
+    }
+
+    void Finish()
+    {
+        for (const auto& result : _results)
+        {
+            _resultIndex[result.SpriteIndex] = NoResult;
+        }
+        _results.clear();
+        _changedLocations.clear();
+        _pathsChanged = false;
+        _active = false;
+    }
+
+    void InvalidateLocation(const CoordsXY& loc)
+    {
+        if (_active)
+        {
+            _changedLocations.push_back(loc);
+        }
+    }
+
+    void InvalidatePaths()
+    {
+        if (_active)
+        {
+            _pathsChanged = true;
+        }
+    }
+
+    static ThinkResult* GetResult(const Guest& guest)
+    {
+        if (!_active)
+            return nullptr;
+
+        auto resultIndex = _resultIndex[guest.sprite_index];
+        if (resultIndex == NoResult)
+            return nullptr;
+
+        auto& result = _results[resultIndex];
+        if (result.Peep != &guest || result.Location != guest.GetLocation())
+            return nullptr;
+
+        return &result;
+    }
+
+    bool TryTakeRidesToGoOn(const Guest& guest, OpenRCT2::BitSet<MAX_RIDES>& rides)
+    {
+        auto* result = GetResult(guest);
+        if (result == nullptr || !result->HasRidesToGoOn || result->HasMap != guest.HasItem(ShopItem::Map))
+            return false;
+
+        // Only valid for the first query, the guest may have ridden something afterwards.
+        result->HasRidesToGoOn = false;
+        rides = result->RidesToGoOn;
+        _stats.RidesToGoOn++;
+        return true;
+    }
+
+    bool TryTakeSurroundingsThought(const Guest& guest, PeepThoughtType& thought)
+    {
+        auto* result = GetResult(guest);
+        if (result == nullptr || !result->HasSurroundingsThought)
+            return false;
+
+        result->HasSurroundingsThought = false;
+        for (const auto& changedLoc : _changedLocations)
+        {
+            if (std::abs(changedLoc.x - result->Location.x) <= SurroundingsRange
+                && std::abs(changedLoc.y - result->Location.y) <= SurroundingsRange)
+            {
+                return false;
+            }
+        }
+        thought = result->SurroundingsThought;
+        _stats.SurroundingsThoughts++;
+        return true;
+    }
+
+    bool TryTakeJunctionChoice(const Guest& guest, const PathfindJunction& junction, Direction& direction)
+    {
+        auto* result = GetResult(guest);
+        if (result == nullptr || !result->HasJunction)
+            return false;
+
+        // Only valid for the junction the guest stands at, it leaves it afterwards.
+        result->HasJunction = false;
+        if (_pathsChanged || !(result->Junction == junction))
+            return false;
+
+        direction = result->JunctionChoice;
+        _stats.JunctionChoices++;
+        return true;
+    }
+
+    Stats GetStats()
+    {
+        return _stats;
+    }
+
+    void ResetStats()
+    {
+        _stats = {};
+    }
+} // namespace OpenRCT2::GuestThink
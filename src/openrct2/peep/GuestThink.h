@@ -0,0 +1,64 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2021 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#pragma once
+
+#include "../core/BitSet.hpp"
+#include "../ride/Ride.h"
+#include "../world/Location.hpp"
+
+struct Guest;
+struct PathfindJunction;
+enum class PeepThoughtType : uint8_t;
+
+/**
+ * Think phase of the guest update. Before guests are updated one by one, the read-only queries they are going to make
+ * this tick (ride consideration, surroundings assessment and the heuristic search at the junction they are about to
+ * leave) are evaluated in parallel. The serial update then takes
+ * those results instead of computing them, after checking that nothing the query depends on has changed in the
+ * meantime. The outcome is always identical to the serial update, so it is safe for multiplayer.
+ */
+namespace OpenRCT2::GuestThink
+{
+    /**
+     * Number of results of each query the serial update took instead of computing them.
+     */
+    struct Stats
+    {
+        uint64_t RidesToGoOn{};
+        uint64_t SurroundingsThoughts{};
+        uint64_t JunctionChoices{};
+    };
+
+    /**
+     * Runs the think phase for the guests that are due for their 128 tick update, must be called before the guests are
+     * updated and followed by Finish once they are.
+     */
+    void Prepare();
+    void Finish();
+
+    /**
+     * Records a change to litter or path additions made during the serial update, results of guests near the
+     * location are discarded.
+     */
+    void InvalidateLocation(const CoordsXY& loc);
+
+    /**
+     * Records a change to the paths, banners, entrances or tracks made during the serial update, none of the junction
+     * searches are used afterwards.
+     */
+    void InvalidatePaths();
+
+    bool TryTakeRidesToGoOn(const Guest& guest, OpenRCT2::BitSet<MAX_RIDES>& result);
+    bool TryTakeSurroundingsThought(const Guest& guest, PeepThoughtType& result);
+    bool TryTakeJunctionChoice(const Guest& guest, const PathfindJunction& junction, Direction& result);
+
+    Stats GetStats();
+    void ResetStats();
+} // namespace OpenRCT2::GuestThink
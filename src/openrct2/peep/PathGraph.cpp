@@ -0,0 +1,649 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2021 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "PathGraph.h"
+
+#include "../Context.h"
+#include "../ReplayManager.h"
+#include "../config/Config.h"
+#include "../network/network.h"
+#include "../ride/Ride.h"
+#include "../ride/RideData.h"
+#include "../ride/Track.h"
+#include "../util/Util.h"
+#include "../world/Entrance.h"
+#include "../world/Footpath.h"
+#include "../world/Map.h"
+#include "GuestPathfinding.h"
+#include "GuestThink.h"
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <unordered_map>
+#include <vector>
+
+namespace OpenRCT2::PathGraph
+{
+    static constexpr uint32_t NODE_NONE = std::numeric_limits<uint32_t>::max();
+    static constexpr uint16_t DISTANCE_NONE = std::numeric_limits<uint16_t>::max();
+
+    // Enough for a table per ride and park entrance of most parks, at two bytes per path tile each.
+    static constexpr size_t MAX_ROUTING_TABLES = 128;
+
+    // Setters called this many times before the graph is needed are most likely changing the whole map, which is
+    // compiled again instead.
+    static constexpr size_t MAX_DIRTY_ELEMENTS = 1024;
+
+    struct Step
+    {
+        uint32_t Target;
+        Direction Edge;
+
+        bool operator==(const Step& other) const
+        {
+            return Target == other.Target && Edge == other.Edge;
+        }
+    };
+
+    // The non-ghost path elements at the same height of a tile.
+    struct Node
+    {
+        TileCoordsXYZ Loc;
+        // Edges guests may leave through, after 'no entry' signs.
+        uint8_t Edges;
+        // Slope direction of the first path element, which the heuristic search uses for the whole tile.
+        Direction SlopeDirection;
+        // Ride of a queue tile that guests heading elsewhere do not walk through.
+        ride_id_t QueueRideIndex;
+        std::vector<Step> StepsFrom;
+        // The nodes with a step into this one, once per step.
+        std::vector<uint32_t> StepsTo;
+
+        bool HasSameProperties(const Node& other) const
+        {
+            return Edges == other.Edges && SlopeDirection == other.SlopeDirection
+                && QueueRideIndex == other.QueueRideIndex;
+        }
+    };
+
+    struct RoutingTable
+    {
+        TileCoordsXYZ Goal;
+        ride_id_t QueueRideIndex;
+        bool IgnoreForeignQueues;
+        uint32_t LastUsed;
+        // Steps to the goal through each node, DISTANCE_NONE where the goal can not be reached.
+        std::vector<uint16_t> Distances;
+    };
+
+    static bool _isDirty = true;
+    static std::vector<TileCoordsXY> _dirtyTiles;
+    static std::vector<const TileElement*> _dirtyElements;
+    // Nodes keep their index for as long as they exist, the indices of removed ones are reused.
+    static std::vector<Node> _nodes;
+    static std::vector<uint32_t> _freeNodes;
+    // The nodes of each tile with paths, sorted by height.
+    static std::unordered_map<uint32_t, std::vector<uint32_t>> _tileNodes;
+    static std::vector<RoutingTable> _routingTables;
+    static uint32_t _routingTableUseCounter;
+    static Stats _stats;
+
+    static uint32_t GetTileKey(const TileCoordsXY& tile)
+    {
+        return (static_cast<uint32_t>(tile.x) << 16) | static_cast<uint16_t>(tile.y);
+    }
+
+    static const std::vector<uint32_t>& GetTileNodes(const TileCoordsXY& tile)
+    {
+        static const std::vector<uint32_t> noNodes;
+        auto it = _tileNodes.find(GetTileKey(tile));
+        return it != _tileNodes.end() ? it->second : noNodes;
+    }
+
+    static uint32_t FindNode(const TileCoordsXYZ& loc)
+    {
+        for (auto nodeIndex : GetTileNodes({ loc.x, loc.y }))
+        {
+            if (_nodes[nodeIndex].Loc.z == loc.z)
+                return nodeIndex;
+        }
+        return NODE_NONE;
+    }
+
+    // Height at which a guest leaving the node through edge enters the next tile.
+    static int32_t GetExitHeight(const Node& node, Direction edge)
+    {
+        return node.SlopeDirection == edge ? node.Loc.z + 2 : node.Loc.z;
+    }
+
+    static bool IsBlocked(const Node& node, ride_id_t queueRideIndex, bool ignoreForeignQueues)
+    {
+        return ignoreForeignQueues && node.QueueRideIndex != RIDE_ID_NULL && node.QueueRideIndex != queueRideIndex;
+    }
+
+    // The nodes of the tile as its elements are now, sorted by height and without any steps.
+    static std::vector<Node> ReadTileNodes(const TileCoordsXY& tile)
+    {
+        std::vector<Node> nodes;
+        auto* tileElement = map_get_first_element_at(tile);
+        if (tileElement == nullptr)
+            return nodes;
+
+        do
+        {
+            if (tileElement->IsGhost() || tileElement->GetType() != TileElementType::Path)
+                continue;
+
+            auto* pathElement = tileElement->AsPath();
+            const TileCoordsXYZ loc{ tile, tileElement->base_height };
+            auto it = std::find_if(nodes.begin(), nodes.end(), [&loc](const Node& node) { return node.Loc == loc; });
+            if (it == nodes.end())
+            {
+                auto slopeDirection = pathElement->IsSloped() ? pathElement->GetSlopeDirection() : INVALID_DIRECTION;
+                it = nodes.insert(nodes.end(), Node{ loc, 0, slopeDirection, RIDE_ID_NULL, {}, {} });
+            }
+
+            it->Edges |= path_get_guest_permitted_edges(pathElement);
+            if (pathElement->IsQueue() && bitcount(pathElement->GetEdges()) == 2 && it->QueueRideIndex == RIDE_ID_NULL)
+            {
+                it->QueueRideIndex = pathElement->GetRideIndex();
+            }
+        } while (!(tileElement++)->IsLastForTile());
+
+        std::sort(nodes.begin(), nodes.end(), [](const Node& a, const Node& b) { return a.Loc.z < b.Loc.z; });
+        return nodes;
+    }
+
+    static uint32_t AddNode(Node&& node)
+    {
+        if (!_freeNodes.empty())
+        {
+            const auto nodeIndex = _freeNodes.back();
+            _freeNodes.pop_back();
+            _nodes[nodeIndex] = std::move(node);
+            return nodeIndex;
+        }
+        _nodes.push_back(std::move(node));
+        return static_cast<uint32_t>(_nodes.size() - 1);
+    }
+
+    static void ClearNodeSteps(uint32_t nodeIndex)
+    {
+        auto& node = _nodes[nodeIndex];
+        for (const auto& step : node.StepsFrom)
+        {
+            auto& stepsTo = _nodes[step.Target].StepsTo;
+            stepsTo.erase(std::find(stepsTo.begin(), stepsTo.end(), nodeIndex));
+        }
+        node.StepsFrom.clear();
+    }
+
+    // Adds the steps the heuristic search would take out of the node, through each of its edges onto every path there
+    // it can walk.
+    static void AddNodeSteps(uint32_t nodeIndex)
+    {
+        auto& node = _nodes[nodeIndex];
+        for (Direction edge = 0; edge < NumOrthogonalDirections; edge++)
+        {
+            if (!(node.Edges & (1 << edge)))
+                continue;
+
+            const auto height = GetExitHeight(node, edge);
+            const auto tile = TileCoordsXY{ node.Loc.x, node.Loc.y } + TileDirectionDelta[edge];
+            auto* tileElement = map_get_first_element_at(tile);
+            if (tileElement == nullptr)
+                continue;
+
+            do
+            {
+                if (tileElement->IsGhost() || tileElement->GetType() != TileElementType::Path)
+                    continue;
+                if (!IsValidPathZAndDirection(tileElement, height, edge))
+                    continue;
+
+                const Step step{ FindNode({ tile, tileElement->base_height }), edge };
+                const auto isDuplicate = std::find(node.StepsFrom.begin(), node.StepsFrom.end(), step)
+                    != node.StepsFrom.end();
+                if (step.Target != NODE_NONE && !isDuplicate)
+                {
+                    node.StepsFrom.push_back(step);
+                    _nodes[step.Target].StepsTo.push_back(nodeIndex);
+                }
+            } while (!(tileElement++)->IsLastForTile());
+        }
+    }
+
+    static void Compile()
+    {
+        _nodes.clear();
+        _freeNodes.clear();
+        _tileNodes.clear();
+        _routingTables.clear();
+        _dirtyTiles.clear();
+        _dirtyElements.clear();
+
+        for (int32_t x = 0; x < gMapSize; x++)
+        {
+            for (int32_t y = 0; y < gMapSize; y++)
+            {
+                auto nodes = ReadTileNodes({ x, y });
+                if (nodes.empty())
+                    continue;
+
+                auto& tileNodes = _tileNodes[GetTileKey({ x, y })];
+                for (auto& node : nodes)
+                {
+                    tileNodes.push_back(AddNode(std::move(node)));
+                }
+            }
+        }
+
+        const auto numNodes = static_cast<uint32_t>(_nodes.size());
+        for (uint32_t i = 0; i < numNodes; i++)
+        {
+            AddNodeSteps(i);
+        }
+
+        _isDirty = false;
+        _stats.Compiles++;
+    }
+
+    // Reads the nodes of the tile again and the steps around them, returning whether anything guests walk through
+    // changed.
+    static bool PatchTile(const TileCoordsXY& tile)
+    {
+        bool hasChanged = false;
+        const auto oldNodes = GetTileNodes(tile);
+        std::vector<uint32_t> newNodes;
+        for (auto& node : ReadTileNodes(tile))
+        {
+            auto it = std::find_if(oldNodes.begin(), oldNodes.end(), [&node](uint32_t nodeIndex) {
+                return _nodes[nodeIndex].Loc == node.Loc;
+            });
+            if (it == oldNodes.end())
+            {
+                newNodes.push_back(AddNode(std::move(node)));
+                hasChanged = true;
+            }
+            else
+            {
+                auto& oldNode = _nodes[*it];
+                if (!oldNode.HasSameProperties(node))
+                {
+                    oldNode.Edges = node.Edges;
+                    oldNode.SlopeDirection = node.SlopeDirection;
+                    oldNode.QueueRideIndex = node.QueueRideIndex;
+                    hasChanged = true;
+                }
+                newNodes.push_back(*it);
+            }
+        }
+
+        std::vector<uint32_t> removedNodes;
+        for (auto nodeIndex : oldNodes)
+        {
+            if (std::find(newNodes.begin(), newNodes.end(), nodeIndex) == newNodes.end())
+            {
+                ClearNodeSteps(nodeIndex);
+                removedNodes.push_back(nodeIndex);
+                hasChanged = true;
+            }
+        }
+
+        if (newNodes.empty())
+            _tileNodes.erase(GetTileKey(tile));
+        else
+            _tileNodes[GetTileKey(tile)] = newNodes;
+
+        // Every step into or out of the tile starts on it or on one of its neighbours. Stepping into removed nodes
+        // stops here as well, as they can no longer be found.
+        for (int32_t i = -1; i < NumOrthogonalDirections; i++)
+        {
+            const auto neighbour = i < 0 ? tile : tile + TileDirectionDelta[i];
+            for (auto nodeIndex : GetTileNodes(neighbour))
+            {
+                const auto oldSteps = _nodes[nodeIndex].StepsFrom;
+                ClearNodeSteps(nodeIndex);
+                AddNodeSteps(nodeIndex);
+                if (_nodes[nodeIndex].StepsFrom != oldSteps)
+                {
+                    hasChanged = true;
+                }
+            }
+        }
+
+        for (auto nodeIndex : removedNodes)
+        {
+            _nodes[nodeIndex] = {};
+            _freeNodes.push_back(nodeIndex);
+        }
+
+        _stats.PatchedTiles++;
+        return hasChanged;
+    }
+
+    // Finds the tiles of the elements changed through their setters. Those of paths in the graph are on tiles with
+    // nodes, new ones on tiles already marked dirty when they were inserted. Anything else, such as an element that
+    // moved when its tile was changed afterwards, compiles the whole graph again.
+    static void FindDirtyElementTiles()
+    {
+        std::sort(_dirtyElements.begin(), _dirtyElements.end(), std::less<>());
+        auto removeElementsOnTile = [](const TileCoordsXY& tile) {
+            const auto* first = map_get_first_element_at(tile);
+            if (first == nullptr)
+                return false;
+
+            const auto* last = first;
+            while (!last->IsLastForTile())
+            {
+                last++;
+            }
+            auto begin = std::lower_bound(_dirtyElements.begin(), _dirtyElements.end(), first, std::less<>());
+            auto end = std::upper_bound(begin, _dirtyElements.end(), last, std::less<>());
+            const auto isOnTile = begin != end;
+            _dirtyElements.erase(begin, end);
+            return isOnTile;
+        };
+
+        for (const auto& tile : _dirtyTiles)
+        {
+            removeElementsOnTile(tile);
+        }
+        for (const auto& tileNodes : _tileNodes)
+        {
+            if (_dirtyElements.empty())
+                break;
+
+            const auto& loc = _nodes[tileNodes.second.front()].Loc;
+            if (removeElementsOnTile({ loc.x, loc.y }))
+            {
+                _dirtyTiles.push_back({ loc.x, loc.y });
+            }
+        }
+
+        if (!_dirtyElements.empty())
+        {
+            Invalidate();
+        }
+        _dirtyElements.clear();
+    }
+
+    static void Update()
+    {
+        if (!_dirtyElements.empty())
+        {
+            FindDirtyElementTiles();
+        }
+        if (_isDirty)
+        {
+            Compile();
+            return;
+        }
+        if (_dirtyTiles.empty())
+            return;
+
+        std::sort(_dirtyTiles.begin(), _dirtyTiles.end(), [](const TileCoordsXY& a, const TileCoordsXY& b) {
+            return GetTileKey(a) < GetTileKey(b);
+        });
+        _dirtyTiles.erase(std::unique(_dirtyTiles.begin(), _dirtyTiles.end()), _dirtyTiles.end());
+
+        bool hasChanged = false;
+        for (const auto& tile : _dirtyTiles)
+        {
+            // Whether guests arrive at a goal depends on the entrances and track of its tile as well.
+            _routingTables.erase(
+                std::remove_if(
+                    _routingTables.begin(), _routingTables.end(),
+                    [&tile](const RoutingTable& table) { return table.Goal.x == tile.x && table.Goal.y == tile.y; }),
+                _routingTables.end());
+            if (PatchTile(tile))
+            {
+                hasChanged = true;
+            }
+        }
+        _dirtyTiles.clear();
+
+        if (hasChanged)
+        {
+            _routingTables.clear();
+        }
+    }
+
+    // Whether a guest entering the goal tile at height through edge has arrived, matching the elements the heuristic
+    // search stops at.
+    static bool ReachesGoal(const TileCoordsXYZ& goal, int32_t height, Direction edge)
+    {
+        auto* tileElement = map_get_first_element_at(TileCoordsXY{ goal.x, goal.y });
+        if (tileElement == nullptr)
+            return false;
+
+        do
+        {
+            if (tileElement->IsGhost())
+                continue;
+
+            switch (tileElement->GetType())
+            {
+                case TileElementType::Path:
+                    if (tileElement->base_height == goal.z && IsValidPathZAndDirection(tileElement, height, edge))
+                        return true;
+                    break;
+                case TileElementType::Entrance:
+                    if (tileElement->base_height != goal.z || height != goal.z)
+                        break;
+                    switch (tileElement->AsEntrance()->GetEntranceType())
+                    {
+                        case ENTRANCE_TYPE_PARK_ENTRANCE:
+                            return true;
+                        case ENTRANCE_TYPE_RIDE_ENTRANCE:
+                        case ENTRANCE_TYPE_RIDE_EXIT:
+                            if (tileElement->GetDirection() == edge)
+                                return true;
+                            break;
+                    }
+                    break;
+                case TileElementType::Track:
+                {
+                    if (tileElement->base_height != goal.z || height != goal.z)
+                        break;
+                    auto ride = get_ride(tileElement->AsTrack()->GetRideIndex());
+                    if (ride != nullptr && ride->GetRideTypeDescriptor().HasFlag(RIDE_TYPE_FLAG_IS_SHOP))
+                        return true;
+                    break;
+                }
+                default:
+                    break;
+            }
+        } while (!(tileElement++)->IsLastForTile());
+        return false;
+    }
+
+    // Breadth first search back from the goal through the nodes guests can walk through.
+    static void BuildRoutingTable(RoutingTable& table)
+    {
+        auto& distances = table.Distances;
+        distances.assign(_nodes.size(), DISTANCE_NONE);
+
+        std::vector<uint32_t> queue;
+        for (Direction edge = 0; edge < NumOrthogonalDirections; edge++)
+        {
+            const auto tile = TileCoordsXY{ table.Goal.x, table.Goal.y } + TileDirectionDelta[direction_reverse(edge)];
+            for (auto nodeIndex : GetTileNodes(tile))
+            {
+                const auto& node = _nodes[nodeIndex];
+                if (!(node.Edges & (1 << edge)) || distances[nodeIndex] != DISTANCE_NONE)
+                    continue;
+                if (IsBlocked(node, table.QueueRideIndex, table.IgnoreForeignQueues))
+                    continue;
+                if (ReachesGoal(table.Goal, GetExitHeight(node, edge), edge))
+                {
+                    distances[nodeIndex] = 1;
+                    queue.push_back(nodeIndex);
+                }
+            }
+        }
+
+        for (size_t head = 0; head < queue.size(); head++)
+        {
+            const auto nodeIndex = queue[head];
+            const auto distance = distances[nodeIndex];
+            if (distance == DISTANCE_NONE - 1)
+                continue;
+
+            for (auto source : _nodes[nodeIndex].StepsTo)
+            {
+                if (distances[source] != DISTANCE_NONE)
+                    continue;
+                if (IsBlocked(_nodes[source], table.QueueRideIndex, table.IgnoreForeignQueues))
+                    continue;
+                distances[source] = distance + 1;
+                queue.push_back(source);
+            }
+        }
+    }
+
+    static const RoutingTable& GetRoutingTable(const TileCoordsXYZ& goal, ride_id_t queueRideIndex, bool ignoreForeignQueues)
+    {
+        _routingTableUseCounter++;
+        for (auto& table : _routingTables)
+        {
+            if (table.Goal == goal && table.QueueRideIndex == queueRideIndex
+                && table.IgnoreForeignQueues == ignoreForeignQueues)
+            {
+                table.LastUsed = _routingTableUseCounter;
+                return table;
+            }
+        }
+
+        RoutingTable* table;
+        if (_routingTables.size() < MAX_ROUTING_TABLES)
+        {
+            table = &_routingTables.emplace_back();
+        }
+        else
+        {
+            table = &*std::min_element(_routingTables.begin(), _routingTables.end(), [](const auto& a, const auto& b) {
+                return a.LastUsed < b.LastUsed;
+            });
+        }
+        table->Goal = goal;
+        table->QueueRideIndex = queueRideIndex;
+        table->IgnoreForeignQueues = ignoreForeignQueues;
+        table->LastUsed = _routingTableUseCounter;
+        BuildRoutingTable(*table);
+        return *table;
+    }
+
+    void Invalidate()
+    {
+        GuestThink::InvalidatePaths();
+        _isDirty = true;
+    }
+
+    void InvalidateTile(const CoordsXY& loc)
+    {
+        GuestThink::InvalidatePaths();
+        if (!_isDirty)
+        {
+            _dirtyTiles.push_back(TileCoordsXY{ loc });
+        }
+    }
+
+    void InvalidateElement(const TileElement* tileElement)
+    {
+        GuestThink::InvalidatePaths();
+
+        // Ghosts are not part of the graph, new elements are still ghosts when they become one.
+        if (_isDirty || tileElement->IsGhost())
+            return;
+
+        if (_dirtyElements.size() >= MAX_DIRTY_ELEMENTS)
+        {
+            _dirtyElements.clear();
+            Invalidate();
+            return;
+        }
+        _dirtyElements.push_back(tileElement);
+    }
+
+    bool IsImprovedModeActive()
+    {
+        if (!gConfigGeneral.improved_guest_pathfinding)
+            return false;
+        if (network_get_mode() != NETWORK_MODE_NONE)
+            return false;
+
+        auto* context = GetContext();
+        if (context != nullptr)
+        {
+            auto* replayManager = context->GetReplayManager();
+            if (replayManager != nullptr
+                && (replayManager->IsReplaying() || replayManager->IsRecording() || replayManager->IsNormalising()))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    Direction ChooseDirection(
+        const TileCoordsXYZ& loc, uint8_t edges, const TileCoordsXYZ& goal, ride_id_t queueRideIndex,
+        bool ignoreForeignQueues)
+    {
+        Update();
+        _stats.Queries++;
+
+        const auto nodeIndex = FindNode(loc);
+        if (nodeIndex == NODE_NONE)
+            return INVALID_DIRECTION;
+
+        const auto& node = _nodes[nodeIndex];
+        const auto& table = GetRoutingTable(goal, queueRideIndex, ignoreForeignQueues);
+        Direction bestEdge = INVALID_DIRECTION;
+        uint32_t bestDistance = DISTANCE_NONE;
+        for (Direction edge = 0; edge < NumOrthogonalDirections; edge++)
+        {
+            if (!(edges & (1 << edge)))
+                continue;
+
+            if (ReachesGoal(goal, GetExitHeight(node, edge), edge))
+            {
+                _stats.RoutedDirections++;
+                return edge;
+            }
+
+            for (const auto& step : node.StepsFrom)
+            {
+                // Foreign queues have no distance, so this also keeps guests out of them.
+                if (step.Edge != edge || table.Distances[step.Target] >= bestDistance)
+                    continue;
+                bestEdge = edge;
+                bestDistance = table.Distances[step.Target];
+            }
+        }
+        if (bestEdge != INVALID_DIRECTION)
+        {
+            _stats.RoutedDirections++;
+        }
+        return bestEdge;
+    }
+
+    Stats GetStats()
+    {
+        auto stats = _stats;
+        stats.Nodes = _nodes.size() - _freeNodes.size();
+        return stats;
+    }
+
+    void ResetStats()
+    {
+        _stats = {};
+    }
+} // namespace OpenRCT2::PathGraph
@@ -0,0 +1,68 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2021 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#pragma once
+
+#include "../common.h"
+#include "../ride/RideTypes.h"
+#include "../world/Location.hpp"
+
+struct TileElement;
+
+/**
+ * The footpaths compiled into a graph of path tiles, with a table per pathfinding goal of the number of steps from every
+ * path tile to the goal. Guests consult these in the improved pathfinding mode instead of running the heuristic search
+ * at every junction.
+ *
+ * The heuristic search gives up on distant goals and is what every client of a network game or replay computes, so the
+ * tables are only consulted when nothing needs to match it: the improved mode is only active in single player games
+ * with improved_guest_pathfinding enabled and no replay being recorded or played back.
+ */
+namespace OpenRCT2::PathGraph
+{
+    struct Stats
+    {
+        size_t Nodes{};
+        uint64_t Compiles{};
+        uint64_t PatchedTiles{};
+        uint64_t Queries{};
+        uint64_t RoutedDirections{};
+    };
+
+    /**
+     * Marks the whole graph as out of date, it is compiled again the next time it is needed. Called when the map is
+     * replaced or changed everywhere at once.
+     */
+    void Invalidate();
+
+    /**
+     * Marks the paths of a tile as out of date, along with the goals on it. Called when path, banner, entrance or track
+     * elements are inserted on or removed from the tile; the graph is patched around it the next time it is needed.
+     */
+    void InvalidateTile(const CoordsXY& loc);
+
+    /**
+     * Marks the tile of a path or banner element as out of date after one of its setters changed it. Setters do not
+     * know where their element is, the tile is looked up when the graph is next needed.
+     */
+    void InvalidateElement(const TileElement* tileElement);
+
+    bool IsImprovedModeActive();
+
+    /**
+     * Returns the direction out of the edges of the path at loc that leads to the goal in the fewest steps, lowest
+     * direction first, or INVALID_DIRECTION if none of them leads to the goal.
+     */
+    Direction ChooseDirection(
+        const TileCoordsXYZ& loc, uint8_t edges, const TileCoordsXYZ& goal, ride_id_t queueRideIndex,
+        bool ignoreForeignQueues);
+
+    Stats GetStats();
+    void ResetStats();
+} // namespace OpenRCT2::PathGraph
@@ -0,0 +1,242 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2021 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "SurroundingsCache.h"
+
+#include "../entity/EntityList.h"
+#include "../entity/Litter.h"
+#include "../entity/LitterIndex.h"
+#include "../world/Footpath.h"
+#include "../world/Map.h"
+#include "../world/TileElementsView.h"
+
+#include <algorithm>
+#include <unordered_map>
+
+namespace OpenRCT2::SurroundingsCache
+{
+    struct CacheEntry
+    {
+        Summary Tiles;
+        uint16_t Litter{};
+        bool TilesValid{};
+        bool LitterValid{};
+    };
+
+    static std::unordered_map<uint32_t, CacheEntry> _entries;
+
+    static bool IsCached(const CoordsXY& centre)
+    {
+        return map_is_location_valid(centre) && centre == centre.ToTileStart();
+    }
+
+    static uint32_t GetKey(const TileCoordsXY& tile)
+    {
+        return static_cast<uint32_t>(tile.x) * MAXIMUM_MAP_SIZE_TECHNICAL + tile.y;
+    }
+
+    static CacheEntry* FindEntry(const TileCoordsXY& tile)
+    {
+        if (tile.x < 0 || tile.y < 0 || tile.x >= MAXIMUM_MAP_SIZE_TECHNICAL || tile.y >= MAXIMUM_MAP_SIZE_TECHNICAL)
+            return nullptr;
+
+        auto it = _entries.find(GetKey(tile));
+        return it != _entries.end() ? &it->second : nullptr;
+    }
+
+    static CacheEntry& GetEntry(const CoordsXY& centre)
+    {
+        const auto tile = TileCoordsXY(centre);
+        auto* entry = FindEntry(tile);
+        if (entry == nullptr)
+        {
+            entry = &_entries[GetKey(tile)];
+        }
+        return *entry;
+    }
+
+    static void AddPathAddition(Summary& summary, const PathElement& pathElement)
+    {
+        const auto entryIndex = pathElement.GetAdditionEntryIndex();
+        auto it = std::find_if(summary.PathAdditions.begin(), summary.PathAdditions.end(), [entryIndex](const auto& addition) {
+            return addition.EntryIndex == entryIndex;
+        });
+        if (it == summary.PathAdditions.end())
+        {
+            it = summary.PathAdditions.insert(it, PathAdditionCount{ entryIndex, 0, 0 });
+        }
+
+        if (pathElement.AdditionIsGhost())
+            return;
+
+        it->Count++;
+        if (pathElement.IsBroken())
+        {
+            it->BrokenCount++;
+        }
+    }
+
+    static void CountTiles(const CoordsXY& centre, Summary& summary)
+    {
+        summary.Scenery = 0;
+        summary.PathAdditions.clear();
+
+        const auto initialX = std::max(centre.x - TileRangeBefore * COORDS_XY_STEP, 0);
+        const auto initialY = std::max(centre.y - TileRangeBefore * COORDS_XY_STEP, 0);
+        const auto finalX = std::min(centre.x + (TileRangeAfter + 1) * COORDS_XY_STEP, MAXIMUM_MAP_SIZE_BIG);
+        const auto finalY = std::min(centre.y + (TileRangeAfter + 1) * COORDS_XY_STEP, MAXIMUM_MAP_SIZE_BIG);
+        for (auto x = initialX; x < finalX; x += COORDS_XY_STEP)
+        {
+            for (auto y = initialY; y < finalY; y += COORDS_XY_STEP)
+            {
+                for (auto* tileElement : TileElementsView({ x, y }))
+                {
+                    switch (tileElement->GetType())
+                    {
+                        case TileElementType::Path:
+                            if (tileElement->AsPath()->HasAddition())
+                            {
+                                AddPathAddition(summary, *tileElement->AsPath());
+                            }
+                            break;
+                        case TileElementType::LargeScenery:
+                        case TileElementType::SmallScenery:
+                            summary.Scenery++;
+                            break;
+                        default:
+                            break;
+                    }
+                }
+            }
+        }
+    }
+
+    static bool IsLitterInRange(const Litter& litter, const CoordsXY& centre)
+    {
+        // Truncated to 16 bits the same way the assessment always has.
+        int16_t distX = abs(litter.x - centre.x);
+        int16_t distY = abs(litter.y - centre.y);
+        return std::max(distX, distY) <= LitterRange;
+    }
+
+    static uint16_t CountPlacedLitter(const CoordsXY& centre)
+    {
+        uint16_t count = 0;
+        for (auto* litter : EntityList<Litter>())
+        {
+            if (map_is_location_valid({ litter->x, litter->y }) && IsLitterInRange(*litter, centre))
+            {
+                count++;
+            }
+        }
+        return count;
+    }
+
+    // Litter outside of the map is still counted as the assessment does not skip it.
+    static uint16_t CountUnplacedLitter(const CoordsXY& centre)
+    {
+        uint16_t count = 0;
+        for (auto spriteIndex : LitterIndex::GetUnplaced())
+        {
+            auto* litter = GetEntity<Litter>(spriteIndex);
+            if (litter != nullptr && IsLitterInRange(*litter, centre))
+            {
+                count++;
+            }
+        }
+        return count;
+    }
+
+    void Reset()
+    {
+        _entries.clear();
+    }
+
+    void InvalidateTile(const CoordsXY& loc)
+    {
+        // Every centre tile whose range includes the tile.
+        const auto tile = TileCoordsXY(loc);
+        for (auto x = tile.x - TileRangeAfter; x <= tile.x + TileRangeBefore; x++)
+        {
+            for (auto y = tile.y - TileRangeAfter; y <= tile.y + TileRangeBefore; y++)
+            {
+                auto* entry = FindEntry({ x, y });
+                if (entry != nullptr)
+                {
+                    entry->TilesValid = false;
+                }
+            }
+        }
+    }
+
+    void InvalidateLitter(const CoordsXY& loc)
+    {
+        if (!map_is_location_valid(loc))
+        {
+            InvalidateAllLitter();
+            return;
+        }
+
+        // Every centre tile whose corner is within range of the litter.
+        const auto tile = TileCoordsXY(loc);
+        const auto tileRange = LitterRange / COORDS_XY_STEP;
+        for (auto x = tile.x - tileRange; x <= tile.x + tileRange; x++)
+        {
+            for (auto y = tile.y - tileRange; y <= tile.y + tileRange; y++)
+            {
+                auto* entry = FindEntry({ x, y });
+                if (entry != nullptr)
+                {
+                    entry->LitterValid = false;
+                }
+            }
+        }
+    }
+
+    void InvalidateAllLitter()
+    {
+        for (auto& entry : _entries)
+        {
+            entry.second.LitterValid = false;
+        }
+    }
+
+    const Summary& GetSummary(const CoordsXY& centre)
+    {
+        if (!IsCached(centre))
+        {
+            static thread_local Summary uncached;
+            CountTiles(centre, uncached);
+            return uncached;
+        }
+
+        auto& entry = GetEntry(centre);
+        if (!entry.TilesValid)
+        {
+            CountTiles(centre, entry.Tiles);
+            entry.TilesValid = true;
+        }
+        return entry.Tiles;
+    }
+
+    uint16_t CountLitter(const CoordsXY& centre)
+    {
+        uint16_t count = CountUnplacedLitter(centre);
+        if (!IsCached(centre))
+            return count + CountPlacedLitter(centre);
+
+        auto& entry = GetEntry(centre);
+        if (!entry.LitterValid)
+        {
+            entry.Litter = CountPlacedLitter(centre);
+            entry.LitterValid = true;
+        }
+        return count + entry.Litter;
+    }
+} // namespace OpenRCT2::SurroundingsCache
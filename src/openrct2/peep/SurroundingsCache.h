@@ -0,0 +1,67 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2021 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#pragma once
+
+#include "../object/Object.h"
+#include "../world/Location.hpp"
+
+#include <vector>
+
+/**
+ * Cache of what guests see around a tile when assessing their surroundings. For every tile a guest has stood on it
+ * keeps the number of scenery elements, path additions and litter within range. Path additions are kept per object so
+ * that loading and unloading objects does not affect the cache, ride music is left to the caller as it depends on the
+ * state of the rides.
+ */
+namespace OpenRCT2::SurroundingsCache
+{
+    // Surroundings are counted over the tiles from 5 tiles before to 4 tiles after the centre tile.
+    constexpr int32_t TileRangeBefore = 5;
+    constexpr int32_t TileRangeAfter = 4;
+
+    // Litter is counted up to 160 units away from the corner of the centre tile.
+    constexpr int32_t LitterRange = 160;
+
+    struct PathAdditionCount
+    {
+        ObjectEntryIndex EntryIndex;
+        uint16_t Count;
+        uint16_t BrokenCount;
+    };
+
+    struct Summary
+    {
+        uint16_t Scenery{};
+
+        // Additions that are ghosts are listed but not counted.
+        std::vector<PathAdditionCount> PathAdditions;
+    };
+
+    /**
+     * Discards the whole cache, used when the tile elements are replaced.
+     */
+    void Reset();
+
+    void InvalidateTile(const CoordsXY& loc);
+
+    /**
+     * Discards the litter counts around a location where litter appeared or disappeared.
+     */
+    void InvalidateLitter(const CoordsXY& loc);
+    void InvalidateAllLitter();
+
+    /**
+     * Returns the summary of the tiles around the tile with its corner at centre. Results that are not cached yet are
+     * computed and stored, so these must be called from the game thread unless the same tile has been queried since
+     * the last change.
+     */
+    const Summary& GetSummary(const CoordsXY& centre);
+    uint16_t CountLitter(const CoordsXY& centre);
+} // namespace OpenRCT2::SurroundingsCache
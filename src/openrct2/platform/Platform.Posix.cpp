@@ -22,6 +22,7 @@
 #    include <ctime>
 #    include <dirent.h>
 #    include <pwd.h>
+#    include <sys/resource.h>
 #    include <sys/stat.h>
 
 namespace Platform
@@ -128,7 +129,7 @@ namespace Platform
             size_t readBytes;
             while ((readBytes = fread(buffer, 1, sizeof(buffer), fpipe)) > 0)
             {
-                outputBuffer.insert(outputBuffer.begin(), buffer, buffer + readBytes);
+                outputBuffer.insert(outputBuffer.end(), buffer, buffer + readBytes);
             }
 
             // Trim line breaks
@@ -161,6 +162,23 @@ namespace Platform
 #    endif // __EMSCRIPTEN__
     }
 
+    uint64_t GetPeakMemoryUsage()
+    {
+        struct rusage usage
+        {
+        };
+        if (getrusage(RUSAGE_SELF, &usage) != 0)
+        {
+            return 0;
+        }
+#    if defined(__APPLE__) && defined(__MACH__)
+        return static_cast<uint64_t>(usage.ru_maxrss);
+#    else
+        // Reported in kilobytes everywhere but on macOS.
+        return static_cast<uint64_t>(usage.ru_maxrss) * 1024;
+#    endif
+    }
+
     uint64_t GetLastModified(const std::string& path)
     {
         uint64_t lastModified = 0;
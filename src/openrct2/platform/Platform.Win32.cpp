@@ -17,6 +17,7 @@
 
 #    include <datetimeapi.h>
 #    include <memory>
+#    include <psapi.h>
 #    include <shlobj.h>
 #    undef GetEnvironmentVariable
 
@@ -536,6 +537,16 @@ namespace Platform
         return -1;
     }
 
+    uint64_t GetPeakMemoryUsage()
+    {
+        PROCESS_MEMORY_COUNTERS counters{};
+        if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+        {
+            return 0;
+        }
+        return counters.PeakWorkingSetSize;
+    }
+
     uint64_t GetLastModified(const std::string& path)
     {
         uint64_t lastModified = 0;
@@ -45,6 +45,8 @@ namespace Platform
     rct2_date GetDateLocal();
     bool FindApp(const std::string& app, std::string* output);
     int32_t Execute(const std::string& command, std::string* output = nullptr);
+    // The most memory the process has had resident, in bytes.
+    uint64_t GetPeakMemoryUsage();
 
 #if defined(__unix__) || (defined(__APPLE__) && defined(__MACH__)) || defined(__FreeBSD__)
     std::string GetEnvironmentPath(const char* name);
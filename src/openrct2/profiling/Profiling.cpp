@@ -0,0 +1,330 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2021 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "Profiling.h"
+
+#include "../core/Json.hpp"
+
+#include <algorithm>
+#include <memory>
+#include <mutex>
+
+namespace OpenRCT2::Profiling
+{
+    // Caps the memory used by a trace to 24 MiB per thread.
+    constexpr size_t MaxTraceEventsPerThread = 1024 * 1024;
+
+    struct TraceEvent
+    {
+        const char* Name;
+        Clock::time_point Start;
+        Clock::duration Duration;
+    };
+
+    struct TraceBuffer
+    {
+        std::mutex Mutex;
+        uint32_t ThreadId{};
+        std::string ThreadName;
+        std::vector<TraceEvent> Events;
+    };
+
+    struct Registry
+    {
+        std::mutex Mutex;
+        std::vector<Function*> Functions;
+    };
+
+    struct TraceState
+    {
+        std::mutex Mutex;
+        std::vector<std::shared_ptr<TraceBuffer>> Buffers;
+        Clock::time_point Start;
+        uint32_t NextThreadId{};
+    };
+
+    static thread_local Function* _currentFunction{};
+    static thread_local std::shared_ptr<TraceBuffer> _traceBuffer;
+
+    // Functions are statics that can be constructed before any other global of this unit.
+    static Registry& GetRegistry()
+    {
+        static Registry registry;
+        return registry;
+    }
+
+    static TraceState& GetTraceState()
+    {
+        static TraceState traceState;
+        return traceState;
+    }
+
+    static double ToMilliseconds(uint64_t nanoseconds)
+    {
+        return nanoseconds / 1000000.0;
+    }
+
+    Function::Function(const char* name)
+        : _name(name)
+    {
+        auto& registry = GetRegistry();
+        std::lock_guard<std::mutex> lock(registry.Mutex);
+        registry.Functions.push_back(this);
+    }
+
+    void Enable()
+    {
+        auto& registry = GetRegistry();
+        std::lock_guard<std::mutex> lock(registry.Mutex);
+
+        // Discard anything accumulated while only tracing or before the profiler was last disabled.
+        for (auto* function : registry.Functions)
+        {
+            function->_tickTime = 0;
+            function->_tickCalls = 0;
+        }
+        Detail::ActiveFlags.fetch_or(Detail::EnabledFlag);
+    }
+
+    void Disable()
+    {
+        Detail::ActiveFlags.fetch_and(static_cast<uint8_t>(~Detail::EnabledFlag));
+    }
+
+    void ResetData()
+    {
+        auto& registry = GetRegistry();
+        std::lock_guard<std::mutex> lock(registry.Mutex);
+        for (auto* function : registry.Functions)
+        {
+            function->_tickTime = 0;
+            function->_tickCalls = 0;
+            function->_totalCalls = 0;
+            function->_numSamples = 0;
+            function->_sampleIdx = 0;
+        }
+    }
+
+    std::vector<Function*> GetFunctions()
+    {
+        auto& registry = GetRegistry();
+        std::lock_guard<std::mutex> lock(registry.Mutex);
+        return registry.Functions;
+    }
+
+    FunctionStats GetStats(const Function& function)
+    {
+        FunctionStats stats;
+        std::vector<uint64_t> samples;
+        {
+            auto& registry = GetRegistry();
+            std::lock_guard<std::mutex> lock(registry.Mutex);
+            stats.Calls = function._totalCalls;
+            samples.assign(function._samples.begin(), function._samples.begin() + function._numSamples);
+        }
+
+        stats.Ticks = samples.size();
+        if (samples.empty())
+        {
+            return stats;
+        }
+
+        uint64_t total = 0;
+        for (auto sample : samples)
+        {
+            total += sample;
+        }
+        stats.MeanMs = ToMilliseconds(total) / samples.size();
+
+        auto percentile = [&samples](size_t percent) {
+            auto nth = samples.begin() + std::min(samples.size() - 1, samples.size() * percent / 100);
+            std::nth_element(samples.begin(), nth, samples.end());
+            return ToMilliseconds(*nth);
+        };
+        stats.P50Ms = percentile(50);
+        stats.P99Ms = percentile(99);
+        stats.MaxMs = ToMilliseconds(*std::max_element(samples.begin(), samples.end()));
+        return stats;
+    }
+
+    void EndTick()
+    {
+        if (!IsEnabled())
+        {
+            return;
+        }
+
+        auto& registry = GetRegistry();
+        std::lock_guard<std::mutex> lock(registry.Mutex);
+        for (auto* function : registry.Functions)
+        {
+            auto calls = function->_tickCalls.exchange(0, std::memory_order_relaxed);
+            auto time = function->_tickTime.exchange(0, std::memory_order_relaxed);
+            if (calls == 0)
+            {
+                continue;
+            }
+
+            function->_totalCalls += calls;
+            function->_samples[function->_sampleIdx] = time;
+            function->_sampleIdx = (function->_sampleIdx + 1) % PROFILING_SAMPLES_COUNT;
+            function->_numSamples = std::min(function->_numSamples + 1, PROFILING_SAMPLES_COUNT);
+        }
+    }
+
+    void StartTrace()
+    {
+        auto& traceState = GetTraceState();
+        std::lock_guard<std::mutex> lock(traceState.Mutex);
+        for (auto& buffer : traceState.Buffers)
+        {
+            std::lock_guard<std::mutex> bufferLock(buffer->Mutex);
+            buffer->Events.clear();
+        }
+        traceState.Start = Clock::now();
+        Detail::ActiveFlags.fetch_or(Detail::TracingFlag);
+    }
+
+    bool StopTrace(const std::string& path)
+    {
+        Detail::ActiveFlags.fetch_and(static_cast<uint8_t>(~Detail::TracingFlag));
+
+        auto& traceState = GetTraceState();
+        std::lock_guard<std::mutex> lock(traceState.Mutex);
+
+        auto traceEvents = json_t::array();
+        for (auto& buffer : traceState.Buffers)
+        {
+            std::lock_guard<std::mutex> bufferLock(buffer->Mutex);
+            if (!buffer->ThreadName.empty())
+            {
+                traceEvents.push_back({
+                    { "name", "thread_name" },
+                    { "ph", "M" },
+                    { "pid", 0 },
+                    { "tid", buffer->ThreadId },
+                    { "args", { { "name", buffer->ThreadName } } },
+                });
+            }
+            for (const auto& traceEvent : buffer->Events)
+            {
+                // Timestamps and durations are in microseconds.
+                std::chrono::duration<double, std::micro> ts = traceEvent.Start - traceState.Start;
+                std::chrono::duration<double, std::micro> dur = traceEvent.Duration;
+                traceEvents.push_back({
+                    { "name", traceEvent.Name },
+                    { "ph", "X" },
+                    { "ts", ts.count() },
+                    { "dur", dur.count() },
+                    { "pid", 0 },
+                    { "tid", buffer->ThreadId },
+                });
+            }
+            buffer->Events.clear();
+            buffer->Events.shrink_to_fit();
+        }
+
+        // Buffers only referenced from here belong to threads that have exited.
+        traceState.Buffers.erase(
+            std::remove_if(
+                traceState.Buffers.begin(), traceState.Buffers.end(),
+                [](const std::shared_ptr<TraceBuffer>& buffer) { return buffer.use_count() == 1; }),
+            traceState.Buffers.end());
+
+        try
+        {
+            json_t trace = { { "traceEvents", std::move(traceEvents) } };
+            Json::WriteToFile(path.c_str(), trace, -1);
+            return true;
+        }
+        catch (const std::exception& e)
+        {
+            log_error("Unable to write trace to '%s': %s", path.c_str(), e.what());
+            return false;
+        }
+    }
+
+    static TraceBuffer& GetThreadTraceBuffer()
+    {
+        if (_traceBuffer == nullptr)
+        {
+            auto& traceState = GetTraceState();
+            std::lock_guard<std::mutex> lock(traceState.Mutex);
+            _traceBuffer = std::make_shared<TraceBuffer>();
+            _traceBuffer->ThreadId = traceState.NextThreadId++;
+            traceState.Buffers.push_back(_traceBuffer);
+        }
+        return *_traceBuffer;
+    }
+
+    void AddTraceEvent(const char* name, Clock::time_point start, Clock::time_point end)
+    {
+        if (!IsTracing())
+        {
+            return;
+        }
+
+        auto& buffer = GetThreadTraceBuffer();
+        std::lock_guard<std::mutex> lock(buffer.Mutex);
+        if (buffer.Events.size() < MaxTraceEventsPerThread)
+        {
+            buffer.Events.push_back({ name, start, end - start });
+        }
+    }
+
+    void SetThreadName(const std::string& name)
+    {
+        auto& buffer = GetThreadTraceBuffer();
+        std::lock_guard<std::mutex> lock(buffer.Mutex);
+        buffer.ThreadName = name;
+    }
+
+    void ScopedTimer::Start(Function& function)
+    {
+        _function = &function;
+        _parent = _currentFunction;
+
+        // The first caller seen becomes the parent, which keeps the hierarchy stable for functions with several callers.
+        if (_parent != nullptr && _parent != &function && function.GetParent() == nullptr)
+        {
+            Function* expected = nullptr;
+            function._parent.compare_exchange_strong(expected, _parent, std::memory_order_relaxed);
+        }
+
+        _currentFunction = &function;
+        _active = true;
+        _start = Clock::now();
+    }
+
+    void ScopedTimer::Switch(Function& function)
+    {
+        if (_active)
+        {
+            Stop();
+            Start(function);
+        }
+    }
+
+    void ScopedTimer::Stop()
+    {
+        if (!_active)
+        {
+            return;
+        }
+
+        auto end = Clock::now();
+        auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(end - _start).count();
+        _function->_tickTime.fetch_add(static_cast<uint64_t>(elapsed), std::memory_order_relaxed);
+        _function->_tickCalls.fetch_add(1, std::memory_order_relaxed);
+        AddTraceEvent(_function->GetName(), _start, end);
+
+        _currentFunction = _parent;
+        _active = false;
+    }
+} // namespace OpenRCT2::Profiling
@@ -0,0 +1,214 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2021 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#pragma once
+
+#include "../common.h"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <vector>
+
+namespace OpenRCT2::Profiling
+{
+    // ~25s at 40Hz
+    constexpr size_t PROFILING_SAMPLES_COUNT = 1024;
+
+    using Clock = std::chrono::high_resolution_clock;
+
+    struct FunctionStats
+    {
+        uint64_t Calls{};
+        size_t Ticks{};
+        double MeanMs{};
+        double P50Ms{};
+        double P99Ms{};
+        double MaxMs{};
+    };
+
+    /**
+     * A named piece of code that is timed by the profiler. Instances are expected to have static storage duration, they
+     * register themselves on construction and are never unregistered.
+     */
+    class Function
+    {
+        friend class ScopedTimer;
+        friend FunctionStats GetStats(const Function& function);
+        friend void Enable();
+        friend void ResetData();
+        friend void EndTick();
+
+    private:
+        const char* _name;
+        std::atomic<Function*> _parent{};
+        std::atomic<uint64_t> _tickTime{};
+        std::atomic<uint64_t> _tickCalls{};
+        uint64_t _totalCalls{};
+        std::array<uint64_t, PROFILING_SAMPLES_COUNT> _samples{};
+        size_t _numSamples{};
+        size_t _sampleIdx{};
+
+    public:
+        explicit Function(const char* name);
+        Function(const Function&) = delete;
+
+        const char* GetName() const
+        {
+            return _name;
+        }
+
+        Function* GetParent() const
+        {
+            return _parent.load(std::memory_order_relaxed);
+        }
+    };
+
+    namespace Detail
+    {
+        constexpr uint8_t EnabledFlag = 1 << 0;
+        constexpr uint8_t TracingFlag = 1 << 1;
+
+        // Whether the profiler is enabled and a trace is being recorded, in one flag so that timers only load it once.
+        inline std::atomic<uint8_t> ActiveFlags{};
+    } // namespace Detail
+
+    inline bool IsEnabled()
+    {
+        return (Detail::ActiveFlags.load(std::memory_order_relaxed) & Detail::EnabledFlag) != 0;
+    }
+
+    void Enable();
+    void Disable();
+    void ResetData();
+
+    /**
+     * Returns all registered functions in registration order. Parents are not guaranteed to precede their children.
+     */
+    std::vector<Function*> GetFunctions();
+
+    /**
+     * Returns statistics over the rolling window of per-tick times of the function. Only ticks in which the function was
+     * entered at least once are sampled.
+     */
+    FunctionStats GetStats(const Function& function);
+
+    /**
+     * Stores the time spent in every function during the current tick as a sample.
+     */
+    void EndTick();
+
+    inline bool IsTracing()
+    {
+        return (Detail::ActiveFlags.load(std::memory_order_relaxed) & Detail::TracingFlag) != 0;
+    }
+
+    void StartTrace();
+
+    /**
+     * Stops recording trace events and writes the recorded events to the given path in the Chrome trace event format,
+     * which can be loaded by chrome://tracing or Perfetto.
+     */
+    bool StopTrace(const std::string& path);
+
+    /**
+     * Records a complete trace event on the calling thread, used for code that is timed outside of a ScopedTimer.
+     */
+    void AddTraceEvent(const char* name, Clock::time_point start, Clock::time_point end);
+
+    /**
+     * Sets the name the calling thread is shown with in traces.
+     */
+    void SetThreadName(const std::string& name);
+
+    /**
+     * Times a scope, nested scopes on the same thread are reported as children of this one. Does nothing unless the
+     * profiler is enabled or a trace is being recorded when the timer is created, which costs a single relaxed atomic
+     * load.
+     */
+    class ScopedTimer
+    {
+    private:
+        Function* _function{};
+        Function* _parent{};
+        Clock::time_point _start;
+        bool _active{};
+
+    public:
+        explicit ScopedTimer(Function& function)
+        {
+            if (Detail::ActiveFlags.load(std::memory_order_relaxed) != 0)
+            {
+                Start(function);
+            }
+        }
+
+        ScopedTimer(const ScopedTimer&) = delete;
+
+        ~ScopedTimer()
+        {
+            if (_active)
+            {
+                Stop();
+            }
+        }
+
+        /**
+         * Ends timing the current function and starts timing another function at the same depth.
+         */
+        void Switch(Function& function);
+        void Stop();
+
+    private:
+        void Start(Function& function);
+    };
+
+    /**
+     * Records a scope in the trace only, for code that runs outside of the game tick such as drawing. Costs a single
+     * relaxed atomic load when no trace is being recorded.
+     */
+    class TraceScope
+    {
+    private:
+        const char* _name;
+        Clock::time_point _start;
+        bool _active;
+
+    public:
+        explicit TraceScope(const char* name)
+            : _name(name)
+            , _active(IsTracing())
+        {
+            if (_active)
+            {
+                _start = Clock::now();
+            }
+        }
+
+        TraceScope(const TraceScope&) = delete;
+
+        ~TraceScope()
+        {
+            if (_active)
+            {
+                AddTraceEvent(_name, _start, Clock::now());
+            }
+        }
+    };
+} // namespace OpenRCT2::Profiling
+
+#define PROFILING_CONCAT_IMPL(a, b) a##b
+#define PROFILING_CONCAT(a, b) PROFILING_CONCAT_IMPL(a, b)
+
+#define PROFILED_SCOPE(name)                                                                                                   \
+    static OpenRCT2::Profiling::Function PROFILING_CONCAT(_profiledFunction, __LINE__)(name);                                  \
+    OpenRCT2::Profiling::ScopedTimer PROFILING_CONCAT(_profiledScope, __LINE__)(PROFILING_CONCAT(_profiledFunction, __LINE__))
+
+#define TRACED_SCOPE(name) OpenRCT2::Profiling::TraceScope PROFILING_CONCAT(_tracedScope, __LINE__)(name)
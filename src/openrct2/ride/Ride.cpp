@@ -26,6 +26,7 @@
 #include "../core/Guard.hpp"
 #include "../core/Numerics.hpp"
 #include "../entity/EntityRegistry.h"
+#include "../entity/MechanicIndex.h"
 #include "../entity/Peep.h"
 #include "../entity/Staff.h"
 #include "../interface/Window.h"
@@ -1688,51 +1689,37 @@ Staff* ride_find_closest_mechanic(Ride* ride, int32_t forInspection)
  */
 Staff* find_closest_mechanic(const CoordsXY& entrancePosition, int32_t forInspection)
 {
-    Staff* closestMechanic = nullptr;
-    uint32_t closestDistance = std::numeric_limits<uint32_t>::max();
+    // Patrol areas only apply inside the park.
+    const auto location = entrancePosition.ToTileStart();
+    const bool checkPatrol = map_is_location_in_park(location);
 
-    for (auto peep : EntityList<Staff>())
-    {
-        if (!peep->IsMechanic())
-            continue;
+    // Mechanics are searched for by their distance, the more expensive patrol area check is only done for the ones
+    // that are closer than the closest so far.
+    return OpenRCT2::MechanicIndex::FindNearest(entrancePosition, [&](const Staff& peep) {
+        if (!peep.IsMechanic())
+            return false;
 
         if (!forInspection)
         {
-            if (peep->State == PeepState::HeadingToInspection)
+            if (peep.State == PeepState::HeadingToInspection)
             {
-                if (peep->SubState >= 4)
-                    continue;
+                if (peep.SubState >= 4)
+                    return false;
             }
-            else if (peep->State != PeepState::Patrolling)
-                continue;
+            else if (peep.State != PeepState::Patrolling)
+                return false;
 
-            if (!(peep->StaffOrders & STAFF_ORDERS_FIX_RIDES))
-                continue;
+            if (!(peep.StaffOrders & STAFF_ORDERS_FIX_RIDES))
+                return false;
         }
         else
         {
-            if (peep->State != PeepState::Patrolling || !(peep->StaffOrders & STAFF_ORDERS_INSPECT_RIDES))
-                continue;
-        }
-
-        auto location = entrancePosition.ToTileStart();
-        if (map_is_location_in_park(location))
-            if (!peep->IsLocationInPatrol(location))
-                continue;
-
-        if (peep->x == LOCATION_NULL)
-            continue;
-
-        // Manhattan distance
-        uint32_t distance = std::abs(peep->x - entrancePosition.x) + std::abs(peep->y - entrancePosition.y);
-        if (distance < closestDistance)
-        {
-            closestDistance = distance;
-            closestMechanic = peep;
+            if (peep.State != PeepState::Patrolling || !(peep.StaffOrders & STAFF_ORDERS_INSPECT_RIDES))
+                return false;
         }
-    }
 
-    return closestMechanic;
+        return !checkPatrol || peep.IsLocationInPatrol(location);
+    });
 }
 
 Staff* ride_get_mechanic(Ride* ride)
@@ -5688,7 +5675,7 @@ void ride_clear_leftover_entrances(Ride* ride)
                 if (entrance->GetRideIndex() != ride->id)
                     continue;
 
-                tile_element_remove(entrance->as<TileElement>());
+                tile_element_remove(tilePos.ToCoordsXY(), entrance->as<TileElement>());
             }
         }
     }
@@ -1572,7 +1572,7 @@ void Ride::ValidateStations()
                 footpath_remove_edges_at(location, tileElement);
                 footpath_update_queue_chains();
                 map_invalidate_tile_full(location);
-                tile_element_remove(tileElement);
+                tile_element_remove(location, tileElement);
                 tileElement--;
             }
         } while (!(tileElement++)->IsLastForTile());
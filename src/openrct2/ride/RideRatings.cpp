@@ -14,6 +14,7 @@
 #include "../OpenRCT2.h"
 #include "../interface/Window.h"
 #include "../localisation/Date.h"
+#include "../profiling/Profiling.h"
 #include "../scripting/ScriptEngine.h"
 #include "../world/Footpath.h"
 #include "../world/Map.h"
@@ -118,6 +119,8 @@ void ride_ratings_update_ride(const Ride& ride)
  */
 void ride_ratings_update_all()
 {
+    PROFILED_SCOPE("ride_ratings_update_all");
+
     if (gScreenFlags & SCREEN_FLAGS_SCENARIO_EDITOR)
         return;
 
@@ -539,6 +542,8 @@ static void ride_ratings_score_close_proximity_loops(RideRatingUpdateState& stat
  */
 static void ride_ratings_score_close_proximity(RideRatingUpdateState& state, TileElement* inputTileElement)
 {
+    PROFILED_SCOPE("ride_ratings_score_close_proximity");
+
     if (state.StationFlags & RIDE_RATING_STATION_FLAG_NO_ENTRANCE)
     {
         return;
@@ -723,6 +728,8 @@ static void ride_ratings_score_close_proximity(RideRatingUpdateState& state, Til
 
 static void ride_ratings_calculate(RideRatingUpdateState& state, Ride* ride)
 {
+    PROFILED_SCOPE("ride_ratings_calculate");
+
     auto calcFunc = ride_ratings_get_calculate_func(ride->type);
     if (calcFunc != nullptr)
     {
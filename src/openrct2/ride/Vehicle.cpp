@@ -25,6 +25,7 @@
 #include "../localisation/Localisation.h"
 #include "../management/NewsItem.h"
 #include "../platform/platform.h"
+#include "../profiling/Profiling.h"
 #include "../rct12/RCT12.h"
 #include "../scenario/Scenario.h"
 #include "../scripting/HookEngine.h"
@@ -1412,6 +1413,8 @@ bool Vehicle::OpenRestraints()
  */
 void Vehicle::UpdateMeasurements()
 {
+    PROFILED_SCOPE("Vehicle::UpdateMeasurements");
+
     auto curRide = GetRide();
     if (curRide == nullptr)
         return;
@@ -1837,6 +1840,8 @@ void Vehicle::GetLiftHillSound(Ride* curRide, SoundIdVolume& curSound)
  */
 void Vehicle::Update()
 {
+    PROFILED_SCOPE("Vehicle::Update");
+
     // The cable lift uses a ride entry index of NULL
     if (ride_subtype == OBJECT_ENTRY_INDEX_NULL)
     {
@@ -5412,6 +5417,8 @@ void Vehicle::UpdateCrash()
  */
 void Vehicle::UpdateSound()
 {
+    PROFILED_SCOPE("Vehicle::UpdateSound");
+
     // frictionVolume (bl) should be set before hand
     SoundIdVolume frictionSound = { OpenRCT2::Audio::SoundId::Null, 255 };
     // bh screamVolume should be set before hand
@@ -9334,6 +9341,8 @@ int32_t Vehicle::UpdateTrackMotionPoweredRideAcceleration(
  */
 int32_t Vehicle::UpdateTrackMotion(int32_t* outStation)
 {
+    PROFILED_SCOPE("Vehicle::UpdateTrackMotion");
+
     auto curRide = GetRide();
     if (curRide == nullptr)
         return 0;
@@ -0,0 +1,91 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2021 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#pragma once
+
+#ifdef ENABLE_SCRIPTING
+
+#    include "../../../Context.h"
+#    include "../../../profiling/Profiling.h"
+#    include "../../Duktape.hpp"
+#    include "../../ScriptEngine.h"
+
+namespace OpenRCT2::Scripting
+{
+    class ScProfiler
+    {
+    public:
+        static void Register(duk_context* ctx)
+        {
+            dukglue_register_property(ctx, &ScProfiler::enabled_get, nullptr, "enabled");
+            dukglue_register_method(ctx, &ScProfiler::getData, "getData");
+            dukglue_register_method(ctx, &ScProfiler::start, "start");
+            dukglue_register_method(ctx, &ScProfiler::stop, "stop");
+            dukglue_register_method(ctx, &ScProfiler::reset, "reset");
+        }
+
+    private:
+        bool enabled_get() const
+        {
+            return Profiling::IsEnabled();
+        }
+
+        std::vector<DukValue> getData() const
+        {
+            auto ctx = GetContext()->GetScriptEngine().GetContext();
+            std::vector<DukValue> result;
+            for (auto* function : Profiling::GetFunctions())
+            {
+                auto stats = Profiling::GetStats(*function);
+                if (stats.Ticks == 0)
+                {
+                    continue;
+                }
+
+                auto parent = function->GetParent();
+
+                DukObject obj(ctx);
+                obj.Set("name", function->GetName());
+                if (parent != nullptr)
+                {
+                    obj.Set("parent", parent->GetName());
+                }
+                else
+                {
+                    obj.Set("parent", nullptr);
+                }
+                obj.Set("calls", stats.Calls);
+                obj.Set("ticks", static_cast<uint32_t>(stats.Ticks));
+                obj.Set("mean", stats.MeanMs);
+                obj.Set("p50", stats.P50Ms);
+                obj.Set("p99", stats.P99Ms);
+                obj.Set("max", stats.MaxMs);
+                result.push_back(obj.Take());
+            }
+            return result;
+        }
+
+        void start()
+        {
+            Profiling::Enable();
+        }
+
+        void stop()
+        {
+            Profiling::Disable();
+        }
+
+        void reset()
+        {
+            Profiling::ResetData();
+        }
+    };
+} // namespace OpenRCT2::Scripting
+
+#endif
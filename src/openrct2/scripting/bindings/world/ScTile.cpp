@@ -15,8 +15,11 @@
 #    include "../../../common.h"
 #    include "../../../core/Guard.hpp"
 #    include "../../../entity/EntityRegistry.h"
+#    include "../../../peep/PathGraph.h"
+#    include "../../../peep/SurroundingsCache.h"
 #    include "../../../ride/Track.h"
 #    include "../../../world/Footpath.h"
+#    include "../../../world/RidePresenceIndex.h"
 #    include "../../../world/Scenery.h"
 #    include "../../../world/Surface.h"
 #    include "../../Duktape.hpp"
@@ -125,6 +128,9 @@ namespace OpenRCT2::Scripting
                     first[numElements - 1].SetLastForTile(true);
                 }
             }
+            RidePresenceIndex::InvalidateTile(_coords);
+            SurroundingsCache::InvalidateTile(_coords);
+            PathGraph::InvalidateTile(_coords);
             map_invalidate_tile_full(_coords);
         }
     }
@@ -195,7 +201,7 @@ namespace OpenRCT2::Scripting
         auto first = GetFirstElement();
         if (index < GetNumElements(first))
         {
-            tile_element_remove(&first[index]);
+            tile_element_remove(_coords, &first[index]);
             map_invalidate_tile_full(_coords);
         }
     }
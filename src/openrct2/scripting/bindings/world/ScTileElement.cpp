@@ -15,9 +15,12 @@
 #    include "../../../common.h"
 #    include "../../../core/Guard.hpp"
 #    include "../../../entity/EntityRegistry.h"
+#    include "../../../peep/PathGraph.h"
+#    include "../../../peep/SurroundingsCache.h"
 #    include "../../../ride/Ride.h"
 #    include "../../../ride/Track.h"
 #    include "../../../world/Footpath.h"
+#    include "../../../world/RidePresenceIndex.h"
 #    include "../../../world/Scenery.h"
 #    include "../../../world/Surface.h"
 #    include "../../Duktape.hpp"
@@ -1626,6 +1629,9 @@ namespace OpenRCT2::Scripting
 
     void ScTileElement::Invalidate()
     {
+        RidePresenceIndex::InvalidateTile(_coords);
+        SurroundingsCache::InvalidateTile(_coords);
+        PathGraph::InvalidateTile(_coords);
         map_invalidate_tile_full(_coords);
     }
 
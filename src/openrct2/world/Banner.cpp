@@ -18,6 +18,7 @@
 #include "../localisation/Localisation.h"
 #include "../management/Finance.h"
 #include "../network/network.h"
+#include "../peep/PathGraph.h"
 #include "../ride/Ride.h"
 #include "../ride/RideData.h"
 #include "../ride/Track.h"
@@ -352,11 +353,13 @@ void BannerElement::SetAllowedEdges(uint8_t newEdges)
 {
     AllowedEdges &= ~0b00001111;
     AllowedEdges |= (newEdges & 0b00001111);
+    OpenRCT2::PathGraph::InvalidateElement(as<TileElement>());
 }
 
 void BannerElement::ResetAllowedEdges()
 {
     AllowedEdges |= 0b00001111;
+    OpenRCT2::PathGraph::InvalidateElement(as<TileElement>());
 }
 
 void UnlinkAllRideBanners()
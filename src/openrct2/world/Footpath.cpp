@@ -27,6 +27,7 @@
 #include "../object/ObjectList.h"
 #include "../object/ObjectManager.h"
 #include "../paint/VirtualFloor.h"
+#include "../peep/PathGraph.h"
 #include "../ride/RideData.h"
 #include "../ride/Station.h"
 #include "../ride/Track.h"
@@ -1530,6 +1531,7 @@ void PathElement::SetSloped(bool isSloped)
     Flags2 &= ~FOOTPATH_ELEMENT_FLAGS2_IS_SLOPED;
     if (isSloped)
         Flags2 |= FOOTPATH_ELEMENT_FLAGS2_IS_SLOPED;
+    OpenRCT2::PathGraph::InvalidateElement(as<TileElement>());
 }
 
 Direction PathElement::GetSlopeDirection() const
@@ -1540,6 +1542,7 @@ Direction PathElement::GetSlopeDirection() const
 void PathElement::SetSlopeDirection(Direction newSlope)
 {
     SlopeDirection = newSlope;
+    OpenRCT2::PathGraph::InvalidateElement(as<TileElement>());
 }
 
 bool PathElement::IsQueue() const
@@ -1552,6 +1555,7 @@ void PathElement::SetIsQueue(bool isQueue)
     type &= ~FOOTPATH_ELEMENT_TYPE_FLAG_IS_QUEUE;
     if (isQueue)
         type |= FOOTPATH_ELEMENT_TYPE_FLAG_IS_QUEUE;
+    OpenRCT2::PathGraph::InvalidateElement(as<TileElement>());
 }
 
 bool PathElement::HasQueueBanner() const
@@ -2387,6 +2391,7 @@ ride_id_t PathElement::GetRideIndex() const
 void PathElement::SetRideIndex(ride_id_t newRideIndex)
 {
     rideIndex = newRideIndex;
+    OpenRCT2::PathGraph::InvalidateElement(as<TileElement>());
 }
 
 uint8_t PathElement::GetAdditionStatus() const
@@ -2408,6 +2413,7 @@ void PathElement::SetEdges(uint8_t newEdges)
 {
     EdgesAndCorners &= ~FOOTPATH_PROPERTIES_EDGES_EDGES_MASK;
     EdgesAndCorners |= (newEdges & FOOTPATH_PROPERTIES_EDGES_EDGES_MASK);
+    OpenRCT2::PathGraph::InvalidateElement(as<TileElement>());
 }
 
 uint8_t PathElement::GetCorners() const
@@ -2429,6 +2435,7 @@ uint8_t PathElement::GetEdgesAndCorners() const
 void PathElement::SetEdgesAndCorners(uint8_t newEdgesAndCorners)
 {
     EdgesAndCorners = newEdgesAndCorners;
+    OpenRCT2::PathGraph::InvalidateElement(as<TileElement>());
 }
 
 bool PathElement::IsLevelCrossing(const CoordsXY& coords) const
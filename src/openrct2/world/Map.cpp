@@ -22,13 +22,17 @@
 #include "../config/Config.h"
 #include "../core/Guard.hpp"
 #include "../interface/Cursors.h"
+#include "../interface/ViewportCache.h"
 #include "../interface/Window.h"
 #include "../localisation/Date.h"
 #include "../localisation/Localisation.h"
 #include "../management/Finance.h"
 #include "../network/network.h"
+#include "../peep/PathGraph.h"
+#include "../peep/SurroundingsCache.h"
 #include "../object/ObjectManager.h"
 #include "../object/TerrainSurfaceObject.h"
+#include "../paint/PaintCache.h"
 #include "../ride/RideConstruction.h"
 #include "../ride/RideData.h"
 #include "../ride/Track.h"
@@ -44,6 +48,7 @@
 #include "LargeScenery.h"
 #include "MapAnimation.h"
 #include "Park.h"
+#include "RidePresenceIndex.h"
 #include "Scenery.h"
 #include "SmallScenery.h"
 #include "Surface.h"
@@ -122,6 +127,11 @@ void StashMap()
     _mapSizeStash = gMapSize;
     _currentRotationStash = gCurrentRotation;
     _tileElementsInUseStash = _tileElementsInUse;
+    OpenRCT2::RidePresenceIndex::Reset();
+    OpenRCT2::SurroundingsCache::Reset();
+    OpenRCT2::PathGraph::Invalidate();
+    OpenRCT2::PaintCache::Reset();
+    OpenRCT2::ViewportCache::Reset();
 }
 
 void UnstashMap()
@@ -131,6 +141,11 @@ void UnstashMap()
     gMapSize = _mapSizeStash;
     gCurrentRotation = _currentRotationStash;
     _tileElementsInUse = _tileElementsInUseStash;
+    OpenRCT2::RidePresenceIndex::Reset();
+    OpenRCT2::SurroundingsCache::Reset();
+    OpenRCT2::PathGraph::Invalidate();
+    OpenRCT2::PaintCache::Reset();
+    OpenRCT2::ViewportCache::Reset();
 }
 
 const std::vector<TileElement>& GetTileElements()
@@ -143,6 +158,11 @@ void SetTileElements(std::vector<TileElement>&& tileElements)
     _tileElements = std::move(tileElements);
     _tileIndex = TilePointerIndex<TileElement>(MAXIMUM_MAP_SIZE_TECHNICAL, _tileElements.data(), _tileElements.size());
     _tileElementsInUse = _tileElements.size();
+    OpenRCT2::RidePresenceIndex::Reset();
+    OpenRCT2::SurroundingsCache::Reset();
+    OpenRCT2::PathGraph::Invalidate();
+    OpenRCT2::PaintCache::Reset();
+    OpenRCT2::ViewportCache::Reset();
 }
 
 static TileElement GetDefaultSurfaceElement()
@@ -378,6 +398,10 @@ void map_set_tile_element(const TileCoordsXY& tilePos, TileElement* elements)
         return;
     }
     _tileIndex.SetTile(tilePos, elements);
+    OpenRCT2::RidePresenceIndex::InvalidateTile(tilePos.ToCoordsXY());
+    OpenRCT2::SurroundingsCache::InvalidateTile(tilePos.ToCoordsXY());
+    OpenRCT2::PathGraph::InvalidateTile(tilePos.ToCoordsXY());
+    OpenRCT2::PaintCache::InvalidateTile(tilePos.ToCoordsXY());
 }
 
 SurfaceElement* map_get_surface_element_at(const CoordsXY& coords)
@@ -508,6 +532,7 @@ void map_strip_ghost_flag_from_elements()
     {
         element.SetGhost(false);
     }
+    OpenRCT2::PathGraph::Invalidate();
 }
 
 /**
@@ -1076,8 +1101,42 @@ bool map_is_location_at_edge(const CoordsXY& loc)
  *
  *  rct2: 0x0068B280
  */
-void tile_element_remove(TileElement* tileElement)
+void tile_element_remove(const CoordsXY& loc, TileElement* tileElement)
 {
+    switch (tileElement->GetType())
+    {
+        case TileElementType::Track:
+            OpenRCT2::RidePresenceIndex::InvalidateTile(loc);
+            if (!tileElement->IsGhost())
+            {
+                OpenRCT2::PathGraph::InvalidateTile(loc);
+            }
+            break;
+        case TileElementType::Path:
+            if (tileElement->AsPath()->HasAddition())
+            {
+                OpenRCT2::SurroundingsCache::InvalidateTile(loc);
+            }
+            if (!tileElement->IsGhost())
+            {
+                OpenRCT2::PathGraph::InvalidateTile(loc);
+            }
+            break;
+        case TileElementType::Entrance:
+        case TileElementType::Banner:
+            if (!tileElement->IsGhost())
+            {
+                OpenRCT2::PathGraph::InvalidateTile(loc);
+            }
+            break;
+        case TileElementType::SmallScenery:
+        case TileElementType::LargeScenery:
+            OpenRCT2::SurroundingsCache::InvalidateTile(loc);
+            break;
+        default:
+            break;
+    }
+
     // Replace Nth element by (N+1)th element.
     // This loop will make tileElement point to the old last element position,
     // after copy it to it's new position
@@ -1126,7 +1185,7 @@ void map_remove_all_rides()
             case TileElementType::Track:
                 footpath_queue_chain_reset();
                 footpath_remove_edges_at(TileCoordsXY{ it.x, it.y }.ToCoordsXY(), it.element);
-                tile_element_remove(it.element);
+                tile_element_remove(TileCoordsXY{ it.x, it.y }.ToCoordsXY(), it.element);
                 tile_element_iterator_restart_for_tile(&it);
                 break;
             default:
@@ -1244,6 +1303,20 @@ TileElement* tile_element_insert(const CoordsXYZ& loc, int32_t occupiedQuadrants
 
     // Set tile index pointer to point to new element block
     _tileIndex.SetTile(tileLoc, newTileElement);
+    OpenRCT2::RidePresenceIndex::InvalidateTile(loc);
+    OpenRCT2::SurroundingsCache::InvalidateTile(loc);
+    OpenRCT2::PaintCache::InvalidateTile(loc);
+    switch (type)
+    {
+        case TileElementType::Path:
+        case TileElementType::Track:
+        case TileElementType::Entrance:
+        case TileElementType::Banner:
+            OpenRCT2::PathGraph::InvalidateTile(loc);
+            break;
+        default:
+            break;
+    }
 
     bool isLastForTile = false;
     if (originalTileElement == nullptr)
@@ -1546,7 +1619,7 @@ static void clear_element_at(const CoordsXY& loc, TileElement** elementPtr)
             // If asking nicely did not work, forcibly remove this to avoid an infinite loop.
             if (result.Error != GameActions::Status::Ok)
             {
-                tile_element_remove(element);
+                tile_element_remove(loc, element);
             }
             break;
         }
@@ -1558,7 +1631,7 @@ static void clear_element_at(const CoordsXY& loc, TileElement** elementPtr)
             // If asking nicely did not work, forcibly remove this to avoid an infinite loop.
             if (result.Error != GameActions::Status::Ok)
             {
-                tile_element_remove(element);
+                tile_element_remove(loc, element);
             }
         }
         break;
@@ -1570,7 +1643,7 @@ static void clear_element_at(const CoordsXY& loc, TileElement** elementPtr)
             // If asking nicely did not work, forcibly remove this to avoid an infinite loop.
             if (result.Error != GameActions::Status::Ok)
             {
-                tile_element_remove(element);
+                tile_element_remove(loc, element);
             }
         }
         break;
@@ -1582,12 +1655,12 @@ static void clear_element_at(const CoordsXY& loc, TileElement** elementPtr)
             // If asking nicely did not work, forcibly remove this to avoid an infinite loop.
             if (result.Error != GameActions::Status::Ok)
             {
-                tile_element_remove(element);
+                tile_element_remove(loc, element);
             }
             break;
         }
         default:
-            tile_element_remove(element);
+            tile_element_remove(loc, element);
             break;
     }
 }
@@ -1836,6 +1909,9 @@ ScreenCoordsXY translate_3d_to_2d_with_z(int32_t rotation, const CoordsXYZ& pos)
 
 static void map_invalidate_tile_under_zoom(int32_t x, int32_t y, int32_t z0, int32_t z1, ZoomLevel maxZoom)
 {
+    // Headless instances still paint screenshots.
+    OpenRCT2::PaintCache::InvalidateTile({ x, y });
+
     if (gOpenRCT2Headless)
         return;
 
@@ -1898,6 +1974,8 @@ void map_invalidate_region(const CoordsXY& mins, const CoordsXY& maxs)
 {
     int32_t x0, y0, x1, y1, left, right, top, bottom;
 
+    OpenRCT2::PaintCache::InvalidateRange(mins, maxs);
+
     x0 = mins.x + 16;
     y0 = mins.y + 16;
 
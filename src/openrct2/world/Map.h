@@ -184,7 +184,7 @@ bool map_is_location_owned(const CoordsXYZ& loc);
 bool map_is_location_in_park(const CoordsXY& coords);
 bool map_is_location_owned_or_has_rights(const CoordsXY& loc);
 bool map_surface_is_blocked(const CoordsXY& mapCoords);
-void tile_element_remove(TileElement* tileElement);
+void tile_element_remove(const CoordsXY& loc, TileElement* tileElement);
 void map_remove_all_rides();
 void map_invalidate_map_selection_tiles();
 void map_invalidate_selection_rect();
@@ -0,0 +1,183 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2021 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "RidePresenceIndex.h"
+
+#include "../ride/Track.h"
+#include "Map.h"
+#include "TileElementsView.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace OpenRCT2::RidePresenceIndex
+{
+    static constexpr int32_t BlocksPerSide = (MAXIMUM_MAP_SIZE_TECHNICAL + BlockSize - 1) / BlockSize;
+
+    struct Block
+    {
+        BitSet<MAX_RIDES> Rides;
+        bool Dirty = true;
+        bool Empty = true;
+    };
+
+    // Allocated by the first Update, until then every query scans tiles.
+    static std::vector<Block> _blocks;
+    static std::vector<size_t> _dirtyBlocks;
+
+    static size_t GetBlockIndex(int32_t blockX, int32_t blockY)
+    {
+        return static_cast<size_t>(blockY) * BlocksPerSide + blockX;
+    }
+
+    static void AddRidesOnTiles(int32_t tileX0, int32_t tileY0, int32_t tileX1, int32_t tileY1, BitSet<MAX_RIDES>& rides)
+    {
+        for (int32_t tileX = tileX0; tileX <= tileX1; tileX++)
+        {
+            for (int32_t tileY = tileY0; tileY <= tileY1; tileY++)
+            {
+                for (auto* trackElement : TileElementsView<TrackElement>(TileCoordsXY{ tileX, tileY }.ToCoordsXY()))
+                {
+                    auto rideIndex = trackElement->GetRideIndex();
+                    if (rideIndex != RIDE_ID_NULL)
+                    {
+                        rides[EnumValue(rideIndex)] = true;
+                    }
+                }
+            }
+        }
+    }
+
+    static bool IsSubsetOf(const BitSet<MAX_RIDES>& subset, const BitSet<MAX_RIDES>& set)
+    {
+        const auto& subsetData = subset.data();
+        const auto& setData = set.data();
+        for (size_t i = 0; i < subsetData.size(); i++)
+        {
+            if ((subsetData[i] & ~setData[i]) != 0)
+                return false;
+        }
+        return true;
+    }
+
+    static void MarkDirty(size_t blockIndex)
+    {
+        auto& block = _blocks[blockIndex];
+        if (!block.Dirty)
+        {
+            block.Dirty = true;
+            _dirtyBlocks.push_back(blockIndex);
+        }
+    }
+
+    static void RebuildBlock(size_t blockIndex)
+    {
+        auto& block = _blocks[blockIndex];
+        const auto blockX = static_cast<int32_t>(blockIndex % BlocksPerSide);
+        const auto blockY = static_cast<int32_t>(blockIndex / BlocksPerSide);
+        const auto tileX0 = blockX * BlockSize;
+        const auto tileY0 = blockY * BlockSize;
+        const auto tileX1 = std::min(tileX0 + BlockSize, MAXIMUM_MAP_SIZE_TECHNICAL) - 1;
+        const auto tileY1 = std::min(tileY0 + BlockSize, MAXIMUM_MAP_SIZE_TECHNICAL) - 1;
+
+        block.Rides.reset();
+        AddRidesOnTiles(tileX0, tileY0, tileX1, tileY1, block.Rides);
+        block.Empty = block.Rides.count() == 0;
+        block.Dirty = false;
+    }
+
+    void Reset()
+    {
+        _blocks.clear();
+        _dirtyBlocks.clear();
+    }
+
+    void InvalidateTile(const CoordsXY& loc)
+    {
+        if (_blocks.empty() || !map_is_location_valid(loc))
+            return;
+
+        const auto tileLoc = TileCoordsXY(loc);
+        MarkDirty(GetBlockIndex(tileLoc.x / BlockSize, tileLoc.y / BlockSize));
+    }
+
+    void Update()
+    {
+        if (_blocks.empty())
+        {
+            _blocks.resize(static_cast<size_t>(BlocksPerSide) * BlocksPerSide);
+            for (size_t i = 0; i < _blocks.size(); i++)
+            {
+                RebuildBlock(i);
+            }
+            return;
+        }
+
+        for (auto blockIndex : _dirtyBlocks)
+        {
+            RebuildBlock(blockIndex);
+        }
+        _dirtyBlocks.clear();
+    }
+
+    void GetRidesInRange(const CoordsXY& centre, int32_t radius, BitSet<MAX_RIDES>& rides)
+    {
+        // Same tile range as stepping from centre - radius to centre + radius and skipping invalid locations.
+        const auto tileX0 = std::max(0, (centre.x - radius) / COORDS_XY_STEP);
+        const auto tileY0 = std::max(0, (centre.y - radius) / COORDS_XY_STEP);
+        const auto tileX1 = std::min(MAXIMUM_MAP_SIZE_TECHNICAL - 1, (centre.x + radius) / COORDS_XY_STEP);
+        const auto tileY1 = std::min(MAXIMUM_MAP_SIZE_TECHNICAL - 1, (centre.y + radius) / COORDS_XY_STEP);
+        GetRidesOnTiles({ tileX0, tileY0 }, { tileX1, tileY1 }, rides);
+    }
+
+    void GetRidesOnTiles(const TileCoordsXY& from, const TileCoordsXY& to, BitSet<MAX_RIDES>& rides)
+    {
+        const auto tileX0 = std::max(0, from.x);
+        const auto tileY0 = std::max(0, from.y);
+        const auto tileX1 = std::min(MAXIMUM_MAP_SIZE_TECHNICAL - 1, to.x);
+        const auto tileY1 = std::min(MAXIMUM_MAP_SIZE_TECHNICAL - 1, to.y);
+        if (tileX0 > tileX1 || tileY0 > tileY1)
+            return;
+
+        if (_blocks.empty())
+        {
+            AddRidesOnTiles(tileX0, tileY0, tileX1, tileY1, rides);
+            return;
+        }
+
+        for (int32_t blockX = tileX0 / BlockSize; blockX <= tileX1 / BlockSize; blockX++)
+        {
+            for (int32_t blockY = tileY0 / BlockSize; blockY <= tileY1 / BlockSize; blockY++)
+            {
+                const auto& block = _blocks[GetBlockIndex(blockX, blockY)];
+                if (!block.Dirty)
+                {
+                    if (block.Empty || IsSubsetOf(block.Rides, rides))
+                        continue;
+                }
+
+                const auto blockTileX0 = blockX * BlockSize;
+                const auto blockTileY0 = blockY * BlockSize;
+                const auto blockTileX1 = blockTileX0 + BlockSize - 1;
+                const auto blockTileY1 = blockTileY0 + BlockSize - 1;
+                const bool fullyCovered = blockTileX0 >= tileX0 && blockTileX1 <= tileX1 && blockTileY0 >= tileY0
+                    && blockTileY1 <= tileY1;
+                if (!block.Dirty && fullyCovered)
+                {
+                    rides = rides | block.Rides;
+                    continue;
+                }
+
+                AddRidesOnTiles(
+                    std::max(tileX0, blockTileX0), std::max(tileY0, blockTileY0), std::min(tileX1, blockTileX1),
+                    std::min(tileY1, blockTileY1), rides);
+            }
+        }
+    }
+} // namespace OpenRCT2::RidePresenceIndex
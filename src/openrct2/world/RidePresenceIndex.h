@@ -0,0 +1,46 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2021 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#pragma once
+
+#include "../core/BitSet.hpp"
+#include "../ride/Ride.h"
+#include "Location.hpp"
+
+/**
+ * Coarse grid over the map recording which rides have track elements in each block of tiles. Blocks are marked dirty by
+ * tile element insertion and removal and rebuilt on the next Update, queries scan the tiles of dirty blocks directly so
+ * the result is always the same as scanning every tile.
+ */
+namespace OpenRCT2::RidePresenceIndex
+{
+    constexpr int32_t BlockSize = 8;
+
+    /**
+     * Discards the whole index, used when the tile elements are replaced.
+     */
+    void Reset();
+
+    void InvalidateTile(const CoordsXY& loc);
+
+    /**
+     * Rebuilds dirty blocks, must be called from the game thread. Queries are safe to run concurrently otherwise.
+     */
+    void Update();
+
+    /**
+     * Adds every ride that has a track element on the tiles within radius of the tile at centre.
+     */
+    void GetRidesInRange(const CoordsXY& centre, int32_t radius, OpenRCT2::BitSet<MAX_RIDES>& rides);
+
+    /**
+     * Adds every ride that has a track element on the tiles between from and to, both inclusive.
+     */
+    void GetRidesOnTiles(const TileCoordsXY& from, const TileCoordsXY& to, OpenRCT2::BitSet<MAX_RIDES>& rides);
+} // namespace OpenRCT2::RidePresenceIndex
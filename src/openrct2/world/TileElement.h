@@ -55,8 +55,6 @@ struct TileElementBase
     uint8_t clearance_height; // 3
     uint8_t owner;            // 4
 
-    void Remove();
-
     TileElementType GetType() const;
     void SetType(TileElementType newType);
 
@@ -80,11 +80,6 @@ void TileElementBase::SetGhost(bool isGhost)
     }
 }
 
-void TileElementBase::Remove()
-{
-    tile_element_remove(static_cast<TileElement*>(this));
-}
-
 uint8_t TileElementBase::GetOccupiedQuadrants() const
 {
     return Flags & TILE_ELEMENT_OCCUPIED_QUADRANTS_MASK;
@@ -17,6 +17,7 @@
 #include "../interface/Window.h"
 #include "../interface/Window_internal.h"
 #include "../localisation/Localisation.h"
+#include "../peep/SurroundingsCache.h"
 #include "../ride/Station.h"
 #include "../ride/Track.h"
 #include "../ride/TrackData.h"
@@ -163,7 +164,7 @@ namespace OpenRCT2::TileInspector
                 tileElement->RemoveBannerEntry();
             }
 
-            tile_element_remove(tileElement);
+            tile_element_remove(loc, tileElement);
             map_invalidate_tile_full(loc);
 
             if (auto* inspector = GetTileInspectorWithPos(loc); inspector != nullptr)
@@ -642,6 +643,7 @@ namespace OpenRCT2::TileInspector
         if (isExecuting)
         {
             pathElement->AsPath()->SetIsBroken(broken);
+            OpenRCT2::SurroundingsCache::InvalidateTile(loc);
 
             map_invalidate_tile_full(loc);
 
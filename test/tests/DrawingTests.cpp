@@ -0,0 +1,246 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2021 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+#include <algorithm>
+#include <array>
+#include <gtest/gtest.h>
+#include <openrct2/drawing/Drawing.h>
+#include <openrct2/drawing/SpriteCache.h>
+#include <openrct2/util/Util.h>
+#include <random>
+#include <vector>
+
+constexpr int32_t TEST_SPRITE_WIDTH = 200;
+constexpr int32_t TEST_SPRITE_HEIGHT = 16;
+
+class DrawingTest : public testing::Test
+{
+protected:
+    std::vector<uint8_t> _spriteData;
+    std::vector<uint8_t> _background;
+    std::array<uint8_t, 256> _paletteMap{};
+    rct_g1_element _g1{};
+    decltype(remap_run_fn) _savedRemapRunFn{};
+
+    void SetUp() override
+    {
+        _savedRemapRunFn = remap_run_fn;
+
+        std::mt19937 rng(1234);
+        auto random = [&rng](int32_t min, int32_t max) { return std::uniform_int_distribution<int32_t>(min, max)(rng); };
+
+        // Make a few palette entries transparent, they must be skipped just like transparent source pixels.
+        for (size_t i = 0; i < _paletteMap.size(); i++)
+        {
+            _paletteMap[i] = random(0, 7) == 0 ? 0 : static_cast<uint8_t>(random(1, 255));
+        }
+
+        // Runs of every length up to the maximum cover both the vectorised loops and their scalar tails.
+        _spriteData.resize(TEST_SPRITE_HEIGHT * 2);
+        for (int32_t y = 0; y < TEST_SPRITE_HEIGHT; y++)
+        {
+            auto lineOffset = _spriteData.size();
+            _spriteData[y * 2] = static_cast<uint8_t>(lineOffset & 0xFF);
+            _spriteData[y * 2 + 1] = static_cast<uint8_t>(lineOffset >> 8);
+
+            int32_t x = random(0, 8);
+            bool isEndOfLine = false;
+            while (!isEndOfLine)
+            {
+                int32_t numPixels = std::min(random(1, 0x7F), TEST_SPRITE_WIDTH - x);
+                int32_t nextX = x + numPixels + random(0, 8);
+                isEndOfLine = nextX >= TEST_SPRITE_WIDTH - 1;
+
+                _spriteData.push_back(static_cast<uint8_t>(numPixels | (isEndOfLine ? 0x80 : 0)));
+                _spriteData.push_back(static_cast<uint8_t>(x));
+                for (int32_t i = 0; i < numPixels; i++)
+                {
+                    _spriteData.push_back(random(0, 5) == 0 ? 0 : static_cast<uint8_t>(random(1, 255)));
+                }
+                x = nextX;
+            }
+        }
+
+        _g1.offset = _spriteData.data();
+        _g1.width = TEST_SPRITE_WIDTH;
+        _g1.height = TEST_SPRITE_HEIGHT;
+        _g1.flags = G1_FLAG_RLE_COMPRESSION;
+
+        // Leaves room for the padding at the end of each line when drawing zoomed out.
+        _background.resize((TEST_SPRITE_WIDTH + 1) * TEST_SPRITE_HEIGHT);
+        for (auto& pixel : _background)
+        {
+            pixel = static_cast<uint8_t>(random(0, 255));
+        }
+    }
+
+    void TearDown() override
+    {
+        remap_run_fn = _savedRemapRunFn;
+        sprite_cache_set_budget(0);
+        sprite_cache_clear();
+        sprite_cache_reset_stats();
+    }
+
+    // Decodes the sprite pixel by pixel, independently of the renderer.
+    std::vector<uint8_t> DrawReference(int32_t srcX, int32_t width) const
+    {
+        auto result = _background;
+        for (int32_t y = 0; y < TEST_SPRITE_HEIGHT; y++)
+        {
+            auto src = _spriteData.data() + (_spriteData[y * 2] | (_spriteData[y * 2 + 1] << 8));
+            bool isEndOfLine = false;
+            while (!isEndOfLine)
+            {
+                uint8_t dataSize = *src++;
+                uint8_t firstPixelX = *src++;
+                isEndOfLine = (dataSize & 0x80) != 0;
+                dataSize &= 0x7F;
+                for (int32_t i = 0; i < dataSize; i++)
+                {
+                    int32_t x = firstPixelX + i - srcX;
+                    uint8_t pixel = _paletteMap[src[i]];
+                    if (x >= 0 && x < width && src[i] != 0 && pixel != 0)
+                    {
+                        result[y * width + x] = pixel;
+                    }
+                }
+                src += dataSize;
+            }
+        }
+        return result;
+    }
+
+    std::vector<uint8_t> Draw(int32_t srcX, int32_t width)
+    {
+        auto result = _background;
+        rct_drawpixelinfo dpi;
+        dpi.bits = result.data();
+        dpi.width = width;
+        dpi.height = TEST_SPRITE_HEIGHT;
+
+        uint8_t paletteMapData[256];
+        std::copy(_paletteMap.begin(), _paletteMap.end(), paletteMapData);
+        PaletteMap paletteMap(paletteMapData);
+        DrawSpriteArgs args(ImageId(0, COLOUR_BRIGHT_RED), paletteMap, _g1, srcX, 0, width, TEST_SPRITE_HEIGHT, dpi.bits);
+        gfx_rle_sprite_to_buffer(dpi, args);
+        return result;
+    }
+
+    // Draws the sprite zoomed out, either through the sprite cache or the RLE decoder.
+    std::vector<uint8_t> DrawZoomed(ImageId imageId, int8_t zoomLevel, int32_t srcX, int32_t srcY, bool useCache)
+    {
+        auto bufferSize = ((TEST_SPRITE_WIDTH >> zoomLevel) + 1) * TEST_SPRITE_HEIGHT;
+        std::vector<uint8_t> result(_background.begin(), _background.begin() + bufferSize);
+        rct_drawpixelinfo dpi;
+        dpi.bits = result.data();
+        dpi.width = TEST_SPRITE_WIDTH;
+        dpi.height = TEST_SPRITE_HEIGHT;
+        dpi.pitch = 1;
+        dpi.zoom_level = ZoomLevel{ zoomLevel };
+
+        uint8_t paletteMapData[256];
+        std::copy(_paletteMap.begin(), _paletteMap.end(), paletteMapData);
+        PaletteMap paletteMap(paletteMapData);
+        DrawSpriteArgs args(imageId, paletteMap, _g1, srcX, srcY, TEST_SPRITE_WIDTH - 20, TEST_SPRITE_HEIGHT - 4, dpi.bits);
+        if (!useCache || !sprite_cache_draw(dpi, args, imageId.GetIndex()))
+        {
+            gfx_rle_sprite_to_buffer(dpi, args);
+        }
+        return result;
+    }
+
+    void TestRemapFunction(void (*remapFunction)(const uint8_t*, uint8_t*, int32_t, const uint8_t*))
+    {
+        remap_run_fn = remapFunction;
+        ASSERT_EQ(Draw(0, TEST_SPRITE_WIDTH), DrawReference(0, TEST_SPRITE_WIDTH));
+        ASSERT_EQ(Draw(13, TEST_SPRITE_WIDTH - 40), DrawReference(13, TEST_SPRITE_WIDTH - 40));
+    }
+};
+
+TEST_F(DrawingTest, RemapRunScalar)
+{
+    TestRemapFunction(remap_run_scalar);
+}
+
+TEST_F(DrawingTest, RemapRunSSE41)
+{
+    if (sse41_available())
+    {
+        TestRemapFunction(remap_run_sse4_1);
+    }
+}
+
+TEST_F(DrawingTest, RemapRunAVX2)
+{
+    if (avx2_available())
+    {
+        TestRemapFunction(remap_run_avx2);
+    }
+}
+
+TEST_F(DrawingTest, RemapRunShortPaletteMap)
+{
+    // Maps shorter than 256 entries can not be used as a lookup table and fall back to bounds checked lookups.
+    uint8_t paletteMapData[16]{};
+    PaletteMap paletteMap(paletteMapData);
+    ASSERT_EQ(paletteMap.GetLookupTable(), nullptr);
+}
+
+TEST_F(DrawingTest, SpriteCacheMatchesRLE)
+{
+    sprite_cache_set_budget(1024 * 1024);
+    for (auto imageId : { ImageId(0), ImageId(0, COLOUR_BRIGHT_RED) })
+    {
+        for (int8_t zoomLevel = 1; zoomLevel <= 3; zoomLevel++)
+        {
+            for (int32_t srcX : { -5, -1, 0, 3, 7 })
+            {
+                for (int32_t srcY : { -1, 0, 2 })
+                {
+                    ASSERT_EQ(
+                        DrawZoomed(imageId, zoomLevel, srcX, srcY, true), DrawZoomed(imageId, zoomLevel, srcX, srcY, false));
+                }
+            }
+        }
+    }
+
+    // The sprite is only decoded the first time it is drawn.
+    auto stats = sprite_cache_get_stats();
+    ASSERT_EQ(stats.Misses, 1U);
+    ASSERT_GT(stats.Hits, 0U);
+    ASSERT_EQ(stats.Entries, 1U);
+}
+
+TEST_F(DrawingTest, SpriteCacheBudget)
+{
+    // A sprite that does not fit within the budget is drawn without being cached.
+    sprite_cache_set_budget(64);
+    DrawZoomed(ImageId(0), 1, 0, 0, true);
+    ASSERT_EQ(sprite_cache_get_stats().Entries, 0U);
+
+    sprite_cache_set_budget(1024 * 1024);
+    DrawZoomed(ImageId(0), 1, 0, 0, true);
+    DrawZoomed(ImageId(1), 1, 0, 0, true);
+    ASSERT_EQ(sprite_cache_get_stats().Entries, 2U);
+
+    sprite_cache_invalidate(0);
+    ASSERT_EQ(sprite_cache_get_stats().Entries, 1U);
+
+    // Shrinking the budget evicts sprites.
+    sprite_cache_set_budget(64);
+    auto stats = sprite_cache_get_stats();
+    ASSERT_EQ(stats.Entries, 0U);
+    ASSERT_EQ(stats.MemoryUsed, 0U);
+    ASSERT_EQ(stats.Evictions, 1U);
+
+    // Zoom level 0 is always drawn by the RLE decoder.
+    sprite_cache_set_budget(1024 * 1024);
+    DrawZoomed(ImageId(0), 0, 0, 0, true);
+    ASSERT_EQ(sprite_cache_get_stats().Entries, 0U);
+}
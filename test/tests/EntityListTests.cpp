@@ -0,0 +1,235 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2021 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+#include <gtest/gtest.h>
+#include <limits>
+#include <openrct2/entity/EntityList.h>
+#include <openrct2/entity/EntityRegistry.h>
+#include <openrct2/entity/Litter.h>
+#include <openrct2/entity/LitterIndex.h>
+#include <openrct2/entity/MechanicIndex.h>
+#include <openrct2/entity/Staff.h>
+#include <openrct2/ride/Vehicle.h>
+#include <random>
+#include <vector>
+
+class EntityListTest : public testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        ResetAllEntities();
+    }
+
+    void TearDown() override
+    {
+        ResetAllEntities();
+    }
+
+    static std::vector<uint16_t> GetVehicleIds()
+    {
+        std::vector<uint16_t> ids;
+        for (auto* vehicle : EntityList<Vehicle>())
+        {
+            ids.push_back(vehicle->sprite_index);
+        }
+        return ids;
+    }
+};
+
+TEST_F(EntityListTest, IteratesInSpriteIndexOrder)
+{
+    for (uint16_t index : { 40, 7, 1000, 0, 12 })
+    {
+        ASSERT_NE(CreateEntityAt<Vehicle>(index), nullptr);
+    }
+    ASSERT_EQ(GetVehicleIds(), (std::vector<uint16_t>{ 0, 7, 12, 40, 1000 }));
+    ASSERT_EQ(GetEntityListCount(EntityType::Vehicle), 5);
+}
+
+TEST_F(EntityListTest, RemoveWhileIterating)
+{
+    for (int i = 0; i < 10; i++)
+    {
+        ASSERT_NE(CreateEntity<Vehicle>(), nullptr);
+    }
+
+    std::vector<uint16_t> visited;
+    for (auto* vehicle : EntityList<Vehicle>())
+    {
+        visited.push_back(vehicle->sprite_index);
+        // Remove the current vehicle and the one visited before it.
+        if (vehicle->sprite_index % 2 == 1)
+        {
+            EntityRemove(GetEntity(vehicle->sprite_index - 1));
+            EntityRemove(vehicle);
+        }
+    }
+    ASSERT_EQ(visited, (std::vector<uint16_t>{ 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 }));
+    ASSERT_EQ(GetEntityListCount(EntityType::Vehicle), 0);
+}
+
+TEST_F(EntityListTest, CreateWhileIterating)
+{
+    for (uint16_t index : { 0, 10, 20 })
+    {
+        ASSERT_NE(CreateEntityAt<Vehicle>(index), nullptr);
+    }
+
+    // The next entity is fixed when the current one is reached, like a linked list iterator.
+    std::vector<uint16_t> visited;
+    for (auto* vehicle : EntityList<Vehicle>())
+    {
+        visited.push_back(vehicle->sprite_index);
+        if (vehicle->sprite_index == 0)
+        {
+            CreateEntityAt<Vehicle>(5);
+            CreateEntityAt<Vehicle>(15);
+        }
+        else if (vehicle->sprite_index == 20)
+        {
+            CreateEntityAt<Vehicle>(30);
+        }
+    }
+    ASSERT_EQ(visited, (std::vector<uint16_t>{ 0, 10, 15, 20 }));
+    ASSERT_EQ(GetVehicleIds(), (std::vector<uint16_t>{ 0, 5, 10, 15, 20, 30 }));
+}
+
+TEST_F(EntityListTest, TileListFollowsMoves)
+{
+    const CoordsXYZ tileA{ 32 * 10 + 16, 32 * 10 + 16, 0 };
+    const CoordsXYZ tileB{ 32 * 11 + 16, 32 * 10 + 16, 0 };
+    for (uint16_t index : { 3, 1, 2, 0 })
+    {
+        auto* vehicle = CreateEntityAt<Vehicle>(index);
+        ASSERT_NE(vehicle, nullptr);
+        vehicle->MoveTo(tileA);
+    }
+
+    auto getTileIds = [](const CoordsXY& loc) {
+        std::vector<uint16_t> ids;
+        for (auto* vehicle : EntityTileList<Vehicle>(loc))
+        {
+            ids.push_back(vehicle->sprite_index);
+        }
+        return ids;
+    };
+    ASSERT_EQ(getTileIds(tileA), (std::vector<uint16_t>{ 0, 1, 2, 3 }));
+
+    GetEntity<Vehicle>(2)->MoveTo(tileB);
+    GetEntity<Vehicle>(0)->MoveTo(tileB);
+    EntityRemove(GetEntity(3));
+    ASSERT_EQ(getTileIds(tileA), (std::vector<uint16_t>{ 1 }));
+    ASSERT_EQ(getTileIds(tileB), (std::vector<uint16_t>{ 0, 2 }));
+
+    // Rebuilding the index keeps the same order.
+    ResetEntitySpatialIndices();
+    ASSERT_EQ(getTileIds(tileA), (std::vector<uint16_t>{ 1 }));
+    ASSERT_EQ(getTileIds(tileB), (std::vector<uint16_t>{ 0, 2 }));
+}
+
+TEST_F(EntityListTest, NearestLitterMatchesScan)
+{
+    constexpr uint16_t maxDistance = 3 * COORDS_XY_STEP;
+    std::mt19937 rng(1234);
+    auto randomLocation = [&rng](int32_t size) {
+        return CoordsXYZ{ static_cast<int32_t>(rng() % size), static_cast<int32_t>(rng() % size),
+                          static_cast<int32_t>(rng() % 2048) };
+    };
+
+    // Clustered litter to get ties, plus litter in the far corners and outside the map where distances wrap around.
+    for (int i = 0; i < 400; i++)
+    {
+        auto* litter = CreateEntity<Litter>();
+        ASSERT_NE(litter, nullptr);
+        auto loc = randomLocation(20 * COORDS_XY_STEP);
+        if (i % 10 == 0)
+        {
+            loc.x = MAXIMUM_MAP_SIZE_BIG - 1 - loc.x;
+            loc.y = MAXIMUM_MAP_SIZE_BIG - 1 - loc.y;
+        }
+        if (i % 50 != 0)
+        {
+            litter->MoveTo(loc);
+        }
+    }
+
+    for (int i = 0; i < 2000; i++)
+    {
+        const auto loc = randomLocation(i % 2 == 0 ? 20 * COORDS_XY_STEP : MAXIMUM_MAP_SIZE_BIG);
+        uint16_t nearestDistance = 0xFFFF;
+        Litter* expected = nullptr;
+        for (auto* litter : EntityList<Litter>())
+        {
+            uint16_t distance = abs(litter->x - loc.x) + abs(litter->y - loc.y) + abs(litter->z - loc.z) * 4;
+            if (distance < nearestDistance)
+            {
+                nearestDistance = distance;
+                expected = litter;
+            }
+        }
+        if (nearestDistance > maxDistance)
+        {
+            expected = nullptr;
+        }
+        ASSERT_EQ(OpenRCT2::LitterIndex::FindNearest(loc, maxDistance), expected);
+    }
+}
+
+TEST_F(EntityListTest, NearestMechanicMatchesScan)
+{
+    std::mt19937 rng(4321);
+    auto randomLocation = [&rng](int32_t size) {
+        // Locations on a coarse grid give equal distances, so ties are common.
+        return CoordsXYZ{ static_cast<int32_t>(rng() % size) & ~0xF, static_cast<int32_t>(rng() % size) & ~0xF, 0 };
+    };
+
+    // Mechanics and handymen, some never placed, some moved and some removed again.
+    std::vector<Staff*> staff;
+    for (int i = 0; i < 300; i++)
+    {
+        auto* peep = CreateEntity<Staff>();
+        ASSERT_NE(peep, nullptr);
+        peep->AssignedStaffType = i % 4 == 0 ? StaffType::Handyman : StaffType::Mechanic;
+        if (i % 25 != 0)
+        {
+            peep->MoveTo(randomLocation(i % 3 == 0 ? MAXIMUM_MAP_SIZE_BIG : 40 * COORDS_XY_STEP));
+        }
+        staff.push_back(peep);
+    }
+    for (size_t i = 0; i < staff.size(); i += 7)
+    {
+        staff[i]->MoveTo(randomLocation(MAXIMUM_MAP_SIZE_BIG));
+    }
+    for (size_t i = 3; i < staff.size(); i += 11)
+    {
+        EntityRemove(staff[i]);
+    }
+
+    for (int i = 0; i < 2000; i++)
+    {
+        const auto loc = randomLocation(i % 2 == 0 ? 40 * COORDS_XY_STEP : MAXIMUM_MAP_SIZE_BIG);
+        auto isSuitable = [i](const Staff& peep) { return (peep.sprite_index + i) % 5 != 0; };
+
+        uint32_t nearestDistance = std::numeric_limits<uint32_t>::max();
+        Staff* expected = nullptr;
+        for (auto* peep : EntityList<Staff>())
+        {
+            if (!peep->IsMechanic() || peep->x == LOCATION_NULL || !isSuitable(*peep))
+                continue;
+
+            uint32_t distance = std::abs(peep->x - loc.x) + std::abs(peep->y - loc.y);
+            if (distance < nearestDistance)
+            {
+                nearestDistance = distance;
+                expected = peep;
+            }
+        }
+        ASSERT_EQ(OpenRCT2::MechanicIndex::FindNearest(loc, isSuitable), expected);
+    }
+}
@@ -0,0 +1,141 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2021 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "TestData.h"
+
+#include <gtest/gtest.h>
+#include <openrct2/Context.h>
+#include <openrct2/Game.h>
+#include <openrct2/GameState.h>
+#include <openrct2/GameStateSnapshots.h>
+#include <openrct2/OpenRCT2.h>
+#include <openrct2/core/MemoryStream.h>
+#include <openrct2/entity/EntityList.h>
+#include <openrct2/entity/EntityRegistry.h>
+#include <openrct2/entity/MoneyEffect.h>
+#include <openrct2/platform/platform.h>
+#include <openrct2/scenario/Scenario.h>
+#include <openrct2/world/Map.h>
+#include <string>
+#include <vector>
+
+using namespace OpenRCT2;
+
+class GameStateSnapshotsTest : public testing::Test
+{
+public:
+    static void SetUpTestCase()
+    {
+        core_init();
+
+        gOpenRCT2Headless = true;
+        gOpenRCT2NoGraphics = true;
+        _context = CreateContext();
+        const bool initialised = _context->Initialise();
+        ASSERT_TRUE(initialised);
+
+        std::string parkPath = TestData::GetParkPath("bpb.sv6");
+        load_from_sv6(parkPath.c_str());
+        game_load_init();
+    }
+
+    static void TearDownTestCase()
+    {
+        _context = nullptr;
+    }
+
+protected:
+    // Captures the current state into a new snapshot of the given history.
+    static GameStateSnapshot_t& Capture(IGameStateSnapshots& snapshots)
+    {
+        auto& snapshot = snapshots.CreateSnapshot();
+        snapshots.Capture(snapshot);
+        snapshots.LinkSnapshot(snapshot, gCurrentTicks, scenario_rand_state().s0);
+        return snapshot;
+    }
+
+    // Serialising a snapshot writes its full state, which for snapshots that are not keyframes is materialised first.
+    static std::vector<uint8_t> Serialise(const IGameStateSnapshots& snapshots, GameStateSnapshot_t& snapshot)
+    {
+        MemoryStream stream;
+        DataSerialiser ds(true, stream);
+        snapshots.SerialiseSnapshot(snapshot, ds);
+        const auto* data = static_cast<const uint8_t*>(stream.GetData());
+        return std::vector<uint8_t>(data, data + stream.GetLength());
+    }
+
+    static void ExpectEqualStates(
+        const IGameStateSnapshots& snapshots, const GameStateSnapshot_t& left, const GameStateSnapshot_t& right,
+        int32_t capture)
+    {
+        auto cmpData = snapshots.Compare(left, right);
+        for (const auto& change : cmpData.spriteChanges)
+        {
+            EXPECT_EQ(change.changeType, GameStateSpriteChange_t::EQUAL)
+                << "capture " << capture << ", entity " << change.spriteIndex;
+        }
+        EXPECT_TRUE(cmpData.tileChanges.empty()) << "capture " << capture;
+        EXPECT_TRUE(cmpData.rideChanges.empty()) << "capture " << capture;
+    }
+
+    static std::shared_ptr<IContext> _context;
+};
+
+std::shared_ptr<IContext> GameStateSnapshotsTest::_context;
+
+TEST_F(GameStateSnapshotsTest, DeltasMaterialiseToFullCaptures)
+{
+    // Spans three keyframes, every eighth capture is one.
+    constexpr int32_t NumCaptures = 20;
+
+    auto snapshots = CreateGameStateSnapshots();
+    std::vector<GameStateSnapshot_t*> captured;
+    std::vector<std::vector<uint8_t>> fullStates;
+
+    auto* gameState = _context->GetGameState();
+    auto centre = CoordsXY{ (gMapSize / 2) * COORDS_XY_STEP, (gMapSize / 2) * COORDS_XY_STEP };
+    for (int32_t i = 0; i < NumCaptures; i++)
+    {
+        // Entities are created and removed between the captures, so records are added to and missing from the
+        // keyframes, and freed indices are reused by other entities.
+        if (i % 3 == 1)
+        {
+            auto loc = CoordsXYZ{ centre + CoordsXY{ i * COORDS_XY_STEP, 0 }, tile_element_height(centre) };
+            MoneyEffect::CreateAt(MONEY(i, 00), loc, false);
+        }
+        if (i % 4 == 2)
+        {
+            for (auto* moneyEffect : EntityList<MoneyEffect>())
+            {
+                EntityRemove(moneyEffect);
+                break;
+            }
+        }
+        gameState->UpdateLogic();
+
+        // A history of its own only holds a single capture, which is always a keyframe.
+        auto fullSnapshots = CreateGameStateSnapshots();
+        auto& full = Capture(*fullSnapshots);
+        auto& snapshot = Capture(*snapshots);
+
+        fullStates.push_back(Serialise(*fullSnapshots, full));
+        EXPECT_EQ(Serialise(*snapshots, snapshot), fullStates.back()) << "capture " << i;
+        ExpectEqualStates(*snapshots, snapshot, full, i);
+        captured.push_back(&snapshot);
+    }
+
+    // Earlier captures keep their own keyframe after newer ones replaced it.
+    for (int32_t i = 0; i < NumCaptures; i++)
+    {
+        EXPECT_EQ(Serialise(*snapshots, *captured[i]), fullStates[i]) << "capture " << i;
+    }
+
+    // The state did change between the captures.
+    EXPECT_NE(fullStates.front(), fullStates.back());
+}
@@ -0,0 +1,72 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2021 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+#include <atomic>
+#include <gtest/gtest.h>
+#include <numeric>
+#include <openrct2/core/JobPool.h>
+#include <vector>
+
+// Enough tasks to make the workers steal from each other.
+constexpr size_t TEST_TASK_COUNT = 10000;
+
+TEST(JobPoolTest, AddTaskAndJoin)
+{
+    JobPool jobPool;
+    std::atomic<size_t> executed = { 0 };
+    size_t completed = 0;
+    for (size_t i = 0; i < TEST_TASK_COUNT; i++)
+    {
+        jobPool.AddTask([&executed]() { executed++; }, [&completed]() { completed++; });
+    }
+    jobPool.Join();
+
+    ASSERT_EQ(executed, TEST_TASK_COUNT);
+    ASSERT_EQ(completed, TEST_TASK_COUNT);
+    ASSERT_EQ(jobPool.CountPending(), 0U);
+
+    size_t statsExecuted = 0;
+    for (const auto& stats : jobPool.GetStatistics())
+    {
+        statsExecuted += stats.TasksExecuted;
+    }
+    ASSERT_EQ(statsExecuted, TEST_TASK_COUNT);
+}
+
+TEST(JobPoolTest, ParallelFor)
+{
+    JobPool jobPool;
+    std::vector<size_t> values(TEST_TASK_COUNT, 0);
+    jobPool.ParallelFor(0, values.size(), 64, [&values](size_t i) { values[i] = i; });
+
+    std::vector<size_t> expected(TEST_TASK_COUNT);
+    std::iota(expected.begin(), expected.end(), 0);
+    ASSERT_EQ(values, expected);
+}
+
+TEST(JobPoolTest, NestedParallelFor)
+{
+    JobPool jobPool;
+    std::atomic<size_t> sum = { 0 };
+    jobPool.ParallelFor(0, 100, 1, [&jobPool, &sum](size_t) {
+        jobPool.ParallelFor(0, 100, 10, [&sum](size_t j) { sum += j; });
+    });
+    ASSERT_EQ(sum, 100U * 4950U);
+}
+
+TEST(JobPoolTest, NoWorkers)
+{
+    JobPool jobPool(0);
+    ASSERT_EQ(jobPool.CountWorkers(), 0U);
+
+    size_t executed = 0;
+    jobPool.AddTask([&executed]() { executed++; });
+    jobPool.Join();
+    jobPool.ParallelFor(0, 10, 3, [&executed](size_t) { executed++; });
+    ASSERT_EQ(executed, 11U);
+}
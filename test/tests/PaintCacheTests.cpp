@@ -0,0 +1,272 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2021 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "TestData.h"
+
+#include <cstdio>
+#include <gtest/gtest.h>
+#include <openrct2/Context.h>
+#include <openrct2/Game.h>
+#include <openrct2/OpenRCT2.h>
+#include <openrct2/actions/RideSetAppearanceAction.h>
+#include <openrct2/config/Config.h>
+#include <openrct2/interface/Viewport.h>
+#include <openrct2/paint/Paint.h>
+#include <openrct2/paint/PaintCache.h>
+#include <openrct2/platform/platform.h>
+#include <openrct2/ride/Ride.h>
+#include <openrct2/util/Math.hpp>
+#include <openrct2/world/Map.h>
+#include <string>
+#include <vector>
+
+using namespace OpenRCT2;
+
+class PaintCacheTest : public testing::Test
+{
+public:
+    static void SetUpTestCase()
+    {
+        core_init();
+
+        // Paint structs are culled by the size of their images, so the graphics are needed.
+        gOpenRCT2Headless = true;
+        gOpenRCT2NoGraphics = false;
+        _context = CreateContext();
+        const bool initialised = _context->Initialise();
+        ASSERT_TRUE(initialised);
+
+        std::string parkPath = TestData::GetParkPath("bpb.sv6");
+        load_from_sv6(parkPath.c_str());
+        game_load_init();
+    }
+
+    void SetUp() override
+    {
+        gConfigGeneral.paint_cache = true;
+        gCurrentRotation = 0;
+        PaintCache::Reset();
+        PaintCache::ResetStats();
+    }
+
+    void TearDown() override
+    {
+        gConfigGeneral.paint_cache = false;
+        PaintCache::BeginViewport();
+        gCurrentRotation = 0;
+    }
+
+    static void TearDownTestCase()
+    {
+        _context = nullptr;
+    }
+
+protected:
+    static constexpr int32_t NumColumns = 8;
+    static constexpr int32_t ColumnHeight = 512;
+
+    /**
+     * Returns the area of a column of a viewport looking at the middle of the map, like the columns viewport_paint
+     * splits the area being drawn into.
+     */
+    static rct_drawpixelinfo GetColumnDPI(int32_t column, const ScreenCoordsXY& offset = {})
+    {
+        CoordsXY centre = { (gMapSize / 2) * COORDS_XY_STEP + 16, (gMapSize / 2) * COORDS_XY_STEP + 16 };
+        auto screenCentre = translate_3d_to_2d_with_z(get_current_rotation(), { centre, tile_element_height(centre) });
+
+        rct_drawpixelinfo dpi;
+        dpi.x = floor2(screenCentre.x - NumColumns * 16, 32) + column * 32 + offset.x;
+        dpi.y = screenCentre.y - ColumnHeight / 2 + offset.y;
+        dpi.width = 32;
+        dpi.height = ColumnHeight;
+        dpi.pitch = 0;
+        dpi.bits = nullptr;
+        dpi.zoom_level = ZoomLevel{ 0 };
+        return dpi;
+    }
+
+    /**
+     * Returns an area of two columns around the centre of a tile.
+     */
+    static rct_drawpixelinfo GetTileDPI(const CoordsXY& loc)
+    {
+        CoordsXY centre = loc.ToTileCentre();
+        auto screenCentre = translate_3d_to_2d_with_z(get_current_rotation(), { centre, tile_element_height(centre) });
+
+        rct_drawpixelinfo dpi;
+        dpi.x = floor2(screenCentre.x - 32, 32);
+        dpi.y = screenCentre.y - ColumnHeight / 2;
+        dpi.width = 64;
+        dpi.height = ColumnHeight;
+        dpi.pitch = 0;
+        dpi.bits = nullptr;
+        dpi.zoom_level = ZoomLevel{ 0 };
+        return dpi;
+    }
+
+    static void DescribeStruct(std::string& out, const paint_struct& ps)
+    {
+        char buffer[256];
+        snprintf(
+            buffer, sizeof(buffer), "image %08X/%08X at %d,%d bounds %d,%d,%d-%d,%d,%d flags %u type %u map %d,%d element %p",
+            ps.image_id.ToUInt32(), ps.colour_image_id.ToUInt32(), ps.x, ps.y, ps.bounds.x, ps.bounds.y, ps.bounds.z,
+            ps.bounds.x_end, ps.bounds.y_end, ps.bounds.z_end, ps.flags, static_cast<uint32_t>(ps.sprite_type), ps.map_x,
+            ps.map_y, static_cast<const void*>(ps.tileElement));
+        out += buffer;
+        for (auto* attached = ps.attached_ps; attached != nullptr; attached = attached->next)
+        {
+            snprintf(
+                buffer, sizeof(buffer), " attached %08X/%08X at %d,%d flags %u", attached->image_id.ToUInt32(),
+                attached->colour_image_id.ToUInt32(), attached->x, attached->y, attached->flags);
+            out += buffer;
+        }
+    }
+
+    /**
+     * Paints the tiles and entities of a column and describes the paint structs in the order of the quadrants,
+     * including their children and attached structs.
+     */
+    static std::vector<std::string> PaintColumn(rct_drawpixelinfo dpi, bool useTileCache)
+    {
+        auto* session = PaintSessionAlloc(&dpi, 0);
+        session->UseTileCache = useTileCache;
+        PaintSessionGenerate(*session);
+
+        std::vector<std::string> structs;
+        for (uint32_t quadrant = 0; quadrant < MaxPaintQuadrants; quadrant++)
+        {
+            for (auto* ps = session->Quadrants[quadrant]; ps != nullptr; ps = ps->next_quadrant_ps)
+            {
+                auto description = "quadrant " + std::to_string(quadrant) + ": ";
+                DescribeStruct(description, *ps);
+                for (auto* child = ps->children; child != nullptr; child = child->children)
+                {
+                    description += " child ";
+                    DescribeStruct(description, *child);
+                }
+                structs.push_back(std::move(description));
+            }
+        }
+
+        PaintSessionFree(session);
+        return structs;
+    }
+
+    static std::shared_ptr<IContext> _context;
+};
+
+std::shared_ptr<IContext> PaintCacheTest::_context;
+
+TEST_F(PaintCacheTest, ReplayedColumnsMatchFreshPaint)
+{
+    for (uint8_t rotation = 0; rotation < 4; rotation++)
+    {
+        gCurrentRotation = rotation;
+        for (int32_t column = 0; column < NumColumns; column++)
+        {
+            auto dpi = GetColumnDPI(column);
+            auto fresh = PaintColumn(dpi, false);
+            ASSERT_FALSE(fresh.empty());
+
+            ASSERT_TRUE(PaintCache::BeginViewport());
+            EXPECT_EQ(fresh, PaintColumn(dpi, true)) << "recorded, rotation " << int(rotation) << ", column " << column;
+            ASSERT_TRUE(PaintCache::BeginViewport());
+            EXPECT_EQ(fresh, PaintColumn(dpi, true)) << "replayed, rotation " << int(rotation) << ", column " << column;
+        }
+    }
+    EXPECT_GT(PaintCache::GetStats().Hits, 0U);
+}
+
+TEST_F(PaintCacheTest, TilesAreReusedByOtherAreas)
+{
+    for (int32_t column = 0; column < NumColumns; column++)
+    {
+        ASSERT_TRUE(PaintCache::BeginViewport());
+        PaintColumn(GetColumnDPI(column), true);
+    }
+    PaintCache::ResetStats();
+
+    // Areas of a scrolled viewport and of dirty rectangles do not line up with the columns the tiles were recorded by.
+    const ScreenCoordsXY offsets[] = { { 7, 0 }, { 0, 13 }, { -19, 5 } };
+    for (const auto& offset : offsets)
+    {
+        for (int32_t column = 1; column < NumColumns - 1; column++)
+        {
+            auto dpi = GetColumnDPI(column, offset);
+            dpi.height = ColumnHeight / 2;
+            auto fresh = PaintColumn(dpi, false);
+
+            ASSERT_TRUE(PaintCache::BeginViewport());
+            EXPECT_EQ(fresh, PaintColumn(dpi, true)) << "offset " << offset.x << "," << offset.y << ", column " << column;
+        }
+    }
+
+    auto stats = PaintCache::GetStats();
+    EXPECT_GT(stats.Hits, 0U);
+    EXPECT_GT(stats.Hits, stats.Misses);
+}
+
+TEST_F(PaintCacheTest, InvalidatedTileIsRecordedAgain)
+{
+    auto dpi = GetColumnDPI(NumColumns / 2);
+    auto fresh = PaintColumn(dpi, false);
+    ASSERT_TRUE(PaintCache::BeginViewport());
+    PaintColumn(dpi, true);
+
+    PaintCache::ResetStats();
+    ASSERT_TRUE(PaintCache::BeginViewport());
+    EXPECT_EQ(fresh, PaintColumn(dpi, true));
+    EXPECT_EQ(PaintCache::GetStats().Misses, 0U);
+    EXPECT_GT(PaintCache::GetStats().Hits, 0U);
+
+    // The tile in the middle of the column, which is painted by it.
+    auto loc = viewport_coord_to_map_coord({ dpi.x + dpi.width / 2, dpi.y + dpi.height / 2 }, 0).ToTileStart();
+    ASSERT_TRUE(map_is_location_valid(loc));
+    map_invalidate_tile({ loc, 0, 2032 });
+
+    PaintCache::ResetStats();
+    ASSERT_TRUE(PaintCache::BeginViewport());
+    EXPECT_EQ(fresh, PaintColumn(dpi, true));
+    EXPECT_GT(PaintCache::GetStats().Misses, 0U);
+}
+
+TEST_F(PaintCacheTest, RideColoursChangedWithinTickArePainted)
+{
+    Ride* ride = nullptr;
+    for (auto& candidate : GetRideManager())
+    {
+        if (!candidate.stations[0].Start.IsNull())
+        {
+            ride = &candidate;
+            break;
+        }
+    }
+    ASSERT_NE(ride, nullptr);
+
+    // Track and entrances are animated tiles, which are replayed as long as the tick does not change.
+    auto dpi = GetTileDPI(ride->stations[0].Start);
+    auto before = PaintColumn(dpi, false);
+    ASSERT_TRUE(PaintCache::BeginViewport());
+    EXPECT_EQ(before, PaintColumn(dpi, true));
+
+    // Ride colours can be changed while the game is paused, the action only invalidates the screen.
+    const auto tick = gCurrentTicks;
+    for (uint32_t scheme = 0; scheme < std::size(ride->track_colour); scheme++)
+    {
+        auto colour = static_cast<uint16_t>((ride->track_colour[scheme].main + 1) % COLOUR_COUNT);
+        auto action = RideSetAppearanceAction(ride->id, RideSetAppearanceType::TrackColourMain, colour, scheme);
+        ASSERT_EQ(GameActions::Execute(&action).Error, GameActions::Status::Ok);
+    }
+    ASSERT_EQ(gCurrentTicks, tick);
+
+    auto after = PaintColumn(dpi, false);
+    ASSERT_NE(before, after);
+    ASSERT_TRUE(PaintCache::BeginViewport());
+    EXPECT_EQ(after, PaintColumn(dpi, true));
+}
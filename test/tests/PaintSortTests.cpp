@@ -0,0 +1,114 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2021 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+#include <algorithm>
+#include <gtest/gtest.h>
+#include <memory>
+#include <openrct2/paint/Paint.h>
+#include <random>
+#include <vector>
+
+// A session of paint structs that can be arranged several times from the same starting state.
+class TestPaintSession
+{
+private:
+    std::vector<paint_struct> _structs;
+    uint8_t _rotation;
+
+public:
+    TestPaintSession(uint32_t seed, uint8_t rotation, size_t count)
+        : _structs(count)
+        , _rotation(rotation)
+    {
+        // Structs are spread over a strip of tiles across the map, like the ones of a viewport column, with some of them
+        // stacked on the same tiles so that their bounding boxes overlap.
+        std::mt19937 rng(seed);
+        auto random = [&rng](int32_t min, int32_t max) { return std::uniform_int_distribution<int32_t>(min, max)(rng); };
+        for (auto& ps : _structs)
+        {
+            int32_t depth = random(0, 40);
+            int32_t across = random(-4, 4);
+            ps.bounds.x = (depth + across) * 16 + random(0, 31);
+            ps.bounds.y = (depth - across) * 16 + random(0, 31);
+            ps.bounds.z = random(0, 12) * 8;
+            ps.bounds.x_end = ps.bounds.x + random(0, 32);
+            ps.bounds.y_end = ps.bounds.y + random(0, 32);
+            ps.bounds.z_end = ps.bounds.z + random(0, 64);
+        }
+    }
+
+    // Returns the order of the structs as indices after arranging them.
+    std::vector<size_t> Arrange(PaintSortAlgorithm algorithm)
+    {
+        auto structs = _structs;
+        auto session = std::make_unique<PaintSessionCore>();
+        session->CurrentRotation = _rotation;
+        session->QuadrantBackIndex = UINT32_MAX;
+        session->QuadrantFrontIndex = 0;
+        std::fill(std::begin(session->Quadrants), std::end(session->Quadrants), nullptr);
+
+        for (auto& ps : structs)
+        {
+            int32_t key;
+            switch (_rotation)
+            {
+                case 0:
+                    key = ps.bounds.x + ps.bounds.y;
+                    break;
+                case 1:
+                    key = ps.bounds.y - ps.bounds.x + 1024;
+                    break;
+                case 2:
+                    key = 2048 - (ps.bounds.x + ps.bounds.y);
+                    break;
+                default:
+                    key = ps.bounds.x - ps.bounds.y + 1024;
+                    break;
+            }
+            uint32_t quadrantIndex = std::clamp(key / 32, 0, MaxPaintQuadrants - 1);
+            ps.quadrant_index = static_cast<uint16_t>(quadrantIndex);
+            ps.next_quadrant_ps = session->Quadrants[quadrantIndex];
+            session->Quadrants[quadrantIndex] = &ps;
+            session->QuadrantBackIndex = std::min(session->QuadrantBackIndex, quadrantIndex);
+            session->QuadrantFrontIndex = std::max(session->QuadrantFrontIndex, quadrantIndex);
+        }
+
+        PaintSessionArrange(*session, algorithm);
+
+        std::vector<size_t> order;
+        for (auto* ps = session->PaintHead.next_quadrant_ps; ps != nullptr; ps = ps->next_quadrant_ps)
+        {
+            order.push_back(ps - structs.data());
+        }
+        return order;
+    }
+};
+
+TEST(PaintSortTest, SpatialMatchesOriginal)
+{
+    for (uint8_t rotation = 0; rotation < 4; rotation++)
+    {
+        for (uint32_t seed = 0; seed < 20; seed++)
+        {
+            TestPaintSession session(seed, rotation, 50 + seed * 100);
+            auto expected = session.Arrange(PaintSortAlgorithm::Original);
+            ASSERT_EQ(expected.size(), 50 + seed * 100);
+            ASSERT_EQ(session.Arrange(PaintSortAlgorithm::Spatial), expected)
+                << "rotation " << static_cast<int32_t>(rotation) << " seed " << seed;
+        }
+    }
+}
+
+TEST(PaintSortTest, EmptySession)
+{
+    for (auto algorithm : { PaintSortAlgorithm::Original, PaintSortAlgorithm::Spatial })
+    {
+        TestPaintSession session(0, 0, 0);
+        ASSERT_TRUE(session.Arrange(algorithm).empty());
+    }
+}
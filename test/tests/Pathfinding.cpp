@@ -2,6 +2,7 @@
 #include "openrct2/core/StringReader.h"
 #include "openrct2/entity/Guest.h"
 #include "openrct2/peep/GuestPathfinding.h"
+#include "openrct2/peep/PathGraph.h"
 #include "openrct2/ride/Station.h"
 #include "openrct2/scenario/Scenario.h"
 
@@ -10,6 +11,7 @@
 #include <openrct2/Game.h>
 #include <openrct2/OpenRCT2.h>
 #include <openrct2/ParkImporter.h>
+#include <openrct2/config/Config.h>
 #include <openrct2/platform/platform.h>
 #include <openrct2/world/Footpath.h>
 #include <openrct2/world/Map.h>
@@ -64,7 +66,8 @@ protected:
         return nullptr;
     }
 
-    static bool FindPath(TileCoordsXYZ* pos, const TileCoordsXYZ& goal, int expectedSteps, ride_id_t targetRideID)
+    static bool FindPath(
+        TileCoordsXYZ* pos, const TileCoordsXYZ& goal, int expectedSteps, ride_id_t targetRideID, int* stepsTaken = nullptr)
     {
         // Our start position is in tile coordinates, but we need to give the peep spawn
         // position in actual world coords (32 units per tile X/Y, 8 per Z level).
@@ -125,8 +128,15 @@ protected:
         // deterministic, and we reset the RNG seed for each test, everything should be entirely repeatable; as
         // such a change in the number of steps taken on one of these paths needs to be reviewed. For the negative
         // tests, we will not have reached the goal but we still expect the loop to have run for the total number
-        // of steps requested before giving up.
-        EXPECT_EQ(step, expectedSteps);
+        // of steps requested before giving up. Callers that compare the number of steps themselves get it instead.
+        if (stepsTaken != nullptr)
+        {
+            *stepsTaken = step;
+        }
+        else
+        {
+            EXPECT_EQ(step, expectedSteps);
+        }
 
         return *pos == goal;
     }
@@ -251,3 +261,75 @@ INSTANTIATE_TEST_CASE_P(
         SimplePathfindingScenario("PathWithFences", { 11, 6, 14 }, 10000),
         SimplePathfindingScenario("PathWithCliff", { 7, 17, 14 }, 10000)),
     SimplePathfindingScenario::ToName);
+
+class ImprovedPathfindingTest : public SimplePathfindingTest
+{
+public:
+    void SetUp() override
+    {
+        SimplePathfindingTest::SetUp();
+        gConfigGeneral.improved_guest_pathfinding = true;
+    }
+
+    void TearDown() override
+    {
+        gConfigGeneral.improved_guest_pathfinding = false;
+    }
+};
+
+TEST_P(ImprovedPathfindingTest, CanFindPathFromStartToGoal)
+{
+    const SimplePathfindingScenario& scenario = GetParam();
+
+    ASSERT_PRED_FORMAT1(AssertIsStartPosition, scenario.start);
+    TileCoordsXYZ pos = scenario.start;
+
+    auto ride = FindRideByName(scenario.name);
+    ASSERT_NE(ride, nullptr);
+
+    auto entrancePos = ride_get_entrance_location(ride, 0);
+    TileCoordsXYZ goal = TileCoordsXYZ(
+        entrancePos.x - TileDirectionDelta[entrancePos.direction].x,
+        entrancePos.y - TileDirectionDelta[entrancePos.direction].y, entrancePos.z);
+
+    // Walk the route with the heuristic search first, the routing tables give the shortest route which is never longer.
+    gConfigGeneral.improved_guest_pathfinding = false;
+    TileCoordsXYZ heuristicPos = scenario.start;
+    int heuristicSteps = 0;
+    ASSERT_TRUE(FindPath(&heuristicPos, goal, scenario.steps, ride->id, &heuristicSteps));
+
+    gConfigGeneral.improved_guest_pathfinding = true;
+    ASSERT_TRUE(PathGraph::IsImprovedModeActive());
+    scenario_rand_seed(0x12345678, 0x87654321);
+    PathGraph::ResetStats();
+    int improvedSteps = 0;
+    EXPECT_TRUE(FindPath(&pos, goal, scenario.steps, ride->id, &improvedSteps))
+        << "Failed to find path from " << scenario.start << " to " << goal << " in " << scenario.steps << " steps; reached "
+        << pos << " before giving up.";
+    EXPECT_LE(improvedSteps, heuristicSteps);
+
+    // Every junction on the way was decided by the routing tables, none fell back to the heuristic search.
+    auto stats = PathGraph::GetStats();
+    EXPECT_EQ(stats.RoutedDirections, stats.Queries);
+
+    // The graph routes the start tile to the goal, whether or not the route has junctions to consult it at.
+    auto* pathElement = map_get_footpath_element(scenario.start.ToCoordsXYZ());
+    ASSERT_NE(pathElement, nullptr);
+    auto edges = path_get_guest_permitted_edges(pathElement->AsPath());
+    EXPECT_NE(
+        PathGraph::ChooseDirection(scenario.start, edges, goal, gPeepPathFindQueueRideIndex, gPeepPathFindIgnoreForeignQueues),
+        INVALID_DIRECTION);
+    EXPECT_GT(PathGraph::GetStats().Nodes, 0u);
+}
+
+INSTANTIATE_TEST_CASE_P(
+    ForScenario, ImprovedPathfindingTest,
+    ::testing::Values(
+        SimplePathfindingScenario("StraightFlat", { 19, 15, 14 }, 24), SimplePathfindingScenario("SBend", { 15, 12, 14 }, 87),
+        SimplePathfindingScenario("UBend", { 17, 9, 14 }, 87), SimplePathfindingScenario("CBend", { 14, 5, 14 }, 164),
+        SimplePathfindingScenario("TwoEqualRoutes", { 9, 13, 14 }, 89),
+        SimplePathfindingScenario("TwoUnequalRoutes", { 3, 13, 14 }, 89),
+        SimplePathfindingScenario("StraightUpBridge", { 12, 15, 14 }, 24),
+        SimplePathfindingScenario("StraightUpSlope", { 14, 15, 14 }, 24),
+        SimplePathfindingScenario("SelfCrossingPath", { 6, 5, 14 }, 211)),
+    SimplePathfindingScenario::ToName);
@@ -17,10 +17,14 @@
 #include <openrct2/ParkImporter.h>
 #include <openrct2/actions/ParkSetParameterAction.h>
 #include <openrct2/actions/RideSetPriceAction.h>
+#include <openrct2/cmdline/CommandLine.hpp>
+#include <openrct2/config/Config.h>
+#include <openrct2/core/Json.hpp>
 #include <openrct2/entity/EntityRegistry.h>
 #include <openrct2/entity/EntityTweener.h>
 #include <openrct2/entity/Peep.h>
 #include <openrct2/object/ObjectManager.h>
+#include <openrct2/peep/GuestThink.h>
 #include <openrct2/platform/platform.h>
 #include <openrct2/ride/Ride.h>
 #include <openrct2/world/MapAnimation.h>
@@ -193,3 +197,83 @@ TEST_F(PlayTests, CarRideWithOneCarOnlyAcceptsTwoGuests)
         gs->UpdateLogic();
     }
 }
+
+TEST_F(PlayTests, MultithreadedGuestUpdateMatchesSerialUpdate)
+{
+    // The think phase of the multithreaded guest update must not change the outcome of the simulation,
+    // run the same park with and without it and compare the entity checksums.
+    constexpr int32_t numTicks = 2000;
+    constexpr int32_t checksumInterval = 100;
+    std::string initStateFile = TestData::GetParkPath("bpb.sv6");
+
+    auto runPark = [&](bool multithreaded, GuestThink::Stats& stats) {
+        std::vector<std::string> checksums;
+        gConfigGeneral.multithreaded_guest_update = multithreaded;
+        GuestThink::ResetStats();
+
+        auto context = localStartGame(initStateFile);
+        EXPECT_NE(context.get(), nullptr);
+        if (context == nullptr)
+            return checksums;
+
+        auto gs = context->GetGameState();
+        execute<ParkSetParameterAction>(ParkParameter::Open);
+
+        // Enough guests for several of them to think in the same tick.
+        for (int i = 0; i < 3000; i++)
+        {
+            gs->GetPark().GenerateGuest();
+        }
+
+        for (int32_t tick = 1; tick <= numTicks; tick++)
+        {
+            gs->UpdateLogic();
+            if (tick % checksumInterval == 0)
+            {
+                checksums.push_back(GetAllEntitiesChecksum().ToString());
+            }
+        }
+        stats = GuestThink::GetStats();
+        return checksums;
+    };
+
+    GuestThink::Stats serialStats;
+    GuestThink::Stats multithreadedStats;
+    auto serialChecksums = runPark(false, serialStats);
+    auto multithreadedChecksums = runPark(true, multithreadedStats);
+    gConfigGeneral.multithreaded_guest_update = false;
+
+    ASSERT_EQ(serialChecksums.size(), static_cast<size_t>(numTicks / checksumInterval));
+    ASSERT_EQ(serialChecksums, multithreadedChecksums);
+
+    // The checksums only mean something if the serial update actually took the results of the think phase.
+    EXPECT_EQ(serialStats.RidesToGoOn + serialStats.SurroundingsThoughts + serialStats.JunctionChoices, 0U);
+    EXPECT_GT(multithreadedStats.RidesToGoOn, 0U);
+    EXPECT_GT(multithreadedStats.SurroundingsThoughts, 0U);
+    EXPECT_GT(multithreadedStats.JunctionChoices, 0U);
+}
+
+TEST_F(PlayTests, SimulateReportsTimingsOfEveryTick)
+{
+    // Fewer ticks than there are measurement slots, so that every tick has to be read back from the right one.
+    constexpr uint32_t numTicks = 40;
+    gOpenRCT2Headless = true;
+    gOpenRCT2NoGraphics = true;
+    core_init();
+
+    auto result = CommandLine::SimulatePark(TestData::GetParkPath("bpb.sv6"), numTicks, true);
+    ASSERT_FALSE(result.contains("error")) << result["error"].get<std::string>();
+    ASSERT_EQ(result["ticks"], numTicks);
+
+    const auto& timings = result["timings_ms"];
+    double totalMs = 0;
+    for (const auto& partTime : timings)
+    {
+        totalMs += partTime.get<double>();
+    }
+    EXPECT_GT(timings[GetLogicTimePartName(LogicTimePart::Peep)].get<double>(), 0.0);
+    EXPECT_GT(totalMs, 0.0);
+
+    // The parts make up nearly all of the run, not just the ticks that happened to be recorded at the first slot.
+    EXPECT_GT(totalMs, result["seconds"].get<double>() * 1000.0 / 2);
+}
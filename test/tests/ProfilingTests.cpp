@@ -0,0 +1,173 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2021 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+#include <gtest/gtest.h>
+#include <openrct2/core/FileSystem.hpp>
+#include <openrct2/core/Json.hpp>
+#include <openrct2/profiling/Profiling.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace OpenRCT2;
+
+static Profiling::Function ProfiledOuter("ProfilingTest::Outer");
+static Profiling::Function ProfiledInner("ProfilingTest::Inner");
+
+constexpr size_t TEST_TICK_COUNT = 10;
+
+static void RunTick()
+{
+    Profiling::ScopedTimer outer(ProfiledOuter);
+    for (int32_t i = 0; i < 3; i++)
+    {
+        Profiling::ScopedTimer inner(ProfiledInner);
+    }
+}
+
+class ProfilingTest : public testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        Profiling::Disable();
+        Profiling::ResetData();
+    }
+
+    void TearDown() override
+    {
+        Profiling::Disable();
+        Profiling::ResetData();
+    }
+};
+
+TEST_F(ProfilingTest, RecordsNestedScopesPerTick)
+{
+    Profiling::Enable();
+    for (size_t i = 0; i < TEST_TICK_COUNT; i++)
+    {
+        RunTick();
+        Profiling::EndTick();
+    }
+
+    ASSERT_EQ(ProfiledOuter.GetParent(), nullptr);
+    ASSERT_EQ(ProfiledInner.GetParent(), &ProfiledOuter);
+
+    auto outerStats = Profiling::GetStats(ProfiledOuter);
+    ASSERT_EQ(outerStats.Ticks, TEST_TICK_COUNT);
+    ASSERT_EQ(outerStats.Calls, TEST_TICK_COUNT);
+
+    auto innerStats = Profiling::GetStats(ProfiledInner);
+    ASSERT_EQ(innerStats.Ticks, TEST_TICK_COUNT);
+    ASSERT_EQ(innerStats.Calls, TEST_TICK_COUNT * 3);
+    ASSERT_LE(innerStats.P50Ms, innerStats.P99Ms);
+    ASSERT_LE(innerStats.P99Ms, innerStats.MaxMs);
+}
+
+TEST_F(ProfilingTest, DisabledRecordsNothing)
+{
+    for (size_t i = 0; i < TEST_TICK_COUNT; i++)
+    {
+        RunTick();
+        Profiling::EndTick();
+    }
+
+    auto stats = Profiling::GetStats(ProfiledOuter);
+    ASSERT_EQ(stats.Ticks, 0U);
+    ASSERT_EQ(stats.Calls, 0U);
+}
+
+TEST_F(ProfilingTest, WritesChromeTrace)
+{
+    auto path = (fs::temp_directory_path() / "openrct2_profiling_test.json").u8string();
+
+    Profiling::StartTrace();
+    RunTick();
+    ASSERT_TRUE(Profiling::StopTrace(path));
+    ASSERT_FALSE(Profiling::IsTracing());
+
+    auto trace = Json::ReadFromFile(path.c_str());
+    fs::remove(fs::u8path(path));
+
+    ASSERT_TRUE(trace["traceEvents"].is_array());
+
+    // Threads named by other tests add metadata events, only the complete events are the scopes.
+    std::vector<json_t> traceEvents;
+    for (const auto& traceEvent : trace["traceEvents"])
+    {
+        if (traceEvent["ph"] == "X")
+        {
+            ASSERT_GE(traceEvent["dur"].get<double>(), 0.0);
+            traceEvents.push_back(traceEvent);
+        }
+    }
+    ASSERT_EQ(traceEvents.size(), 4U);
+
+    // Events are recorded when a scope ends, so the outer scope comes last.
+    ASSERT_EQ(traceEvents[0]["name"], "ProfilingTest::Inner");
+    ASSERT_EQ(traceEvents[3]["name"], "ProfilingTest::Outer");
+}
+
+TEST_F(ProfilingTest, TracesOtherThreads)
+{
+    auto path = (fs::temp_directory_path() / "openrct2_profiling_thread_test.json").u8string();
+
+    Profiling::StartTrace();
+    std::thread worker([]() {
+        Profiling::SetThreadName("ProfilingTest worker");
+        TRACED_SCOPE("ProfilingTest::Worker");
+    });
+    worker.join();
+    ASSERT_TRUE(Profiling::StopTrace(path));
+
+    auto trace = Json::ReadFromFile(path.c_str());
+    fs::remove(fs::u8path(path));
+
+    json_t threadName;
+    json_t workerEvent;
+    for (const auto& traceEvent : trace["traceEvents"])
+    {
+        if (traceEvent["ph"] == "M" && traceEvent["args"]["name"] == "ProfilingTest worker")
+            threadName = traceEvent;
+        else if (traceEvent["name"] == "ProfilingTest::Worker")
+            workerEvent = traceEvent;
+    }
+    ASSERT_TRUE(threadName.is_object());
+    ASSERT_TRUE(workerEvent.is_object());
+    ASSERT_EQ(threadName["tid"], workerEvent["tid"]);
+}
+
+TEST_F(ProfilingTest, DropsBuffersOfExitedThreads)
+{
+    auto path = (fs::temp_directory_path() / "openrct2_profiling_exited_test.json").u8string();
+
+    Profiling::StartTrace();
+    std::thread worker([]() {
+        Profiling::SetThreadName("ProfilingTest exited worker");
+        TRACED_SCOPE("ProfilingTest::ExitedWorker");
+    });
+    worker.join();
+    ASSERT_TRUE(Profiling::StopTrace(path));
+
+    // The worker has exited, so the next trace no longer mentions it.
+    Profiling::StartTrace();
+    RunTick();
+    ASSERT_TRUE(Profiling::StopTrace(path));
+
+    auto trace = Json::ReadFromFile(path.c_str());
+    fs::remove(fs::u8path(path));
+
+    for (const auto& traceEvent : trace["traceEvents"])
+    {
+        ASSERT_NE(traceEvent["name"], "ProfilingTest::ExitedWorker");
+        if (traceEvent["ph"] == "M")
+        {
+            ASSERT_NE(traceEvent["args"]["name"], "ProfilingTest exited worker");
+        }
+    }
+}
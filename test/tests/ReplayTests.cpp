@@ -14,14 +14,25 @@
 #include <openrct2/Game.h>
 #include <openrct2/GameState.h>
 #include <openrct2/OpenRCT2.h>
+#include <openrct2/ParkImporter.h>
 #include <openrct2/ReplayManager.h>
+#include <openrct2/actions/StaffHireNewAction.h>
 #include <openrct2/audio/AudioContext.h>
 #include <openrct2/core/File.h>
 #include <openrct2/core/FileScanner.h>
+#include <openrct2/core/FileSystem.hpp>
 #include <openrct2/core/Path.hpp>
 #include <openrct2/core/String.hpp>
+#include <openrct2/entity/EntityList.h>
+#include <openrct2/entity/EntityRegistry.h>
+#include <openrct2/entity/EntityTweener.h>
+#include <openrct2/entity/Staff.h>
+#include <openrct2/object/ObjectManager.h>
 #include <openrct2/platform/platform.h>
 #include <openrct2/ride/Ride.h>
+#include <openrct2/world/MapAnimation.h>
+#include <openrct2/world/Scenery.h>
+#include <map>
 #include <string>
 
 using namespace OpenRCT2;
@@ -116,3 +127,134 @@ struct PrintReplayParameter
 };
 
 INSTANTIATE_TEST_CASE_P(Replay, ReplayTests, testing::ValuesIn(GetReplayFiles()), PrintReplayParameter());
+
+static void LoadKeyframeTestPark(IContext& context)
+{
+    std::string parkPath = TestData::GetParkPath("small_park_with_ferris_wheel.sv6");
+    auto importer = ParkImporter::CreateS6(context.GetObjectRepository());
+    auto loadResult = importer->LoadSavedGame(parkPath.c_str(), false);
+    context.GetObjectManager().LoadObjects(loadResult.RequiredObjects);
+    importer->Import();
+
+    ResetEntitySpatialIndices();
+    reset_all_sprite_quadrant_placements();
+    scenery_set_default_placement_configuration();
+    EntityTweener::Get().Reset();
+    AutoCreateMapAnimations();
+    fix_invalid_vehicle_sprite_sizes();
+}
+
+TEST(ReplayKeyframeTests, SeekMatchesPlayback)
+{
+    gOpenRCT2Headless = true;
+    gOpenRCT2NoGraphics = true;
+    core_init();
+
+    auto context = CreateContext();
+    ASSERT_TRUE(context->Initialise());
+    LoadKeyframeTestPark(*context);
+
+    auto* gs = context->GetGameState();
+    auto* replayManager = context->GetReplayManager();
+
+    // Long enough for two keyframes.
+    auto replayPath = (fs::temp_directory_path() / "openrct2_keyframe_test.parkrep").u8string();
+    ASSERT_TRUE(replayManager->StartRecording(replayPath, k_ReplayKeyframeTicks * 2 + 200));
+    while (replayManager->IsRecording())
+    {
+        gs->UpdateLogic();
+    }
+
+    // Ticks before the first keyframe, between the keyframes and after the last one.
+    std::map<uint32_t, EntitiesChecksum> checksums;
+    for (uint32_t replayTick : { 100U, k_ReplayKeyframeTicks + 50, k_ReplayKeyframeTicks * 2 + 100 })
+    {
+        checksums[replayTick] = {};
+    }
+
+    ASSERT_TRUE(replayManager->StartPlayback(replayPath));
+    ReplayRecordInfo info;
+    ASSERT_TRUE(replayManager->GetCurrentReplayInfo(info));
+    ASSERT_EQ(info.NumKeyframes, 2U);
+
+    uint32_t tickStart = gCurrentTicks;
+    while (replayManager->IsReplaying())
+    {
+        gs->UpdateLogic();
+        auto it = checksums.find(gCurrentTicks - tickStart);
+        if (it != checksums.end())
+        {
+            it->second = GetAllEntitiesChecksum();
+        }
+    }
+    ASSERT_FALSE(replayManager->IsPlaybackStateMismatching());
+
+    // Seek forwards past both keyframes, then backwards to each of the ticks.
+    ASSERT_TRUE(replayManager->StartPlayback(replayPath));
+    for (auto it = checksums.rbegin(); it != checksums.rend(); it++)
+    {
+        ASSERT_TRUE(replayManager->SeekPlayback(it->first));
+        ASSERT_EQ(gCurrentTicks - tickStart, it->first);
+        ASSERT_EQ(GetAllEntitiesChecksum().raw, it->second.raw) << "replay tick " << it->first;
+        ASSERT_FALSE(replayManager->IsPlaybackStateMismatching());
+    }
+    replayManager->StopPlayback();
+
+    fs::remove(fs::u8path(replayPath));
+}
+
+TEST(ReplayKeyframeTests, SeekReplaysActionsOnce)
+{
+    gOpenRCT2Headless = true;
+    gOpenRCT2NoGraphics = true;
+    core_init();
+
+    auto context = CreateContext();
+    ASSERT_TRUE(context->Initialise());
+    LoadKeyframeTestPark(*context);
+
+    auto* gs = context->GetGameState();
+    auto* replayManager = context->GetReplayManager();
+
+    // Hiring staff is not idempotent, an action executed twice adds a second entity to the checksum.
+    // Actions are recorded before the first tick, the tick of the keyframe and the tick after it.
+    auto replayPath = (fs::temp_directory_path() / "openrct2_keyframe_actions_test.parkrep").u8string();
+    ASSERT_TRUE(replayManager->StartRecording(replayPath, k_ReplayKeyframeTicks + 200));
+    uint32_t recordStart = gCurrentTicks;
+    while (replayManager->IsRecording())
+    {
+        uint32_t replayTick = gCurrentTicks - recordStart;
+        if (replayTick == 0 || replayTick == k_ReplayKeyframeTicks || replayTick == k_ReplayKeyframeTicks + 1)
+        {
+            auto action = StaffHireNewAction(true, StaffType::Handyman, EntertainerCostume::Panda, 0);
+            ASSERT_EQ(GameActions::Execute(&action).Error, GameActions::Status::Ok) << "replay tick " << replayTick;
+        }
+        gs->UpdateLogic();
+    }
+
+    const uint32_t seekTick = k_ReplayKeyframeTicks + 100;
+    ASSERT_TRUE(replayManager->StartPlayback(replayPath));
+    ReplayRecordInfo info;
+    ASSERT_TRUE(replayManager->GetCurrentReplayInfo(info));
+    ASSERT_EQ(info.NumKeyframes, 1U);
+
+    uint32_t tickStart = gCurrentTicks;
+    while (replayManager->IsReplaying() && gCurrentTicks - tickStart < seekTick)
+    {
+        gs->UpdateLogic();
+    }
+    ASSERT_FALSE(replayManager->IsPlaybackStateMismatching());
+    auto expected = GetAllEntitiesChecksum();
+    auto expectedStaff = GetEntityListCount(EntityType::Staff);
+    replayManager->StopPlayback();
+
+    ASSERT_TRUE(replayManager->StartPlayback(replayPath));
+    ASSERT_TRUE(replayManager->SeekPlayback(seekTick));
+    ASSERT_EQ(gCurrentTicks - tickStart, seekTick);
+    ASSERT_EQ(GetEntityListCount(EntityType::Staff), expectedStaff);
+    ASSERT_EQ(GetAllEntitiesChecksum().raw, expected.raw);
+    ASSERT_FALSE(replayManager->IsPlaybackStateMismatching());
+    replayManager->StopPlayback();
+
+    fs::remove(fs::u8path(replayPath));
+}
@@ -0,0 +1,222 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2021 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "TestData.h"
+
+#include <gtest/gtest.h>
+#include <memory>
+#include <openrct2/Context.h>
+#include <openrct2/Game.h>
+#include <openrct2/OpenRCT2.h>
+#include <openrct2/config/Config.h>
+#include <openrct2/drawing/LightFX.h>
+#include <openrct2/drawing/X8DrawingEngine.h>
+#include <openrct2/interface/Viewport.h>
+#include <openrct2/interface/ViewportCache.h>
+#include <openrct2/interface/Window.h>
+#include <openrct2/platform/platform.h>
+#include <openrct2/world/Map.h>
+#include <openrct2/world/Surface.h>
+#include <string>
+#include <vector>
+
+using namespace OpenRCT2;
+using namespace OpenRCT2::Drawing;
+
+class ViewportCacheTest : public testing::Test
+{
+public:
+    static void SetUpTestCase()
+    {
+        core_init();
+
+        gOpenRCT2Headless = true;
+        gOpenRCT2NoGraphics = false;
+        _context = CreateContext();
+        const bool initialised = _context->Initialise();
+        ASSERT_TRUE(initialised);
+
+        std::string parkPath = TestData::GetParkPath("bpb.sv6");
+        load_from_sv6(parkPath.c_str());
+        game_load_init();
+
+        // Pages are only used by drawing engines that draw the viewports into the pixels of the screen.
+        _drawingEngine = std::make_unique<X8DrawingEngine>(nullptr);
+#ifdef __ENABLE_LIGHTFX__
+        lightfx_set_available(false);
+#endif
+    }
+
+    void SetUp() override
+    {
+        gConfigGeneral.viewport_cache = true;
+        gConfigGeneral.paint_cache = false;
+        gCurrentRotation = 0;
+        ViewportCache::Reset();
+        ViewportCache::ResetStats();
+    }
+
+    void TearDown() override
+    {
+        gConfigGeneral.viewport_cache = false;
+        ViewportCache::Reset();
+    }
+
+    static void TearDownTestCase()
+    {
+        _drawingEngine = nullptr;
+        _context = nullptr;
+    }
+
+protected:
+    static constexpr int32_t Width = 480;
+    static constexpr int32_t Height = 320;
+
+    static CoordsXY GetMapCentre()
+    {
+        return { (gMapSize / 2) * COORDS_XY_STEP, (gMapSize / 2) * COORDS_XY_STEP };
+    }
+
+    // Returns a viewport the size of the pixels drawn, looking at the middle of the map.
+    static rct_viewport CreateViewport(ZoomLevel zoom)
+    {
+        auto centre = GetMapCentre() + CoordsXY{ 16, 16 };
+        auto screenCentre = translate_3d_to_2d_with_z(get_current_rotation(), { centre, tile_element_height(centre) });
+
+        rct_viewport viewport{};
+        viewport.width = Width;
+        viewport.height = Height;
+        viewport.view_width = Width * zoom;
+        viewport.view_height = Height * zoom;
+        viewport.viewPos = screenCentre - ScreenCoordsXY{ viewport.view_width / 2, viewport.view_height / 2 };
+        viewport.zoom = zoom;
+        return viewport;
+    }
+
+    /**
+     * Draws the whole viewport, from the pages or by painting it directly, the same way viewport_render draws the
+     * area of a viewport within a dirty rectangle.
+     */
+    static std::vector<uint8_t> Draw(const rct_viewport& viewport, bool usePages)
+    {
+        std::vector<uint8_t> pixels(Width * Height, PALETTE_INDEX_0);
+
+        rct_drawpixelinfo dpi;
+        dpi.bits = pixels.data();
+        dpi.x = 0;
+        dpi.y = 0;
+        dpi.width = Width;
+        dpi.height = Height;
+        dpi.pitch = 0;
+        dpi.zoom_level = ZoomLevel{ 0 };
+        dpi.DrawingEngine = _drawingEngine.get();
+
+        ScreenRect viewRect = { viewport.viewPos,
+                                viewport.viewPos + ScreenCoordsXY{ viewport.view_width, viewport.view_height } };
+        if (usePages)
+        {
+            EXPECT_TRUE(ViewportCache::Render(dpi, viewport, viewRect));
+        }
+        else
+        {
+            viewport_paint(&viewport, &dpi, viewRect, nullptr);
+        }
+        return pixels;
+    }
+
+    static std::shared_ptr<IContext> _context;
+    static std::unique_ptr<X8DrawingEngine> _drawingEngine;
+};
+
+std::shared_ptr<IContext> ViewportCacheTest::_context;
+std::unique_ptr<X8DrawingEngine> ViewportCacheTest::_drawingEngine;
+
+TEST_F(ViewportCacheTest, PagesMatchViewportPaint)
+{
+    for (int8_t zoom = 0; zoom <= 2; zoom++)
+    {
+        auto viewport = CreateViewport(ZoomLevel{ zoom });
+        auto painted = Draw(viewport, false);
+        EXPECT_EQ(painted, Draw(viewport, true)) << "painted pages, zoom " << int(zoom);
+
+        ViewportCache::ResetStats();
+        EXPECT_EQ(painted, Draw(viewport, true)) << "copied pages, zoom " << int(zoom);
+        EXPECT_EQ(ViewportCache::GetStats().PaintCount, 0U);
+        EXPECT_GT(ViewportCache::GetStats().BlitCount, 0U);
+    }
+}
+
+TEST_F(ViewportCacheTest, InvalidatedAreaIsPaintedAgain)
+{
+    auto viewport = CreateViewport(ZoomLevel{ 0 });
+    Draw(viewport, true);
+
+    // Raise the water of the tile in the middle of the viewport, invalidating only the area of the tile.
+    auto loc = GetMapCentre();
+    auto* surfaceElement = map_get_surface_element_at(loc);
+    ASSERT_NE(surfaceElement, nullptr);
+    auto waterHeight = surfaceElement->GetWaterHeight();
+    surfaceElement->SetWaterHeight(surfaceElement->GetBaseZ() + 32);
+
+    auto screenCoords = translate_3d_to_2d_with_z(get_current_rotation(), { loc + CoordsXY{ 16, 16 }, 0 });
+    ScreenRect tileRect = { { screenCoords.x - 32, screenCoords.y - 32 - 2080 }, { screenCoords.x + 32, screenCoords.y + 32 } };
+    viewports_invalidate(tileRect, ZoomLevel{ -1 });
+
+    ViewportCache::ResetStats();
+    auto cached = Draw(viewport, true);
+    auto painted = Draw(viewport, false);
+    EXPECT_GT(ViewportCache::GetStats().PaintCount, 0U);
+    EXPECT_EQ(painted, cached);
+
+    surfaceElement->SetWaterHeight(waterHeight);
+    viewports_invalidate(tileRect, ZoomLevel{ -1 });
+    EXPECT_EQ(Draw(viewport, false), Draw(viewport, true));
+}
+
+TEST_F(ViewportCacheTest, PannedViewportMatchesViewportPaint)
+{
+    for (int8_t zoom = 0; zoom <= 1; zoom++)
+    {
+        auto viewport = CreateViewport(ZoomLevel{ zoom });
+        Draw(viewport, true);
+
+        // Offsets that do not line up with the pages, the pages drawn before are partly reused.
+        const ScreenCoordsXY offsets[] = { { 40, 24 }, { -100, 0 }, { 0, -300 }, { 310, 170 } };
+        for (const auto& offset : offsets)
+        {
+            viewport.viewPos += ScreenCoordsXY{ offset.x * viewport.zoom, offset.y * viewport.zoom };
+            auto cached = Draw(viewport, true);
+            EXPECT_EQ(Draw(viewport, false), cached) << "offset " << offset.x << "," << offset.y << ", zoom " << int(zoom);
+        }
+    }
+}
+
+#ifdef __ENABLE_LIGHTFX__
+TEST_F(ViewportCacheTest, LightFXPaintsDirectly)
+{
+    auto viewport = CreateViewport(ZoomLevel{ 0 });
+    std::vector<uint8_t> pixels(Width * Height);
+
+    rct_drawpixelinfo dpi;
+    dpi.bits = pixels.data();
+    dpi.x = 0;
+    dpi.y = 0;
+    dpi.width = Width;
+    dpi.height = Height;
+    dpi.pitch = 0;
+    dpi.zoom_level = ZoomLevel{ 0 };
+    dpi.DrawingEngine = _drawingEngine.get();
+
+    lightfx_set_available(true);
+    EXPECT_FALSE(ViewportCache::Render(
+        dpi, viewport, { viewport.viewPos, viewport.viewPos + ScreenCoordsXY{ viewport.view_width, viewport.view_height } }));
+    lightfx_set_available(false);
+    EXPECT_EQ(ViewportCache::GetStats().Pages, 0U);
+}
+#endif